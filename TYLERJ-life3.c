@@ -3,17 +3,103 @@
 	Created by Joshua Tyler (URN:6213642)
 */
 
+/* For sync_file_range(), which the mapped engine uses to write its boards back to disk as it goes */
+#define _GNU_SOURCE
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
+#include <limits.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <sched.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/signalfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/un.h>
+#include <sys/wait.h>
 
 /* The maximum board width and height from the specification */
 #define MAX_BOARD_WIDTH 78
 #define MAX_BOARD_HEIGHT 50
 
-/* The maximum period that the program is capable of detecting.
+/* The age at which a cell's age stops increasing, this is printed as an 'X' */
+#define MAX_AGE 10
+
+/* The number of boards that can be waiting to be printed unless told otherwise with the --output-buffer option. */
+#define DEFAULT_OUTPUT_BUFFER 8
+
+/* The smallest and largest blocks of cells, as powers of two, whose populations a viewport's population pyramid keeps.
+   The smallest are 8 x 8, so that a block's population fits in a byte and a word holds the blocks of a word of the live plane.
+   Smaller blocks are counted from the live plane as the view is drawn, and larger ones are summed from the largest,
+   which is the largest whose population always fits in 32 bits. */
+#define PYRAMID_FIRST_LEVEL 3
+#define PYRAMID_LAST_LEVEL 15
+
+/* The number of density levels that a pixel of a zoomed out view is given, from the fraction of its cells that are alive */
+#define DENSITY_LEVELS 15
+
+/* The number of generations between the full boards (keyframes) in a frame log, unless told otherwise with the --keyframe-interval option.
+   A longer interval makes the log smaller, but finding a generation in it slower. */
+#define DEFAULT_KEYFRAME_INTERVAL 64
+
+/* The estimated time in nanoseconds that the engines take for a generation: the bit engine per cell of the board,
+   and the sparse engine per live cell and per cell that changed. Measured on 1024 x 1024 still and random boards,
+   they make the two engines cost the same when about 1% of the cells are alive. */
+#define BIT_COST_PER_CELL 0.6
+#define SPARSE_COST_PER_LIVE_CELL 60.0
+#define SPARSE_COST_PER_CHANGED_CELL 30.0
+
+/* The number of live cells that the sparse engine's memory is reserved for: SPARSE_GROWTH times the cells the board starts with,
+   but at least SPARSE_MIN_CELLS, and no more than the whole board. A board that grows past that fills its arena. */
+#define SPARSE_GROWTH 64
+#define SPARSE_MIN_CELLS ( 1L << 24 )
+
+/* The estimated time in nanoseconds that the freezing engine takes for a generation: per cell of the board to find the frozen tiles,
+   and the bit engine's time for the cells that can't be frozen, FREEZE_CELLS_PER_CHANGED_CELL for each cell that changed.
+   Oscillators change every generation but can still be frozen, so the estimate is cautious for ash that is full of blinkers:
+   measured on 1024 x 1024 random boards, it moves the board to the freezing engine once about 1% of the cells change each generation. */
+#define FREEZE_COST_PER_CELL 0.05
+#define FREEZE_CELLS_PER_CHANGED_CELL 40.0
+
+/* The number of generations between the adaptive controller's checks on the workload, unless told otherwise with --adapt-interval.
+   The controller only moves the board to another engine if that engine's estimated cost is less than SWITCH_MARGIN times the current one's,
+   so that a board near the break-even point doesn't keep changing engine. */
+#define DEFAULT_ADAPT_INTERVAL 16
+#define SWITCH_MARGIN 0.5
+
+/* The alignment of every allocation carved from a memory arena, which is also the size of the header in front of it. */
+#define ARENA_ALIGNMENT 64
+
+/* The memory added to each arena's estimated size for the arena headers and anything too small to count. */
+#define ARENA_SLACK (1 << 20)
+
+/* The largest arena that is reserved. The program won't start a board that needs more than this. */
+#define MAX_ARENA_SIZE ( (double)( (size_t)1 << 46 ) )
+
+/* The size of the buffers given to stdout and the frame log file, so that the C library doesn't allocate its own. */
+#define STREAM_BUFFER_SIZE 65536
+
+/* The maximum period that the program detects unless told otherwise with the --history option.
    Using a larger maximum period will increase memory usage and decrease performance. */
-#define MAX_PERIOD_TO_DETECT 4
+#define DEFAULT_PERIOD_TO_DETECT 4
+
+/* The smallest snapshot, in 64 bit words, that the thread pool takes in bands rather than the main thread taking it alone,
+   and the number of words of a snapshot that each of the pool's comparison tasks compares. */
+#define PARALLEL_SNAPSHOT_WORDS 16384
+#define COMPARE_CHUNK_WORDS 16384
 
 /* Structure to hold co-ordinates of a point */
 typedef struct
@@ -22,17 +108,1237 @@ typedef struct
 	int row;
 } coord;
 
+/* Structure to hold a list of live cells, which is how a board is given to an engine,
+   so that an engine that doesn't store the whole board never needs to allocate it.
+   A list read from a file has no ages (ages is NULL, so every cell has age 0), and may contain duplicates.
+   A list with ages comes from planesToCells(), so is in row order without duplicates. */
+typedef struct
+{
+	long noOfCells;
+	coord *cells;
+	unsigned char *ages;
+} cellList;
+
+/* Structure to hold a board as two separate planes.
+   The live plane holds one bit per cell: bit (column % 64) of word (column / 64) of each row is set if the cell is alive.
+   The age plane holds one nibble per cell: nibble (column % 16) of word (column / 16) of each row is the age of a live cell.
+   Ages saturate at MAX_AGE, which is printed as 'X'. The age nibble of a dead cell is always 0.
+   Rows are liveWordsPerRow and ageWordsPerRow words long, and any bits past the end of a row are always 0. */
+typedef struct
+{
+	int width, height;
+	int liveWordsPerRow, ageWordsPerRow;
+	uint64_t *live;
+	uint64_t *ages;
+} boardPlanes;
+
+/* Structure to hold what is known about a board as a whole: its population, the cells born and the cells that died since the generation before,
+   and the bounding box of its live cells, which is empty (right and bottom less than left and top) if there aren't any. */
+typedef struct
+{
+	long population;
+	long births, deaths;
+	int left, top, right, bottom;
+} boardStatistics;
+
+/* Structure to hold a compact copy of the live cells of a board, so that later boards can be tested for repetition.
+   The cells are packed one bit per cell in row order (cell (row, column) is bit number row * boardWidth + column),
+   so a snapshot is an eighth of the size of a board.
+   The population and hash let most non-identical snapshots be told apart without looking at the cells. */
+typedef struct
+{
+	uint64_t *cells;
+	long population;
+	uint64_t hash;
+	int used;
+} boardSnapshot;
+
+/* Structure to hold main()'s history of the earlier generations, for engines that don't keep their own:
+   a ring of depth + 1 snapshots, one for the current board and one for each earlier generation to compare it to.
+   current is the index that the snapshot of the current board is taken into,
+   the snapshots of the previous generations are the ones before it (wrapping round to the end of the array).
+   If the ring has a thread pool, the rest is the state that the pool's tasks share while they test the current board:
+   the board the snapshot is taken of, which is split into noOfBands bands of whole units of rowsPerUnit rows
+   (rowsPerUnit rows take up a whole number of snapshot words, so that the bands never share a word), with the population and hash of each band,
+   and the candidates (the slots of the earlier snapshots with the same population and hash as the current one, most recent first),
+   each compared in noOfChunks chunks, with the number of chunks of each still to match,
+   and the smallest period found so far (INT_MAX while there isn't one). */
+typedef struct threadPool threadPool;
+typedef struct
+{
+	int depth;
+	int current;
+	boardSnapshot *snapshots;
+	uint64_t *cells;
+	threadPool *pool;
+	const boardPlanes *board;
+	int noOfBands, rowsPerUnit, noOfUnits;
+	long *bandPopulations;
+	uint64_t *bandHashes;
+	int *candidates;
+	atomic_int *chunksLeft;
+	int noOfCandidates, noOfChunks;
+	atomic_int period;
+} snapshotRing;
+
+/* The most cells in a bounding box that the spaceship tracker packs the pattern of. A pattern with a bigger box isn't recognized as a spaceship. */
+#define MAX_PATTERN_CELLS (1L << 22)
+
+/* Structure to hold the spaceship tracker, which remembers the patterns of the last depth generations, normalized to their bounding boxes,
+   so that a pattern that moves across the board can be recognized. Generation n is in slot n % (depth + 1), which holds its statistics,
+   and, if packed is set, its cells (packed by packPattern(), in patternWords words) and their hash. A pattern is only packed if an earlier
+   generation had the same population and size of bounding box, as only then could it be the same pattern. The last speed reported is
+   reportedColumns and reportedRows every reportedPeriod generations, so that a spaceship is only reported again if it changes. */
+typedef struct
+{
+	int depth;
+	size_t patternWords;
+	boardStatistics *statistics;
+	unsigned char *packed;
+	uint64_t *hashes;
+	uint64_t *patterns;
+	int reportedPeriod, reportedColumns, reportedRows;
+} spaceshipTracker;
+
+/* Structure to hold where packPattern() is writing the cells that visitCells() passes it: the cells, and the top left corner and width of the box. */
+typedef struct
+{
+	uint64_t *cells;
+	int top, left, boxWidth;
+} patternPacker;
+
+/* Structure to hold a memory arena: a block of memory reserved when the program starts, which allocateMemory() carves allocations from in order,
+   so that nothing needs to be allocated from the heap once the generations are being calculated.
+   Each allocation starts ARENA_ALIGNMENT bytes after a header holding its size, and is ARENA_ALIGNMENT aligned.
+   Freeing an allocation gives its pages back to the system, but only the last allocation in an arena can be reused,
+   and the whole arena is reused when it is emptied. */
+typedef struct
+{
+	unsigned char *base;
+	size_t size;
+	size_t used;
+} memoryArena;
+
+/* The most states a cell can have under a rule from the Generations family, and the number of bits that hold a state */
+#define MAX_STATES 16
+#define STATE_BITS 4
+
+/* The largest neighbourhood range of a Larger than Life rule */
+#define MAX_RANGE 500
+
+/* Structure to hold a rule from the Generations family, which includes Life.
+   A dead cell is born if its number of live neighbours is in birth (bit n being set for n neighbours), and a live cell stays alive if it is in survival.
+   A live cell that doesn't stay alive goes up a state each generation, through the noOfStates - 2 dying states, until it is dead again.
+   Dying cells aren't live neighbours, and can't be born. Life is B3/S23 with 2 states, so a cell that doesn't survive is dead at once.
+   A Larger than Life rule (range above 0) counts the live cells within range rows and columns of each cell instead, including the cell itself
+   if includesCentre is set, and a cell is born or survives if the count is between birthMin and birthMax, or survivalMin and survivalMax. */
+typedef struct
+{
+	unsigned birth;
+	unsigned survival;
+	int noOfStates;
+	int range;
+	int includesCentre;
+	int birthMin, birthMax;
+	int survivalMin, survivalMax;
+} generationsRule;
+
+/* Structure to hold the settings from the command line that engines may need when they are created,
+   and the number of live cells the board starts with (initialPopulation), which an engine's memory can be estimated from. */
+typedef struct
+{
+	int historyDepth;
+	int noOfWorkers;
+	int noOfThreads;
+	int needBoards;
+	const char *mapFileName;
+	generationsRule rule;
+	int trackStatistics;
+	long tileCacheEntries;
+	long initialPopulation;
+} engineOptions;
+
+/* Structure to hold a way of calculating generations (an engine).
+   Each engine keeps its boards in whatever form suits it, and provides its current board as a boardPlanes when asked.
+   An engine that keeps its own history can also test for repetition itself with findPeriod(), which is NULL otherwise,
+   and give back the earlier generations with recallHistory() if the board moves to another engine.
+   An engine that the adaptive controller may choose provides measure(), which counts the live cells and the cells that changed
+   in the last generation, and estimateCost(), which estimates its time for a generation from those counts.
+   memoryNeeded() gives the most memory, in bytes, that an engine can allocate for a board, which is reserved in the engine's arena.
+   An engine that can find the statistics of its board without reading the whole of it gives them with statistics(), which returns 0
+   if it hasn't got them for the current generation (it is NULL if the engine never has them). Some only keep them up to date
+   as they calculate each generation if they were created with trackStatistics set.
+   An engine whose boards can be shared provides fork(), which makes a new engine at the same generation, with the same history,
+   that carries on independently of the first without copying the board (it is NULL otherwise).
+   An engine that doesn't keep the whole board provides visitCells(), which passes each live cell in a rectangle of the board, in order,
+   to a function, so that part of the board can be looked at without view() making all of it (it is NULL otherwise).
+   The functions are called through the type, so that main() doesn't depend on which engine is in use. */
+typedef struct lifeEngine lifeEngine;
+typedef struct
+{
+	const char *name;
+	const char *description;
+	lifeEngine *(*create)(int width, int height, const engineOptions *options);
+	void (*load)(lifeEngine *engine, const cellList *cells);
+	void (*step)(lifeEngine *engine);
+	const boardPlanes *(*view)(lifeEngine *engine);
+	void (*destroy)(lifeEngine *engine);
+	int (*findPeriod)(lifeEngine *engine);
+	int (*recallHistory)(lifeEngine *engine, cellList *generations);
+	void (*measure)(lifeEngine *engine, long *population, long *changed);
+	double (*estimateCost)(double area, long population, long changed);
+	double (*memoryNeeded)(int width, int height, const engineOptions *options);
+	int (*statistics)(lifeEngine *engine, boardStatistics *statistics);
+	lifeEngine *(*fork)(lifeEngine *engine);
+	void (*visitCells)(lifeEngine *engine, int top, int left, int bottom, int right, void (*visit)(void *context, int row, int column, int age), void *context);
+} engineType;
+
+/* The part of the engine shared by all types, each engine's own structure starts with this. */
+struct lifeEngine
+{
+	const engineType *type;
+	int width, height;
+};
+
+/* Engine that uses the original character boards, iterateBoard() and numberOfNeighbours().
+   It is the reference that the other engines must match. */
+typedef struct
+{
+	lifeEngine base;
+	char *currentBoard;
+	char *nextBoard;
+	boardPlanes planes;
+} charEngine;
+
+/* Engine that keeps one byte per cell, 1 for a live cell and 0 for a dead one, with a border of dead cells all the way round
+   so that every cell of the board has eight neighbours to add up. Each row is stride (width + 2) bytes, and there are height + 2 rows.
+   The ages are kept in the same layout. The kernel has no branches that depend on the cells, so that the compiler can vectorize it. */
+typedef struct
+{
+	lifeEngine base;
+	int stride;
+	unsigned char *live;
+	unsigned char *nextLive;
+	unsigned char *ages;
+	unsigned char *nextAges;
+	boardPlanes planes;
+} scalarEngine;
+
+/* Engine that calculates a rule from the Generations family. The state of each cell is held in STATE_BITS bit planes,
+   so that, like the bit engine, it works on 64 cells at once. The bit planes of generation n are in slot n % noOfSlots of states,
+   each plane being planeWords words laid out like a live plane, so the last historyDepth generations are kept to test for repetition,
+   with the hash of each slot in hashes. planes[n % 2] holds the live cells (state 1) of generation n and their ages. */
+typedef struct
+{
+	lifeEngine base;
+	generationsRule rule;
+	int historyDepth, noOfSlots;
+	long generation;
+	size_t planeWords;
+	uint64_t *states;
+	uint64_t *hashes;
+	boardPlanes planes[2];
+	uint64_t *deadRow;
+} generationsEngine;
+
+/* The number of bands of rows the wavefront engine splits the board into for each of its threads */
+#define WAVEFRONT_BANDS_PER_THREAD 8
+
+/* Engine that uses the bit engine's kernels on noOfThreads threads of its own, each calculating a different generation at the same time:
+   thread k calculates generations k + 1, k + 1 + noOfThreads, and so on, each one band of bandRows rows at a time.
+   bandGenerations[band] is the last generation that has been calculated for each band. A band of generation n can be calculated once the bands
+   next to it have reached generation n - 1, so each thread follows a couple of bands behind the one before it, without waiting for whole generations.
+   The generations are kept in a ring of noOfSlots boards, generation n being in slots[n % noOfSlots]. viewedGeneration is main()'s current generation,
+   which must not be overwritten, so the threads stay less than noOfSlots generations ahead of it. */
+typedef struct
+{
+	lifeEngine base;
+	int noOfThreads, noOfSlots;
+	int noOfBands, bandRows;
+	boardPlanes *slots;
+	uint64_t *deadRow;
+	atomic_long *bandGenerations;
+	atomic_long viewedGeneration;
+	atomic_int nextThread;
+	atomic_int stopping;
+	pthread_t *threads;
+	int running;
+} wavefrontEngine;
+
+/* Engine that keeps the board as a boardPlanes, and calculates 64 cells at a time with bitwise operations.
+   If trackStatistics is set, the statistics of the current board are worked out as it is calculated, and haveStatistics is set once they are. */
+typedef struct
+{
+	lifeEngine base;
+	boardPlanes current;
+	boardPlanes next;
+	uint64_t *deadRow;
+	int trackStatistics, haveStatistics;
+	boardStatistics statistics;
+} bitEngine;
+
+/* The number of generations the freezing engine keeps, and the number of rows in each of its tiles (which are one word, 64 cells, wide).
+   A tile that repeats with a period that divides FREEZE_CYCLE (1, 2, 3 or 6) can be frozen. */
+#define FREEZE_CYCLE 6
+#define FREEZE_TILE_ROWS 16
+
+/* Engine that uses the bit engine's kernels, but stops calculating the parts of the board that have settled into still lifes and oscillators.
+   It keeps the last FREEZE_CYCLE generations, generation n being in planes[n % FREEZE_CYCLE], and the board is divided into tiles.
+   repeating[tile] is set if the tile is the same as it was FREEZE_CYCLE generations ago, so if a tile and the eight around it are all repeating,
+   the tile's next generation is the same as the one FREEZE_CYCLE - 1 generations ago, which is already in the planes it would be written to.
+   Such a tile is frozen: it is skipped, until a tile around it stops repeating.
+   If trackStatistics is set, tilePopulations and tileBirths hold the live cells and the cells just born in each tile of each generation kept,
+   generation n's being from n % FREEZE_CYCLE * tileRows * words, which a frozen tile's next generation has already got too.
+   The statistics of the current board are worked out from them, and haveStatistics is set once they are. */
+typedef struct
+{
+	lifeEngine base;
+	boardPlanes planes[FREEZE_CYCLE];
+	long generation;
+	int tileRows;
+	unsigned char *repeating;
+	unsigned char *nextRepeating;
+	unsigned char *frozenWords;
+	long activeTiles;
+	uint64_t *deadRow;
+	int trackStatistics, haveStatistics;
+	uint16_t *tilePopulations;
+	uint16_t *tileBirths;
+	boardStatistics statistics;
+} freezeEngine;
+
+/* The number of bytes of the current and next boards that the mapped engine works on at once, which is rounded down to whole rows,
+   and the name of the temporary file it keeps its boards in if it isn't given one. */
+#define MAPPED_BAND_BYTES (8 << 20)
+#define MAPPED_FILE_TEMPLATE "/tmp/TYLERJ-life3-XXXXXX"
+
+/* Engine that uses the bit engine's kernels, but keeps its boards in a memory-mapped file, for boards too big to keep in memory.
+   The file holds noOfLiveSlots live planes, generation n's being in slot n % noOfLiveSlots so that the last historyDepth generations
+   are there to test for repetition, followed by two age planes, generation n's being in the second if n is odd. Each plane starts on a page boundary.
+   A generation is calculated in bands of bandRows rows, and each band of the next board is written back to the file as soon as it is calculated,
+   so that only a couple of bands of each plane need to be in memory at once.
+   populations and hashes hold the population and hash of the generation in each live slot, and planes is the view of the current board. */
+typedef struct
+{
+	lifeEngine base;
+	int fd;
+	unsigned char *map;
+	size_t mapSize;
+	size_t liveBytes, ageBytes;
+	int noOfLiveSlots;
+	int historyDepth;
+	long generation;
+	int bandRows;
+	long *populations;
+	uint64_t *hashes;
+	boardPlanes planes;
+	uint64_t *deadRow;
+} mappedEngine;
+
+/* Structure to hold one generation of the sparse engine's history, the keys of its live cells in order. */
+typedef struct
+{
+	uint64_t *keys;
+	long noOfCells;
+	long capacity;
+	uint64_t hash;
+	int used;
+} sparseSnapshot;
+
+/* Engine that stores only the live cells, as a sorted array of keys (row << 32 | column) with their ages,
+   so that a generation takes time in proportion to the population, however big the board is.
+   It keeps its own history, so the whole board is only made when it is printed or logged.
+   births and deaths are the cells born and the cells that died in the last generation, which haveStatistics is set once they are known. */
+typedef struct
+{
+	lifeEngine base;
+	long noOfCells;
+	long capacity;
+	uint64_t *keys;
+	unsigned char *ages;
+	uint64_t *nextKeys;
+	unsigned char *nextAges;
+	long *neighbourColumns;
+	long changedCells;
+	long births, deaths;
+	int haveStatistics;
+	int historyDepth;
+	int currentSnapshot;
+	sparseSnapshot *history;
+	boardPlanes planes;
+	int havePlanes;
+} sparseEngine;
+
+/* What to do with a board that is ready to be printed when the output buffer is full */
+typedef enum
+{
+	OUTPUT_BLOCK,    /* wait for the writer to make room, so every board is printed */
+	OUTPUT_DROP,     /* don't print the board */
+	OUTPUT_COALESCE  /* keep the board aside, replacing any board kept aside earlier, and print it when there is room */
+} outputPolicy;
+
+/* Structure to hold an output pipeline, which outputs boards on a separate writer thread so the simulation doesn't wait for I/O.
+   The simulation thread copies each board into the next free slot of a ring, and the writer thread passes the slots in order to writeBoard().
+   There is a single producer and a single consumer, so the ring positions only need atomic loads and stores.
+   The semaphores count the full and free slots, so that either thread can sleep when it has nothing to do. */
+typedef struct
+{
+	int noOfSlots;
+	boardPlanes *slots;
+	int *slotIsStop;
+	atomic_int head;
+	atomic_int tail;
+	sem_t fullSlots;
+	sem_t freeSlots;
+	outputPolicy policy;
+	boardPlanes coalesced;
+	int haveCoalesced;
+	long droppedBoards;
+	void (*writeBoard)(void *context, const boardPlanes *board);
+	void *context;
+	pthread_t writer;
+} outputPipeline;
+
+/* Structure to hold a pool of helper threads, which work with the main thread through a job split into numbered tasks.
+   runPoolTasks() posts startTasks once for each helper, then every thread, the main one included, takes task numbers from nextTask
+   and passes them to runTask() until there are none left. Each helper posts tasksDone when it runs out, so the main thread knows the job is over.
+   The tasks of a job can run in any order, so a job that needs a particular result has to get it whatever the order. */
+struct threadPool
+{
+	int noOfThreads;
+	pthread_t *helpers;
+	sem_t startTasks;
+	sem_t tasksDone;
+	void (*runTask)(void *context, int task);
+	void *context;
+	int noOfTasks;
+	atomic_int nextTask;
+	int stopping;
+};
+
+/* Engine that calculates a Larger than Life rule (or any other rule from the Generations family), keeping the state of each cell in a byte.
+   The neighbours of every cell are counted from a summed-area table of the live cells, rebuilt each generation, so a count costs the same
+   whatever the range. The states of generation n are in slot n % noOfSlots of states, each row being stride bytes,
+   so the last historyDepth generations are kept to test for repetition, with the hash of each slot in hashes.
+   transitions gives the next state of a dead cell, then of a live cell, for each count up to maxCount.
+   planes[n % 2] holds the live cells (state 1) of generation n and their ages.
+   The table is built, and the board calculated, by a pool of threads in bands of bandRows rows,
+   bandCarries holding the total of the rows above each band and bandHashes the hash of each band's next states. */
+typedef struct
+{
+	lifeEngine base;
+	generationsRule rule;
+	int range, maxCount;
+	int historyDepth, noOfSlots;
+	long generation;
+	int stride;
+	unsigned char *states;
+	uint64_t *hashes;
+	unsigned char *transitions;
+	boardPlanes planes[2];
+	int sumStride;
+	uint32_t *sums;
+	int noOfThreads, noOfBands, bandRows;
+	uint32_t *bandCarries;
+	uint64_t *bandHashes;
+	threadPool pool;
+} largerThanLifeEngine;
+
+/* The memo engine's tiles are TILE_SIZE cells square. The key of a tile is its cells with the ring of cells around it,
+   TILE_SIZE + 2 rows of TILE_SIZE + 2 bits packed three rows to a word, and its value is its next generation, TILE_SIZE rows of TILE_SIZE bits
+   packed four rows to a word. The cache holds DEFAULT_TILE_CACHE_ENTRIES tiles unless told otherwise, in sets of TILE_CACHE_WAYS,
+   and every MEMO_CALIBRATION_INTERVAL generations one is calculated with the bit engine's kernel instead, to measure how much the cache saves. */
+#define TILE_SIZE 16
+#define TILES_PER_WORD (64 / TILE_SIZE)
+#define TILE_KEY_WORDS 6
+#define TILE_VALUE_WORDS 4
+#define TILE_CACHE_WAYS 4
+#define DEFAULT_TILE_CACHE_ENTRIES 65536
+#define MEMO_CALIBRATION_INTERVAL 32
+
+/* Structure to hold one tile in the memo engine's cache. The cache is shared by the engine's threads, so sequence is a seqlock, as in the export:
+   a thread that writes the entry makes it odd first, and a thread that reads it keeps what it read only if sequence was the same even number
+   before and after. referenced is set whenever the entry is used, for the CLOCK replacement of its set. */
+typedef struct
+{
+	atomic_uint_least64_t sequence;
+	atomic_uint_least64_t key[TILE_KEY_WORDS];
+	atomic_uint_least64_t value[TILE_VALUE_WORDS];
+	atomic_uint referenced;
+} tileCacheEntry;
+
+/* Engine that uses the bit engine's planes, but calculates the board in tiles, looking up the next generation of each tile in a cache
+   so that tiles that recur anywhere on the board (still lifes, oscillators and the debris of patterns) are only calculated once.
+   Empty tiles stay empty without a lookup, and a tile that misses is calculated with the bit engine's kernel and added to the cache.
+   The cache has noOfSets sets of TILE_CACHE_WAYS entries, and a tile can only be in the set its hash picks. When a set is full,
+   its clock hand passes over the entries, clearing their referenced flags, until it finds one that hasn't been used since it last passed.
+   The board is calculated by a pool of threads a row of tiles at a time, each row counting its hits, misses and empty tiles in tileCounts.
+   The time taken by the generations calculated with the cache and with the kernel is added up, to report the speedup.
+   If trackStatistics is set, each row of tiles also works out its own statistics in rowStatistics, which are put together in statistics. */
+typedef struct
+{
+	lifeEngine base;
+	boardPlanes current;
+	boardPlanes next;
+	uint64_t *deadRow;
+	uint64_t lastWordMask;
+	int noOfTileRows;
+	long noOfSets;
+	tileCacheEntry *entries;
+	atomic_uint *hands;
+	long *tileCounts;
+	long hits, misses, emptyTiles;
+	long generation;
+	int useKernel;
+	long cacheGenerations, kernelGenerations;
+	double cacheSeconds, kernelSeconds;
+	int noOfThreads;
+	threadPool pool;
+	int trackStatistics, haveStatistics;
+	boardStatistics *rowStatistics;
+	boardStatistics statistics;
+} memoEngine;
+
+/* The table engine looks up the next generation of each 2 x 2 block of cells from the 4 x 4 cells around it, so its rule table has an entry
+   for each of the BLOCK_TABLE_SIZE ways of filling them. Bit 4r + c of an index is the cell in row r and column c of the 4 x 4 cells,
+   and bits 0 to 3 of an entry are the cells in rows 1 and 2 and columns 1 and 2 of them, in the same order.
+   The table for Life is built by the compiler (lifeBlockTable). The table for any other rule is built the first time it is used,
+   and kept in a file in the BLOCK_TABLE_DIRECTORY directory of $XDG_CACHE_HOME (or of ~/.cache), which later runs map instead of building it.
+   The file starts with a blockTableHeader, so that a file for another rule, or with another layout, isn't used. */
+#define BLOCK_TABLE_SIZE 65536
+#define BLOCK_TABLE_DIRECTORY "TYLERJ-life3"
+#define BLOCK_TABLE_MAGIC "LIFETBL1"
+
+/* Structure at the start of a cached rule table, which is followed by the BLOCK_TABLE_SIZE entries. */
+typedef struct
+{
+	char magic[8];
+	uint32_t birth;
+	uint32_t survival;
+	uint32_t size;
+	uint32_t reserved;
+} blockTableHeader;
+
+/* Engine that keeps the board as a boardPlanes, like the bit engine, but calculates it two rows at a time, looking up each 2 x 2 block
+   of the two rows in rules, and updates the ages of two cells at a time from ageTransitionTable. It calculates any rule from the Generations
+   family without dying states. rules is lifeBlockTable, a table mapped from the cache (tableMap), or one built in builtTable.
+   spareRow takes the second row of the blocks when the board has an odd number of rows.
+   If trackStatistics is set, the statistics are worked out as the ages are updated, as in the bit engine. */
+typedef struct
+{
+	lifeEngine base;
+	boardPlanes current;
+	boardPlanes next;
+	uint64_t *deadRow;
+	uint64_t *spareRow;
+	const unsigned char *rules;
+	unsigned char *builtTable;
+	void *tableMap;
+	size_t tableMapSize;
+	int trackStatistics, haveStatistics;
+	boardStatistics statistics;
+} tableEngine;
+
+/* The cow engine's tiles are COW_TILE_SIZE cells square, so a row of a tile is one word of a live plane, and COW_AGE_WORDS words of an age plane. */
+#define COW_TILE_SIZE 64
+#define COW_AGE_WORDS (COW_TILE_SIZE / 16)
+
+/* Structure to hold a tile of the cow engine's board. A tile never changes once it has been made, so any number of generations,
+   and of engines forked from each other, can share it. references counts the grids (and views) that hold it, and it is freed
+   once the last lets go of it. hash is the hash of its live cells, population the number of them, firstRow and lastRow the first and last
+   of its rows with any, and columns the columns with any (all its rows ORed together). A tile that is free is in its pool's free list, through nextFree. */
+typedef struct cowTile
+{
+	atomic_int references;
+	uint64_t hash;
+	int population, firstRow, lastRow;
+	uint64_t columns;
+	struct cowTile *nextFree;
+	uint64_t live[COW_TILE_SIZE];
+	uint64_t ages[COW_TILE_SIZE * COW_AGE_WORDS];
+} cowTile;
+
+/* Structure to hold a generation of the cow engine's board, as the tiles of each row of tiles in turn.
+   Like its tiles it never changes, so it is shared in the same way. hash is the sum of the hashes of its tiles, each mixed with its position. */
+typedef struct cowGrid
+{
+	atomic_int references;
+	uint64_t hash;
+	struct cowGrid *nextFree;
+	cowTile *tiles[];
+} cowGrid;
+
+/* Structure to hold the memory that the cow engine's tiles and grids come from when it is made in an arena, which can't reuse freed memory.
+   It has room for as many as the engine can hold at once, and the ones that are freed go on free lists to be used again.
+   Engines forked from each other share the pool (references counts them), so the lists are protected by lock.
+   An engine made without an arena (in the server) allocates its tiles and grids from the heap, and has no pool. */
+typedef struct
+{
+	pthread_mutex_t lock;
+	atomic_int references;
+	size_t gridBytes;
+	long tileCapacity, tilesUsed;
+	long gridCapacity, gridsUsed;
+	cowTile *tiles;
+	unsigned char *grids;
+	cowTile *freeTiles;
+	cowGrid *freeGrids;
+} cowPool;
+
+/* Engine that keeps the board as grids of shared tiles, copying a tile only when it changes, so that its history, the last historyDepth
+   generations (generation n in history[n % noOfSlots]), costs only the tiles that changed, and a fork only copies the pointers to the grids.
+   A tile whose 3 x 3 tiles are the same as a generation ago stays the same, so it is shared without being calculated,
+   and one with no live cells around it stays emptyCowTile. The others are calculated into scratch with the bit engine's kernel,
+   and shared if they didn't change. planes holds the board for view(), made from the tiles in viewedTiles (which it holds),
+   so only the tiles that are different from those need to be copied to it. haveStatistics is clear while the births and deaths
+   of the current generation aren't known, which is when it has been loaded from another engine. */
+typedef struct
+{
+	lifeEngine base;
+	int tileRows, tileColumns;
+	long noOfTiles;
+	int historyDepth, noOfSlots;
+	long generation;
+	cowGrid **history;
+	cowPool *pool;
+	cowTile *scratch;
+	boardPlanes planes;
+	cowTile **viewedTiles;
+	long viewedGeneration;
+	int haveStatistics;
+} cowEngine;
+
+/* Structure to hold a frame log, which records every generation in a compact binary file for lifereplay to read back.
+   The file layout is described with openFrameLog(). */
+typedef struct
+{
+	FILE *file;
+	char *streamBuffer;
+	int keyframeInterval;
+	long generation;
+	boardPlanes previous;
+	unsigned char *buffer;
+	long noOfKeyframes;
+	int64_t *keyframeGenerations;
+	int64_t *keyframeOffsets;
+} frameLog;
+
+/* Structure at the start of a shared memory export, followed by the live plane and then the age plane of the board.
+   The fields after sequence are protected by it, as a seqlock: sequence is odd while the board is being written,
+   so a reader copies what it needs between two reads of sequence, and keeps the copy only if both reads are the same even number.
+   The layout is described with openBoardExport(). */
+typedef struct
+{
+	char magic[8];
+	int32_t width;
+	int32_t height;
+	int32_t liveWordsPerRow;
+	int32_t ageWordsPerRow;
+	atomic_uint_least64_t sequence;
+	int64_t generation;
+	int64_t population;
+	uint64_t hash;
+	int32_t finished;
+	int32_t reserved;
+} sharedBoardHeader;
+
+/* Structure to hold a shared memory export of the board, which is updated in place every generation. */
+typedef struct
+{
+	const char *name;
+	sharedBoardHeader *header;
+	uint64_t *live;
+	uint64_t *ages;
+	size_t size;
+} boardExport;
+
+/* Structure to hold the populations of the blocks of a board at every scale, so that a view of any part of the board at any zoom
+   can be drawn in time in proportion to the size of the view. Level k holds the population of each 2^k x 2^k block of cells,
+   in rows of columns[k] blocks, for k from PYRAMID_FIRST_LEVEL to noOfLevels - 1 (the first level above the first whose one block
+   covers the board, or PYRAMID_LAST_LEVEL). The first level is packed a byte per block, so that byte (column % 8) of word (column / 8)
+   of each row of liveWordsPerRow words is the population of the block, and the others are in counts.
+   An update compares the first level's words with the board's, and only changes the blocks above the words that changed. */
+typedef struct
+{
+	int width, height;
+	int noOfLevels;
+	int liveWordsPerRow;
+	int rows[PYRAMID_LAST_LEVEL + 1];
+	int columns[PYRAMID_LAST_LEVEL + 1];
+	uint64_t *firstLevel;
+	uint32_t *counts[PYRAMID_LAST_LEVEL + 1];
+	uint64_t *sums;
+} populationPyramid;
+
+/* Structure to hold a view of part of a board, for boards too big to print whole (see --viewport).
+   Each pixel of the view is a 2^zoom x 2^zoom block of cells, and the block at the top left starts at cell (top, left).
+   The view is drawn into image, which has a cell for each pixel: the cell is alive if any cell of the block is,
+   and its age is the block's density (1 to DENSITY_LEVELS), or with a zoom of 0 the age of the cell itself.
+   The image is columns pixels wide, and rows pixels high, or twice that with half blocks, which print two pixels in each character.
+   The view of an engine that can visit its cells (see visitCells()) is drawn from the cells inside it, counted in pixelCounts,
+   so the pyramid is only used, and its memory only touched, for the engines that keep the whole board. */
+typedef struct
+{
+	int top, left;
+	int zoom;
+	int columns, rows;
+	int halfBlocks;
+	populationPyramid pyramid;
+	boardPlanes image;
+	long *pixelCounts;
+} boardViewport;
+
+/* Structure to hold a raw image dump, which the views are appended to as 8 bit greyscale frames. */
+typedef struct
+{
+	FILE *file;
+	char *streamBuffer;
+	unsigned char *pixels;
+	const boardViewport *viewport;
+} imageDump;
+
+/* Engine that splits the board into bands of rows, each calculated by a separate worker process.
+   Neighbouring workers swap the rows at the edges of their bands (the halo rows) each generation over a pair of sockets,
+   and each worker tests its own band for repetition, so that this process (the launcher) only needs the whole board to print it.
+   firstRows[n] is the first row of worker n's band, and firstRows[noOfWorkers] is the height of the board. */
+typedef struct
+{
+	lifeEngine base;
+	int noOfWorkers;
+	int historyDepth;
+	int needBoards;
+	int *firstRows;
+	pid_t *workerPids;
+	int *workerSockets;
+	boardPlanes board;
+	long generation;
+	long receivedGeneration;
+	int period;
+} distributedEngine;
+
+/* Structure to hold the message each worker sends to the launcher every generation, followed by its band if the launcher needs boards.
+   Bit n - 1 of matches is set if the worker's band is the same as it was n generations ago. */
+typedef struct
+{
+	uint64_t matches;
+} workerStatus;
+
+/* The largest history depth that distributed workers can test, one bit of workerStatus.matches per generation */
+#define MAX_DISTRIBUTED_HISTORY 64
+
+/* The types of the messages that a client sends to the server (--serve). Each request is answered with a reply of the same type.
+   The layout of the messages is described with runServer(). */
+#define SERVER_LOAD 1
+#define SERVER_STEP 2
+#define SERVER_QUERY 3
+#define SERVER_STATUS 4
+#define SERVER_CLOSE 5
+#define SERVER_FORK 6
+
+/* The status of a reply: the request was carried out, it was malformed or couldn't be carried out, or its session doesn't exist */
+#define SERVER_OK 0
+#define SERVER_BAD_REQUEST 1
+#define SERVER_NO_SESSION 2
+
+/* The flag of a query that asks for the ages of the cells as well as which are alive */
+#define SERVER_WITH_AGES 1
+
+/* The largest payload the server accepts or sends, the most sessions and connections it holds at once,
+   the most memory, in bytes, that a session's engine and history may need, and the widest or tallest board a session may load,
+   which keeps the engines' sums of rows and columns well inside an int. */
+#define MAX_SERVER_MESSAGE (1 << 28)
+#define MAX_SERVER_SESSIONS 4096
+#define MAX_SERVER_CONNECTIONS 1024
+#define MAX_SERVER_SESSION_MEMORY 4e9
+#define MAX_SERVER_BOARD_SIDE (1 << 24)
+
+/* The most work, in cells calculated or copied, that the server carries out on its event loop rather than handing to a worker thread.
+   A small request is answered sooner on the event loop, but a large one would keep every other connection waiting. */
+#define SERVER_INLINE_CELLS (1 << 18)
+
+/* Structure at the start of every message to and from the server, in the machine's own byte order, followed by length bytes of payload.
+   flags holds the flags of a request and the status of a reply, and tag is anything the client likes,
+   which is copied into the reply so that the client can match its replies with its requests. */
+typedef struct
+{
+	uint32_t length;
+	uint16_t type;
+	uint16_t flags;
+	uint32_t session;
+	uint32_t tag;
+} serverHeader;
+
+/* Structure at the start of the reply to every request but a close, describing the session's current board.
+   hash is worked out as in the shared memory export, and period is the period detected at this generation, or 0. */
+typedef struct
+{
+	int64_t generation;
+	int64_t population;
+	uint64_t hash;
+	int32_t period;
+	int32_t reserved;
+} serverStatus;
+
+/* Structure to hold a buffer of bytes that grows as it is filled, of which the first length are in use. */
+typedef struct
+{
+	unsigned char *bytes;
+	size_t length;
+	size_t capacity;
+} byteBuffer;
+
+/* Structure to hold a client's connection to the server: the bytes received that don't make a whole message yet,
+   and the replies waiting to be sent, of which the first written bytes have been. */
+typedef struct
+{
+	int socket;
+	int slot;
+	byteBuffer input;
+	byteBuffer output;
+	size_t written;
+	int waitingToWrite;
+} serverConnection;
+
+/* Structure to hold a session: a board calculated by an engine of its own, which belongs to the connection that loaded it
+   (owner, which is NULL once that connection has closed). The requests for a session are queued in requests, with the number of cells
+   they calculate or copy in cost, and carried out in batches: the whole queue is moved to batch, and the replies written to replies.
+   queued is set while the session is in the server's ready queue, or a worker is carrying out its batch, or the batch is done but its
+   replies haven't been passed on, and only then are requests and cost shared with the workers, so are only changed with the server's lock held.
+   Everything else belongs to whichever thread is carrying out the batch, except owner, area (the size of the last board loaded), id and queued,
+   which belong to the event loop. The session tests for repetition with its engine's findPeriod(), or if it hasn't one,
+   with a ring of historyDepth + 1 live planes, generation n being in slot n % (historyDepth + 1), with the population and hash of each.
+   measuredGeneration is the generation that population and hash were last worked out for, and closed is set once the client has closed the session.
+   A session started by a fork is queued until the session it is forked from has carried the fork out, and forks lists (through nextFork)
+   the sessions forked in a batch, which the event loop lets go of once the batch is done. */
+typedef struct serverSession
+{
+	uint32_t id;
+	serverConnection *owner;
+	double area;
+	int queued;
+	lifeEngine *engine;
+	long generation;
+	int period;
+	int historyDepth;
+	size_t liveWords;
+	uint64_t *history;
+	long *populations;
+	uint64_t *hashes;
+	long measuredGeneration;
+	long population;
+	uint64_t hash;
+	byteBuffer requests;
+	byteBuffer batch;
+	byteBuffer replies;
+	int closed;
+	double cost;
+	struct serverSession *next;
+	struct serverSession *forks, *nextFork;
+} serverSession;
+
+/* Structure to hold the server. The event loop waits on epollFd for the listening socket, the connections, wakeFd (an eventfd that
+   the workers write to when they finish a batch) and signalFd (which SIGINT and SIGTERM are read from). Sessions are held in
+   sessions[(id - 1) % MAX_SERVER_SESSIONS], and slotUses counts how often each slot has been used, so that an old id is never reused soon.
+   The sessions waiting for a worker are in a queue from firstReady to lastReady, and the ones whose batches are done are in a list from firstDone,
+   both protected by lock. */
+typedef struct
+{
+	const engineType *type;
+	engineOptions options;
+	int listenSocket;
+	int epollFd;
+	int wakeFd;
+	int signalFd;
+	serverConnection *connections[MAX_SERVER_CONNECTIONS];
+	serverSession *sessions[MAX_SERVER_SESSIONS];
+	uint32_t slotUses[MAX_SERVER_SESSIONS];
+	pthread_mutex_t lock;
+	pthread_cond_t sessionsReady;
+	serverSession *firstReady, *lastReady;
+	serverSession *firstDone;
+	int stopping;
+	int noOfWorkers;
+	pthread_t *workers;
+} lifeServer;
+
 /* Stores the width and height of all the boards used in the program. */
 int boardWidth, boardHeight;
 
+/* Stores the number of 64 bit words needed to hold a board snapshot. */
+long snapshotWords;
+
+/* The arenas that allocateMemory() carves from, which are all parts of one reservation:
+   the engine arena holds the engine, and is emptied when the board moves to another engine,
+   the scratch arena holds the lists made while the board moves, and the main arena holds everything else.
+   activeArena is the one in use, or NULL if the arenas couldn't be reserved (or before they are), in which case the heap is used. */
+memoryArena mainArena, engineArena, scratchArena;
+memoryArena *activeArena = NULL;
+
+/* Set once the program has finished starting up. A program built with CHECK_ALLOCATIONS defined aborts if it then uses the heap. */
+int allocationsSealed = 0;
+
+/* The tile of the cow engine with no live cells, which every empty tile of every board is. It is never freed, so isn't counted. */
+cowTile emptyCowTile;
+
+/* The characters used to print the age of a live cell, indexed by its age. */
+const char ageCharacters[MAX_AGE + 1] = {'0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'X'};
+
+/* The characters used to print a pixel of a zoomed out view, from empty to full. */
+const char densityCharacters[] = " .:-=+*#%@";
+
+/* The rules as a table, indexed by whether a cell is alive and its number of live neighbours: 1 if the cell is alive in the next generation. */
+const unsigned char lifeRule[2][9] = { {0, 0, 0, 1, 0, 0, 0, 0, 0},
+                                       {0, 0, 1, 1, 0, 0, 0, 0, 0} };
+
+/* The macros that build the table engine's tables when the program is compiled, so that they are in its read-only data and need no time
+   at startup. TABLE16(entry, prefix) is entry(prefix0) to entry(prefixF), prefix being a hexadecimal constant without its last digits,
+   and TABLE256 and TABLE4096 go through two and three more digits, so that every index is a constant the compiler can work the entry out from.
+   BLOCK_CELL is the next generation of the cell at bit centre of a block table index, whose neighbours are the bits set in neighbours. */
+#define TABLE16(entry, prefix) entry(prefix##0), entry(prefix##1), entry(prefix##2), entry(prefix##3), entry(prefix##4), entry(prefix##5), \
+                               entry(prefix##6), entry(prefix##7), entry(prefix##8), entry(prefix##9), entry(prefix##A), entry(prefix##B), \
+                               entry(prefix##C), entry(prefix##D), entry(prefix##E), entry(prefix##F)
+#define TABLE256(entry, prefix) TABLE16(entry, prefix##0), TABLE16(entry, prefix##1), TABLE16(entry, prefix##2), TABLE16(entry, prefix##3), \
+                                TABLE16(entry, prefix##4), TABLE16(entry, prefix##5), TABLE16(entry, prefix##6), TABLE16(entry, prefix##7), \
+                                TABLE16(entry, prefix##8), TABLE16(entry, prefix##9), TABLE16(entry, prefix##A), TABLE16(entry, prefix##B), \
+                                TABLE16(entry, prefix##C), TABLE16(entry, prefix##D), TABLE16(entry, prefix##E), TABLE16(entry, prefix##F)
+#define TABLE4096(entry, prefix) TABLE256(entry, prefix##0), TABLE256(entry, prefix##1), TABLE256(entry, prefix##2), TABLE256(entry, prefix##3), \
+                                 TABLE256(entry, prefix##4), TABLE256(entry, prefix##5), TABLE256(entry, prefix##6), TABLE256(entry, prefix##7), \
+                                 TABLE256(entry, prefix##8), TABLE256(entry, prefix##9), TABLE256(entry, prefix##A), TABLE256(entry, prefix##B), \
+                                 TABLE256(entry, prefix##C), TABLE256(entry, prefix##D), TABLE256(entry, prefix##E), TABLE256(entry, prefix##F)
+#define BLOCK_CELL(index, neighbours, centre, birth, survival) \
+	( ( ( ( (index) >> (centre) ) & 1 ? (survival) : (birth) ) >> __builtin_popcount( (index) & (neighbours) ) ) & 1 )
+#define LIFE_BLOCK(index) ( BLOCK_CELL(index, 0x757, 5, 0x8, 0xC) | BLOCK_CELL(index, 0xEAE, 6, 0x8, 0xC) << 1 \
+                            | BLOCK_CELL(index, 0x7570, 9, 0x8, 0xC) << 2 | BLOCK_CELL(index, 0xEAE0, 10, 0x8, 0xC) << 3 )
+#define AGE_CELL(index, cell) ( ( ( (index) >> (8 + (cell)) ) & ( (index) >> (10 + (cell)) ) & 1 ) \
+                                ? ( ( ( (index) >> (4 * (cell)) ) & 0xF ) < MAX_AGE ? ( ( (index) >> (4 * (cell)) ) & 0xF ) + 1 : MAX_AGE ) : 0 )
+#define AGE_PAIR(index) ( AGE_CELL(index, 0) | AGE_CELL(index, 1) << 4 )
+
+/* The next generation of each 2 x 2 block of cells under Life, indexed as described with BLOCK_TABLE_SIZE. */
+const unsigned char lifeBlockTable[BLOCK_TABLE_SIZE] = { TABLE4096(LIFE_BLOCK, 0x0), TABLE4096(LIFE_BLOCK, 0x1), TABLE4096(LIFE_BLOCK, 0x2),
+                                                         TABLE4096(LIFE_BLOCK, 0x3), TABLE4096(LIFE_BLOCK, 0x4), TABLE4096(LIFE_BLOCK, 0x5),
+                                                         TABLE4096(LIFE_BLOCK, 0x6), TABLE4096(LIFE_BLOCK, 0x7), TABLE4096(LIFE_BLOCK, 0x8),
+                                                         TABLE4096(LIFE_BLOCK, 0x9), TABLE4096(LIFE_BLOCK, 0xA), TABLE4096(LIFE_BLOCK, 0xB),
+                                                         TABLE4096(LIFE_BLOCK, 0xC), TABLE4096(LIFE_BLOCK, 0xD), TABLE4096(LIFE_BLOCK, 0xE),
+                                                         TABLE4096(LIFE_BLOCK, 0xF) };
+
+/* The next ages of two neighbouring cells, as the two nibbles of a byte of an age plane, indexed by their ages (bits 0 to 7),
+   whether each is alive (bits 8 and 9) and whether each is alive in the next generation (bits 10 and 11).
+   A cell that stays alive gets one year older, stopping at MAX_AGE (printed as 'X'), and any other cell gets an age of 0. */
+const unsigned char ageTransitionTable[4096] = { TABLE256(AGE_PAIR, 0x0), TABLE256(AGE_PAIR, 0x1), TABLE256(AGE_PAIR, 0x2), TABLE256(AGE_PAIR, 0x3),
+                                                 TABLE256(AGE_PAIR, 0x4), TABLE256(AGE_PAIR, 0x5), TABLE256(AGE_PAIR, 0x6), TABLE256(AGE_PAIR, 0x7),
+                                                 TABLE256(AGE_PAIR, 0x8), TABLE256(AGE_PAIR, 0x9), TABLE256(AGE_PAIR, 0xA), TABLE256(AGE_PAIR, 0xB),
+                                                 TABLE256(AGE_PAIR, 0xC), TABLE256(AGE_PAIR, 0xD), TABLE256(AGE_PAIR, 0xE), TABLE256(AGE_PAIR, 0xF) };
+
 /* Function prototypes.
    Function descriptions can be found with the function definitions. */
-int readFileToBoard(const char* fileName, char (*boardToWrite)[boardWidth]);
-void printBoard(char (*boardToRead)[boardWidth]);
-void printBorderRow(void);
+int readFileToBoard(const char* fileName, cellList *cellsToWrite);
+void printBoard(const boardPlanes *boardToRead);
+void printBorderRow(int width);
 void iterateBoard(char (*boardToRead)[boardWidth], char (*boardToWrite)[boardWidth]);
 int numberOfNeighbours(char (*board)[boardWidth], coord current);
-int repetitionTest(char (*board1)[boardWidth], char (*board2)[boardWidth]);
+void *allocateMemory(size_t size);
+void *resizeMemory(void *memory, size_t oldSize, size_t newSize);
+void freeMemory(void *memory);
+int openArenas(double mainSize, double engineSize, double scratchSize);
+void selectArena(memoryArena *arena);
+void emptyArena(memoryArena *arena);
+void zeroArenaRange(unsigned char *start, unsigned char *end);
+double planesSize(int width, int height);
+void allocatePlanes(boardPlanes *planes, int width, int height);
+void freePlanes(boardPlanes *planes);
+void fillPlanes(boardPlanes *planes, const cellList *cells);
+void planesToCells(const boardPlanes *planes, cellList *cells);
+void freeCells(cellList *cells);
+void allocateSnapshotRing(snapshotRing *ring, int depth, threadPool *pool);
+void clearSnapshotRing(snapshotRing *ring);
+void freeSnapshotRing(snapshotRing *ring);
+int findSnapshotPeriod(snapshotRing *ring, const boardPlanes *board);
+long long repeatedGeneration(long long generation, int period, long long target);
+void packSnapshotRows(const boardPlanes *boardToRead, uint64_t *cells, int firstRow, int lastRow, long *population, uint64_t *hash);
+void takeSnapshotBand(void *context, int band);
+void compareSnapshotChunk(void *context, int task);
+void startThreadPool(threadPool *pool, int noOfThreads);
+void runPoolTasks(threadPool *pool, int noOfTasks, void (*runTask)(void *context, int task), void *context);
+void *runHelper(void *argument);
+void stopThreadPool(threadPool *pool);
+void unpackSnapshot(const boardSnapshot *snapshot, boardPlanes *boardToWrite);
+void startStatistics(boardStatistics *statistics, int width, int height);
+void addRowToStatistics(const uint64_t *live, const uint64_t *previousLive, int words, int row, boardStatistics *statistics);
+void mergeStatistics(boardStatistics *statistics, const boardStatistics *part);
+long countRowBits(const uint64_t *bits, const uint64_t *excluded, int words);
+void scanBoardStatistics(const boardPlanes *board, long generation, long previousPopulation, boardStatistics *statistics);
+void allocateSpaceshipTracker(spaceshipTracker *tracker, int depth);
+void freeSpaceshipTracker(spaceshipTracker *tracker);
+size_t trackerPatternWords(int width, int height);
+void trackBoard(spaceshipTracker *tracker, lifeEngine *engine, const boardStatistics *statistics, long generation);
+size_t packPattern(lifeEngine *engine, const boardStatistics *statistics, uint64_t *cells);
+void packPatternCell(void *context, int row, int column, int age);
+lifeEngine *adaptEngine(lifeEngine *engine, long generation, const engineOptions *options, snapshotRing *ring);
+lifeEngine *switchEngine(lifeEngine *engine, const engineType *newType, const engineOptions *options, snapshotRing *ring);
+void measureBitEngine(lifeEngine *engine, long *population, long *changed);
+double estimateBitCost(double area, long population, long changed);
+double bitEngineMemory(int width, int height, const engineOptions *options);
+double charEngineMemory(int width, int height, const engineOptions *options);
+const engineType *findEngineType(const char *name);
+lifeEngine *createCharEngine(int width, int height, const engineOptions *options);
+void loadCharEngine(lifeEngine *engine, const cellList *cells);
+void stepCharEngine(lifeEngine *engine);
+const boardPlanes *viewCharEngine(lifeEngine *engine);
+void destroyCharEngine(lifeEngine *engine);
+lifeEngine *createScalarEngine(int width, int height, const engineOptions *options);
+void loadScalarEngine(lifeEngine *engine, const cellList *cells);
+void stepScalarEngine(lifeEngine *engine);
+void iterateScalarRow(const unsigned char *restrict above, const unsigned char *restrict row, const unsigned char *restrict below,
+                      const unsigned char *restrict ages, unsigned char *restrict rowToWrite, unsigned char *restrict agesToWrite, int width);
+const boardPlanes *viewScalarEngine(lifeEngine *engine);
+void destroyScalarEngine(lifeEngine *engine);
+double scalarEngineMemory(int width, int height, const engineOptions *options);
+lifeEngine *createWavefrontEngine(int width, int height, const engineOptions *options);
+void loadWavefrontEngine(lifeEngine *engine, const cellList *cells);
+void stepWavefrontEngine(lifeEngine *engine);
+void *runWavefront(void *argument);
+int waitForGeneration(wavefrontEngine *self, atomic_long *counter, long generation);
+const boardPlanes *viewWavefrontEngine(lifeEngine *engine);
+void destroyWavefrontEngine(lifeEngine *engine);
+double wavefrontEngineMemory(int width, int height, const engineOptions *options);
+int parseRule(const char *text, generationsRule *rule);
+lifeEngine *createGenerationsEngine(int width, int height, const engineOptions *options);
+void loadGenerationsEngine(lifeEngine *engine, const cellList *cells);
+void stepGenerationsEngine(lifeEngine *engine);
+void countNeighbourWord(const uint64_t *above, const uint64_t *row, const uint64_t *below, int word, int words, uint64_t count[4]);
+uint64_t countIsInRule(unsigned neighbours, const uint64_t count[4]);
+uint64_t stateEquals(const uint64_t state[STATE_BITS], unsigned value);
+const boardPlanes *viewGenerationsEngine(lifeEngine *engine);
+int findGenerationsPeriod(lifeEngine *engine);
+double generationsEngineMemory(int width, int height, const engineOptions *options);
+void destroyGenerationsEngine(lifeEngine *engine);
+int parseLargerThanLifeRule(const char *text, generationsRule *rule);
+lifeEngine *createLargerThanLifeEngine(int width, int height, const engineOptions *options);
+void loadLargerThanLifeEngine(lifeEngine *engine, const cellList *cells);
+void stepLargerThanLifeEngine(lifeEngine *engine);
+void sumBandRows(void *context, int band);
+void addBandCarries(void *context, int task);
+void stepLargerThanLifeBand(void *context, int band);
+uint64_t hashStateRows(const unsigned char *states, size_t start, size_t end);
+const boardPlanes *viewLargerThanLifeEngine(lifeEngine *engine);
+int findLargerThanLifePeriod(lifeEngine *engine);
+double largerThanLifeEngineMemory(int width, int height, const engineOptions *options);
+void destroyLargerThanLifeEngine(lifeEngine *engine);
+lifeEngine *createMemoEngine(int width, int height, const engineOptions *options);
+void loadMemoEngine(lifeEngine *engine, const cellList *cells);
+void stepMemoEngine(lifeEngine *engine);
+void stepMemoTileRow(void *context, int tileRow);
+int findCachedTile(memoEngine *self, long set, const uint64_t key[TILE_KEY_WORDS], uint64_t value[TILE_VALUE_WORDS]);
+void addCachedTile(memoEngine *self, long set, const uint64_t key[TILE_KEY_WORDS], const uint64_t value[TILE_VALUE_WORDS]);
+int memoEngineStatistics(lifeEngine *engine, boardStatistics *statistics);
+const boardPlanes *viewMemoEngine(lifeEngine *engine);
+double memoEngineMemory(int width, int height, const engineOptions *options);
+void destroyMemoEngine(lifeEngine *engine);
+lifeEngine *createTableEngine(int width, int height, const engineOptions *options);
+void loadTableEngine(lifeEngine *engine, const cellList *cells);
+void stepTableEngine(lifeEngine *engine);
+void iterateBlockRow(const uint64_t *above, const uint64_t *top, const uint64_t *bottom, const uint64_t *below,
+                     uint64_t *topToWrite, uint64_t *bottomToWrite, int words, uint64_t lastWordMask, const unsigned char *rules);
+void updateAgePairs(const uint64_t *oldLive, const uint64_t *newLive, const uint64_t *oldAges, uint64_t *newAges, int ageWords);
+int tableEngineStatistics(lifeEngine *engine, boardStatistics *statistics);
+const boardPlanes *viewTableEngine(lifeEngine *engine);
+double tableEngineMemory(int width, int height, const engineOptions *options);
+void destroyTableEngine(lifeEngine *engine);
+int blockTablePath(const generationsRule *rule, char *path, size_t size);
+const unsigned char *mapBlockTable(const generationsRule *rule, void **map, size_t *mapSize);
+void buildBlockTable(const generationsRule *rule, unsigned char *table);
+void saveBlockTable(const generationsRule *rule, const unsigned char *table);
+lifeEngine *createCowEngine(int width, int height, const engineOptions *options);
+void loadCowEngine(lifeEngine *engine, const cellList *cells);
+void stepCowEngine(lifeEngine *engine);
+cowTile *stepCowTile(cowEngine *self, const cowGrid *current, const cowGrid *previous, int tileRow, int tileColumn);
+const boardPlanes *viewCowEngine(lifeEngine *engine);
+int findCowPeriod(lifeEngine *engine);
+int cowEngineStatistics(lifeEngine *engine, boardStatistics *statistics);
+lifeEngine *forkCowEngine(lifeEngine *engine);
+double cowEngineMemory(int width, int height, const engineOptions *options);
+void destroyCowEngine(lifeEngine *engine);
+cowTile *newCowTile(cowPool *pool);
+cowGrid *newCowGrid(cowEngine *self);
+void holdCowTile(cowTile *tile);
+void releaseCowTile(cowPool *pool, cowTile *tile);
+void releaseCowGrid(cowPool *pool, cowGrid *grid, long noOfTiles);
+void copyTileToPlanes(const cowTile *tile, boardPlanes *planes, int tileRow, int tileColumn);
+void measureCowTile(cowTile *tile);
+uint64_t hashCowTile(const cowTile *tile);
+lifeEngine *createBitEngine(int width, int height, const engineOptions *options);
+void loadBitEngine(lifeEngine *engine, const cellList *cells);
+void stepBitEngine(lifeEngine *engine);
+const boardPlanes *viewBitEngine(lifeEngine *engine);
+void destroyBitEngine(lifeEngine *engine);
+void iterateLiveRow(const uint64_t *above, const uint64_t *row, const uint64_t *below, uint64_t *rowToWrite, int words, uint64_t lastWordMask);
+uint64_t iterateLiveWord(const uint64_t *above, const uint64_t *row, const uint64_t *below, int word, int words);
+void updateAgeRow(const uint64_t *oldLive, const uint64_t *newLive, const uint64_t *oldAges, uint64_t *newAges, int ageWords);
+uint64_t spreadToNibbles(uint64_t bits);
+int countBits(uint64_t word);
+int countTrailingZeros(uint64_t word);
+int countLeadingZeros(uint64_t word);
+int bitEngineStatistics(lifeEngine *engine, boardStatistics *statistics);
+void takeSnapshot(const boardPlanes *boardToRead, boardSnapshot *snapshot);
+uint64_t mixBits(uint64_t value);
+void startOutputPipeline(outputPipeline *pipeline, int noOfSlots, int width, int height, outputPolicy policy,
+                         void (*writeBoard)(void *context, const boardPlanes *board), void *context);
+void queueBoard(outputPipeline *pipeline, const boardPlanes *board);
+int publishToPipeline(outputPipeline *pipeline, const boardPlanes *board, int isStop, int wait, int copyAges);
+void copyPlanes(boardPlanes *destination, const boardPlanes *source);
+void stopOutputPipeline(outputPipeline *pipeline);
+void *writeBoards(void *argument);
+void printQueuedBoard(void *context, const boardPlanes *board);
+void openViewport(boardViewport *viewport, int top, int left, int zoom, int columns, int rows, int halfBlocks);
+void closeViewport(boardViewport *viewport);
+double viewportMemory(int columns, int rows, int halfBlocks);
+void allocatePyramid(populationPyramid *pyramid, int width, int height);
+void freePyramid(populationPyramid *pyramid);
+double pyramidMemory(int width, int height);
+void updatePyramid(populationPyramid *pyramid, const boardPlanes *board);
+long blockPopulation(const populationPyramid *pyramid, const boardPlanes *board, int zoom, long blockRow, long blockColumn);
+void drawViewport(boardViewport *viewport, lifeEngine *engine);
+void drawViewportFromCells(boardViewport *viewport, lifeEngine *engine);
+void countViewportCell(void *context, int row, int column, int age);
+void printViewport(void *context, const boardPlanes *image);
+void openImageDump(imageDump *dump, const char *fileName, const boardViewport *viewport);
+void dumpImage(void *context, const boardPlanes *image);
+void closeImageDump(imageDump *dump);
+int repetitionTest(const boardSnapshot *snapshot1, const boardSnapshot *snapshot2);
+lifeEngine *createDistributedEngine(int width, int height, const engineOptions *options);
+void loadDistributedEngine(lifeEngine *engine, const cellList *cells);
+void stepDistributedEngine(lifeEngine *engine);
+const boardPlanes *viewDistributedEngine(lifeEngine *engine);
+void destroyDistributedEngine(lifeEngine *engine);
+int findDistributedPeriod(lifeEngine *engine);
+double distributedEngineMemory(int width, int height, const engineOptions *options);
+void receiveFromWorkers(distributedEngine *self);
+void runWorker(distributedEngine *self, const boardPlanes *board, int worker, int upperSocket, int lowerSocket, int launcherSocket);
+int exchangeHaloRows(int upperSocket, int lowerSocket, const uint64_t *topRow, const uint64_t *bottomRow,
+                     uint64_t *haloAbove, uint64_t *haloBelow, size_t rowBytes, int wait, size_t progress[4]);
+int writeAll(int socket, const void *buffer, size_t length);
+int readAll(int socket, void *buffer, size_t length);
+void openFrameLog(frameLog *log, const char *fileName, int keyframeInterval, long maxGenerations);
+void openBoardExport(boardExport *export, const char *name);
+void exportBoard(boardExport *export, const boardPlanes *board, long generation);
+void closeBoardExport(boardExport *export);
+void logBoard(void *context, const boardPlanes *board);
+void writeLogRecord(frameLog *log, int32_t type, const uint64_t *words1, const uint64_t *previous1, size_t noOfWords1, const uint64_t *words2, size_t noOfWords2);
+size_t encodeZeroRuns(const uint64_t *input, const uint64_t *previous, size_t length, unsigned char *output);
+size_t encodeNumber(uint64_t number, unsigned char *output);
+void closeFrameLog(frameLog *log);
+lifeEngine *createSparseEngine(int width, int height, const engineOptions *options);
+void loadSparseEngine(lifeEngine *engine, const cellList *cells);
+void stepSparseEngine(lifeEngine *engine);
+const boardPlanes *viewSparseEngine(lifeEngine *engine);
+void destroySparseEngine(lifeEngine *engine);
+int sparseEngineStatistics(lifeEngine *engine, boardStatistics *statistics);
+void visitSparseCells(lifeEngine *engine, int top, int left, int bottom, int right, void (*visit)(void *context, int row, int column, int age), void *context);
+int findSparsePeriod(lifeEngine *engine);
+int recallSparseHistory(lifeEngine *engine, cellList *generations);
+void measureSparseEngine(lifeEngine *engine, long *population, long *changed);
+double estimateSparseCost(double area, long population, long changed);
+double sparseEngineMemory(int width, int height, const engineOptions *options);
+void reserveSparseCells(sparseEngine *self, long noOfCells);
+void stepSparseRow(sparseEngine *self, long row, long *noOfNextCells, long *survivors);
+long findRowStart(const uint64_t *keys, long noOfCells, long row);
+int compareKeys(const void *key1, const void *key2);
+lifeEngine *createFreezeEngine(int width, int height, const engineOptions *options);
+void loadFreezeEngine(lifeEngine *engine, const cellList *cells);
+void stepFreezeEngine(lifeEngine *engine);
+int tileIsFrozen(const freezeEngine *self, int tileRow, int word);
+void gatherFreezeStatistics(freezeEngine *self, const boardPlanes *board, const uint16_t *populations, const uint16_t *births);
+int freezeEngineStatistics(lifeEngine *engine, boardStatistics *statistics);
+const boardPlanes *viewFreezeEngine(lifeEngine *engine);
+void destroyFreezeEngine(lifeEngine *engine);
+void measureFreezeEngine(lifeEngine *engine, long *population, long *changed);
+double estimateFreezeCost(double area, long population, long changed);
+double freezeEngineMemory(int width, int height, const engineOptions *options);
+lifeEngine *createMappedEngine(int width, int height, const engineOptions *options);
+void loadMappedEngine(lifeEngine *engine, const cellList *cells);
+void stepMappedEngine(lifeEngine *engine);
+void writeBackMappedRange(mappedEngine *self, size_t start, size_t end);
+void releaseMappedRange(mappedEngine *self, size_t start, size_t end, int written);
+const boardPlanes *viewMappedEngine(lifeEngine *engine);
+int findMappedPeriod(lifeEngine *engine);
+double mappedEngineMemory(int width, int height, const engineOptions *options);
+void destroyMappedEngine(lifeEngine *engine);
+const engineType *engineForRule(const engineType *selectedEngine, const generationsRule *rule);
+int runServer(const char *socketPath, const engineType *type, const engineOptions *options, int noOfWorkers);
+int openServerSocket(const char *socketPath);
+void acceptConnections(lifeServer *server);
+int readConnection(lifeServer *server, serverConnection *connection);
+void receiveRequest(lifeServer *server, serverConnection *connection, serverHeader *header, const unsigned char *payload);
+void scheduleSession(lifeServer *server, serverSession *session);
+void finishBatches(lifeServer *server);
+void finishSessionBatch(lifeServer *server, serverSession *session);
+void flushConnection(lifeServer *server, serverConnection *connection);
+void closeConnection(lifeServer *server, serverConnection *connection);
+serverSession *createSession(lifeServer *server, serverConnection *owner);
+serverSession *findSession(lifeServer *server, uint32_t id);
+void destroySession(lifeServer *server, serverSession *session);
+void freeSessionBoard(serverSession *session);
+void *runServerWorker(void *argument);
+void runSessionBatch(const lifeServer *server, serverSession *session);
+int loadSession(const lifeServer *server, serverSession *session, const unsigned char *payload, uint32_t length);
+void stepSession(serverSession *session, int64_t noOfGenerations);
+void testSessionPeriod(serverSession *session);
+void describeSession(serverSession *session, serverStatus *status);
+int forkSession(const lifeServer *server, serverSession *session, serverSession *fork);
+void measureLivePlane(const boardPlanes *board, long *population, uint64_t *hash);
+void copyRegion(const boardPlanes *board, int32_t top, int32_t left, int32_t height, int32_t width, int withAges, unsigned char *bytes);
+uint64_t liveBitsFrom(const uint64_t *row, int words, long column);
+unsigned char *addReply(byteBuffer *buffer, const serverHeader *request, uint16_t status, size_t length);
+void appendBytes(byteBuffer *buffer, const void *bytes, size_t length);
+void reserveBytes(byteBuffer *buffer, size_t length);
+
+/* The engine used when the board is split between worker processes with --workers, each running the bit engine's kernel. */
+const engineType distributedEngineType = {"distributed", "bands of rows on separate worker processes",
+                                          createDistributedEngine, loadDistributedEngine, stepDistributedEngine, viewDistributedEngine,
+                                          destroyDistributedEngine, findDistributedPeriod, NULL, NULL, NULL, distributedEngineMemory, NULL, NULL, NULL};
+
+/* The engines that can be chosen with the --engine option, the first is the default. */
+const engineType bitEngineType = {"bit", "live bitplane and age nibble plane, 64 cells per operation",
+                                  createBitEngine, loadBitEngine, stepBitEngine, viewBitEngine, destroyBitEngine, NULL,
+                                  NULL, measureBitEngine, estimateBitCost, bitEngineMemory, bitEngineStatistics, NULL, NULL};
+const engineType charEngineType = {"char", "the original character boards (reference)",
+                                   createCharEngine, loadCharEngine, stepCharEngine, viewCharEngine, destroyCharEngine, NULL,
+                                   NULL, NULL, NULL, charEngineMemory, NULL, NULL, NULL};
+
+const engineType sparseEngineType = {"sparse", "only the live cells, for boards that are mostly empty",
+                                     createSparseEngine, loadSparseEngine, stepSparseEngine, viewSparseEngine, destroySparseEngine, findSparsePeriod,
+                                     recallSparseHistory, measureSparseEngine, estimateSparseCost, sparseEngineMemory, sparseEngineStatistics, NULL,
+                                     visitSparseCells};
+const engineType freezeEngineType = {"freeze", "the bit engine, skipping still lifes and oscillators of period 1, 2, 3 or 6",
+                                     createFreezeEngine, loadFreezeEngine, stepFreezeEngine, viewFreezeEngine, destroyFreezeEngine, NULL,
+                                     NULL, measureFreezeEngine, estimateFreezeCost, freezeEngineMemory, freezeEngineStatistics, NULL, NULL};
+const engineType mappedEngineType = {"mapped", "the bit engine, keeping the boards in a file for boards too big for memory",
+                                     createMappedEngine, loadMappedEngine, stepMappedEngine, viewMappedEngine, destroyMappedEngine, findMappedPeriod,
+                                     NULL, NULL, NULL, mappedEngineMemory, NULL, NULL, NULL};
+const engineType scalarEngineType = {"scalar", "a byte per cell, without branches so the compiler can vectorize it",
+                                     createScalarEngine, loadScalarEngine, stepScalarEngine, viewScalarEngine, destroyScalarEngine, NULL,
+                                     NULL, NULL, NULL, scalarEngineMemory, NULL, NULL, NULL};
+const engineType wavefrontEngineType = {"wavefront", "the bit engine, calculating --threads generations at once",
+                                        createWavefrontEngine, loadWavefrontEngine, stepWavefrontEngine, viewWavefrontEngine, destroyWavefrontEngine, NULL,
+                                        NULL, NULL, NULL, wavefrontEngineMemory, NULL, NULL, NULL};
+const engineType generationsEngineType = {"generations", "rules from the Generations family (see --rule), on bit planes of the cells' states",
+                                          createGenerationsEngine, loadGenerationsEngine, stepGenerationsEngine, viewGenerationsEngine,
+                                          destroyGenerationsEngine, findGenerationsPeriod, NULL, NULL, NULL, generationsEngineMemory, NULL, NULL, NULL};
+const engineType largerThanLifeEngineType = {"ltl", "Larger than Life rules (see --rule), counting neighbours from a summed-area table",
+                                             createLargerThanLifeEngine, loadLargerThanLifeEngine, stepLargerThanLifeEngine, viewLargerThanLifeEngine,
+                                             destroyLargerThanLifeEngine, findLargerThanLifePeriod, NULL, NULL, NULL, largerThanLifeEngineMemory, NULL, NULL, NULL};
+const engineType memoEngineType = {"memo", "the bit engine in 16 x 16 tiles, looking up tiles that recur in a cache (see --tile-cache)",
+                                   createMemoEngine, loadMemoEngine, stepMemoEngine, viewMemoEngine, destroyMemoEngine, NULL,
+                                   NULL, NULL, NULL, memoEngineMemory, memoEngineStatistics, NULL, NULL};
+const engineType tableEngineType = {"table", "the bit engine's planes, looking up 2 x 2 blocks of cells in a rule table (any rule without dying states)",
+                                    createTableEngine, loadTableEngine, stepTableEngine, viewTableEngine, destroyTableEngine, NULL,
+                                    NULL, NULL, NULL, tableEngineMemory, tableEngineStatistics, NULL, NULL};
+const engineType cowEngineType = {"cow", "the board in 64 x 64 tiles shared between generations and forks, copying only the tiles that change",
+                                  createCowEngine, loadCowEngine, stepCowEngine, viewCowEngine, destroyCowEngine, findCowPeriod,
+                                  NULL, NULL, NULL, cowEngineMemory, cowEngineStatistics, forkCowEngine, NULL};
+const engineType *engineTypes[] = {&bitEngineType, &charEngineType, &sparseEngineType, &freezeEngineType, &mappedEngineType, &scalarEngineType,
+                                   &wavefrontEngineType, &generationsEngineType, &largerThanLifeEngineType, &memoEngineType, &tableEngineType,
+                                   &cowEngineType, NULL};
 
 /*
 	Function: main()
@@ -42,6 +1348,43 @@ int repetitionTest(char (*board1)[boardWidth], char (*board2)[boardWidth]);
 	Arguments: The file containing the initial configuration,
 	           the width and height of the game of life board,
 	           and the number of generations to iterate the board through.
+	           Optionally preceded by:
+	             --history <n>    the maximum period to detect (default 4),
+	             --at <n>         print only generation n, skipping straight to it once a period is detected
+	                              (the no. of generations is then the most that are calculated looking for a period),
+	             --engine <name>  the engine used to calculate the generations (by default the engine is chosen,
+	                              and changed while running, by the adaptive controller),
+	             --adapt-interval <n>  the number of generations between the adaptive controller's checks (default 16),
+	             --map-file <file>  the file the mapped engine keeps its boards in (by default a temporary file),
+	             --tile-cache <n>  the number of tiles the memo engine's cache holds (default 65536),
+	             --rule <rule>    the rule to calculate, from the Generations family, as B<counts>/S<counts>[/C<states>]
+	                              (default B3/S23, which is Life; any other rule needs the generations or ltl engine, and selects the first,
+	                              or without dying states the table engine),
+	                              or a Larger than Life rule, as R<range>,C<states>,M<0|1>,S<min>..<max>,B<min>..<max>,NM
+	                              (which needs the ltl engine, and selects it),
+	             --workers <n>    split the board into bands of rows calculated by n worker processes (default 1),
+	             --threads <n>    share the test for repetition of a large board between n threads,
+	                              and with the wavefront engine calculate n generations at once (default 1),
+	             --output-buffer <n>  the number of boards that can wait to be printed (default 8),
+	             --output-policy <p>  what to do with a board when the output buffer is full:
+	                                  block (default), drop or coalesce,
+	             --quiet          don't print the boards, which also lifts the limit on the board size,
+	             --viewport <columns>x<rows>  print a view of the board that many characters wide and high instead of the whole board,
+	                              which also lifts the limit on the board size,
+	             --zoom <n>       show a 2^n x 2^n block of cells in each character of the view, by its density
+	                              (by default the smallest zoom at which the whole board fits in the view),
+	             --pan <row>,<column>  put that cell (or the start of its block) at the top left of the view (default 0,0),
+	             --blocks         show two blocks in each character of the view with Unicode half blocks, one above the other,
+	             --dump <file>    append the view of every generation to <file> as a raw 8 bit greyscale image (see openImageDump()),
+	                              using a view of 78 x 50 characters unless told otherwise with --viewport,
+	             --log <file>     record every generation in a frame log, for lifereplay to read,
+	             --keyframe-interval <n>  the number of generations between full boards in the log (default 64),
+	             --export <name>  publish every generation in the POSIX shared memory object <name>, for other programs to read,
+	             --track          print the population, births, deaths and bounding box of every generation on stderr,
+	                              and report patterns that move across the board (spaceships) with their speed.
+	             --serve <socket> instead of calculating one board, run as a server on the Unix domain socket <socket>,
+	                              which calculates boards for its clients with the engine and rule given (see runServer()),
+	                              on --threads worker threads. There are no positional arguments, and the other options are ignored.
 	Return value: EXIT_SUCCESS if the program completes successfully,
 	              EXIT_FAILURE if there is a problem in program execution.
 	Inputs from user: None.
@@ -52,400 +1395,9713 @@ int repetitionTest(char (*board1)[boardWidth], char (*board2)[boardWidth]);
  */
 int main(int argc, char* argv[])
 {
-	if(argc != 5)
-	{
-		fprintf(stderr, "Invalid arguments.\n"
-		                "Usage: %s <file-name containing initial data> <width> <height> <no. of generations to calculate>\n"
-		                "The program will now exit.\n", argv[0]);
-		exit(EXIT_FAILURE);
-	}
+	/* The positional arguments are collected here as the options are removed from the argument list. */
+	char *positionalArguments[4];
+	int noOfPositionalArguments = 0;
 
-	/* Read the width, height and number of generations arguments into integers */
-	extern int boardWidth, boardHeight;
-	int noOfGenerations;
+	/* The maximum period to detect, which is also the number of previous generations that are remembered. */
+	int historyDepth = DEFAULT_PERIOD_TO_DETECT;
 
-	/* Set the integers to -1 before reading them from the function arguments, to ensure erroneous input is detected. */
-	boardWidth = boardHeight = noOfGenerations = -1;
+	/* The only generation to print, or -1 to print them all. */
+	long long atGeneration = -1;
 
-	sscanf(argv[2], "%d", &boardWidth);
-	if( (boardWidth < 0) || (boardWidth > MAX_BOARD_WIDTH) )
-	{
-		fprintf(stderr, "Invalid board width.\n"
-		                "Please ensure that board width is an integer greater than or equal to zero, and less than or equal to %d.\n"
-		                "The program will now exit.\n", MAX_BOARD_WIDTH);
-		exit(EXIT_FAILURE);
-	}
+	/* The size of the output buffer, and what to do when it is full. */
+	int outputBufferSize = DEFAULT_OUTPUT_BUFFER;
+	outputPolicy policy = OUTPUT_BLOCK;
 
-	sscanf(argv[3], "%d", &boardHeight);
-	if( (boardHeight < 0) || (boardHeight > MAX_BOARD_HEIGHT) )
-	{
-		fprintf(stderr, "Invalid board height.\n"
-		                "Please ensure that board height is an integer greater than or equal to zero, and less than or equal to %d.\n"
-		                "The program will now exit.\n", MAX_BOARD_HEIGHT);
-		exit(EXIT_FAILURE);
-	}
+	/* Whether the boards are printed, which is the only thing that limits the board size. */
+	int printBoards = 1;
 
-	sscanf(argv[4], "%d", &noOfGenerations);
-	if(noOfGenerations < 0)
-	{
-		fputs("Invalid no. of generations to calculate.\n"
-		      "Please ensure that The no. of generations to calculate is an integer greater than or equal tozero.\n"
-		      "The program will now exit.\n", stderr);
-		exit(EXIT_FAILURE);
-	}
+	/* The size of the view printed instead of the whole board, if any, the zoom (or -1 to fit the board in the view),
+	   the cell at its top left, and whether it uses half blocks. The view is also what is dumped to the image dump file, if any. */
+	int viewColumns = 0, viewRows = 0, viewZoom = -1, panRow = 0, panColumn = 0, halfBlocks = 0;
+	const char *dumpFileName = NULL;
 
-	/* Allocate space for an array of MAX_PERIOD_TO_DETECT + 1 boards,
-	   each board is a 2D array of characters whose dimensions are boardHeight and boardWidth
-	   i.e each board is of the format board1[boardWidth][boardHeight] */
-	char (*boards)[boardWidth][boardHeight];
+	/* The file to log every generation to, if any, and how often it gets a full board */
+	const char *logFileName = NULL;
+	int keyframeInterval = DEFAULT_KEYFRAME_INTERVAL;
 
-	boards = ( char (*)[boardWidth][boardHeight] )malloc( (MAX_PERIOD_TO_DETECT + 1) * boardWidth * boardHeight * sizeof(char) );
+	/* The shared memory object to publish every generation in, if any */
+	const char *exportName = NULL;
 
-	/* Pointers to a board so that the 'current' and 'next' boards can be swapped for any board in the boards array.
-	   Initially, boards[0] will be the currentBoard and boards[1] will be the nextBoard. */
-	char (*currentBoard)[boardWidth] = boards[0];
-	char (*nextBoard)[boardWidth] = boards[1];
+	/* Whether the statistics of each generation are printed, and spaceships looked for */
+	int tracking = 0;
 
-	/* nextBoardPosition stores the array index of nextBoard.
-	   initialised to 1 since nextBoard is initialised to boards[1] */
-	int nextBoardPosition = 1;
+	/* The Unix domain socket to listen on if the program is to be a server, which is given its boards by its clients */
+	const char *socketPath = NULL;
 
-	/* Initialise currentBoard to be full of dead cells (spaces) */
-	memset(currentBoard, ' ', boardWidth * boardHeight * sizeof(char));
+	/* The file the mapped engine keeps its boards in, if it isn't to be a temporary one */
+	const char *mapFileName = NULL;
 
-	/* Read the initial live cells to the current board. */
-	if(!readFileToBoard(argv[1], currentBoard))
-	{
-		fputs("The program will now exit.\n", stderr);
-		exit(EXIT_FAILURE);
-	}
+	/* The number of tiles the memo engine's cache holds */
+	long tileCacheEntries = DEFAULT_TILE_CACHE_ENTRIES;
+
+	/* The rule to calculate, which is Life unless told otherwise */
+	generationsRule rule = {1u << 3, (1u << 2) | (1u << 3), 2, 0, 0, 0, 0, 0, 0};
+
+	/* The engine used to calculate the generations, and the number of processes to split the board between. */
+	const engineType *selectedEngine = NULL;
+	int noOfWorkers = 1;
+	int noOfThreads = 1;
+	int adaptInterval = DEFAULT_ADAPT_INTERVAL;
 
-	/* Loop to iterate the board and print it out for the number of generations specified.
-	   boards[3][0][0] is initially set to \0, so that testForRepitions() knows whether that board has been used yet.
-	   This tells the function which boards have been used at least once, so it knows which boards to test when testing for repeats  */
 	int i;
-	int j;
-	/* Board to compare counter stores the current boards[] array index of the board to compare to the current one */
-	int boardToCompareCounter;
+	for(i = 1; i < argc; i++)
+	{
+		if(strcmp(argv[i], "--history") == 0)
+		{
+			/* Set historyDepth to -1 before reading it, to ensure erroneous input is detected. */
+			historyDepth = -1;
+			if(i + 1 < argc)
+				sscanf(argv[++i], "%d", &historyDepth);
+			if(historyDepth < 0)
+			{
+				fputs("Invalid history depth.\n"
+				      "Please ensure that the history depth is an integer greater than or equal to zero.\n"
+				      "The program will now exit.\n", stderr);
+				exit(EXIT_FAILURE);
+			}
+		}
+		else if(strcmp(argv[i], "--at") == 0)
+		{
+			atGeneration = -1;
+			if(i + 1 < argc)
+				sscanf(argv[++i], "%lld", &atGeneration);
+			if(atGeneration < 0)
+			{
+				fputs("Invalid generation.\n"
+				      "Please ensure that the generation is an integer greater than or equal to zero.\n"
+				      "The program will now exit.\n", stderr);
+				exit(EXIT_FAILURE);
+			}
+		}
+		else if(strcmp(argv[i], "--engine") == 0)
+		{
+			selectedEngine = NULL;
+			if(i + 1 < argc)
+				selectedEngine = findEngineType(argv[++i]);
+			if(selectedEngine == NULL)
+			{
+				fputs("Invalid engine.\n"
+				      "Please choose one of the following engines:\n", stderr);
+				const engineType **type;
+				for(type = engineTypes; *type != NULL; type++)
+					fprintf(stderr, "  %-8s %s\n", (*type)->name, (*type)->description);
+				fputs("The program will now exit.\n", stderr);
+				exit(EXIT_FAILURE);
+			}
+		}
+		else if(strcmp(argv[i], "--output-buffer") == 0)
+		{
+			outputBufferSize = -1;
+			if(i + 1 < argc)
+				sscanf(argv[++i], "%d", &outputBufferSize);
+			if(outputBufferSize < 1)
+			{
+				fputs("Invalid output buffer size.\n"
+				      "Please ensure that the output buffer size is an integer greater than or equal to one.\n"
+				      "The program will now exit.\n", stderr);
+				exit(EXIT_FAILURE);
+			}
+		}
+		else if(strcmp(argv[i], "--output-policy") == 0)
+		{
+			const char *policyName = (i + 1 < argc) ? argv[++i] : "";
+			if(strcmp(policyName, "block") == 0)
+				policy = OUTPUT_BLOCK;
+			else if(strcmp(policyName, "drop") == 0)
+				policy = OUTPUT_DROP;
+			else if(strcmp(policyName, "coalesce") == 0)
+				policy = OUTPUT_COALESCE;
+			else
+			{
+				fputs("Invalid output policy.\n"
+				      "Please choose block, drop or coalesce.\n"
+				      "The program will now exit.\n", stderr);
+				exit(EXIT_FAILURE);
+			}
+		}
+		else if(strcmp(argv[i], "--adapt-interval") == 0)
+		{
+			adaptInterval = -1;
+			if(i + 1 < argc)
+				sscanf(argv[++i], "%d", &adaptInterval);
+			if(adaptInterval < 1)
+			{
+				fputs("Invalid adapt interval.\n"
+				      "Please ensure that the adapt interval is an integer greater than or equal to one.\n"
+				      "The program will now exit.\n", stderr);
+				exit(EXIT_FAILURE);
+			}
+		}
+		else if(strcmp(argv[i], "--workers") == 0)
+		{
+			noOfWorkers = -1;
+			if(i + 1 < argc)
+				sscanf(argv[++i], "%d", &noOfWorkers);
+			if(noOfWorkers < 1)
+			{
+				fputs("Invalid number of workers.\n"
+				      "Please ensure that the number of workers is an integer greater than or equal to one.\n"
+				      "The program will now exit.\n", stderr);
+				exit(EXIT_FAILURE);
+			}
+		}
+		else if(strcmp(argv[i], "--threads") == 0)
+		{
+			noOfThreads = -1;
+			if(i + 1 < argc)
+				sscanf(argv[++i], "%d", &noOfThreads);
+			if(noOfThreads < 1)
+			{
+				fputs("Invalid number of threads.\n"
+				      "Please ensure that the number of threads is an integer greater than or equal to one.\n"
+				      "The program will now exit.\n", stderr);
+				exit(EXIT_FAILURE);
+			}
+		}
+		else if(strcmp(argv[i], "--quiet") == 0)
+			printBoards = 0;
+		else if(strcmp(argv[i], "--track") == 0)
+			tracking = 1;
+		else if(strcmp(argv[i], "--viewport") == 0)
+		{
+			viewColumns = viewRows = -1;
+			if(i + 1 < argc)
+				sscanf(argv[++i], "%dx%d", &viewColumns, &viewRows);
+			if( (viewColumns < 1) || (viewRows < 1) )
+			{
+				fputs("Invalid viewport size.\n"
+				      "Please give the size of the view in characters as <columns>x<rows>, e.g. 160x48.\n"
+				      "The program will now exit.\n", stderr);
+				exit(EXIT_FAILURE);
+			}
+		}
+		else if(strcmp(argv[i], "--zoom") == 0)
+		{
+			viewZoom = -1;
+			if(i + 1 < argc)
+				sscanf(argv[++i], "%d", &viewZoom);
+			if( (viewZoom < 0) || (viewZoom > 30) )
+			{
+				fputs("Invalid zoom.\n"
+				      "Please ensure that the zoom is an integer from 0 to 30.\n"
+				      "The program will now exit.\n", stderr);
+				exit(EXIT_FAILURE);
+			}
+		}
+		else if(strcmp(argv[i], "--pan") == 0)
+		{
+			panRow = panColumn = -1;
+			if(i + 1 < argc)
+				sscanf(argv[++i], "%d,%d", &panRow, &panColumn);
+			if( (panRow < 0) || (panColumn < 0) )
+			{
+				fputs("Invalid pan position.\n"
+				      "Please give the cell at the top left of the view as <row>,<column>, with both greater than or equal to zero.\n"
+				      "The program will now exit.\n", stderr);
+				exit(EXIT_FAILURE);
+			}
+		}
+		else if(strcmp(argv[i], "--blocks") == 0)
+			halfBlocks = 1;
+		else if(strcmp(argv[i], "--dump") == 0)
+		{
+			if(i + 1 < argc)
+				dumpFileName = argv[++i];
+		}
+		else if(strcmp(argv[i], "--log") == 0)
+		{
+			if(i + 1 < argc)
+				logFileName = argv[++i];
+		}
+		else if(strcmp(argv[i], "--export") == 0)
+		{
+			if(i + 1 < argc)
+				exportName = argv[++i];
+		}
+		else if(strcmp(argv[i], "--serve") == 0)
+		{
+			if(i + 1 < argc)
+				socketPath = argv[++i];
+		}
+		else if(strcmp(argv[i], "--map-file") == 0)
+		{
+			if(i + 1 < argc)
+				mapFileName = argv[++i];
+		}
+		else if(strcmp(argv[i], "--tile-cache") == 0)
+		{
+			/* Set tileCacheEntries to -1 before reading it, to ensure erroneous input is detected. */
+			tileCacheEntries = -1;
+			if(i + 1 < argc)
+				sscanf(argv[++i], "%ld", &tileCacheEntries);
+			if( (tileCacheEntries < TILE_CACHE_WAYS) || (tileCacheEntries > (1L << 30)) )
+			{
+				fprintf(stderr, "Invalid tile cache size.\n"
+				                "Please ensure that the tile cache holds from %d to %ld tiles.\n"
+				                "The program will now exit.\n", TILE_CACHE_WAYS, 1L << 30);
+				exit(EXIT_FAILURE);
+			}
+		}
+		else if(strcmp(argv[i], "--rule") == 0)
+		{
+			if( (i + 1 >= argc) || !parseRule(argv[++i], &rule) )
+			{
+				fprintf(stderr, "Invalid rule.\n"
+				                "Please give the rule as B<neighbours>/S<neighbours>, optionally followed by /C<no. of states> (2 to %d), e.g. B3/S23 or B2/S/C3,\n"
+				                "or as R<range>,C<no. of states>,M<0 or 1>,S<min>..<max>,B<min>..<max>,NM (a range of 1 to %d), e.g. R5,C0,M1,S34..58,B34..45,NM.\n"
+				                "The program will now exit.\n", MAX_STATES, MAX_RANGE);
+				exit(EXIT_FAILURE);
+			}
+		}
+		else if(strcmp(argv[i], "--keyframe-interval") == 0)
+		{
+			keyframeInterval = -1;
+			if(i + 1 < argc)
+				sscanf(argv[++i], "%d", &keyframeInterval);
+			if(keyframeInterval < 1)
+			{
+				fputs("Invalid keyframe interval.\n"
+				      "Please ensure that the keyframe interval is an integer greater than or equal to one.\n"
+				      "The program will now exit.\n", stderr);
+				exit(EXIT_FAILURE);
+			}
+		}
+		else if( (strncmp(argv[i], "--", 2) != 0) && (noOfPositionalArguments < 4) )
+			positionalArguments[noOfPositionalArguments++] = argv[i];
+		else
+		{
+			/* Either an unknown option, or too many positional arguments. Setting the count too high reports the usage below. */
+			noOfPositionalArguments = 5;
+			break;
+		}
+	}
+
+	/* A server takes its boards from its clients, so has no positional arguments, and only uses the options that create the engines */
+	if( (socketPath != NULL) && (noOfPositionalArguments == 0) )
+	{
+		selectedEngine = engineForRule(selectedEngine, &rule);
+		if(selectedEngine == NULL)
+			selectedEngine = &bitEngineType;
+		if( (selectedEngine == &charEngineType) || (noOfWorkers > 1) || (mapFileName != NULL) )
+		{
+			fputs("The server can't use the char engine, which keeps its board in global variables, split boards between workers,\n"
+			      "or give every session's mapped engine the same file.\n"
+			      "The program will now exit.\n", stderr);
+			exit(EXIT_FAILURE);
+		}
+
+		/* Each session's engine calculates on the worker thread that carries out its requests, so has no threads of its own */
+		engineOptions serverOptions;
+		serverOptions.historyDepth = historyDepth;
+		serverOptions.noOfWorkers = 1;
+		serverOptions.noOfThreads = 1;
+		serverOptions.needBoards = 1;
+		serverOptions.mapFileName = NULL;
+		serverOptions.rule = rule;
+		serverOptions.trackStatistics = 0;
+		serverOptions.tileCacheEntries = tileCacheEntries;
+		serverOptions.initialPopulation = 0;
+		return runServer(socketPath, selectedEngine, &serverOptions, noOfThreads);
+	}
+
+	if( (noOfPositionalArguments != 4) || (socketPath != NULL) )
+	{
+		fprintf(stderr, "Invalid arguments.\n"
+		                "Usage: %s [--history <max. period to detect>] [--at <generation>] [--engine <name> [--map-file <file>] [--tile-cache <tiles>]] [--rule <rule>] [--adapt-interval <n>] [--workers <n>] [--threads <n>] [--output-buffer <boards>] [--output-policy block|drop|coalesce] [--quiet] [--viewport <columns>x<rows>] [--zoom <n>] [--pan <row>,<column>] [--blocks] [--dump <file>] [--log <file> [--keyframe-interval <n>]] [--export <name>] [--track] <file-name containing initial data> <width> <height> <no. of generations to calculate>\n"
+		                "   or: %s --serve <socket> [--engine <name> [--tile-cache <tiles>]] [--rule <rule>] [--threads <n>]\n"
+		                "The program will now exit.\n", argv[0], argv[0]);
+		exit(EXIT_FAILURE);
+	}
+
+	/* Read the width, height and number of generations arguments into integers */
+	extern int boardWidth, boardHeight;
+	int noOfGenerations;
+
+	/* Set the integers to -1 before reading them from the function arguments, to ensure erroneous input is detected. */
+	boardWidth = boardHeight = noOfGenerations = -1;
+
+	/* A view is dumped as well as printed, so dumping without a view uses a view of the largest board that can be printed */
+	int viewing = (viewColumns > 0) || (dumpFileName != NULL);
+	if( viewing && (viewColumns == 0) )
+	{
+		viewColumns = MAX_BOARD_WIDTH;
+		viewRows = MAX_BOARD_HEIGHT;
+	}
+
+	/* The maximum dimensions only apply to boards that are printed whole */
+	sscanf(positionalArguments[1], "%d", &boardWidth);
+	if( (boardWidth < 0) || (printBoards && !viewing && (boardWidth > MAX_BOARD_WIDTH)) )
+	{
+		fprintf(stderr, "Invalid board width.\n"
+		                "Please ensure that board width is an integer greater than or equal to zero, and less than or equal to %d (unless using --quiet or --viewport).\n"
+		                "The program will now exit.\n", MAX_BOARD_WIDTH);
+		exit(EXIT_FAILURE);
+	}
+
+	sscanf(positionalArguments[2], "%d", &boardHeight);
+	if( (boardHeight < 0) || (printBoards && !viewing && (boardHeight > MAX_BOARD_HEIGHT)) )
+	{
+		fprintf(stderr, "Invalid board height.\n"
+		                "Please ensure that board height is an integer greater than or equal to zero, and less than or equal to %d (unless using --quiet or --viewport).\n"
+		                "The program will now exit.\n", MAX_BOARD_HEIGHT);
+		exit(EXIT_FAILURE);
+	}
+
+	sscanf(positionalArguments[3], "%d", &noOfGenerations);
+	if(noOfGenerations < 0)
+	{
+		fputs("Invalid no. of generations to calculate.\n"
+		      "Please ensure that The no. of generations to calculate is an integer greater than or equal tozero.\n"
+		      "The program will now exit.\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+
+	/* The view has to start on the board, and unless told otherwise is zoomed out until the whole board fits in it */
+	int viewPixelRows = halfBlocks ? 2 * viewRows : viewRows;
+	if(viewing)
+	{
+		if( ( (panRow > 0) && (panRow >= boardHeight) ) || ( (panColumn > 0) && (panColumn >= boardWidth) ) )
+		{
+			fputs("Invalid pan position.\n"
+			      "Please ensure that the cell at the top left of the view is on the board.\n"
+			      "The program will now exit.\n", stderr);
+			exit(EXIT_FAILURE);
+		}
+		if(viewZoom < 0)
+			for(viewZoom = 0; ( ( ((long)boardWidth - 1) >> viewZoom ) >= viewColumns ) || ( ( ((long)boardHeight - 1) >> viewZoom ) >= viewPixelRows ); viewZoom++)
+				;
+	}
+
+	/* The cells read from the file are loaded into the engine, which then keeps its own boards.
+	   Whenever the current board is needed, it is viewed as a boardPlanes through the engine,
+	   so the ages are only turned into characters when the board is printed. */
+	cellList initialCells;
+
+	/* Read the initial live cells. */
+	if(!readFileToBoard(positionalArguments[0], &initialCells))
+	{
+		fputs("The program will now exit.\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+
+	/* Only the ltl engine calculates Larger than Life rules, and only it and the generations engine calculate other rules than Life,
+	   so one of them is used for those rules, and never changed */
+	selectedEngine = engineForRule(selectedEngine, &rule);
+
+	/* Unless an engine was chosen, start with the one estimated to be fastest for the initial board,
+	   and let the adaptive controller change it as the board changes. Split boards always use the bit engine.
+	   Nothing is known yet about how the board changes, so every live cell is assumed to be changing. */
+	int adaptive = (selectedEngine == NULL) && (noOfWorkers == 1);
+	if(selectedEngine == NULL)
+	{
+		const engineType **type;
+		double cost, lowestCost = 0;
+		selectedEngine = &bitEngineType;
+		for(type = engineTypes; adaptive && (*type != NULL); type++)
+		{
+			if((*type)->estimateCost == NULL)
+				continue;
+			cost = (*type)->estimateCost( (double)boardWidth * boardHeight, initialCells.noOfCells, initialCells.noOfCells );
+			if( (type == engineTypes) || (cost < lowestCost) )
+			{
+				selectedEngine = *type;
+				lowestCost = cost;
+			}
+		}
+	}
+
+	/* Check that the board can be split between the workers */
+	if(noOfWorkers > 1)
+	{
+		if(selectedEngine != &bitEngineType)
+		{
+			fputs("Only the bit engine can be split between workers.\n"
+			      "The program will now exit.\n", stderr);
+			exit(EXIT_FAILURE);
+		}
+		if( (noOfWorkers > boardHeight) || (historyDepth > MAX_DISTRIBUTED_HISTORY) )
+		{
+			fprintf(stderr, "Invalid number of workers.\n"
+			                "Please ensure that there are no more workers than rows, and that the history depth is at most %d.\n"
+			                "The program will now exit.\n", MAX_DISTRIBUTED_HISTORY);
+			exit(EXIT_FAILURE);
+		}
+		selectedEngine = &distributedEngineType;
+	}
+
+	/* Create the engine. Any worker processes are started when the board is loaded,
+	   which must happen before any threads are started. The engine may need to provide its boards for the tracker,
+	   but main() only views them every generation if they are output. */
+	int outputBoards = printBoards || viewing || (logFileName != NULL) || (exportName != NULL);
+	engineOptions options;
+	options.historyDepth = historyDepth;
+	options.noOfWorkers = noOfWorkers;
+	options.noOfThreads = noOfThreads;
+	options.needBoards = outputBoards || tracking;
+	options.mapFileName = mapFileName;
+	options.rule = rule;
+	options.trackStatistics = tracking;
+	options.tileCacheEntries = tileCacheEntries;
+	options.initialPopulation = initialCells.noOfCells;
+
+	/* Reserve the arenas that everything from here on is allocated from, so that nothing is allocated from the heap once the generations
+	   are being calculated. If the board can move to another engine, the engine arena has room for any engine it could be given,
+	   the scratch arena for the lists of cells made while it moves, with every cell alive, and the main arena for main()'s history,
+	   which the engine it starts on might not need. That room is only reserved (see openArenas()), so it costs nothing unless it is used. */
+	snapshotWords = ( (long)boardWidth * boardHeight + 63 ) / 64;
+	double boardSize = planesSize(boardWidth, boardHeight);
+	double slotSize = boardSize + sizeof(boardPlanes) + sizeof(int) + 2 * ARENA_ALIGNMENT;
+	double viewSlotSize = planesSize(viewColumns, viewPixelRows) + sizeof(boardPlanes) + sizeof(int) + 2 * ARENA_ALIGNMENT;
+	double mainSize = 0, engineSize = selectedEngine->memoryNeeded(boardWidth, boardHeight, &options), scratchSize = 0;
+	mainSize += STREAM_BUFFER_SIZE;
+	if(printBoards)
+		mainSize += (outputBufferSize + 1) * (viewing ? viewSlotSize : slotSize);
+	if(viewing)
+		mainSize += viewportMemory(viewColumns, viewRows, halfBlocks);
+	if(dumpFileName != NULL)
+		mainSize += STREAM_BUFFER_SIZE + viewColumns + (outputBufferSize + 1) * viewSlotSize + 2 * ARENA_ALIGNMENT;
+	if(logFileName != NULL)
+		mainSize += STREAM_BUFFER_SIZE + (outputBufferSize + 2) * slotSize + 1.25 * boardSize + 2.0 * (noOfGenerations / keyframeInterval + 1) * sizeof(int64_t);
+	double ringSize = (historyDepth + 1) * ( sizeof(boardSnapshot) + snapshotWords * sizeof(uint64_t) + sizeof(int) + sizeof(atomic_int) )
+	                  + 4.0 * noOfThreads * ( sizeof(long) + sizeof(uint64_t) ) + 6 * ARENA_ALIGNMENT;
+	if(selectedEngine->findPeriod == NULL)
+		mainSize += ringSize;
+	mainSize += noOfThreads * sizeof(pthread_t) + ARENA_ALIGNMENT;
+	if(tracking)
+		mainSize += (historyDepth + 1) * ( sizeof(boardStatistics) + 1 + sizeof(uint64_t) + trackerPatternWords(boardWidth, boardHeight) * sizeof(uint64_t) )
+		            + 4 * ARENA_ALIGNMENT;
+	double startMainSize = mainSize, startEngineSize = engineSize;
+	if(adaptive)
+	{
+		const engineType **type;
+		for(type = engineTypes; *type != NULL; type++)
+			if( ((*type)->estimateCost != NULL) && ((*type)->memoryNeeded(boardWidth, boardHeight, &options) > engineSize) )
+				engineSize = (*type)->memoryNeeded(boardWidth, boardHeight, &options);
+		scratchSize = (historyDepth + 1) * ( sizeof(cellList) + (double)boardWidth * boardHeight * (sizeof(coord) + 1) + 2 * ARENA_ALIGNMENT ) + boardSize;
+		if(selectedEngine->findPeriod != NULL)
+			mainSize += ringSize;
+	}
+	/* A board too big to have room to move can still be calculated on the engine it starts on, but one too big for that can't be */
+	if(!openArenas(mainSize, engineSize, scratchSize))
+	{
+		if( !adaptive || !openArenas(startMainSize, startEngineSize, 0) )
+		{
+			fputs("Memory arena error.\n"
+			      "The board is too big to reserve the memory for.\n"
+			      "The program will now exit.\n", stderr);
+			exit(EXIT_FAILURE);
+		}
+		adaptive = 0;
+		fprintf(stderr, "The board is too big to reserve the memory to move it to another engine, so it will stay on the %s engine.\n", selectedEngine->name);
+	}
+
+	/* Give stdout a buffer, so that the C library doesn't allocate one when the first board or message is printed */
+	setvbuf(stdout, (char *)allocateMemory(STREAM_BUFFER_SIZE), isatty(STDOUT_FILENO) ? _IOLBF : _IOFBF, STREAM_BUFFER_SIZE);
+
+	selectArena(&engineArena);
+	lifeEngine *engine = selectedEngine->create(boardWidth, boardHeight, &options);
+	engine->type->load(engine, &initialCells);
+	selectArena(&mainArena);
+	freeCells(&initialCells);
+
+	/* Set up the view, which is drawn from a population pyramid of the board, so that it doesn't need the whole board to be printed */
+	boardViewport viewport;
+	if(viewing)
+		openViewport(&viewport, panRow, panColumn, viewZoom, viewColumns, viewRows, halfBlocks);
+
+	/* Start the writer thread, which prints the boards (or their views) as they are queued */
+	outputPipeline pipeline;
+	if(printBoards && viewing)
+		startOutputPipeline(&pipeline, outputBufferSize, viewColumns, viewPixelRows, policy, printViewport, &viewport);
+	else if(printBoards)
+		startOutputPipeline(&pipeline, outputBufferSize, boardWidth, boardHeight, policy, printQueuedBoard, NULL);
+
+	/* Open the image dump, which like the frame log is written on a writer thread that is never allowed to drop a view */
+	imageDump dump;
+	outputPipeline dumpPipeline;
+	if(dumpFileName != NULL)
+	{
+		openImageDump(&dump, dumpFileName, &viewport);
+		startOutputPipeline(&dumpPipeline, outputBufferSize, viewColumns, viewPixelRows, OUTPUT_BLOCK, dumpImage, &dump);
+	}
+
+	/* Open the frame log. The boards are compressed and written on a second writer thread,
+	   which is never allowed to drop a board, so the log holds every generation. */
+	frameLog log;
+	outputPipeline logPipeline;
+	if(logFileName != NULL)
+	{
+		openFrameLog(&log, logFileName, keyframeInterval, noOfGenerations);
+		startOutputPipeline(&logPipeline, outputBufferSize, boardWidth, boardHeight, OUTPUT_BLOCK, logBoard, &log);
+	}
+
+	/* Create the shared memory export. Copying a board into it is cheaper than queueing it, so it is done on this thread. */
+	boardExport export;
+	if(exportName != NULL)
+		openBoardExport(&export, exportName);
+
+	/* Start the helper threads that share the test for repetition */
+	threadPool pool;
+	startThreadPool(&pool, noOfThreads);
+
+	/* Allocate the history of earlier generations. Engines that test for repetition themselves don't need it,
+	   so it is only allocated once the board is on an engine that does, which the adaptive controller might move it to at any time. */
+	snapshotRing history;
+	history.snapshots = NULL;
+	history.depth = historyDepth;
+	history.pool = &pool;
+	if(engine->type->findPeriod == NULL)
+		allocateSnapshotRing(&history, historyDepth, &pool);
+
+	/* The spaceship tracker remembers as many generations as the history, so finds spaceships of up to the maximum period to detect */
+	spaceshipTracker tracker;
+	boardStatistics statistics;
+	statistics.population = 0;
+	if(tracking)
+		allocateSpaceshipTracker(&tracker, historyDepth);
+
+	/* Start up is over: only the engine can allocate from now on, and only from its arena */
+	selectArena(&engineArena);
+	allocationsSealed = 1;
+
+	/* Loop to iterate the board and print it out for the number of generations specified, stopping early if a period is found. */
+	const boardPlanes *currentBoard = NULL;
+	int period = 0;
+
+	/* With --at, the loop also stops at the generation to print, which is the only one printed */
+	for(i = 0; (i <= noOfGenerations) && (period == 0) && ( (atGeneration < 0) || (i <= atGeneration) ); i++)
+	{
+		/* Queue the current board (or its view) to be printed to stdout, dump its view, record it in the log, and publish it in the export. */
+		if(outputBoards)
+		{
+			/* The whole board is only made if it is printed, logged or exported, as a view is drawn from the engine */
+			int printing = printBoards && ( (atGeneration < 0) || (i == atGeneration) );
+			if( (printing && !viewing) || (logFileName != NULL) || (exportName != NULL) )
+				currentBoard = engine->type->view(engine);
+			if( viewing && ( printing || (dumpFileName != NULL) ) )
+				drawViewport(&viewport, engine);
+			if(printing)
+				queueBoard(&pipeline, viewing ? &viewport.image : currentBoard);
+			if(dumpFileName != NULL)
+				publishToPipeline(&dumpPipeline, &viewport.image, 0, 1, 1);
+			if(logFileName != NULL)
+				publishToPipeline(&logPipeline, currentBoard, 0, 1, i % keyframeInterval == 0);
+			if(exportName != NULL)
+				exportBoard(&export, currentBoard, i);
+		}
+
+		/* Some engines keep their own history, and test for repetition themselves */
+		if(engine->type->findPeriod != NULL)
+			period = engine->type->findPeriod(engine);
+		else
+			period = findSnapshotPeriod(&history, engine->type->view(engine));
+
+		/* Engines that can give the statistics do, otherwise they are found from the board */
+		if(tracking)
+		{
+			if( (engine->type->statistics == NULL) || !engine->type->statistics(engine, &statistics) )
+				scanBoardStatistics(engine->type->view(engine), i, statistics.population, &statistics);
+			trackBoard(&tracker, engine, &statistics, i);
+		}
+
+		/* Calculate the next generation, and every adaptInterval generations let the controller move the board to a faster engine */
+		if( (period == 0) && (i < noOfGenerations) && ( (atGeneration < 0) || (i < atGeneration) ) )
+		{
+			engine->type->step(engine);
+			if( adaptive && ( (i + 1) % adaptInterval == 0 ) )
+				engine = adaptEngine(engine, i + 1, &options, &history);
+		}
+	}
+
+	/* The loop stopped on generation i - 1. If the generation asked for with --at is later,
+	   the board repeats from here on, so it can be reached without calculating the generations in between. */
+	long long lastGeneration = i - 1, skipTo = -1;
+	if( (atGeneration >= 0) && (atGeneration > lastGeneration) )
+	{
+		if(period == 0)
+		{
+			fprintf(stderr, "Generation %lld wasn't reached.\n"
+			                "No period was detected in the first %d generations, so please increase the no. of generations to calculate.\n"
+			                "The program will now exit.\n", atGeneration, noOfGenerations);
+			exit(EXIT_FAILURE);
+		}
+
+		skipTo = repeatedGeneration(lastGeneration, period, atGeneration);
+		for(; lastGeneration < skipTo; lastGeneration++)
+			engine->type->step(engine);
+		if(printBoards && viewing)
+		{
+			drawViewport(&viewport, engine);
+			queueBoard(&pipeline, &viewport.image);
+		}
+		else if(printBoards)
+			queueBoard(&pipeline, engine->type->view(engine));
+	}
+
+	/* After the for loop, we are finished once the remaining boards are printed, so the message comes after them. */
+	if(printBoards)
+		stopOutputPipeline(&pipeline);
+	if(logFileName != NULL)
+	{
+		stopOutputPipeline(&logPipeline);
+		closeFrameLog(&log);
+	}
+	if(exportName != NULL)
+		closeBoardExport(&export);
+	if(dumpFileName != NULL)
+	{
+		stopOutputPipeline(&dumpPipeline);
+		closeImageDump(&dump);
+	}
+	if(skipTo >= 0)
+		printf("Period detected (%d) at generation %lld: generation %lld is the same as generation %lld\n",
+		       period, (long long)i - 1, atGeneration, skipTo);
+	else if(period != 0)
+		printf("Period detected (%d): exiting\n", period);
+	else
+		puts("Finished");
+	engine->type->destroy(engine);
+	freeSnapshotRing(&history);
+	if(tracking)
+		freeSpaceshipTracker(&tracker);
+	if(viewing)
+		closeViewport(&viewport);
+	stopThreadPool(&pool);
+	return EXIT_SUCCESS;
+}
+
+/*
+	Function: readFileToBoard()
+	Purpose: Read the initial board configuration from a file, and save the live cells in a list.
+	Arguments: The filename of the configuration file (fileName)
+	           A pointer to the list to write the live cells to, which is allocated here (cellsToWrite)
+	Return value: 1 upon successful reading.
+	              0 upon unsuccessful reading
+	Inputs from user: None.
+	Outputs to user: Error messages if there if there is a problem with the file.
+	Note: As per the specification, this function does no error checking on the format of the input file,
+	      other than ensuring the input file exists and ensuring the co-ordinates are within the defined board.
+	      So please ensure that any input files are carefully formatted.
+ */
+int readFileToBoard(const char* fileName, cellList *cellsToWrite)
+{
+	/* Attempt to open the file */
+	FILE *inputFilePointer;
+	inputFilePointer = fopen(fileName, "r");
+
+	/* If the inputFilePointer is NULL, the opening must have failed */
+	if(inputFilePointer == NULL)
+	{
+		fputs("Error opening board configuration file.\n"
+					"Please ensure that the file exists.\n", stderr);
+		return 0;
+	}
+
+	/* The first integer in the file is the number of coordinates that that file contains. */
+	int noOfCoordsToRead = 0;
+	fscanf(inputFilePointer, "%d", &noOfCoordsToRead);
+
+	/* The list grows as it is filled, rather than trusting the count in the file to allocate it */
+	long capacity = 16;
+	cellsToWrite->noOfCells = 0;
+	cellsToWrite->cells = (coord *)allocateMemory(capacity * sizeof(coord));
+	cellsToWrite->ages = NULL;
+
+	/* Now loop through the file until we've read the specifed no. of co-ordinates,
+	   read the each co-ordinate from the file,
+	   and save it in the appropriate place on the board. */
+	coord currentPoint;
+	for(; noOfCoordsToRead > 0; noOfCoordsToRead--)
+	{
+		/* Read the co-ordinates from the file */
+		fscanf(inputFilePointer, "%d%d", &currentPoint.row, &currentPoint.column);
+
+		/* Ensure that the co-ordiates are within the defined range. Return 0 (the error return) if they're not */
+		if( (currentPoint.row < 0) || (currentPoint.column < 0) || (currentPoint.row >= boardHeight) || (currentPoint.column >= boardWidth) )
+		{
+			fputs("Co-ordinate outside board dimensions.\n", stderr);
+			return 0;
+		}
+
+		/* If the defined co-ordinates are correct, add each one to the list as a live cell. */
+		if(cellsToWrite->noOfCells == capacity)
+		{
+			capacity *= 2;
+			cellsToWrite->cells = (coord *)resizeMemory(cellsToWrite->cells, capacity / 2 * sizeof(coord), capacity * sizeof(coord));
+		}
+		cellsToWrite->cells[cellsToWrite->noOfCells++] = currentPoint;
+	}
+
+	/* Close the input file and return the "success" return. */
+	fclose(inputFilePointer);
+	return 1;
+}
+
+/*
+	Function: printBoard()
+	Purpose: Print the current iteration of the board to stdout.
+	         Each live cell is printed as its age, and each dead cell as a space.
+	Arguments: The board to print (boardToRead).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: The board that is printed.
+ */
+void printBoard(const boardPlanes *boardToRead)
+{
+	/* Call printBorderRow(), to print the top border of the grid. */
+	printBorderRow(boardWidth);
+
+	/* Loop through and print out each row in turn. */
+	int i;
+	char rowCharacters[MAX_BOARD_WIDTH];
+	coord counter;
+	for(counter.row = 0; counter.row < boardHeight; counter.row++)
+	{
+		/* Build the characters for the row from the live and age planes */
+		const uint64_t *live = boardToRead->live + counter.row * boardToRead->liveWordsPerRow;
+		const uint64_t *ages = boardToRead->ages + counter.row * boardToRead->ageWordsPerRow;
+		for(counter.column = 0; counter.column < boardWidth; counter.column++)
+			if( (live[counter.column / 64] >> (counter.column % 64)) & 1 )
+				rowCharacters[counter.column] = ageCharacters[(ages[counter.column / 16] >> (4 * (counter.column % 16))) & 0xF];
+			else
+				rowCharacters[counter.column] = ' ';
+
+		/* The row can now be printed out as a string with defined length boardWidth.
+		   Pipes are put on the beginning and end of the string to create the border.*/
+		printf("|%.*s|\n", boardWidth, rowCharacters);
+	}
+
+	/* Call printBorderRow() again, to print the bottom border */
+	printBorderRow(boardWidth);
+
+	/* Put two blank lines after the board is printed, as specified. */
+	for(i=1; i<=2; i++)
+	putchar('\n');
+
+	return;
+}
+
+/*
+	Function: printBorderRow()
+	Purpose: Print a "border row" (the border that appears at the top or bottom of each printed board) to stdout.
+	Arguments: The number of columns inside the border (width).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: The border row that is printed to stdout.
+ */
+void printBorderRow(int width)
+{
+	/*Put a '*' to the the left corner of the border */
+	putchar('*');
+
+	/* Now we need as many '-'s as there are columns in the board */
+	int i;
+	for(i=0; i < width; i++)
+		putchar('-');
+
+	/* Now we need a * for the top right hand corner */
+	putchar('*');
+
+	/* Then finally a new line character so that the next output goes to a blank line. */
+	putchar('\n');
+
+	return;
+}
+
+/*
+	Function: iterateBoard()
+	Purpose: Perform the logical operations on each and every cell in a board, to see if it will live or die in the next state.
+	         Then write these changes to a different board.
+	Arguments: The board to read the current state from (boardToRead), and the board to write the next state to (boardToWrite).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+void iterateBoard(char (*boardToRead)[boardWidth], char (*boardToWrite)[boardWidth])
+{
+
+	/* Since we will be looping through each cell of the board, we will use a coord structure as our loop counter */
+	coord counter;
+
+	/* Outside loop loops through the rows */
+	for(counter.row = 0; counter.row < boardHeight; counter.row++)
+		/* Inside loop loops through the columns */
+		for(counter.column = 0; counter.column < boardWidth; counter.column++)
+			/* numberOfNeighbours() returns the number of live neighbours that a cell has.
+			   We can use this with a switch to create different outcomes each possible number of neighbours */
+			switch( numberOfNeighbours(boardToRead, counter) )
+			{
+				/* 0, 1 or 4+ (i.e default: ) neighbours means the cell will need to be dead */
+				case 0: case 1: default:
+					boardToWrite[counter.row][counter.column] = ' ';
+					break;
+
+				/* 2 neighbours means that the cell continues in its current state. */
+				case 2:
+					/* We can use a nested switch to handle the different cases that arise due to this */
+					switch(boardToRead[counter.row][counter.column])
+					{
+						/* If it's dead(' '), it remains dead (' '). */
+						case ' ':
+							boardToWrite[counter.row][counter.column] = ' ';
+							break;
+
+					 	/* If it's alive and has an age of 9 ('9') or more ('X'), it will be made an 'X' */
+						case'9': case'X':
+							boardToWrite[counter.row][counter.column] = 'X';
+							break;
+
+						/* All the other cases mean that the cell is alive and has an age of less than 9.
+						   This means that we should increment the digit.
+						   To do ths, we can add 1 to the ASCII code,
+						   since the ANSI standard guarentees that the digits 0-9 are be properly odered in the ASCII table. */
+						default:
+							boardToWrite[counter.row][counter.column] = boardToRead[counter.row][counter.column] + 1;
+							break;
+					}
+					break;
+
+				/* 3 neighbours means the cell will be alive */
+				case 3:
+					/* As with case 2, we can use a nested switch to take care of the eventualities */
+					switch(boardToRead[counter.row][counter.column])
+					{
+						/* If it's currently dead, make it a live cell with an age of 0 */
+						case ' ':
+							boardToWrite[counter.row][counter.column] = '0';
+						break;
+
+					 	/* If it's alive and has an age of 9 ('9') or more ('X'), it will be made an 'X' */
+						case'9': case'X':
+							boardToWrite[counter.row][counter.column] = 'X';
+							break;
+
+						/* All the other cases mean that the cell is alive and has an age of less than 9.
+						   This means that we should increment the digit.
+						   To do ths, we can add 1 to the ASCII code,
+						   since the ANSI standard guarentees that the digits 0-9 are be properly odered in the ASCII table. */
+						default:
+							boardToWrite[counter.row][counter.column] = boardToRead[counter.row][counter.column] + 1;
+							break;
+					}
+					break;
+			}
+
+}
+
+/*
+	Function: numberOfNeighbours()
+	Purpose: Calculate the number of live neighbours that a cell has, and return this number
+	Arguments: The board containing the cell whose neighbours need checking (board), and the co-ordinates of the cell the check (current).
+	Return value: An integer contianing the number of live neighbours that a cell has
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+int numberOfNeighbours(char (*board)[boardWidth], coord current)
+{
+	/* Return variable */
+	int neighbours = 0;
+
+	/* Starting from the far top left, check all the cells in a clockwise order, to see if a neighbour cell is alive */
+
+	/*Top left */
+	if( (current.row > 0) && (current.column > 0) )
+		if (board[current.row -1][current.column -1] != ' ')
+			neighbours++;
+
+	/*Top middle */
+	if(current.row > 0)
+		if (board[current.row -1][current.column] != ' ')
+			neighbours++;
+
+	/*Top right */
+	if( (current.row > 0) && (current.column < (boardWidth -1)) )
+		if (board[current.row -1][current.column +1] != ' ')
+			neighbours++;
+
+	/* Centre right */
+	if(current.column < (boardWidth -1) )
+		if (board[current.row][current.column +1] != ' ')
+			neighbours++;
+
+	/* Bottom right */
+	if( (current.column < (boardWidth -1)) && (current.row < (boardHeight -1)) )
+		if (board[current.row + 1][current.column +1] != ' ')
+			neighbours++;
+
+	/* Bottom middle */
+	if(current.row < (boardHeight -1))
+		if (board[current.row +1][current.column] != ' ')
+			neighbours++;
+
+	/* Bottom left */
+	if( (current.column > 0) && (current.row < (boardHeight -1)) )
+		if (board[current.row +1][current.column -1] != ' ')
+			neighbours++;
+
+	/* Centre left */
+	if(current.column > 0)
+		if (board[current.row][current.column -1] != ' ')
+			neighbours++;
+
+	/* Returnt the number of neighbours that there are. */
+	return neighbours;
+}
+
+/*
+	Function: takeSnapshot()
+	Purpose: Pack the live cells of a board into a snapshot, one bit per cell, and record the population and hash of the board.
+	Arguments: The board to take the snapshot of (boardToRead), and the snapshot to write to (snapshot).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+	Note: The hash is a sum over the non-empty 64 bit words of the snapshot, each mixed with its position,
+	      so boards that differ in any cell almost always have different hashes.
+ */
+void takeSnapshot(const boardPlanes *boardToRead, boardSnapshot *snapshot)
+{
+	packSnapshotRows(boardToRead, snapshot->cells, 0, boardToRead->height, &snapshot->population, &snapshot->hash);
+	snapshot->used = 1;
+	return;
+}
+
+/*
+	Function: packSnapshotRows()
+	Purpose: Pack the live cells of some of the rows of a board into the words of a snapshot that hold them,
+	         and find their population and their part of the hash.
+	Arguments: The board to read (boardToRead), the cells of the snapshot to write to (cells),
+	           the first row to pack and the row after the last (firstRow and lastRow),
+	           and where to write the population and the hash of the rows (population and hash).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+	Note: The rows must start and end on word boundaries of the snapshot (or at the end of the board),
+	      so that the words written belong to these rows alone. The hash is a sum, so the hashes of the bands of a board add up to the hash of the board.
+ */
+void packSnapshotRows(const boardPlanes *boardToRead, uint64_t *cells, int firstRow, int lastRow, long *population, uint64_t *hash)
+{
+	/* The words of the snapshot that these rows take up */
+	long firstWord = (long)firstRow * boardToRead->width / 64;
+	long lastWord = (lastRow == boardToRead->height) ? snapshotWords : (long)lastRow * boardToRead->width / 64;
+
+	/* Clear the words, so that each row can be ORed into place */
+	memset(cells + firstWord, 0, (lastWord - firstWord) * sizeof(uint64_t));
+
+	/* bitNumber is the position in the snapshot of the first cell of the current row. */
+	long bitNumber = (long)firstRow * boardToRead->width;
+	long rowPopulation = 0;
+	int row, word, bitsInWord;
+	uint64_t rowCells;
+
+	for(row = firstRow; row < lastRow; row++)
+		for(word = 0; word < boardToRead->liveWordsPerRow; word++, bitNumber += bitsInWord)
+		{
+			/* The last word of a row may only be partly used */
+			bitsInWord = boardToRead->width - 64 * word;
+			if(bitsInWord > 64)
+				bitsInWord = 64;
+
+			rowCells = boardToRead->live[row * boardToRead->liveWordsPerRow + word];
+			if(rowCells == 0)
+				continue;
+			rowPopulation += countBits(rowCells);
+
+			/* The 64 bit word may straddle two words of the snapshot */
+			cells[bitNumber / 64] |= rowCells << (bitNumber % 64);
+			if( (bitNumber % 64) + bitsInWord > 64 )
+				cells[bitNumber / 64 + 1] |= rowCells >> (64 - bitNumber % 64);
+		}
+
+	/* Hash the words that contain live cells */
+	uint64_t rowHash = 0;
+	long i;
+	for(i = firstWord; i < lastWord; i++)
+		if(cells[i] != 0)
+			rowHash += mixBits(cells[i] ^ mixBits(i));
+
+	*population = rowPopulation;
+	*hash = rowHash;
+	return;
+}
+
+/*
+	Function: takeSnapshotBand()
+	Purpose: A task for the thread pool: pack one band of rows of the board being tested into the current snapshot of a history.
+	Arguments: The history (context), and the number of the band (band).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+void takeSnapshotBand(void *context, int band)
+{
+	snapshotRing *ring = (snapshotRing *)context;
+
+	/* The bands are made of whole units, so that they start and end on word boundaries of the snapshot */
+	int firstRow = (int)( (long)ring->noOfUnits * band / ring->noOfBands ) * ring->rowsPerUnit;
+	int lastRow = (int)( (long)ring->noOfUnits * (band + 1) / ring->noOfBands ) * ring->rowsPerUnit;
+	if(lastRow > ring->board->height)
+		lastRow = ring->board->height;
+
+	packSnapshotRows(ring->board, ring->snapshots[ring->current].cells, firstRow, lastRow, &ring->bandPopulations[band], &ring->bandHashes[band]);
+	return;
+}
+
+/*
+	Function: repeatedGeneration()
+	Purpose: Find the first generation, from the one where a period was detected, that is identical to a later target generation,
+	         including the ages of the cells.
+	Arguments: The generation where the period was detected (generation), the period (period), and the target generation (target).
+	Return value: The generation that is identical to the target, between generation and target.
+	Inputs from user: None.
+	Outputs to user: None.
+	Note: The live cells repeat from generation - period onwards, but an age depends on the last MAX_AGE generations,
+	      so the ages only repeat from generation - period + MAX_AGE. For periods less than MAX_AGE,
+	      this means calculating up to MAX_AGE + period extra generations rather than stopping at generation + (target - generation) % period.
+ */
+long long repeatedGeneration(long long generation, int period, long long target)
+{
+	long long firstRepeated = generation - period + MAX_AGE;
+	if(firstRepeated < generation)
+		firstRepeated = generation;
+
+	/* A target before the ages repeat is simply calculated */
+	if(target <= firstRepeated)
+		return target;
+	return firstRepeated + (target - firstRepeated) % period;
+}
+
+/*
+	Function: unpackSnapshot()
+	Purpose: Turn a snapshot back into the live plane of a board, the opposite of takeSnapshot(). The ages are all set to 0.
+	Arguments: The snapshot to read (snapshot), and the board to write to (boardToWrite).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+void unpackSnapshot(const boardSnapshot *snapshot, boardPlanes *boardToWrite)
+{
+	/* bitNumber is the position in the snapshot of the first cell of the current row. */
+	long bitNumber = 0;
+	int row, word, bitsInWord;
+	uint64_t cells;
+
+	memset(boardToWrite->ages, 0, (size_t)boardToWrite->height * boardToWrite->ageWordsPerRow * sizeof(uint64_t));
+	for(row = 0; row < boardToWrite->height; row++)
+		for(word = 0; word < boardToWrite->liveWordsPerRow; word++, bitNumber += bitsInWord)
+		{
+			/* The last word of a row may only be partly used */
+			bitsInWord = boardToWrite->width - 64 * word;
+			if(bitsInWord > 64)
+				bitsInWord = 64;
+
+			/* The 64 bit word may straddle two words of the snapshot */
+			cells = snapshot->cells[bitNumber / 64] >> (bitNumber % 64);
+			if( (bitNumber % 64) + bitsInWord > 64 )
+				cells |= snapshot->cells[bitNumber / 64 + 1] << (64 - bitNumber % 64);
+			if(bitsInWord < 64)
+				cells &= ( (uint64_t)1 << bitsInWord ) - 1;
+
+			boardToWrite->live[row * boardToWrite->liveWordsPerRow + word] = cells;
+		}
+	return;
+}
+
+/*
+	Function: mixBits()
+	Purpose: Scramble the bits of a 64 bit value, so that similar values give very different results (the splitmix64 finaliser).
+	Arguments: The value to scramble (value).
+	Return value: The scrambled value.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+uint64_t mixBits(uint64_t value)
+{
+	value ^= value >> 30;
+	value *= 0xbf58476d1ce4e5b9ULL;
+	value ^= value >> 27;
+	value *= 0x94d049bb133111ebULL;
+	value ^= value >> 31;
+	return value;
+}
+
+/*
+	Function: repetitionTest()
+	Purpose: Test to see if two snapshots contain identical live cells
+	Arguments: Two pointers to the snapshots to compare (snapshot1 and snapshot2)
+	Return value: 0 if the snapshots contain different live cells.
+	              1 if the snapshots contain identical live cells.
+	Inputs from user: None.
+	Outputs to user: None.
+	Note: Snapshots with a different population or hash can't be identical, so are rejected without comparing any cells.
+ */
+int repetitionTest(const boardSnapshot *snapshot1, const boardSnapshot *snapshot2)
+{
+	if( (snapshot1->population != snapshot2->population) || (snapshot1->hash != snapshot2->hash) )
+		return 0;
+
+	/* The population and hash match, so compare the cells themselves to rule out a hash collision. */
+	return memcmp(snapshot1->cells, snapshot2->cells, snapshotWords * sizeof(uint64_t)) == 0;
+}
+
+/*
+	Function: allocateSnapshotRing()
+	Purpose: Allocate main()'s history of earlier generations. All the snapshot cells are allocated in one block.
+	Arguments: The ring to allocate (ring), the number of earlier generations to remember (depth),
+	           and the thread pool to share the tests with, or NULL to test on the calling thread alone (pool).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+void allocateSnapshotRing(snapshotRing *ring, int depth, threadPool *pool)
+{
+	int i;
+
+	ring->depth = depth;
+	ring->snapshots = (boardSnapshot *)allocateMemory( (depth + 1) * sizeof(boardSnapshot) );
+	ring->cells = (uint64_t *)allocateMemory( (depth + 1) * snapshotWords * sizeof(uint64_t) );
+	for(i = 0; i <= depth; i++)
+		ring->snapshots[i].cells = ring->cells + i * snapshotWords;
+
+	/* A snapshot row starts on a word boundary every 64 / gcd(width, 64) rows, so the bands are made of units of that many rows.
+	   A pool of one thread, or a small board, is never worth splitting. */
+	ring->pool = pool;
+	if( (pool != NULL) && (pool->noOfThreads > 1) )
+	{
+		ring->rowsPerUnit = 64;
+		while( (ring->rowsPerUnit > 1) && (boardWidth % (64 / ring->rowsPerUnit * 2) == 0) )
+			ring->rowsPerUnit /= 2;
+		ring->noOfUnits = (boardHeight + ring->rowsPerUnit - 1) / ring->rowsPerUnit;
+		ring->noOfBands = (ring->noOfUnits < 4 * pool->noOfThreads) ? ring->noOfUnits : 4 * pool->noOfThreads;
+		ring->noOfChunks = (snapshotWords + COMPARE_CHUNK_WORDS - 1) / COMPARE_CHUNK_WORDS;
+		ring->bandPopulations = (long *)allocateMemory(ring->noOfBands * sizeof(long));
+		ring->bandHashes = (uint64_t *)allocateMemory(ring->noOfBands * sizeof(uint64_t));
+		ring->candidates = (int *)allocateMemory(depth * sizeof(int));
+		ring->chunksLeft = (atomic_int *)allocateMemory(depth * sizeof(atomic_int));
+	}
+	else
+		ring->pool = NULL;
+	clearSnapshotRing(ring);
+	return;
+}
+
+/*
+	Function: clearSnapshotRing()
+	Purpose: Forget all the generations in a history.
+	Arguments: The ring (ring).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+void clearSnapshotRing(snapshotRing *ring)
+{
+	int i;
+
+	/* Mark every snapshot as unused, so that they aren't compared before they have been written to. */
+	for(i = 0; i <= ring->depth; i++)
+		ring->snapshots[i].used = 0;
+	ring->current = 0;
+	return;
+}
+
+/*
+	Function: freeSnapshotRing()
+	Purpose: Free main()'s history of earlier generations, if it was allocated.
+	Arguments: The ring (ring).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+void freeSnapshotRing(snapshotRing *ring)
+{
+	if(ring->snapshots == NULL)
+		return;
+	if(ring->pool != NULL)
+	{
+		freeMemory(ring->chunksLeft);
+		freeMemory(ring->candidates);
+		freeMemory(ring->bandHashes);
+		freeMemory(ring->bandPopulations);
+	}
+	freeMemory(ring->cells);
+	freeMemory(ring->snapshots);
+	ring->snapshots = NULL;
+	return;
+}
+
+/*
+	Function: findSnapshotPeriod()
+	Purpose: Remember the current board in a history, and test it against the earlier generations, most recent first.
+	Arguments: The ring (ring), and the current board (board).
+	Return value: The smallest period if the board is the same as one of the last depth generations, or 0 if it isn't.
+	Inputs from user: None.
+	Outputs to user: None.
+	Note: With a thread pool, a large board's snapshot is taken in bands by the pool, and the earlier snapshots with the same population and hash
+	      are compared a chunk at a time by the pool. The period is the same as with one thread, whichever order the tasks run in.
+ */
+int findSnapshotPeriod(snapshotRing *ring, const boardPlanes *board)
+{
+	int j, period = 0;
+	/* Snapshot to compare counter stores the current snapshots[] array index of the snapshot to compare to the current one */
+	int snapshotToCompareCounter;
+	boardSnapshot *current = &ring->snapshots[ring->current];
+	int parallel = (ring->pool != NULL) && (snapshotWords >= PARALLEL_SNAPSHOT_WORDS);
+
+	/* Take a snapshot of the current board, so that it can be compared to the previous ones now, and to the following ones later. */
+	if(parallel)
+	{
+		ring->board = board;
+		runPoolTasks(ring->pool, ring->noOfBands, takeSnapshotBand, ring);
+		current->population = 0;
+		current->hash = 0;
+		for(j = 0; j < ring->noOfBands; j++)
+		{
+			current->population += ring->bandPopulations[j];
+			current->hash += ring->bandHashes[j];
+		}
+		current->used = 1;
+	}
+	else
+		takeSnapshot(board, current);
+
+	/* Test all the relevant snapshots, most recent first, to see if any of them are identical to the current board.
+	   With the pool, only the population and hash are tested here, and the snapshots that pass are compared by the pool below. */
+	ring->noOfCandidates = 0;
+	snapshotToCompareCounter = ring->current;
+	for(j = 1; j <= ring->depth; j++)
+	{
+		snapshotToCompareCounter == 0? snapshotToCompareCounter = ring->depth : snapshotToCompareCounter--;
+		if(!ring->snapshots[snapshotToCompareCounter].used)
+			break;
+
+		if(parallel)
+		{
+			if( (current->population == ring->snapshots[snapshotToCompareCounter].population) && (current->hash == ring->snapshots[snapshotToCompareCounter].hash) )
+				ring->candidates[ring->noOfCandidates++] = j;
+		}
+		else if(repetitionTest(current, &ring->snapshots[snapshotToCompareCounter]))
+		{
+			period = j;
+			break;
+		}
+	}
+
+	if(ring->noOfCandidates > 0)
+	{
+		for(j = 0; j < ring->noOfCandidates; j++)
+			atomic_init(&ring->chunksLeft[j], ring->noOfChunks);
+		atomic_init(&ring->period, INT_MAX);
+		runPoolTasks(ring->pool, ring->noOfCandidates * ring->noOfChunks, compareSnapshotChunk, ring);
+		period = atomic_load(&ring->period);
+		if(period == INT_MAX)
+			period = 0;
+	}
+
+	/* The snapshot just taken becomes the previous generation, so the next snapshot goes in the following slot. */
+	ring->current == ring->depth? ring->current = 0 : ring->current++;
+	return period;
+}
+
+/*
+	Function: compareSnapshotChunk()
+	Purpose: A task for the thread pool: compare one chunk of the current snapshot of a history with the same chunk of one of the candidates,
+	         and make the candidate's period the one found if it is the last of its chunks to match and no smaller period has been found.
+	Arguments: The history (context), and the number of the task (task), which is the candidate's index times the no. of chunks plus the chunk's.
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+	Note: A candidate is cancelled, by setting its no. of chunks left to 0, as soon as one of its chunks doesn't match,
+	      and its remaining chunks are skipped, as are the chunks of any candidate with a larger period than one already found.
+	      A candidate can only be found once all of its chunks have matched, so the smallest period is found whatever the order of the tasks.
+ */
+void compareSnapshotChunk(void *context, int task)
+{
+	snapshotRing *ring = (snapshotRing *)context;
+	int candidate = task / ring->noOfChunks;
+	int candidatePeriod = ring->candidates[candidate];
+
+	if( (atomic_load(&ring->chunksLeft[candidate]) <= 0) || (atomic_load(&ring->period) < candidatePeriod) )
+		return;
+
+	/* The candidates are candidatePeriod generations before the current snapshot */
+	long firstWord = (long)(task % ring->noOfChunks) * COMPARE_CHUNK_WORDS;
+	long noOfWords = (snapshotWords - firstWord < COMPARE_CHUNK_WORDS) ? snapshotWords - firstWord : COMPARE_CHUNK_WORDS;
+	const uint64_t *currentCells = ring->snapshots[ring->current].cells;
+	const uint64_t *earlierCells = ring->snapshots[(ring->current + ring->depth + 1 - candidatePeriod) % (ring->depth + 1)].cells;
+
+	if(memcmp(currentCells + firstWord, earlierCells + firstWord, noOfWords * sizeof(uint64_t)) != 0)
+	{
+		atomic_store(&ring->chunksLeft[candidate], 0);
+		return;
+	}
+
+	/* The last chunk of the candidate to match records its period, unless a smaller one is already recorded */
+	if(atomic_fetch_sub(&ring->chunksLeft[candidate], 1) == 1)
+	{
+		int found = atomic_load(&ring->period);
+		while( (candidatePeriod < found) && !atomic_compare_exchange_weak(&ring->period, &found, candidatePeriod) )
+			;
+	}
+	return;
+}
+
+/*
+	Function: startStatistics()
+	Purpose: Empty the statistics of a board, ready for its rows to be added with addRowToStatistics().
+	Arguments: The statistics (statistics), and the width and height of the board (width and height).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+void startStatistics(boardStatistics *statistics, int width, int height)
+{
+	statistics->population = statistics->births = statistics->deaths = 0;
+	statistics->left = width;
+	statistics->top = height;
+	statistics->right = statistics->bottom = -1;
+	return;
+}
+
+/*
+	Function: addRowToStatistics()
+	Purpose: Add a row of a board to the board's statistics: its live cells to the population and bounding box,
+	         and, if the row's previous generation is given, the cells born.
+	Arguments: The live cells of the row (live), its live cells in the previous generation, or NULL (previousLive),
+	           the number of words in the row (words), the row (row), and the statistics (statistics).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+	Note: The deaths aren't counted, as they are whatever else is needed to get from the previous population to this one.
+ */
+inline void addRowToStatistics(const uint64_t *live, const uint64_t *previousLive, int words, int row, boardStatistics *statistics)
+{
+	int firstWord, lastWord, column;
+
+	/* The first and last words with live cells are found from either end, so an empty row is read once and a full one hardly at all */
+	for(firstWord = 0; (firstWord < words) && (live[firstWord] == 0); firstWord++)
+		;
+	if(firstWord == words)
+		return;
+	for(lastWord = words - 1; live[lastWord] == 0; lastWord--)
+		;
+
+	statistics->population += countRowBits(live + firstWord, NULL, lastWord - firstWord + 1);
+	if(previousLive != NULL)
+		statistics->births += countRowBits(live + firstWord, previousLive + firstWord, lastWord - firstWord + 1);
+
+	if(row < statistics->top)
+		statistics->top = row;
+	if(row > statistics->bottom)
+		statistics->bottom = row;
+	column = 64 * firstWord + countTrailingZeros(live[firstWord]);
+	if(column < statistics->left)
+		statistics->left = column;
+	column = 64 * lastWord + 63 - countLeadingZeros(live[lastWord]);
+	if(column > statistics->right)
+		statistics->right = column;
+	return;
+}
+
+/*
+	Function: mergeStatistics()
+	Purpose: Add the statistics of part of a board, worked out separately, to the board's statistics.
+	Arguments: The statistics of the board (statistics), and of the part (part).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+void mergeStatistics(boardStatistics *statistics, const boardStatistics *part)
+{
+	statistics->population += part->population;
+	statistics->births += part->births;
+	statistics->deaths += part->deaths;
+	if(part->population == 0)
+		return;
+	if(part->left < statistics->left)
+		statistics->left = part->left;
+	if(part->top < statistics->top)
+		statistics->top = part->top;
+	if(part->right > statistics->right)
+		statistics->right = part->right;
+	if(part->bottom > statistics->bottom)
+		statistics->bottom = part->bottom;
+	return;
+}
+
+/*
+	Function: countRowBits()
+	Purpose: Count the set bits in a run of words, leaving out the bits that are set in another run of words if it is given
+	         (e.g. the live cells of a row that weren't alive in the generation before).
+	Arguments: The words to count (bits), the words whose bits are left out, or NULL (excluded), and the number of words (words).
+	Return value: The number of bits.
+	Inputs from user: None.
+	Outputs to user: None.
+	Note: This adds up the bits of each byte of the words in parallel, only adding the bytes together every 31 words (before any can overflow),
+	      which is several times faster than counting each word with countBits() unless the processor has an instruction for it.
+	      The bytes can hold up to 248 by then, so they are added in pairs first, as their total could overflow a byte.
+ */
+inline long countRowBits(const uint64_t *bits, const uint64_t *excluded, int words)
+{
+	uint64_t word, byteSums = 0;
+	long count = 0;
+	int i;
+
+	for(i = 0; i < words; i++)
+	{
+		word = (excluded != NULL) ? bits[i] & ~excluded[i] : bits[i];
+		word = word - ( (word >> 1) & 0x5555555555555555ULL );
+		word = (word & 0x3333333333333333ULL) + ( (word >> 2) & 0x3333333333333333ULL );
+		byteSums += (word + (word >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+		if( (i % 31 == 30) || (i == words - 1) )
+		{
+			byteSums = (byteSums & 0x00FF00FF00FF00FFULL) + ( (byteSums >> 8) & 0x00FF00FF00FF00FFULL );
+			count += (long)( (byteSums * 0x0001000100010001ULL) >> 48 );
+			byteSums = 0;
+		}
+	}
+	return count;
+}
+
+/*
+	Function: scanBoardStatistics()
+	Purpose: Find the statistics of a board from the board itself, for engines that don't keep them.
+	Arguments: The board (board), its generation (generation), the population of the generation before (previousPopulation),
+	           and where to write the statistics (statistics).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+	Note: Only cells that have just been born have an age of 0, so the births are found from the age plane without the previous board.
+	      Generation 0 has no births or deaths, its cells weren't born, they were read from the file.
+ */
+void scanBoardStatistics(const boardPlanes *board, long generation, long previousPopulation, boardStatistics *statistics)
+{
+	int row, word;
+	const uint64_t *live, *ages;
+	uint64_t liveCells, oldCells;
+
+	startStatistics(statistics, board->width, board->height);
+	for(row = 0; row < board->height; row++)
+	{
+		live = board->live + (size_t)row * board->liveWordsPerRow;
+		ages = board->ages + (size_t)row * board->ageWordsPerRow;
+		addRowToStatistics(live, NULL, board->liveWordsPerRow, row, statistics);
+		if(generation == 0)
+			continue;
+
+		/* A nibble with any bit set is a cell older than 0, so the live cells without one are the ones just born */
+		for(word = 0; word < board->ageWordsPerRow; word++)
+		{
+			liveCells = spreadToNibbles( (live[word / 4] >> (16 * (word % 4))) & 0xFFFF );
+			if(liveCells == 0)
+				continue;
+			oldCells = (ages[word] | (ages[word] >> 1) | (ages[word] >> 2) | (ages[word] >> 3)) & 0x1111111111111111ULL;
+			statistics->births += countBits(liveCells & ~oldCells);
+		}
+	}
+	if(generation > 0)
+		statistics->deaths = previousPopulation + statistics->births - statistics->population;
+	return;
+}
+
+/*
+	Function: allocateSpaceshipTracker()
+	Purpose: Allocate a spaceship tracker, which remembers the patterns of the last few generations.
+	Arguments: The tracker (tracker), and the most generations a pattern can take to move (depth).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+	Note: The patterns are only reserved in the arena, so a slot's pages are only used once a pattern as big as them is packed into it.
+ */
+void allocateSpaceshipTracker(spaceshipTracker *tracker, int depth)
+{
+	tracker->depth = depth;
+	tracker->patternWords = trackerPatternWords(boardWidth, boardHeight);
+	tracker->statistics = (boardStatistics *)allocateMemory( (depth + 1) * sizeof(boardStatistics) );
+	tracker->packed = (unsigned char *)allocateMemory(depth + 1);
+	tracker->hashes = (uint64_t *)allocateMemory( (depth + 1) * sizeof(uint64_t) );
+	tracker->patterns = (uint64_t *)allocateMemory( (depth + 1) * tracker->patternWords * sizeof(uint64_t) );
+	memset(tracker->packed, 0, depth + 1);
+	tracker->reportedPeriod = 0;
+	tracker->reportedColumns = tracker->reportedRows = 0;
+	return;
+}
+
+/*
+	Function: freeSpaceshipTracker()
+	Purpose: Free a spaceship tracker.
+	Arguments: The tracker (tracker).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+void freeSpaceshipTracker(spaceshipTracker *tracker)
+{
+	freeMemory(tracker->statistics);
+	freeMemory(tracker->packed);
+	freeMemory(tracker->hashes);
+	freeMemory(tracker->patterns);
+	return;
+}
+
+/*
+	Function: trackerPatternWords()
+	Purpose: Find the number of words the spaceship tracker keeps for each pattern on a board.
+	Arguments: The width and height of the board (width and height).
+	Return value: The number of words.
+	Inputs from user: None.
+	Outputs to user: None.
+	Note: A pattern's bounding box is never bigger than the board, and one with more than MAX_PATTERN_CELLS cells isn't packed.
+ */
+size_t trackerPatternWords(int width, int height)
+{
+	double cells = (double)width * height;
+
+	return (size_t)( ( (cells < MAX_PATTERN_CELLS) ? (long)cells : MAX_PATTERN_CELLS ) + 63 ) / 64;
+}
+
+/*
+	Function: trackBoard()
+	Purpose: Report the statistics of a generation, then normalize its pattern to its bounding box,
+	         and compare it with the patterns of the earlier generations to find out if it is moving (a spaceship).
+	Arguments: The tracker (tracker), the engine the generation is on (engine), its statistics (statistics) and its generation (generation).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: A line on stderr giving the generation's statistics,
+	                 and another giving the pattern's speed when it is first seen to move, or starts to move in another way.
+	Note: Patterns that are the same in the same place are left to the test for repetition, which stops the program.
+	      A pattern is only packed once an earlier generation has the same population and size of bounding box, so the first generation
+	      of a spaceship isn't packed, and the spaceship is recognized up to a period later than it would be if every pattern were.
+ */
+void trackBoard(spaceshipTracker *tracker, lifeEngine *engine, const boardStatistics *statistics, long generation)
+{
+	int slot = (int)(generation % (tracker->depth + 1)), earlier, j, columns, rows, sameSize = 0;
+	uint64_t *pattern = tracker->patterns + slot * tracker->patternWords;
+	const boardStatistics *previous;
+	size_t noOfWords = 0, i;
+	uint64_t hash = 0;
+
+	if(statistics->population == 0)
+		fprintf(stderr, "Generation %ld: population 0, births %ld, deaths %ld, no live cells\n",
+		        generation, statistics->births, statistics->deaths);
+	else
+		fprintf(stderr, "Generation %ld: population %ld, births %ld, deaths %ld, rows %d to %d, columns %d to %d\n",
+		        generation, statistics->population, statistics->births, statistics->deaths,
+		        statistics->top, statistics->bottom, statistics->left, statistics->right);
+
+	/* Without any earlier generations to compare with, there is no need to keep the pattern */
+	tracker->statistics[slot] = *statistics;
+	tracker->packed[slot] = 0;
+	if( (tracker->depth == 0) || (statistics->population == 0)
+	    || ( (double)(statistics->right - statistics->left + 1) * (statistics->bottom - statistics->top + 1) > MAX_PATTERN_CELLS ) )
+		return;
+
+	/* Nor if no earlier generation has the same population and size of box, which most generations of a pattern that isn't a spaceship don't */
+	for(j = 1; (j <= tracker->depth) && (j <= generation) && !sameSize; j++)
+	{
+		previous = &tracker->statistics[(generation - j) % (tracker->depth + 1)];
+		sameSize = (previous->population == statistics->population)
+		           && (previous->right - previous->left == statistics->right - statistics->left)
+		           && (previous->bottom - previous->top == statistics->bottom - statistics->top);
+	}
+	if(!sameSize)
+		return;
+
+	noOfWords = packPattern(engine, statistics, pattern);
+	for(i = 0; i < noOfWords; i++)
+		if(pattern[i] != 0)
+			hash += mixBits(pattern[i] ^ mixBits(i));
+	tracker->hashes[slot] = hash;
+	tracker->packed[slot] = 1;
+
+	/* The most recent earlier generation with the same pattern somewhere else gives the period and the distance moved */
+	for(j = 1; (j <= tracker->depth) && (j <= generation); j++)
+	{
+		earlier = (int)( (generation - j) % (tracker->depth + 1) );
+		previous = &tracker->statistics[earlier];
+		columns = statistics->left - previous->left;
+		rows = statistics->top - previous->top;
+		if( !tracker->packed[earlier] || (previous->population != statistics->population) || (tracker->hashes[earlier] != hash)
+		    || ( (columns == 0) && (rows == 0) )
+		    || (previous->right - previous->left != statistics->right - statistics->left)
+		    || (previous->bottom - previous->top != statistics->bottom - statistics->top)
+		    || (memcmp(tracker->patterns + earlier * tracker->patternWords, pattern, noOfWords * sizeof(uint64_t)) != 0) )
+			continue;
+
+		if( (j != tracker->reportedPeriod) || (columns != tracker->reportedColumns) || (rows != tracker->reportedRows) )
+		{
+			fprintf(stderr, "Generation %ld: spaceship detected, moving %d columns and %d rows every %d generations, a speed of (%d, %d)/%d\n",
+			        generation, columns, rows, j, columns, rows, j);
+			tracker->reportedPeriod = j;
+			tracker->reportedColumns = columns;
+			tracker->reportedRows = rows;
+		}
+		return;
+	}
+	return;
+}
+
+/*
+	Function: packPattern()
+	Purpose: Pack the cells inside the bounding box of a board one bit per cell, each row of the box straight after the one before,
+	         so that the same pattern packs the same wherever it is on the board.
+	Arguments: The engine the board is on (engine), its statistics, which give the bounding box (statistics), and where to write the cells (cells).
+	Return value: The number of words written.
+	Inputs from user: None.
+	Outputs to user: None.
+	Note: An engine that can visit the cells in the box is asked for them, so that the whole board isn't made just to read the box.
+ */
+size_t packPattern(lifeEngine *engine, const boardStatistics *statistics, uint64_t *cells)
+{
+	int boxWidth = statistics->right - statistics->left + 1;
+	int row, offset, noOfBits, start, shift;
+	const boardPlanes *board;
+	const uint64_t *live;
+	uint64_t bits;
+	size_t bit = 0;
+
+	if(engine->type->visitCells != NULL)
+	{
+		patternPacker packer = {cells, statistics->top, statistics->left, boxWidth};
+		bit = (size_t)boxWidth * (statistics->bottom - statistics->top + 1);
+		memset(cells, 0, (bit + 63) / 64 * sizeof(uint64_t));
+		engine->type->visitCells(engine, statistics->top, statistics->left, statistics->bottom, statistics->right, packPatternCell, &packer);
+		return (bit + 63) / 64;
+	}
+
+	board = engine->type->view(engine);
+	for(row = statistics->top; row <= statistics->bottom; row++)
+	{
+		live = board->live + (size_t)row * board->liveWordsPerRow;
+		for(offset = 0; offset < boxWidth; offset += 64)
+		{
+			/* Read up to 64 cells of the row, which may straddle two words */
+			noOfBits = (boxWidth - offset < 64) ? boxWidth - offset : 64;
+			start = statistics->left + offset;
+			shift = start % 64;
+			bits = live[start / 64] >> shift;
+			if( (shift != 0) && (shift + noOfBits > 64) )
+				bits |= live[start / 64 + 1] << (64 - shift);
+			if(noOfBits < 64)
+				bits &= ( (uint64_t)1 << noOfBits ) - 1;
+
+			/* and write them after the cells already packed, which may also straddle two words */
+			shift = bit % 64;
+			if(shift == 0)
+				cells[bit / 64] = bits;
+			else
+			{
+				cells[bit / 64] |= bits << shift;
+				if(shift + noOfBits > 64)
+					cells[bit / 64 + 1] = bits >> (64 - shift);
+			}
+			bit += noOfBits;
+		}
+	}
+	return (bit + 63) / 64;
+}
+
+/*
+	Function: packPatternCell()
+	Purpose: Set the bit of a live cell passed by an engine's visitCells() in the pattern that packPattern() is packing.
+	Arguments: The packer (context), the cell's row and column (row and column), and its age, which isn't needed (age).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+void packPatternCell(void *context, int row, int column, int age)
+{
+	patternPacker *packer = (patternPacker *)context;
+	size_t bit = (size_t)(row - packer->top) * packer->boxWidth + (column - packer->left);
+
+	(void)age;
+	packer->cells[bit / 64] |= (uint64_t)1 << (bit % 64);
+	return;
+}
+
+/*
+	Function: adaptEngine()
+	Purpose: The adaptive controller: measure the board, estimate what each engine would cost for it,
+	         and move the board to another engine if that would be much faster.
+	Arguments: The current engine (engine), the generation it is on (generation), the command line settings (options),
+	           and main()'s history of earlier generations (ring).
+	Return value: The engine to use from now on, which is the same engine unless the board was moved.
+	Inputs from user: None.
+	Outputs to user: A line on stderr for each move, giving the generation, the engines and the measurements that led to it.
+ */
+lifeEngine *adaptEngine(lifeEngine *engine, long generation, const engineOptions *options, snapshotRing *ring)
+{
+	const engineType **type, *bestType = engine->type;
+	double area = (double)engine->width * engine->height;
+	double currentCost, bestCost, cost;
+	long population, changed;
+
+	if(engine->type->measure == NULL)
+		return engine;
+	engine->type->measure(engine, &population, &changed);
+
+	currentCost = bestCost = engine->type->estimateCost(area, population, changed);
+	for(type = engineTypes; *type != NULL; type++)
+	{
+		if( ((*type)->estimateCost == NULL) || (*type == engine->type) )
+			continue;
+		cost = (*type)->estimateCost(area, population, changed);
+		if( (cost < SWITCH_MARGIN * currentCost) && (cost < bestCost) )
+		{
+			bestType = *type;
+			bestCost = cost;
+		}
+	}
+
+	if(bestType == engine->type)
+		return engine;
+
+	fprintf(stderr, "Generation %ld: switching from the %s engine to the %s engine "
+	                "(%ld live cells, %.2f%% of cells changed, estimated %.0f ns per generation instead of %.0f ns)\n",
+	        generation, engine->type->name, bestType->name, population, (area > 0) ? 100.0 * changed / area : 0.0, bestCost, currentCost);
+	return switchEngine(engine, bestType, options, ring);
+}
+
+/*
+	Function: switchEngine()
+	Purpose: Move the board, and the earlier generations needed to test for repetition, to a new engine.
+	Arguments: The current engine (engine), which is destroyed, the type of the new engine (newType),
+	           the command line settings (options), and main()'s history of earlier generations (ring).
+	Return value: The new engine.
+	Inputs from user: None.
+	Outputs to user: None.
+	Note: This must be called between generations, once the last one has been tested for repetition.
+	      The earlier generations are given to the new engine's history in order, as if it had calculated them,
+	      so that a period is found on the same generation whichever engine is in use.
+ */
+lifeEngine *switchEngine(lifeEngine *engine, const engineType *newType, const engineOptions *options, snapshotRing *ring)
+{
+	cellList currentCells;
+	int noOfEarlier = 0, j, slot;
+
+	/* The lists are made in the scratch arena, so that the engine arena can be emptied for the new engine */
+	selectArena(&scratchArena);
+	cellList *earlier = (cellList *)allocateMemory(options->historyDepth * sizeof(cellList));
+
+	/* Collect the earlier generations, oldest first, from whichever history the old engine used */
+	if(engine->type->findPeriod != NULL)
+		noOfEarlier = engine->type->recallHistory(engine, earlier);
+	else
+	{
+		boardPlanes planes;
+		allocatePlanes(&planes, engine->width, engine->height);
+		while( (noOfEarlier < ring->depth) && ring->snapshots[(ring->current + ring->depth - noOfEarlier) % (ring->depth + 1)].used )
+			noOfEarlier++;
+		for(j = 0; j < noOfEarlier; j++)
+		{
+			slot = (ring->current + ring->depth + 1 - noOfEarlier + j) % (ring->depth + 1);
+			unpackSnapshot(&ring->snapshots[slot], &planes);
+			planesToCells(&planes, &earlier[j]);
+		}
+		freePlanes(&planes);
+	}
+	planesToCells(engine->type->view(engine), &currentCells);
+	engine->type->destroy(engine);
+	emptyArena(&engineArena);
+
+	/* Give the earlier generations to the new engine's history, then load the current board */
+	selectArena(&engineArena);
+	engine = newType->create(boardWidth, boardHeight, options);
+	if(newType->findPeriod != NULL)
+	{
+		for(j = 0; j < noOfEarlier; j++)
+		{
+			engine->type->load(engine, &earlier[j]);
+			engine->type->findPeriod(engine);
+		}
+	}
+	else
+	{
+		/* main()'s history is allocated the first time the board moves to an engine that needs it, in the room main() reserved for it */
+		if(ring->snapshots == NULL)
+		{
+			selectArena(&mainArena);
+			allocateSnapshotRing(ring, ring->depth, ring->pool);
+			selectArena(&engineArena);
+		}
+		clearSnapshotRing(ring);
+
+		boardPlanes planes;
+		selectArena(&scratchArena);
+		allocatePlanes(&planes, boardWidth, boardHeight);
+		for(j = 0; j < noOfEarlier; j++)
+		{
+			fillPlanes(&planes, &earlier[j]);
+			findSnapshotPeriod(ring, &planes);
+		}
+		freePlanes(&planes);
+		selectArena(&engineArena);
+	}
+	engine->type->load(engine, &currentCells);
+
+	for(j = 0; j < noOfEarlier; j++)
+		freeCells(&earlier[j]);
+	freeMemory(earlier);
+	freeCells(&currentCells);
+	emptyArena(&scratchArena);
+	return engine;
+}
+
+/*
+	Function: allocateMemory()
+	Purpose: Allocate memory from the active arena, or from the heap if there isn't one, and exit the program if it can't be allocated.
+	Arguments: The number of bytes to allocate (size).
+	Return value: A pointer to the allocated memory, which is set to zero.
+	Inputs from user: None.
+	Outputs to user: An error message if the memory can't be allocated.
+ */
+void *allocateMemory(size_t size)
+{
+	/* At least one byte is allocated, so that a NULL return is always an error, and every allocation is a different pointer. */
+	if(size == 0)
+		size = 1;
+
+	if(activeArena != NULL)
+	{
+		/* The arena's memory is already zero, since it is only ever reused once it has been zeroed again */
+		size_t blockSize = (size + ARENA_ALIGNMENT - 1) / ARENA_ALIGNMENT * ARENA_ALIGNMENT;
+		if(blockSize + ARENA_ALIGNMENT > activeArena->size - activeArena->used)
+		{
+			fputs("Memory arena full.\n"
+			      "The board needs more memory than was reserved for it when the program started.\n"
+			      "The program will now exit.\n", stderr);
+			exit(EXIT_FAILURE);
+		}
+
+		unsigned char *header = activeArena->base + activeArena->used;
+		*(size_t *)header = blockSize;
+		activeArena->used += ARENA_ALIGNMENT + blockSize;
+		return header + ARENA_ALIGNMENT;
+	}
+
+	/* calloc() is used so that the memory starts full of zeros, which is an empty board for the bit planes. */
+	void *memory = calloc(size, 1);
+	if(memory == NULL)
+	{
+		fputs("Memory allocation error.\n"
+		      "The program will now exit.\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+	return memory;
+}
+
+/*
+	Function: resizeMemory()
+	Purpose: Change the size of an allocation, keeping its contents, and exit the program if it can't be resized.
+	Arguments: The memory to resize (memory), which may be NULL for a new allocation,
+	           its current size in bytes (oldSize), and the size it is needed to be (newSize).
+	Return value: A pointer to the resized memory, which may have moved. Any new bytes are set to zero if the memory is in an arena.
+	Inputs from user: None.
+	Outputs to user: An error message if the memory can't be resized.
+	Note: Memory in an arena is always moved to a new allocation, unless it is the last allocation in the arena and there is room for it to grow.
+ */
+void *resizeMemory(void *memory, size_t oldSize, size_t newSize)
+{
+	memoryArena *arena = NULL;
+	if( (memory != NULL) && (mainArena.base != NULL) )
+	{
+		if( ( (unsigned char *)memory >= engineArena.base ) && ( (unsigned char *)memory < engineArena.base + engineArena.size ) )
+			arena = &engineArena;
+		else if( ( (unsigned char *)memory >= scratchArena.base ) && ( (unsigned char *)memory < scratchArena.base + scratchArena.size ) )
+			arena = &scratchArena;
+		else if( ( (unsigned char *)memory >= mainArena.base ) && ( (unsigned char *)memory < mainArena.base + mainArena.size ) )
+			arena = &mainArena;
+	}
+
+	if( (arena == NULL) && ( (memory != NULL) || (activeArena == NULL) ) )
+	{
+		memory = realloc(memory, newSize > 0 ? newSize : 1);
+		if(memory == NULL)
+		{
+			fputs("Memory allocation error.\n"
+			      "The program will now exit.\n", stderr);
+			exit(EXIT_FAILURE);
+		}
+		return memory;
+	}
+
+	if(arena != NULL)
+	{
+		unsigned char *header = (unsigned char *)memory - ARENA_ALIGNMENT;
+		size_t blockSize = *(size_t *)header;
+		size_t newBlockSize = (newSize + ARENA_ALIGNMENT - 1) / ARENA_ALIGNMENT * ARENA_ALIGNMENT;
+		if( (header + ARENA_ALIGNMENT + blockSize == arena->base + arena->used) && (newBlockSize <= arena->size - (header + ARENA_ALIGNMENT - arena->base)) )
+		{
+			if(newBlockSize > blockSize)
+			{
+				*(size_t *)header = newBlockSize;
+				arena->used += newBlockSize - blockSize;
+			}
+			return memory;
+		}
+	}
+
+	void *newMemory = allocateMemory(newSize);
+	if(memory != NULL)
+	{
+		memcpy(newMemory, memory, oldSize < newSize ? oldSize : newSize);
+		freeMemory(memory);
+	}
+	return newMemory;
+}
+
+/*
+	Function: freeMemory()
+	Purpose: Free memory from allocateMemory() or resizeMemory(), whether it came from an arena or the heap.
+	Arguments: The memory to free (memory), which may be NULL.
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+	Note: The pages that only hold this allocation are given back to the system, but the arena can only reuse them if it was the last allocation.
+ */
+void freeMemory(void *memory)
+{
+	memoryArena *arenas[3] = {&engineArena, &scratchArena, &mainArena};
+	unsigned char *header;
+	size_t blockSize;
+	int i;
+
+	if(memory == NULL)
+		return;
+
+	for(i = 0; i < 3; i++)
+	{
+		if( (arenas[i]->base == NULL) || ( (unsigned char *)memory < arenas[i]->base ) || ( (unsigned char *)memory >= arenas[i]->base + arenas[i]->size ) )
+			continue;
+
+		header = (unsigned char *)memory - ARENA_ALIGNMENT;
+		blockSize = *(size_t *)header;
+		zeroArenaRange(header, header + ARENA_ALIGNMENT + blockSize);
+		if(header + ARENA_ALIGNMENT + blockSize == arenas[i]->base + arenas[i]->used)
+			arenas[i]->used = header - arenas[i]->base;
+		return;
+	}
+
+	free(memory);
+	return;
+}
+
+/*
+	Function: openArenas()
+	Purpose: Reserve the memory for the main, engine and scratch arenas, and make the main arena the active one.
+	Arguments: The estimated number of bytes needed in each arena (mainSize, engineSize and scratchSize).
+	Return value: 1 if the arenas were reserved, 0 if they couldn't be, in which case nothing is reserved and memory keeps being allocated from the heap.
+	Inputs from user: None.
+	Outputs to user: None.
+	Note: The memory is reserved without being committed, so the system only provides the pages that are used,
+	      and an arena's size can be a generous estimate at no cost.
+ */
+int openArenas(double mainSize, double engineSize, double scratchSize)
+{
+	size_t pageSize = (size_t)sysconf(_SC_PAGESIZE);
+	double sizes[3] = {mainSize + ARENA_SLACK, engineSize + ARENA_SLACK, scratchSize + ARENA_SLACK};
+	memoryArena *arenas[3] = {&mainArena, &engineArena, &scratchArena};
+	size_t roundedSizes[3], total = 0;
+	int i;
+
+	if(sizes[0] + sizes[1] + sizes[2] > MAX_ARENA_SIZE)
+		return 0;
+
+	/* Each arena starts on a page boundary, so that emptying one never touches the pages of another */
+	for(i = 0; i < 3; i++)
+	{
+		roundedSizes[i] = ( (size_t)sizes[i] + pageSize - 1 ) / pageSize * pageSize;
+		total += roundedSizes[i];
+	}
+
+	unsigned char *memory = (unsigned char *)mmap(NULL, total, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+	if(memory == MAP_FAILED)
+		return 0;
+
+	for(i = 0; i < 3; i++)
+	{
+		arenas[i]->base = memory;
+		arenas[i]->size = roundedSizes[i];
+		arenas[i]->used = 0;
+		memory += roundedSizes[i];
+	}
+	activeArena = &mainArena;
+	return 1;
+}
+
+/*
+	Function: selectArena()
+	Purpose: Make an arena the one that allocateMemory() uses, unless the arenas couldn't be reserved.
+	Arguments: The arena to use (arena).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+void selectArena(memoryArena *arena)
+{
+	if(activeArena != NULL)
+		activeArena = arena;
+	return;
+}
+
+/*
+	Function: emptyArena()
+	Purpose: Free everything allocated in an arena at once, so that it can be used again from the start.
+	Arguments: The arena to empty (arena).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+void emptyArena(memoryArena *arena)
+{
+	if(arena->base == NULL)
+		return;
+	zeroArenaRange(arena->base, arena->base + arena->used);
+	arena->used = 0;
+	return;
+}
+
+/*
+	Function: zeroArenaRange()
+	Purpose: Set a range of an arena back to zero, giving the whole pages in it back to the system.
+	Arguments: The start and end of the range (start and end).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+	Note: The system provides zeroed pages when they are next used, so the whole pages don't need to be cleared here.
+ */
+void zeroArenaRange(unsigned char *start, unsigned char *end)
+{
+	size_t pageSize = (size_t)sysconf(_SC_PAGESIZE);
+	unsigned char *firstPage = (unsigned char *)( ( (uintptr_t)start + pageSize - 1 ) / pageSize * pageSize );
+	unsigned char *lastPage = (unsigned char *)( (uintptr_t)end / pageSize * pageSize );
+
+	if(firstPage >= lastPage)
+	{
+		memset(start, 0, end - start);
+		return;
+	}
+
+	memset(start, 0, firstPage - start);
+	if(madvise(firstPage, lastPage - firstPage, MADV_DONTNEED) != 0)
+		memset(firstPage, 0, lastPage - firstPage);
+	memset(lastPage, 0, end - lastPage);
+	return;
+}
+
+/*
+	Function: planesSize()
+	Purpose: Calculate the memory needed for the live and age planes of a board, for estimating the size of the arenas.
+	Arguments: The width and height of the board (width and height).
+	Return value: The number of bytes, including the arena headers.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+double planesSize(int width, int height)
+{
+	return (double)height * ( ( (long)width + 63 ) / 64 + ( (long)width + 15 ) / 16 ) * sizeof(uint64_t) + 4 * ARENA_ALIGNMENT;
+}
+
+#ifdef CHECK_ALLOCATIONS
+/* With CHECK_ALLOCATIONS defined, malloc(), calloc() and realloc() are replaced for the whole program, including the C library,
+   by versions that abort the program if the heap is used once allocationsSealed is set.
+   They pass everything else on to glibc's own versions, so this only works with glibc. */
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t count, size_t size);
+extern void *__libc_realloc(void *memory, size_t size);
+
+/*
+	Function: checkHeapAllocation()
+	Purpose: Abort the program if the heap is used after it has finished starting up.
+	Arguments: None.
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: An error message if the heap is used after start up.
+ */
+void checkHeapAllocation(void)
+{
+	static const char message[] = "Heap allocation after start up.\n";
+	if(allocationsSealed)
+	{
+		/* write() is used since the stdio functions might allocate */
+		if(write(STDERR_FILENO, message, sizeof(message) - 1) < 0)
+			abort();
+		abort();
+	}
+	return;
+}
+
+void *malloc(size_t size)
+{
+	checkHeapAllocation();
+	return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size)
+{
+	checkHeapAllocation();
+	return __libc_calloc(count, size);
+}
+
+void *realloc(void *memory, size_t size)
+{
+	checkHeapAllocation();
+	return __libc_realloc(memory, size);
+}
+#endif
+
+/*
+	Function: allocatePlanes()
+	Purpose: Allocate the live and age planes for an empty board.
+	Arguments: The planes to allocate (planes), and the width and height of the board (width and height).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+void allocatePlanes(boardPlanes *planes, int width, int height)
+{
+	planes->width = width;
+	planes->height = height;
+	planes->liveWordsPerRow = (width + 63) / 64;
+	planes->ageWordsPerRow = (width + 15) / 16;
+	planes->live = (uint64_t *)allocateMemory( (size_t)height * planes->liveWordsPerRow * sizeof(uint64_t) );
+	planes->ages = (uint64_t *)allocateMemory( (size_t)height * planes->ageWordsPerRow * sizeof(uint64_t) );
+	return;
+}
+
+/*
+	Function: freePlanes()
+	Purpose: Free the memory used by a board's planes.
+	Arguments: The planes to free (planes).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+void freePlanes(boardPlanes *planes)
+{
+	freeMemory(planes->live);
+	freeMemory(planes->ages);
+	planes->live = planes->ages = NULL;
+	return;
+}
+
+/*
+	Function: fillPlanes()
+	Purpose: Set the cells of a board's planes from a list of live cells.
+	Arguments: The planes to fill (planes), and the live cells (cells).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+void fillPlanes(boardPlanes *planes, const cellList *cells)
+{
+	long i;
+
+	memset(planes->live, 0, (size_t)planes->height * planes->liveWordsPerRow * sizeof(uint64_t));
+	memset(planes->ages, 0, (size_t)planes->height * planes->ageWordsPerRow * sizeof(uint64_t));
+	for(i = 0; i < cells->noOfCells; i++)
+	{
+		planes->live[(size_t)cells->cells[i].row * planes->liveWordsPerRow + cells->cells[i].column / 64] |= (uint64_t)1 << (cells->cells[i].column % 64);
+		if(cells->ages != NULL)
+			planes->ages[(size_t)cells->cells[i].row * planes->ageWordsPerRow + cells->cells[i].column / 16] |= (uint64_t)cells->ages[i] << (4 * (cells->cells[i].column % 16));
+	}
+	return;
+}
+
+/*
+	Function: planesToCells()
+	Purpose: Make a list of the live cells of a board, with their ages, in row order.
+	Arguments: The planes to read (planes), and the list to write, which is allocated here (cells).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+void planesToCells(const boardPlanes *planes, cellList *cells)
+{
+	long population = 0, i = 0;
+	size_t word, noOfWords = (size_t)planes->height * planes->liveWordsPerRow;
+	uint64_t bits;
+	int column;
+
+	for(word = 0; word < noOfWords; word++)
+		population += countBits(planes->live[word]);
+
+	cells->noOfCells = population;
+	cells->cells = (coord *)allocateMemory(population * sizeof(coord));
+	cells->ages = (unsigned char *)allocateMemory(population);
+
+	for(word = 0; word < noOfWords; word++)
+		for(bits = planes->live[word]; bits != 0; bits &= bits - 1)
+		{
+			cells->cells[i].row = (int)(word / planes->liveWordsPerRow);
+			column = (int)(word % planes->liveWordsPerRow) * 64 + countTrailingZeros(bits);
+			cells->cells[i].column = column;
+			cells->ages[i] = (planes->ages[(size_t)cells->cells[i].row * planes->ageWordsPerRow + column / 16] >> (4 * (column % 16))) & 0xF;
+			i++;
+		}
+	return;
+}
+
+/*
+	Function: freeCells()
+	Purpose: Free a list of live cells.
+	Arguments: The list (cells).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+void freeCells(cellList *cells)
+{
+	freeMemory(cells->cells);
+	freeMemory(cells->ages);
+	return;
+}
+
+/*
+	Function: findEngineType()
+	Purpose: Find the engine with a given name.
+	Arguments: The name of the engine (name).
+	Return value: A pointer to the engine type, or NULL if there is no engine with that name.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+const engineType *findEngineType(const char *name)
+{
+	const engineType **type;
+	for(type = engineTypes; *type != NULL; type++)
+		if(strcmp((*type)->name, name) == 0)
+			return *type;
+	return NULL;
+}
+
+/*
+	Function: createCharEngine()
+	Purpose: Create an engine that uses the original character boards.
+	Arguments: The width and height of the board (width and height), which must be boardWidth and boardHeight,
+	           and the command line settings (options), which aren't used.
+	Return value: A pointer to the new engine.
+	Inputs from user: None.
+	Outputs to user: None.
+	Note: iterateBoard() uses the global board dimensions, so this engine can only be used for the board given to main().
+ */
+lifeEngine *createCharEngine(int width, int height, const engineOptions *options)
+{
+	(void)options;
+	charEngine *engine = (charEngine *)allocateMemory(sizeof(charEngine));
+	engine->base.type = &charEngineType;
+	engine->base.width = width;
+	engine->base.height = height;
+
+	/* Two boards are necessary so that the rules can be applied to one board, and the results saved in another.
+	   This method allows the rules to be applied to each cell simultaneously. */
+	engine->currentBoard = (char *)allocateMemory( (size_t)width * height * sizeof(char) );
+	engine->nextBoard = (char *)allocateMemory( (size_t)width * height * sizeof(char) );
+	allocatePlanes(&engine->planes, width, height);
+
+	return &engine->base;
+}
+
+/*
+	Function: loadCharEngine()
+	Purpose: Set the current board of a character engine, turning the live cells into their age characters.
+	Arguments: The engine (engine), and the live cells to load (cells).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+void loadCharEngine(lifeEngine *engine, const cellList *cells)
+{
+	charEngine *self = (charEngine *)engine;
+	char (*boardToWrite)[boardWidth] = ( char (*)[boardWidth] )self->currentBoard;
+	long i;
+
+	memset(self->currentBoard, ' ', (size_t)boardWidth * boardHeight);
+	for(i = 0; i < cells->noOfCells; i++)
+		boardToWrite[cells->cells[i].row][cells->cells[i].column] = ageCharacters[(cells->ages != NULL) ? cells->ages[i] : 0];
+
+	return;
+}
+
+/*
+	Function: stepCharEngine()
+	Purpose: Calculate the next generation with iterateBoard(), then swap the boards.
+	Arguments: The engine (engine).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+void stepCharEngine(lifeEngine *engine)
+{
+	charEngine *self = (charEngine *)engine;
+
+	/* It is not necessary to initialise nextBoard to be the same as currentBoard because iterateBoard() writes to every used cell. */
+	iterateBoard( ( char (*)[boardWidth] )self->currentBoard, ( char (*)[boardWidth] )self->nextBoard );
+
+	char *tempBoardptr = self->currentBoard;
+	self->currentBoard = self->nextBoard;
+	self->nextBoard = tempBoardptr;
+	return;
+}
+
+/*
+	Function: viewCharEngine()
+	Purpose: Convert the current character board into live and age planes.
+	Arguments: The engine (engine).
+	Return value: A pointer to the planes, which are valid until the engine is next used.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+const boardPlanes *viewCharEngine(lifeEngine *engine)
+{
+	charEngine *self = (charEngine *)engine;
+	char (*boardToRead)[boardWidth] = ( char (*)[boardWidth] )self->currentBoard;
+	boardPlanes *planes = &self->planes;
+	coord counter;
+	uint64_t *live, *ages;
+	char cell;
+
+	memset(planes->live, 0, (size_t)planes->height * planes->liveWordsPerRow * sizeof(uint64_t));
+	memset(planes->ages, 0, (size_t)planes->height * planes->ageWordsPerRow * sizeof(uint64_t));
+
+	for(counter.row = 0; counter.row < boardHeight; counter.row++)
+	{
+		live = planes->live + counter.row * planes->liveWordsPerRow;
+		ages = planes->ages + counter.row * planes->ageWordsPerRow;
+		for(counter.column = 0; counter.column < boardWidth; counter.column++)
+		{
+			cell = boardToRead[counter.row][counter.column];
+			if(cell == ' ')
+				continue;
+
+			live[counter.column / 64] |= (uint64_t)1 << (counter.column % 64);
+			ages[counter.column / 16] |= (uint64_t)(cell == 'X' ? MAX_AGE : cell - '0') << (4 * (counter.column % 16));
+		}
+	}
+
+	return planes;
+}
+
+/*
+	Function: destroyCharEngine()
+	Purpose: Free a character engine.
+	Arguments: The engine (engine).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+void destroyCharEngine(lifeEngine *engine)
+{
+	charEngine *self = (charEngine *)engine;
+	freeMemory(self->currentBoard);
+	freeMemory(self->nextBoard);
+	freePlanes(&self->planes);
+	freeMemory(self);
+	return;
+}
+
+/*
+	Function: charEngineMemory()
+	Purpose: Estimate the most memory a character engine allocates for a board.
+	Arguments: The width and height of the board (width and height), and the command line settings (options), which aren't used.
+	Return value: The number of bytes.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+double charEngineMemory(int width, int height, const engineOptions *options)
+{
+	(void)options;
+	return sizeof(charEngine) + 2.0 * width * height + planesSize(width, height) + 3 * ARENA_ALIGNMENT;
+}
+
+/*
+	Function: createScalarEngine()
+	Purpose: Create an engine that keeps one byte per cell, with a border of dead cells.
+	Arguments: The width and height of the board (width and height), and the command line settings (options), which aren't used.
+	Return value: A pointer to the new engine.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+lifeEngine *createScalarEngine(int width, int height, const engineOptions *options)
+{
+	(void)options;
+	scalarEngine *engine = (scalarEngine *)allocateMemory(sizeof(scalarEngine));
+	engine->base.type = &scalarEngineType;
+	engine->base.width = width;
+	engine->base.height = height;
+
+	/* allocateMemory() zeroes the boards, so the borders start dead, and no generation ever writes to them */
+	size_t size = (size_t)(width + 2) * (height + 2);
+	engine->stride = width + 2;
+	engine->live = (unsigned char *)allocateMemory(size);
+	engine->nextLive = (unsigned char *)allocateMemory(size);
+	engine->ages = (unsigned char *)allocateMemory(size);
+	engine->nextAges = (unsigned char *)allocateMemory(size);
+	allocatePlanes(&engine->planes, width, height);
+	return &engine->base;
+}
+
+/*
+	Function: loadScalarEngine()
+	Purpose: Set the current board of a scalar engine.
+	Arguments: The engine (engine), and the live cells to load (cells).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+void loadScalarEngine(lifeEngine *engine, const cellList *cells)
+{
+	scalarEngine *self = (scalarEngine *)engine;
+	size_t size = (size_t)self->stride * (engine->height + 2), cell;
+	long i;
+
+	memset(self->live, 0, size);
+	memset(self->ages, 0, size);
+	for(i = 0; i < cells->noOfCells; i++)
+	{
+		cell = (size_t)(cells->cells[i].row + 1) * self->stride + cells->cells[i].column + 1;
+		self->live[cell] = 1;
+		self->ages[cell] = (cells->ages != NULL) ? cells->ages[i] : 0;
+	}
+	return;
+}
+
+/*
+	Function: stepScalarEngine()
+	Purpose: Calculate the next generation a row at a time with iterateScalarRow(), then swap the boards.
+	Arguments: The engine (engine).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+void stepScalarEngine(lifeEngine *engine)
+{
+	scalarEngine *self = (scalarEngine *)engine;
+	size_t rowStart;
+	int row;
+
+	for(row = 1; row <= engine->height; row++)
+	{
+		rowStart = (size_t)row * self->stride;
+		iterateScalarRow(self->live + rowStart - self->stride, self->live + rowStart, self->live + rowStart + self->stride,
+		                 self->ages + rowStart, self->nextLive + rowStart, self->nextAges + rowStart, engine->width);
+	}
+
+	unsigned char *temp = self->live;
+	self->live = self->nextLive;
+	self->nextLive = temp;
+	temp = self->ages;
+	self->ages = self->nextAges;
+	self->nextAges = temp;
+	return;
+}
+
+/*
+	Function: iterateScalarRow()
+	Purpose: Apply the rules to a row of a scalar engine's board, and update the ages of its cells.
+	Arguments: The rows above, of and below the cells to calculate (above, row and below), which start at the left border,
+	           the ages of the row (ages), the row and the ages to write the next generation to (rowToWrite and agesToWrite),
+	           and the number of cells in the row, not counting the borders (width).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+	Note: The neighbours are added up as bytes, and the rule table is looked up by comparing the count with each entry in turn,
+	      which the compiler reduces to a couple of comparisons, so the loop has no branches and no loads that depend on the cells.
+	      GCC and Clang vectorize the loop at -O3 on any architecture with vector instructions.
+ */
+void iterateScalarRow(const unsigned char *restrict above, const unsigned char *restrict row, const unsigned char *restrict below,
+                      const unsigned char *restrict ages, unsigned char *restrict rowToWrite, unsigned char *restrict agesToWrite, int width)
+{
+	int column, neighbours;
+	unsigned char count, next;
+
+	for(column = 1; column <= width; column++)
+	{
+		count = above[column - 1] + above[column] + above[column + 1] + row[column - 1] + row[column + 1]
+		        + below[column - 1] + below[column] + below[column + 1];
+
+		next = 0;
+		for(neighbours = 0; neighbours <= 8; neighbours++)
+			next |= (count == neighbours) & ( (lifeRule[0][neighbours] & (row[column] ^ 1)) | (lifeRule[1][neighbours] & row[column]) );
+		rowToWrite[column] = next;
+
+		/* A cell that stays alive gets a year older, up to MAX_AGE, and every other cell's age is 0 */
+		agesToWrite[column] = (ages[column] + (ages[column] < MAX_AGE)) * (row[column] & next);
+	}
+	return;
+}
+
+/*
+	Function: viewScalarEngine()
+	Purpose: Convert the current board of a scalar engine into live and age planes.
+	Arguments: The engine (engine).
+	Return value: A pointer to the planes, which are valid until the engine is next used.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+const boardPlanes *viewScalarEngine(lifeEngine *engine)
+{
+	scalarEngine *self = (scalarEngine *)engine;
+	boardPlanes *planes = &self->planes;
+	const unsigned char *live, *ages;
+	uint64_t *liveWords, *ageWords, bits;
+	int row, word, column, cellsInWord;
+
+	for(row = 0; row < planes->height; row++)
+	{
+		live = self->live + (size_t)(row + 1) * self->stride + 1;
+		ages = self->ages + (size_t)(row + 1) * self->stride + 1;
+		liveWords = planes->live + (size_t)row * planes->liveWordsPerRow;
+		ageWords = planes->ages + (size_t)row * planes->ageWordsPerRow;
+
+		/* Each word is built up from its cells in turn, the last word of a row may only be partly used */
+		for(word = 0; word < planes->liveWordsPerRow; word++)
+		{
+			cellsInWord = (planes->width - 64 * word < 64) ? planes->width - 64 * word : 64;
+			for(bits = 0, column = 0; column < cellsInWord; column++)
+				bits |= (uint64_t)live[64 * word + column] << column;
+			liveWords[word] = bits;
+		}
+		for(word = 0; word < planes->ageWordsPerRow; word++)
+		{
+			cellsInWord = (planes->width - 16 * word < 16) ? planes->width - 16 * word : 16;
+			for(bits = 0, column = 0; column < cellsInWord; column++)
+				bits |= (uint64_t)ages[16 * word + column] << (4 * column);
+			ageWords[word] = bits;
+		}
+	}
+
+	return planes;
+}
+
+/*
+	Function: destroyScalarEngine()
+	Purpose: Free a scalar engine.
+	Arguments: The engine (engine).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+void destroyScalarEngine(lifeEngine *engine)
+{
+	scalarEngine *self = (scalarEngine *)engine;
+	freeMemory(self->live);
+	freeMemory(self->nextLive);
+	freeMemory(self->ages);
+	freeMemory(self->nextAges);
+	freePlanes(&self->planes);
+	freeMemory(self);
+	return;
+}
+
+/*
+	Function: scalarEngineMemory()
+	Purpose: Calculate the memory a scalar engine allocates for a board.
+	Arguments: The width and height of the board (width and height), and the command line settings (options), which aren't used.
+	Return value: The number of bytes.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+double scalarEngineMemory(int width, int height, const engineOptions *options)
+{
+	(void)options;
+	return sizeof(scalarEngine) + 4.0 * (width + 2.0) * (height + 2.0) + planesSize(width, height) + 5 * ARENA_ALIGNMENT;
+}
+
+/*
+	Function: createBitEngine()
+	Purpose: Create an engine that calculates generations on live and age planes.
+	Arguments: The width and height of the board (width and height), and the command line settings (options), of which only trackStatistics is used.
+	Return value: A pointer to the new engine.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+lifeEngine *createBitEngine(int width, int height, const engineOptions *options)
+{
+	bitEngine *engine = (bitEngine *)allocateMemory(sizeof(bitEngine));
+	engine->base.type = &bitEngineType;
+	engine->base.width = width;
+	engine->base.height = height;
+	engine->trackStatistics = options->trackStatistics;
+	engine->haveStatistics = 0;
+	allocatePlanes(&engine->current, width, height);
+	allocatePlanes(&engine->next, width, height);
+
+	/* A row of dead cells to use above the top row and below the bottom row */
+	engine->deadRow = (uint64_t *)allocateMemory(engine->current.liveWordsPerRow * sizeof(uint64_t));
+	return &engine->base;
+}
+
+/*
+	Function: loadBitEngine()
+	Purpose: Set the current board of a bit engine.
+	Arguments: The engine (engine), and the live cells to load (cells).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+void loadBitEngine(lifeEngine *engine, const cellList *cells)
+{
+	bitEngine *self = (bitEngine *)engine;
+
+	fillPlanes(&self->current, cells);
+
+	/* Which of the cells were just born isn't known, so only the population is kept, to work out the deaths from in the next generation */
+	self->haveStatistics = 0;
+	if(self->trackStatistics)
+		scanBoardStatistics(&self->current, 0, 0, &self->statistics);
+	return;
+}
+
+/*
+	Function: stepBitEngine()
+	Purpose: Calculate the next generation of the live plane a row at a time, then update the ages, and swap the planes.
+	Arguments: The engine (engine).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+	Note: The rows above the top and below the bottom of the board are treated as dead cells.
+ */
+void stepBitEngine(lifeEngine *engine)
+{
+	bitEngine *self = (bitEngine *)engine;
+	boardPlanes *current = &self->current;
+	boardPlanes *next = &self->next;
+	int words = current->liveWordsPerRow;
+	int ageWords = current->ageWordsPerRow;
+
+	/* The cells past the end of the last word of each row don't exist, so must be kept dead */
+	uint64_t lastWordMask = (current->width % 64 == 0) ? ~(uint64_t)0 : ( ((uint64_t)1 << (current->width % 64)) - 1 );
+
+	int row;
+	const uint64_t *above, *below;
+	for(row = 0; row < current->height; row++)
+	{
+		above = (row > 0) ? current->live + (row - 1) * words : self->deadRow;
+		below = (row < current->height - 1) ? current->live + (row + 1) * words : self->deadRow;
+		iterateLiveRow(above, current->live + row * words, below, next->live + row * words, words, lastWordMask);
+	}
+
+	/* The ages only depend on whether each cell stayed alive, so they are updated separately from the rules.
+	   The statistics are taken a row at a time along with them, while the row's live cells are still in the cache. */
+	long previousPopulation = 0;
+	if(self->trackStatistics)
+	{
+		previousPopulation = self->statistics.population;
+		startStatistics(&self->statistics, current->width, current->height);
+	}
+	for(row = 0; row < current->height; row++)
+	{
+		updateAgeRow(current->live + row * words, next->live + row * words, current->ages + row * ageWords, next->ages + row * ageWords, ageWords);
+		if(self->trackStatistics)
+			addRowToStatistics(next->live + row * words, current->live + row * words, words, row, &self->statistics);
+	}
+	if(self->trackStatistics)
+	{
+		self->statistics.deaths = previousPopulation + self->statistics.births - self->statistics.population;
+		self->haveStatistics = 1;
+	}
+
+	/* Swap the planes, so that the current board is the one that has just been calculated */
+	boardPlanes temp = *current;
+	*current = *next;
+	*next = temp;
+	return;
+}
+
+/*
+	Function: iterateLiveRow()
+	Purpose: Apply the rules to a row of the live plane, 64 cells at a time.
+	Arguments: The rows above, of and below the cells to calculate (above, row and below),
+	           the row to write the next generation to (rowToWrite),
+	           the number of words in each row (words), and the mask of the cells that exist in the last word (lastWordMask).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+void iterateLiveRow(const uint64_t *above, const uint64_t *row, const uint64_t *below, uint64_t *rowToWrite, int words, uint64_t lastWordMask)
+{
+	int word;
+
+	for(word = 0; word < words; word++)
+		rowToWrite[word] = iterateLiveWord(above, row, below, word, words);
+
+	if(words > 0)
+		rowToWrite[words - 1] &= lastWordMask;
+	return;
+}
+
+/*
+	Function: iterateLiveWord()
+	Purpose: Apply the rules to one word (64 cells) of a row of the live plane.
+	Arguments: The rows above, of and below the cells to calculate (above, row and below),
+	           the index of the word to calculate (word), and the number of words in each row (words).
+	Return value: The word of the next generation, which must still be masked with lastWordMask if it is the last word of the row.
+	Inputs from user: None.
+	Outputs to user: None.
+	Note: The eight neighbours of all 64 cells in the word are added together at once, as a 3 bit binary number held in three words.
+	      A count of 8 wraps round to 0, which is harmless since both mean the cell will be dead.
+ */
+inline uint64_t iterateLiveWord(const uint64_t *above, const uint64_t *row, const uint64_t *below, int word, int words)
+{
+	uint64_t leftAbove, leftRow, leftBelow, rightAbove, rightRow, rightBelow;
+	uint64_t aboveOnes, aboveTwos, belowOnes, belowTwos, rowOnes, rowTwos;
+	uint64_t ones, carry, twosA, twosB, fours;
+
+	/* Shift each row so that the neighbour to the left (or right) of every cell lines up with the cell,
+	   bringing in the bit from the neighbouring word, or a dead cell at the edge of the board. */
+	leftAbove = (above[word] << 1) | ( (word > 0) ? above[word - 1] >> 63 : 0 );
+	leftRow = (row[word] << 1) | ( (word > 0) ? row[word - 1] >> 63 : 0 );
+	leftBelow = (below[word] << 1) | ( (word > 0) ? below[word - 1] >> 63 : 0 );
+	rightAbove = (above[word] >> 1) | ( (word < words - 1) ? above[word + 1] << 63 : 0 );
+	rightRow = (row[word] >> 1) | ( (word < words - 1) ? row[word + 1] << 63 : 0 );
+	rightBelow = (below[word] >> 1) | ( (word < words - 1) ? below[word + 1] << 63 : 0 );
+
+	/* Add the three cells above, the three cells below and the two cells either side, each giving a 2 bit sum */
+	aboveOnes = leftAbove ^ above[word] ^ rightAbove;
+	aboveTwos = (leftAbove & above[word]) | (rightAbove & (leftAbove ^ above[word]));
+	belowOnes = leftBelow ^ below[word] ^ rightBelow;
+	belowTwos = (leftBelow & below[word]) | (rightBelow & (leftBelow ^ below[word]));
+	rowOnes = leftRow ^ rightRow;
+	rowTwos = leftRow & rightRow;
+
+	/* Add the three sums together: first the ones, then the twos along with the carry from the ones */
+	ones = aboveOnes ^ belowOnes ^ rowOnes;
+	carry = (aboveOnes & belowOnes) | (rowOnes & (aboveOnes ^ belowOnes));
+	twosA = aboveTwos ^ belowTwos;
+	twosB = rowTwos ^ carry;
+	fours = (aboveTwos & belowTwos) ^ (rowTwos & carry) ^ (twosA & twosB);
+
+	/* A cell is alive next generation if it has 3 neighbours, or if it has 2 neighbours and is alive now */
+	return (twosA ^ twosB) & ~fours & (ones | row[word]);
+}
+
+/*
+	Function: updateAgeRow()
+	Purpose: Update the ages of a row of cells, 16 cells at a time:
+	         cells that stayed alive get one year older (stopping at MAX_AGE), and all other cells get an age of 0.
+	Arguments: The live cells of the row in the previous and next generations (oldLive and newLive),
+	           the ages of the row in the previous and next generations (oldAges and newAges),
+	           and the number of age words in the row (ageWords).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+	Note: MAX_AGE is 10 (binary 1010), and no age is ever larger, so an age is saturated exactly when its bits 3 and 1 are set.
+ */
+inline void updateAgeRow(const uint64_t *oldLive, const uint64_t *newLive, const uint64_t *oldAges, uint64_t *newAges, int ageWords)
+{
+	int word;
+	uint64_t stayedAlive, saturated;
+	const uint64_t lowNibbleBits = 0x1111111111111111ULL;
+
+	for(word = 0; word < ageWords; word++)
+	{
+		/* Each bit of the 16 cells covered by this age word becomes the lowest bit of that cell's nibble */
+		stayedAlive = spreadToNibbles( ( (oldLive[word / 4] & newLive[word / 4]) >> (16 * (word % 4)) ) & 0xFFFF );
+		saturated = (oldAges[word] >> 3) & (oldAges[word] >> 1) & lowNibbleBits;
+
+		/* Add one to every unsaturated cell that stayed alive, then clear the cells that didn't stay alive.
+		   No nibble can overflow, so the additions can't interfere with each other. */
+		newAges[word] = (oldAges[word] + (stayedAlive & ~saturated)) & (stayedAlive * 0xF);
+	}
+
+	return;
+}
+
+/*
+	Function: spreadToNibbles()
+	Purpose: Move each of the lowest 16 bits of a word to the lowest bit of the corresponding nibble (bit n moves to bit 4n).
+	Arguments: The bits to spread (bits), which must have no bits set above bit 15.
+	Return value: The spread bits.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+inline uint64_t spreadToNibbles(uint64_t bits)
+{
+	bits = (bits | (bits << 24)) & 0x000000FF000000FFULL;
+	bits = (bits | (bits << 12)) & 0x000F000F000F000FULL;
+	bits = (bits | (bits << 6)) & 0x0303030303030303ULL;
+	bits = (bits | (bits << 3)) & 0x1111111111111111ULL;
+	return bits;
+}
+
+/*
+	Function: countBits()
+	Purpose: Count the number of set bits in a word (the number of live cells it holds).
+	Arguments: The word to count (word).
+	Return value: The number of set bits.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+int countBits(uint64_t word)
+{
+#ifdef __GNUC__
+	return __builtin_popcountll(word);
+#else
+	int count;
+	for(count = 0; word != 0; count++)
+		word &= word - 1;
+	return count;
+#endif
+}
+
+/*
+	Function: countTrailingZeros()
+	Purpose: Count the number of unset bits below the lowest set bit of a word (the position of the first live cell it holds).
+	Arguments: The word to count (word), which must not be 0.
+	Return value: The position of the lowest set bit.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+int countTrailingZeros(uint64_t word)
+{
+#ifdef __GNUC__
+	return __builtin_ctzll(word);
+#else
+	int count;
+	for(count = 0; (word & 1) == 0; count++)
+		word >>= 1;
+	return count;
+#endif
+}
+
+/*
+	Function: countLeadingZeros()
+	Purpose: Count the number of unset bits above the highest set bit of a word (63 less the position of the last live cell it holds).
+	Arguments: The word to count (word), which must not be 0.
+	Return value: The number of unset bits above the highest set bit.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+int countLeadingZeros(uint64_t word)
+{
+#ifdef __GNUC__
+	return __builtin_clzll(word);
+#else
+	int count;
+	for(count = 0; (word >> 63) == 0; count++)
+		word <<= 1;
+	return count;
+#endif
+}
+
+/*
+	Function: bitEngineStatistics()
+	Purpose: Give the statistics of the current board of a bit engine, which it works out as it calculates each generation if asked to.
+	Arguments: The engine (engine), and where to write the statistics (statistics).
+	Return value: 1 if the statistics were written.
+	              0 if the engine hasn't got them, because it wasn't asked to keep them or hasn't calculated a generation since it was loaded.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+int bitEngineStatistics(lifeEngine *engine, boardStatistics *statistics)
+{
+	bitEngine *self = (bitEngine *)engine;
+	if(!self->haveStatistics)
+		return 0;
+	*statistics = self->statistics;
+	return 1;
+}
+
+/*
+	Function: viewBitEngine()
+	Purpose: Provide the current board of a bit engine.
+	Arguments: The engine (engine).
+	Return value: A pointer to the planes, which are valid until the engine is next used.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+const boardPlanes *viewBitEngine(lifeEngine *engine)
+{
+	return &((bitEngine *)engine)->current;
+}
+
+/*
+	Function: measureBitEngine()
+	Purpose: Count the live cells of a bit engine's board, and the cells that changed in the last generation.
+	Arguments: The engine (engine), and where to write the counts (population and changed).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+	Note: After a step the next planes hold the previous generation, so the changed cells are the bits that differ between the live planes.
+ */
+void measureBitEngine(lifeEngine *engine, long *population, long *changed)
+{
+	bitEngine *self = (bitEngine *)engine;
+	size_t i, noOfWords = (size_t)self->current.height * self->current.liveWordsPerRow;
+
+	*population = *changed = 0;
+	for(i = 0; i < noOfWords; i++)
+	{
+		*population += countBits(self->current.live[i]);
+		*changed += countBits(self->current.live[i] ^ self->next.live[i]);
+	}
+	return;
+}
+
+/*
+	Function: estimateBitCost()
+	Purpose: Estimate the time the bit engine takes for a generation, which depends only on the area of the board.
+	Arguments: The area of the board (area), the number of live cells (population) and the cells that changed (changed), which aren't used.
+	Return value: The estimated time in nanoseconds.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+double estimateBitCost(double area, long population, long changed)
+{
+	(void)population;
+	(void)changed;
+	return BIT_COST_PER_CELL * area;
+}
+
+/*
+	Function: bitEngineMemory()
+	Purpose: Estimate the most memory a bit engine allocates for a board.
+	Arguments: The width and height of the board (width and height), and the command line settings (options), which aren't used.
+	Return value: The number of bytes.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+double bitEngineMemory(int width, int height, const engineOptions *options)
+{
+	(void)options;
+	return sizeof(bitEngine) + 2 * planesSize(width, height) + ( ( (long)width + 63 ) / 64 ) * sizeof(uint64_t) + 2 * ARENA_ALIGNMENT;
+}
+
+/*
+	Function: destroyBitEngine()
+	Purpose: Free a bit engine.
+	Arguments: The engine (engine).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+void destroyBitEngine(lifeEngine *engine)
+{
+	bitEngine *self = (bitEngine *)engine;
+	freePlanes(&self->current);
+	freePlanes(&self->next);
+	freeMemory(self->deadRow);
+	freeMemory(self);
+	return;
+}
+
+/*
+	Function: createWavefrontEngine()
+	Purpose: Create an engine that calculates several generations at once on threads of its own.
+	Arguments: The width and height of the board (width and height),
+	           and the command line settings (options), of which only the no. of threads is used.
+	Return value: A pointer to the new engine.
+	Inputs from user: None.
+	Outputs to user: None.
+	Note: The threads are started when the board is loaded.
+ */
+lifeEngine *createWavefrontEngine(int width, int height, const engineOptions *options)
+{
+	wavefrontEngine *self = (wavefrontEngine *)allocateMemory(sizeof(wavefrontEngine));
+	int i;
+
+	self->base.type = &wavefrontEngineType;
+	self->base.width = width;
+	self->base.height = height;
+
+	/* One slot for main()'s generation, one for each thread's, and one more so that the first thread can start on another
+	   while main() is still using its generation */
+	self->noOfThreads = options->noOfThreads;
+	self->noOfSlots = self->noOfThreads + 2;
+	self->slots = (boardPlanes *)allocateMemory(self->noOfSlots * sizeof(boardPlanes));
+	for(i = 0; i < self->noOfSlots; i++)
+		allocatePlanes(&self->slots[i], width, height);
+
+	self->noOfBands = (height < WAVEFRONT_BANDS_PER_THREAD * self->noOfThreads) ? height : WAVEFRONT_BANDS_PER_THREAD * self->noOfThreads;
+	self->bandRows = (self->noOfBands > 0) ? (height + self->noOfBands - 1) / self->noOfBands : 0;
+	if(self->noOfBands > 0)
+		self->noOfBands = (height + self->bandRows - 1) / self->bandRows;
+	self->bandGenerations = (atomic_long *)allocateMemory( (self->noOfBands + 1) * sizeof(atomic_long) );
+	self->threads = (pthread_t *)allocateMemory(self->noOfThreads * sizeof(pthread_t));
+	self->running = 0;
+
+	/* A row of dead cells to use above the top row and below the bottom row */
+	self->deadRow = (uint64_t *)allocateMemory(self->slots[0].liveWordsPerRow * sizeof(uint64_t));
+	return &self->base;
+}
+
+/*
+	Function: loadWavefrontEngine()
+	Purpose: Set the current board of a wavefront engine, which becomes generation 0, and start its threads calculating the following generations.
+	Arguments: The engine (engine), and the live cells to load (cells).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: An error message if the threads can't be started.
+	Note: A wavefront engine can only be loaded once.
+ */
+void loadWavefrontEngine(lifeEngine *engine, const cellList *cells)
+{
+	wavefrontEngine *self = (wavefrontEngine *)engine;
+	int i;
+
+	fillPlanes(&self->slots[0], cells);
+	for(i = 0; i < self->noOfBands; i++)
+		atomic_init(&self->bandGenerations[i], 0);
+	atomic_init(&self->viewedGeneration, 0);
+	atomic_init(&self->nextThread, 0);
+	atomic_init(&self->stopping, 0);
+
+	/* A board without any rows has nothing to calculate */
+	if(self->noOfBands == 0)
+		return;
+
+	for(i = 0; i < self->noOfThreads; i++)
+		if(pthread_create(&self->threads[i], NULL, runWavefront, self) != 0)
+		{
+			fputs("Error starting the wavefront threads.\n"
+			      "The program will now exit.\n", stderr);
+			exit(EXIT_FAILURE);
+		}
+	self->running = 1;
+	return;
+}
+
+/*
+	Function: stepWavefrontEngine()
+	Purpose: Move a wavefront engine on to the next generation, waiting for its threads to finish it if they haven't already.
+	Arguments: The engine (engine).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+	Note: Moving on lets the threads overwrite the previous generation, so its view mustn't be used after this.
+ */
+void stepWavefrontEngine(lifeEngine *engine)
+{
+	wavefrontEngine *self = (wavefrontEngine *)engine;
+	long generation = atomic_load_explicit(&self->viewedGeneration, memory_order_relaxed) + 1;
+
+	atomic_store_explicit(&self->viewedGeneration, generation, memory_order_release);
+
+	/* The bands of a generation are finished in order, so it is finished once its last band is */
+	if(self->noOfBands > 0)
+		waitForGeneration(self, &self->bandGenerations[self->noOfBands - 1], generation);
+	return;
+}
+
+/*
+	Function: runWavefront()
+	Purpose: A thread of a wavefront engine: calculate every noOfThreads'th generation, a band at a time,
+	         following the thread calculating the generation before it, until the engine is destroyed.
+	Arguments: The engine (argument).
+	Return value: None (NULL).
+	Inputs from user: None.
+	Outputs to user: None.
+	Note: Band b of generation n reads rows of bands b - 1 to b + 1 of generation n - 1, and overwrites band b of generation n - noOfSlots,
+	      which was last read for bands b - 1 to b + 1 of generation n - noOfSlots + 1. So waiting for band b + 1 (or the last band)
+	      to reach generation n - 1, which means the bands before it have too, is all that is needed between the threads.
+ */
+void *runWavefront(void *argument)
+{
+	wavefrontEngine *self = (wavefrontEngine *)argument;
+	int words = self->slots[0].liveWordsPerRow;
+	int ageWords = self->slots[0].ageWordsPerRow;
+	int height = self->slots[0].height;
+	uint64_t lastWordMask = (self->slots[0].width % 64 == 0) ? ~(uint64_t)0 : ( ((uint64_t)1 << (self->slots[0].width % 64)) - 1 );
+	long generation = atomic_fetch_add(&self->nextThread, 1) + 1;
+	int band, row, lastRow;
+	const boardPlanes *current;
+	boardPlanes *next;
+	const uint64_t *above, *below;
+
+	for(; ; generation += self->noOfThreads)
+	{
+		/* Wait until main() has finished with the generation in the slot this one goes in */
+		if(!waitForGeneration(self, &self->viewedGeneration, generation - self->noOfSlots + 1))
+			break;
+		current = &self->slots[(generation - 1) % self->noOfSlots];
+		next = &self->slots[generation % self->noOfSlots];
+
+		for(band = 0; band < self->noOfBands; band++)
+		{
+			if(!waitForGeneration(self, &self->bandGenerations[(band + 1 < self->noOfBands) ? band + 1 : band], generation - 1))
+				return NULL;
+
+			lastRow = (band + 1) * self->bandRows;
+			if(lastRow > height)
+				lastRow = height;
+			for(row = band * self->bandRows; row < lastRow; row++)
+			{
+				above = (row > 0) ? current->live + (size_t)(row - 1) * words : self->deadRow;
+				below = (row < height - 1) ? current->live + (size_t)(row + 1) * words : self->deadRow;
+				iterateLiveRow(above, current->live + (size_t)row * words, below, next->live + (size_t)row * words, words, lastWordMask);
+				updateAgeRow(current->live + (size_t)row * words, next->live + (size_t)row * words,
+				             current->ages + (size_t)row * ageWords, next->ages + (size_t)row * ageWords, ageWords);
+			}
+
+			/* Storing with release ordering makes the band visible to the threads that wait for it */
+			atomic_store_explicit(&self->bandGenerations[band], generation, memory_order_release);
+		}
+	}
+	return NULL;
+}
+
+/*
+	Function: waitForGeneration()
+	Purpose: Wait until one of a wavefront engine's counters reaches a generation, or the engine is being destroyed.
+	Arguments: The engine (self), the counter (counter), and the generation to wait for (generation).
+	Return value: 1 once the counter has reached the generation.
+	              0 if the engine is being destroyed.
+	Inputs from user: None.
+	Outputs to user: None.
+	Note: A generation is usually reached within a band's time, so the wait spins at first,
+	      then gives up the processor, and only sleeps once it has been waiting a long time (e.g. while main() is printing).
+ */
+int waitForGeneration(wavefrontEngine *self, atomic_long *counter, long generation)
+{
+	struct timespec pause = {0, 50000};
+	long tries;
+
+	for(tries = 0; atomic_load_explicit(counter, memory_order_acquire) < generation; tries++)
+	{
+		if(atomic_load_explicit(&self->stopping, memory_order_relaxed))
+			return 0;
+		if(tries >= 1024)
+			nanosleep(&pause, NULL);
+		else if(tries >= 64)
+			sched_yield();
+	}
+	return 1;
+}
+
+/*
+	Function: viewWavefrontEngine()
+	Purpose: Give the current board of a wavefront engine.
+	Arguments: The engine (engine).
+	Return value: A pointer to the planes, which are valid until the engine next moves on a generation.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+const boardPlanes *viewWavefrontEngine(lifeEngine *engine)
+{
+	wavefrontEngine *self = (wavefrontEngine *)engine;
+	return &self->slots[atomic_load_explicit(&self->viewedGeneration, memory_order_relaxed) % self->noOfSlots];
+}
+
+/*
+	Function: destroyWavefrontEngine()
+	Purpose: Stop the threads of a wavefront engine, and free the engine.
+	Arguments: The engine (engine).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+void destroyWavefrontEngine(lifeEngine *engine)
+{
+	wavefrontEngine *self = (wavefrontEngine *)engine;
+	int i;
+
+	if(self->running)
+	{
+		atomic_store(&self->stopping, 1);
+		for(i = 0; i < self->noOfThreads; i++)
+			pthread_join(self->threads[i], NULL);
+	}
+
+	for(i = 0; i < self->noOfSlots; i++)
+		freePlanes(&self->slots[i]);
+	freeMemory(self->slots);
+	freeMemory(self->bandGenerations);
+	freeMemory(self->threads);
+	freeMemory(self->deadRow);
+	freeMemory(self);
+	return;
+}
+
+/*
+	Function: wavefrontEngineMemory()
+	Purpose: Calculate the memory a wavefront engine allocates for a board.
+	Arguments: The width and height of the board (width and height), and the command line settings (options), of which only the no. of threads is used.
+	Return value: The number of bytes.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+double wavefrontEngineMemory(int width, int height, const engineOptions *options)
+{
+	int noOfThreads = options->noOfThreads;
+	return sizeof(wavefrontEngine) + (noOfThreads + 2) * ( sizeof(boardPlanes) + planesSize(width, height) )
+	       + (WAVEFRONT_BANDS_PER_THREAD * noOfThreads + 1) * sizeof(atomic_long) + noOfThreads * sizeof(pthread_t)
+	       + ( (long)width + 63 ) / 64 * sizeof(uint64_t) + 6 * ARENA_ALIGNMENT;
+}
+
+/*
+	Function: parseRule()
+	Purpose: Read a rule from the Generations family, written as B<digits>/S<digits>, optionally followed by /C<no. of states>,
+	         e.g. B3/S23 for Life, B2/S/C3 for Brian's Brain or B2/S345/C4 for Star Wars,
+	         or a Larger than Life rule, which starts with R (see parseLargerThanLifeRule()).
+	Arguments: The text of the rule (text), and the rule to write to (rule).
+	Return value: 1 if the rule was read.
+	              0 if the text isn't a rule.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+int parseRule(const char *text, generationsRule *rule)
+{
+	unsigned *neighbours;
+	int haveBirth = 0, haveSurvival = 0;
+
+	if( (*text == 'R') || (*text == 'r') )
+		return parseLargerThanLifeRule(text, rule);
+
+	memset(rule, 0, sizeof(generationsRule));
+	rule->noOfStates = 2;
+
+	while(*text != '\0')
+	{
+		if( (*text == 'B') || (*text == 'b') || (*text == 'S') || (*text == 's') )
+		{
+			if( (*text == 'B') || (*text == 'b') )
+			{
+				neighbours = &rule->birth;
+				haveBirth = 1;
+			}
+			else
+			{
+				neighbours = &rule->survival;
+				haveSurvival = 1;
+			}
+			for(text++; (*text >= '0') && (*text <= '8'); text++)
+				*neighbours |= 1u << (*text - '0');
+		}
+		else if( (*text == 'C') || (*text == 'c') )
+		{
+			for(rule->noOfStates = 0, text++; (*text >= '0') && (*text <= '9') && (rule->noOfStates <= MAX_STATES); text++)
+				rule->noOfStates = 10 * rule->noOfStates + (*text - '0');
+			if( (rule->noOfStates < 2) || (rule->noOfStates > MAX_STATES) )
+				return 0;
+		}
+		else
+			return 0;
+
+		if(*text == '/')
+			text++;
+		else if(*text != '\0')
+			return 0;
+	}
+	return haveBirth && haveSurvival;
+}
+
+/*
+	Function: parseLargerThanLifeRule()
+	Purpose: Read a Larger than Life rule, written as R<range>,C<no. of states>,M<0 or 1>,S<min>..<max>,B<min>..<max>,NM
+	         (the notation used by Golly), e.g. R5,C0,M1,S34..58,B34..45,NM for Bosco's rule.
+	         C and M can be left out, and a C of 0 or 1 means 2 states, as does a C of 2.
+	Arguments: The text of the rule (text), and the rule to write to (rule).
+	Return value: 1 if the rule was read.
+	              0 if the text isn't a rule, or uses a neighbourhood other than the Moore neighbourhood (NM).
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+int parseLargerThanLifeRule(const char *text, generationsRule *rule)
+{
+	int haveBirth = 0, haveSurvival = 0, length;
+	char neighbourhood;
+
+	memset(rule, 0, sizeof(generationsRule));
+	rule->noOfStates = 2;
+
+	while(*text != '\0')
+	{
+		length = 0;
+		switch(*text)
+		{
+			case 'R':
+			case 'r':
+				if( (sscanf(text + 1, "%d%n", &rule->range, &length) != 1) || (rule->range < 1) || (rule->range > MAX_RANGE) )
+					return 0;
+				break;
+			case 'C':
+			case 'c':
+				if( (sscanf(text + 1, "%d%n", &rule->noOfStates, &length) != 1) || (rule->noOfStates < 0) || (rule->noOfStates > MAX_STATES) )
+					return 0;
+				if(rule->noOfStates < 2)
+					rule->noOfStates = 2;
+				break;
+			case 'M':
+			case 'm':
+				if( (sscanf(text + 1, "%d%n", &rule->includesCentre, &length) != 1) || (rule->includesCentre < 0) || (rule->includesCentre > 1) )
+					return 0;
+				break;
+			case 'S':
+			case 's':
+				if(sscanf(text + 1, "%d..%d%n", &rule->survivalMin, &rule->survivalMax, &length) != 2)
+					return 0;
+				haveSurvival = 1;
+				break;
+			case 'B':
+			case 'b':
+				if(sscanf(text + 1, "%d..%d%n", &rule->birthMin, &rule->birthMax, &length) != 2)
+					return 0;
+				haveBirth = 1;
+				break;
+			case 'N':
+			case 'n':
+				neighbourhood = text[1];
+				if( (neighbourhood != 'M') && (neighbourhood != 'm') )
+					return 0;
+				length = 1;
+				break;
+			default:
+				return 0;
+		}
+
+		text += 1 + length;
+		if(*text == ',')
+			text++;
+		else if(*text != '\0')
+			return 0;
+	}
+	return (rule->range > 0) && haveBirth && haveSurvival;
+}
+
+/*
+	Function: createGenerationsEngine()
+	Purpose: Create an engine that calculates a rule from the Generations family on bit planes of the cells' states.
+	Arguments: The width and height of the board (width and height),
+	           and the command line settings (options), of which the rule and the history depth are used.
+	Return value: A pointer to the new engine.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+lifeEngine *createGenerationsEngine(int width, int height, const engineOptions *options)
+{
+	generationsEngine *self = (generationsEngine *)allocateMemory(sizeof(generationsEngine));
+	self->base.type = &generationsEngineType;
+	self->base.width = width;
+	self->base.height = height;
+	self->rule = options->rule;
+
+	/* Generation n is in slot n % noOfSlots, so at least two are needed to calculate one generation from another */
+	self->historyDepth = options->historyDepth;
+	self->noOfSlots = (self->historyDepth + 1 > 2) ? self->historyDepth + 1 : 2;
+	self->generation = 0;
+
+	allocatePlanes(&self->planes[0], width, height);
+	allocatePlanes(&self->planes[1], width, height);
+	self->planeWords = (size_t)height * self->planes[0].liveWordsPerRow;
+	self->states = (uint64_t *)allocateMemory(self->noOfSlots * STATE_BITS * self->planeWords * sizeof(uint64_t));
+	self->hashes = (uint64_t *)allocateMemory(self->noOfSlots * sizeof(uint64_t));
+
+	/* A row of dead cells to use above the top row and below the bottom row */
+	self->deadRow = (uint64_t *)allocateMemory(self->planes[0].liveWordsPerRow * sizeof(uint64_t));
+	return &self->base;
+}
+
+/*
+	Function: loadGenerationsEngine()
+	Purpose: Set the current board of a generations engine, which becomes generation 0. The cells in the list are all alive (state 1).
+	Arguments: The engine (engine), and the live cells to load (cells).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+void loadGenerationsEngine(lifeEngine *engine, const cellList *cells)
+{
+	generationsEngine *self = (generationsEngine *)engine;
+	uint64_t *states;
+	size_t i;
+	int bit;
+
+	self->generation = 0;
+	fillPlanes(&self->planes[0], cells);
+
+	/* State 1 is just the lowest bit plane, which is the live plane */
+	states = self->states;
+	memset(states, 0, STATE_BITS * self->planeWords * sizeof(uint64_t));
+	memcpy(states, self->planes[0].live, self->planeWords * sizeof(uint64_t));
+
+	self->hashes[0] = 0;
+	for(bit = 0; bit < STATE_BITS; bit++)
+		for(i = 0; i < self->planeWords; i++)
+			if(states[bit * self->planeWords + i] != 0)
+				self->hashes[0] += mixBits(states[bit * self->planeWords + i] ^ mixBits(STATE_BITS * i + bit));
+	return;
+}
+
+/*
+	Function: stepGenerationsEngine()
+	Purpose: Calculate the next generation of a generations engine, 64 cells at a time, then update the ages of the live cells.
+	Arguments: The engine (engine).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+	Note: The state of each cell is held in STATE_BITS bit planes, bit k of every cell's state being in plane k,
+	      so the states of 64 cells are worked out at once with bitwise operations, in the same way as the bit engine works out the live cells:
+	      a cell that is born or survives goes to state 1, every other cell that isn't dead goes up a state, and a cell that reaches noOfStates is dead.
+ */
+void stepGenerationsEngine(lifeEngine *engine)
+{
+	generationsEngine *self = (generationsEngine *)engine;
+	const boardPlanes *current = &self->planes[self->generation % 2];
+	boardPlanes *next = &self->planes[(self->generation + 1) % 2];
+	int words = current->liveWordsPerRow;
+	int ageWords = current->ageWordsPerRow;
+	int nextSlot = (int)( (self->generation + 1) % self->noOfSlots );
+	const uint64_t *states = self->states + (self->generation % self->noOfSlots) * STATE_BITS * self->planeWords;
+	uint64_t *nextStates = self->states + nextSlot * STATE_BITS * self->planeWords;
+
+	/* The cells past the end of the last word of each row don't exist, so must be kept dead */
+	uint64_t lastWordMask = (current->width % 64 == 0) ? ~(uint64_t)0 : ( ((uint64_t)1 << (current->width % 64)) - 1 );
+
+	/* A state of noOfStates is dead, and a 4 bit state of 16 is 0, which is already dead */
+	unsigned deadState = self->rule.noOfStates % (1 << STATE_BITS);
+
+	int row, word, bit;
+	size_t i;
+	const uint64_t *above, *below;
+	uint64_t count[4], state[STATE_BITS], raised[STATE_BITS], carry, dead, stayAlive, goesUp, wraps;
+	uint64_t hash = 0;
+
+	for(row = 0; row < current->height; row++)
+	{
+		above = (row > 0) ? current->live + (row - 1) * words : self->deadRow;
+		below = (row < current->height - 1) ? current->live + (row + 1) * words : self->deadRow;
+		for(word = 0; word < words; word++)
+		{
+			i = (size_t)row * words + word;
+			countNeighbourWord(above, current->live + row * words, below, word, words, count);
+
+			/* Add one to every state, rippling the carry up through the planes */
+			dead = ~(uint64_t)0;
+			carry = ~(uint64_t)0;
+			for(bit = 0; bit < STATE_BITS; bit++)
+			{
+				state[bit] = states[bit * self->planeWords + i];
+				dead &= ~state[bit];
+				raised[bit] = state[bit] ^ carry;
+				carry &= state[bit];
+			}
+
+			/* Dead cells can be born, live cells can survive, and every other cell goes up a state unless it is dead or reaches the last */
+			stayAlive = (dead & countIsInRule(self->rule.birth, count)) | (current->live[i] & countIsInRule(self->rule.survival, count));
+			wraps = dead | stateEquals(raised, deadState);
+			goesUp = ~(stayAlive | wraps);
+			if(word == words - 1)
+			{
+				stayAlive &= lastWordMask;
+				goesUp &= lastWordMask;
+			}
+
+			for(bit = 0; bit < STATE_BITS; bit++)
+			{
+				nextStates[bit * self->planeWords + i] = (raised[bit] & goesUp) | ( (bit == 0) ? stayAlive : 0 );
+				if(nextStates[bit * self->planeWords + i] != 0)
+					hash += mixBits(nextStates[bit * self->planeWords + i] ^ mixBits(STATE_BITS * i + bit));
+			}
+			next->live[i] = stayAlive;
+		}
+	}
+
+	/* The ages only depend on whether each cell stayed alive, so they are updated separately from the rules */
+	for(row = 0; row < current->height; row++)
+		updateAgeRow(current->live + row * words, next->live + row * words, current->ages + row * ageWords, next->ages + row * ageWords, ageWords);
+
+	self->generation++;
+	self->hashes[nextSlot] = hash;
+	return;
+}
+
+/*
+	Function: countNeighbourWord()
+	Purpose: Count the live neighbours of one word (64 cells) of a row of the live plane, as 4 bit binary numbers held in four words.
+	Arguments: The rows above, of and below the cells to count (above, row and below),
+	           the index of the word (word), the number of words in each row (words),
+	           and the four words to write the count to, lowest bit first (count).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+	Note: This is iterateLiveWord()'s adder, carried on to the eights so that counts of 0 and 8 can be told apart.
+ */
+inline void countNeighbourWord(const uint64_t *above, const uint64_t *row, const uint64_t *below, int word, int words, uint64_t count[4])
+{
+	uint64_t leftAbove, leftRow, leftBelow, rightAbove, rightRow, rightBelow;
+	uint64_t aboveOnes, aboveTwos, belowOnes, belowTwos, rowOnes, rowTwos;
+	uint64_t carry, twos, twosCarry;
+
+	/* Shift each row so that the neighbour to the left (or right) of every cell lines up with the cell,
+	   bringing in the bit from the neighbouring word, or a dead cell at the edge of the board. */
+	leftAbove = (above[word] << 1) | ( (word > 0) ? above[word - 1] >> 63 : 0 );
+	leftRow = (row[word] << 1) | ( (word > 0) ? row[word - 1] >> 63 : 0 );
+	leftBelow = (below[word] << 1) | ( (word > 0) ? below[word - 1] >> 63 : 0 );
+	rightAbove = (above[word] >> 1) | ( (word < words - 1) ? above[word + 1] << 63 : 0 );
+	rightRow = (row[word] >> 1) | ( (word < words - 1) ? row[word + 1] << 63 : 0 );
+	rightBelow = (below[word] >> 1) | ( (word < words - 1) ? below[word + 1] << 63 : 0 );
+
+	/* Add the three cells above, the three cells below and the two cells either side, each giving a 2 bit sum */
+	aboveOnes = leftAbove ^ above[word] ^ rightAbove;
+	aboveTwos = (leftAbove & above[word]) | (rightAbove & (leftAbove ^ above[word]));
+	belowOnes = leftBelow ^ below[word] ^ rightBelow;
+	belowTwos = (leftBelow & below[word]) | (rightBelow & (leftBelow ^ below[word]));
+	rowOnes = leftRow ^ rightRow;
+	rowTwos = leftRow & rightRow;
+
+	/* Add the ones, then the three twos and the carry from the ones, which can add up to four twos */
+	count[0] = aboveOnes ^ belowOnes ^ rowOnes;
+	carry = (aboveOnes & belowOnes) | (rowOnes & (aboveOnes ^ belowOnes));
+	twos = aboveTwos ^ belowTwos ^ rowTwos;
+	twosCarry = (aboveTwos & belowTwos) | (rowTwos & (aboveTwos ^ belowTwos));
+	count[1] = twos ^ carry;
+	count[2] = twosCarry ^ (twos & carry);
+	count[3] = twosCarry & twos & carry;
+	return;
+}
+
+/*
+	Function: countIsInRule()
+	Purpose: Find the cells whose neighbour count is one of the counts in a rule's birth or survival conditions.
+	Arguments: The counts in the condition, bit n being set for a count of n (neighbours), and the neighbour counts of 64 cells (count).
+	Return value: A word with the bits of the cells whose count is in the condition set.
+	Inputs from user: None.
+	Outputs to user: None.
+	Note: The loop only depends on the rule, not on the cells.
+ */
+inline uint64_t countIsInRule(unsigned neighbours, const uint64_t count[4])
+{
+	uint64_t cells = 0;
+	unsigned n;
+
+	for(n = 0; n <= 8; n++)
+		if(neighbours & (1u << n))
+			cells |= ( (n & 1) ? count[0] : ~count[0] ) & ( (n & 2) ? count[1] : ~count[1] )
+			         & ( (n & 4) ? count[2] : ~count[2] ) & ( (n & 8) ? count[3] : ~count[3] );
+	return cells;
+}
+
+/*
+	Function: stateEquals()
+	Purpose: Find the cells whose state is a particular one.
+	Arguments: The states of 64 cells, as STATE_BITS bit planes (state), and the state to look for (value).
+	Return value: A word with the bits of the cells in that state set.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+inline uint64_t stateEquals(const uint64_t state[STATE_BITS], unsigned value)
+{
+	uint64_t cells = ~(uint64_t)0;
+	int bit;
+
+	for(bit = 0; bit < STATE_BITS; bit++)
+		cells &= ( (value >> bit) & 1 ) ? state[bit] : ~state[bit];
+	return cells;
+}
+
+/*
+	Function: viewGenerationsEngine()
+	Purpose: Give the current board of a generations engine.
+	Arguments: The engine (engine).
+	Return value: A pointer to the planes, which are valid until the engine is next used.
+	Inputs from user: None.
+	Outputs to user: None.
+	Note: Only the live cells (state 1) are in the planes, cells that are dying are shown as dead.
+ */
+const boardPlanes *viewGenerationsEngine(lifeEngine *engine)
+{
+	generationsEngine *self = (generationsEngine *)engine;
+	return &self->planes[self->generation % 2];
+}
+
+/*
+	Function: findGenerationsPeriod()
+	Purpose: Test the states of the current board of a generations engine against the earlier generations, most recent first.
+	Arguments: The engine (engine).
+	Return value: The period if every cell is in the same state as in one of the last historyDepth generations, or 0 if it isn't.
+	Inputs from user: None.
+	Outputs to user: None.
+	Note: The dying cells stop cells being born, so two boards with the same live cells can still have different futures,
+	      which is why the engine compares the states itself rather than leaving main() to compare the live cells.
+ */
+int findGenerationsPeriod(lifeEngine *engine)
+{
+	generationsEngine *self = (generationsEngine *)engine;
+	int current = (int)(self->generation % self->noOfSlots), earlier, j;
+	size_t slotWords = STATE_BITS * self->planeWords;
+
+	for(j = 1; (j <= self->historyDepth) && (j <= self->generation); j++)
+	{
+		earlier = (int)( (self->generation - j) % self->noOfSlots );
+		if( (self->hashes[earlier] == self->hashes[current])
+		    && (memcmp(self->states + earlier * slotWords, self->states + current * slotWords, slotWords * sizeof(uint64_t)) == 0) )
+			return j;
+	}
+	return 0;
+}
+
+/*
+	Function: generationsEngineMemory()
+	Purpose: Calculate the memory a generations engine allocates for a board.
+	Arguments: The width and height of the board (width and height), and the command line settings (options), of which only the history depth is used.
+	Return value: The number of bytes.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+double generationsEngineMemory(int width, int height, const engineOptions *options)
+{
+	int noOfSlots = (options->historyDepth + 1 > 2) ? options->historyDepth + 1 : 2;
+	return sizeof(generationsEngine) + 2 * planesSize(width, height)
+	       + noOfSlots * ( STATE_BITS * (double)height * ( ( (long)width + 63 ) / 64 ) * sizeof(uint64_t) + sizeof(uint64_t) )
+	       + ( (long)width + 63 ) / 64 * sizeof(uint64_t) + 4 * ARENA_ALIGNMENT;
+}
+
+/*
+	Function: destroyGenerationsEngine()
+	Purpose: Free a generations engine.
+	Arguments: The engine (engine).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+void destroyGenerationsEngine(lifeEngine *engine)
+{
+	generationsEngine *self = (generationsEngine *)engine;
+	freePlanes(&self->planes[0]);
+	freePlanes(&self->planes[1]);
+	freeMemory(self->states);
+	freeMemory(self->hashes);
+	freeMemory(self->deadRow);
+	freeMemory(self);
+	return;
+}
+
+/*
+	Function: createLargerThanLifeEngine()
+	Purpose: Create an engine that calculates a Larger than Life rule, or any other rule from the Generations family,
+	         counting the neighbours of each cell from a summed-area table of the live cells.
+	Arguments: The width and height of the board (width and height),
+	           and the command line settings (options), of which the rule, the history depth and the no. of threads are used.
+	Return value: A pointer to the new engine.
+	Inputs from user: None.
+	Outputs to user: None.
+	Note: A rule written as B<digits>/S<digits> is calculated as a rule of range 1. The threads are started when the board is loaded.
+ */
+lifeEngine *createLargerThanLifeEngine(int width, int height, const engineOptions *options)
+{
+	largerThanLifeEngine *self = (largerThanLifeEngine *)allocateMemory(sizeof(largerThanLifeEngine));
+	int count;
+
+	self->base.type = &largerThanLifeEngineType;
+	self->base.width = width;
+	self->base.height = height;
+	self->rule = options->rule;
+	self->range = (self->rule.range > 0) ? self->rule.range : 1;
+
+	/* Generation n is in slot n % noOfSlots, so at least two are needed to calculate one generation from another.
+	   Each row of states is padded to a whole number of words, so that the slots can be hashed a word at a time. */
+	self->historyDepth = options->historyDepth;
+	self->noOfSlots = (self->historyDepth + 1 > 2) ? self->historyDepth + 1 : 2;
+	self->generation = 0;
+	self->stride = (width + 7) / 8 * 8;
+	self->states = (unsigned char *)allocateMemory( (size_t)self->noOfSlots * self->stride * height );
+	self->hashes = (uint64_t *)allocateMemory(self->noOfSlots * sizeof(uint64_t));
+	allocatePlanes(&self->planes[0], width, height);
+	allocatePlanes(&self->planes[1], width, height);
+
+	/* What happens to a dead (row 0) or live (row 1) cell for each count of the cells in its neighbourhood,
+	   which is everything the rule's birth and survival conditions say */
+	self->maxCount = (2 * self->range + 1) * (2 * self->range + 1);
+	self->transitions = (unsigned char *)allocateMemory(2 * (size_t)(self->maxCount + 1));
+	for(count = 0; count <= self->maxCount; count++)
+		if(self->rule.range > 0)
+		{
+			self->transitions[count] = (count >= self->rule.birthMin) && (count <= self->rule.birthMax);
+			self->transitions[self->maxCount + 1 + count] = ( (count >= self->rule.survivalMin) && (count <= self->rule.survivalMax) )
+			                                                ? 1 : 2 % self->rule.noOfStates;
+		}
+		else
+		{
+			self->transitions[count] = (count <= 8) && ( (self->rule.birth >> count) & 1 );
+			self->transitions[self->maxCount + 1 + count] = ( (count <= 8) && ( (self->rule.survival >> count) & 1 ) ) ? 1 : 2 % self->rule.noOfStates;
+		}
+
+	/* The summed-area table has a row and column of zeros before the board, so that every sum is a difference of four entries */
+	self->sumStride = width + 1;
+	self->sums = (uint32_t *)allocateMemory( (size_t)(height + 1) * self->sumStride * sizeof(uint32_t) );
+
+	/* The table is built and the board calculated in bands of rows, a few for each thread so that they share the work evenly */
+	self->noOfThreads = options->noOfThreads;
+	self->noOfBands = (self->noOfThreads == 1) ? 1 : 4 * self->noOfThreads;
+	if(self->noOfBands > height)
+		self->noOfBands = height;
+	self->bandRows = (self->noOfBands > 0) ? (height + self->noOfBands - 1) / self->noOfBands : 0;
+	if(self->noOfBands > 0)
+		self->noOfBands = (height + self->bandRows - 1) / self->bandRows;
+	self->bandCarries = (uint32_t *)allocateMemory( (size_t)(self->noOfBands + 1) * self->sumStride * sizeof(uint32_t) );
+	self->bandHashes = (uint64_t *)allocateMemory( (self->noOfBands + 1) * sizeof(uint64_t) );
+	return &self->base;
+}
+
+/*
+	Function: loadLargerThanLifeEngine()
+	Purpose: Set the current board of a Larger than Life engine, which becomes generation 0, and start its threads.
+	         The cells in the list are all alive (state 1).
+	Arguments: The engine (engine), and the live cells to load (cells).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+	Note: A Larger than Life engine can only be loaded once.
+ */
+void loadLargerThanLifeEngine(lifeEngine *engine, const cellList *cells)
+{
+	largerThanLifeEngine *self = (largerThanLifeEngine *)engine;
+	long i;
+
+	self->generation = 0;
+	fillPlanes(&self->planes[0], cells);
+	memset(self->states, 0, (size_t)self->stride * self->base.height);
+	for(i = 0; i < cells->noOfCells; i++)
+		self->states[(size_t)cells->cells[i].row * self->stride + cells->cells[i].column] = 1;
+	self->hashes[0] = hashStateRows(self->states, 0, (size_t)self->stride * self->base.height);
+
+	startThreadPool(&self->pool, self->noOfThreads);
+	return;
+}
+
+/*
+	Function: stepLargerThanLifeEngine()
+	Purpose: Calculate the next generation of a Larger than Life engine, then update the ages of the live cells.
+	Arguments: The engine (engine).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+	Note: The summed-area table is built in three jobs for the thread pool. First each band sums its own rows as if it were the whole board,
+	      then (between the jobs) the totals of the bands above each band are added up, and then each band adds those totals to its rows.
+	      The last job calculates each band's cells, which needs the whole table, as a cell's neighbourhood can reach into other bands.
+ */
+void stepLargerThanLifeEngine(lifeEngine *engine)
+{
+	largerThanLifeEngine *self = (largerThanLifeEngine *)engine;
+	int band, column, lastRow;
+	uint64_t hash = 0;
+
+	if(self->noOfBands == 0)
+	{
+		self->generation++;
+		self->hashes[self->generation % self->noOfSlots] = 0;
+		return;
+	}
+
+	runPoolTasks(&self->pool, self->noOfBands, sumBandRows, self);
+
+	/* The carry into each band is the carry into the band above plus the band above's own total, which is its last row of sums */
+	memset(self->bandCarries, 0, self->sumStride * sizeof(uint32_t));
+	for(band = 1; band < self->noOfBands; band++)
+	{
+		lastRow = band * self->bandRows;
+		for(column = 0; column < self->sumStride; column++)
+			self->bandCarries[(size_t)band * self->sumStride + column] = self->bandCarries[(size_t)(band - 1) * self->sumStride + column]
+			                                                             + self->sums[(size_t)lastRow * self->sumStride + column];
+	}
+	if(self->noOfBands > 1)
+		runPoolTasks(&self->pool, self->noOfBands - 1, addBandCarries, self);
+
+	runPoolTasks(&self->pool, self->noOfBands, stepLargerThanLifeBand, self);
+
+	self->generation++;
+	for(band = 0; band < self->noOfBands; band++)
+		hash += self->bandHashes[band];
+	self->hashes[self->generation % self->noOfSlots] = hash;
+	return;
+}
+
+/*
+	Function: sumBandRows()
+	Purpose: A task for a Larger than Life engine's thread pool: fill in the rows of the summed-area table for one band of rows of the board,
+	         counting only the live cells in the band.
+	Arguments: The engine (context), and the band (band).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+	Note: Row r + 1 of the table holds, for each column c + 1, the number of live cells in rows up to r and columns up to c.
+ */
+void sumBandRows(void *context, int band)
+{
+	largerThanLifeEngine *self = (largerThanLifeEngine *)context;
+	const unsigned char *states = self->states + (self->generation % self->noOfSlots) * self->stride * self->base.height;
+	int firstRow = band * self->bandRows;
+	int lastRow = (firstRow + self->bandRows < self->base.height) ? firstRow + self->bandRows : self->base.height;
+	int row, column;
+	uint32_t rowSum;
+	const uint32_t *above;
+	uint32_t *sums;
+
+	for(row = firstRow; row < lastRow; row++)
+	{
+		above = self->sums + (size_t)row * self->sumStride;
+		sums = self->sums + (size_t)(row + 1) * self->sumStride;
+		sums[0] = 0;
+		rowSum = 0;
+		if(row == firstRow)
+			for(column = 0; column < self->base.width; column++)
+			{
+				rowSum += (states[(size_t)row * self->stride + column] == 1);
+				sums[column + 1] = rowSum;
+			}
+		else
+			for(column = 0; column < self->base.width; column++)
+			{
+				rowSum += (states[(size_t)row * self->stride + column] == 1);
+				sums[column + 1] = above[column + 1] + rowSum;
+			}
+	}
+	return;
+}
+
+/*
+	Function: addBandCarries()
+	Purpose: A task for a Larger than Life engine's thread pool: add the totals of the bands above a band to its rows of the summed-area table.
+	Arguments: The engine (context), and the band less one (task), as the first band has nothing above it.
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+void addBandCarries(void *context, int task)
+{
+	largerThanLifeEngine *self = (largerThanLifeEngine *)context;
+	int band = task + 1;
+	int firstRow = band * self->bandRows;
+	int lastRow = (firstRow + self->bandRows < self->base.height) ? firstRow + self->bandRows : self->base.height;
+	const uint32_t *carry = self->bandCarries + (size_t)band * self->sumStride;
+	uint32_t *sums;
+	int row, column;
+
+	for(row = firstRow; row < lastRow; row++)
+	{
+		sums = self->sums + (size_t)(row + 1) * self->sumStride;
+		for(column = 1; column < self->sumStride; column++)
+			sums[column] += carry[column];
+	}
+	return;
+}
+
+/*
+	Function: stepLargerThanLifeBand()
+	Purpose: A task for a Larger than Life engine's thread pool: calculate the next generation of one band of rows of the board,
+	         with its live cells and their ages, and hash the band's next states.
+	Arguments: The engine (context), and the band (band).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+	Note: The live cells in a cell's neighbourhood are the sum of a rectangle of the board, which is four entries of the summed-area table
+	      whatever the range, with the rectangle cut short at the edges of the board, beyond which every cell is dead.
+ */
+void stepLargerThanLifeBand(void *context, int band)
+{
+	largerThanLifeEngine *self = (largerThanLifeEngine *)context;
+	int width = self->base.width, height = self->base.height, range = self->range;
+	size_t slotSize = (size_t)self->stride * height;
+	const unsigned char *states = self->states + (self->generation % self->noOfSlots) * slotSize;
+	unsigned char *nextStates = self->states + ( (self->generation + 1) % self->noOfSlots ) * slotSize;
+	const boardPlanes *current = &self->planes[self->generation % 2];
+	boardPlanes *next = &self->planes[(self->generation + 1) % 2];
+	const unsigned char *births = self->transitions, *survivals = self->transitions + self->maxCount + 1;
+	int firstRow = band * self->bandRows;
+	int lastRow = (firstRow + self->bandRows < height) ? firstRow + self->bandRows : height;
+	int row, column, left, right, state, count;
+	const uint32_t *top, *bottom;
+	uint64_t *liveRow;
+
+	for(row = firstRow; row < lastRow; row++)
+	{
+		top = self->sums + (size_t)( (row - range > 0) ? row - range : 0 ) * self->sumStride;
+		bottom = self->sums + (size_t)( (row + range + 1 < height) ? row + range + 1 : height ) * self->sumStride;
+		liveRow = next->live + (size_t)row * next->liveWordsPerRow;
+		memset(liveRow, 0, next->liveWordsPerRow * sizeof(uint64_t));
+
+		for(column = 0; column < width; column++)
+		{
+			left = (column - range > 0) ? column - range : 0;
+			right = (column + range + 1 < width) ? column + range + 1 : width;
+			count = (int)(bottom[right] - top[right] - bottom[left] + top[left]);
+			state = states[(size_t)row * self->stride + column];
+
+			/* The cell itself is in the rectangle, so is taken off again unless the rule counts it */
+			if( (state == 1) && !self->rule.includesCentre )
+				count--;
+
+			if(state == 0)
+				state = births[count];
+			else if(state == 1)
+				state = survivals[count];
+			else
+				state = (state + 1 < self->rule.noOfStates) ? state + 1 : 0;
+			nextStates[(size_t)row * self->stride + column] = (unsigned char)state;
+			liveRow[column / 64] |= (uint64_t)(state == 1) << (column % 64);
+		}
+
+		updateAgeRow(current->live + (size_t)row * current->liveWordsPerRow, liveRow,
+		             current->ages + (size_t)row * current->ageWordsPerRow, next->ages + (size_t)row * next->ageWordsPerRow, current->ageWordsPerRow);
+	}
+
+	self->bandHashes[band] = hashStateRows(nextStates, (size_t)firstRow * self->stride, (size_t)lastRow * self->stride);
+	return;
+}
+
+/*
+	Function: hashStateRows()
+	Purpose: Hash some rows of a board of cell states, a word of 8 cells at a time, so that hashes of different rows can be added together.
+	Arguments: The states (states), and the first and last (exclusive) bytes of the rows (start and end), both multiples of 8.
+	Return value: The hash.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+uint64_t hashStateRows(const unsigned char *states, size_t start, size_t end)
+{
+	uint64_t hash = 0, word;
+	size_t i;
+
+	for(i = start; i < end; i += 8)
+	{
+		memcpy(&word, states + i, sizeof(uint64_t));
+		if(word != 0)
+			hash += mixBits(word ^ mixBits(i));
+	}
+	return hash;
+}
+
+/*
+	Function: viewLargerThanLifeEngine()
+	Purpose: Give the current board of a Larger than Life engine.
+	Arguments: The engine (engine).
+	Return value: A pointer to the planes, which are valid until the engine is next used.
+	Inputs from user: None.
+	Outputs to user: None.
+	Note: Only the live cells (state 1) are in the planes, cells that are dying are shown as dead.
+ */
+const boardPlanes *viewLargerThanLifeEngine(lifeEngine *engine)
+{
+	largerThanLifeEngine *self = (largerThanLifeEngine *)engine;
+	return &self->planes[self->generation % 2];
+}
+
+/*
+	Function: findLargerThanLifePeriod()
+	Purpose: Test the states of the current board of a Larger than Life engine against the earlier generations, most recent first.
+	Arguments: The engine (engine).
+	Return value: The period if every cell is in the same state as in one of the last historyDepth generations, or 0 if it isn't.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+int findLargerThanLifePeriod(lifeEngine *engine)
+{
+	largerThanLifeEngine *self = (largerThanLifeEngine *)engine;
+	size_t slotSize = (size_t)self->stride * self->base.height;
+	int current = (int)(self->generation % self->noOfSlots), earlier, j;
+
+	for(j = 1; (j <= self->historyDepth) && (j <= self->generation); j++)
+	{
+		earlier = (int)( (self->generation - j) % self->noOfSlots );
+		if( (self->hashes[earlier] == self->hashes[current])
+		    && (memcmp(self->states + earlier * slotSize, self->states + current * slotSize, slotSize) == 0) )
+			return j;
+	}
+	return 0;
+}
+
+/*
+	Function: largerThanLifeEngineMemory()
+	Purpose: Calculate the memory a Larger than Life engine allocates for a board.
+	Arguments: The width and height of the board (width and height),
+	           and the command line settings (options), of which the rule, the history depth and the no. of threads are used.
+	Return value: The number of bytes.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+double largerThanLifeEngineMemory(int width, int height, const engineOptions *options)
+{
+	int noOfSlots = (options->historyDepth + 1 > 2) ? options->historyDepth + 1 : 2;
+	int range = (options->rule.range > 0) ? options->rule.range : 1;
+	int noOfBands = (options->noOfThreads == 1) ? 1 : 4 * options->noOfThreads;
+	return sizeof(largerThanLifeEngine) + noOfSlots * ( ( (double)width + 7 ) / 8 * 8 * height + sizeof(uint64_t) ) + 2 * planesSize(width, height)
+	       + 2.0 * ( (2 * range + 1) * (2 * range + 1) + 1 ) + ( (double)height + 1 ) * ( (double)width + 1 ) * sizeof(uint32_t)
+	       + (noOfBands + 1) * ( ( (double)width + 1 ) * sizeof(uint32_t) + sizeof(uint64_t) ) + options->noOfThreads * sizeof(pthread_t)
+	       + 8 * ARENA_ALIGNMENT;
+}
+
+/*
+	Function: destroyLargerThanLifeEngine()
+	Purpose: Stop the threads of a Larger than Life engine, and free the engine.
+	Arguments: The engine (engine).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+void destroyLargerThanLifeEngine(lifeEngine *engine)
+{
+	largerThanLifeEngine *self = (largerThanLifeEngine *)engine;
+	stopThreadPool(&self->pool);
+	freePlanes(&self->planes[0]);
+	freePlanes(&self->planes[1]);
+	freeMemory(self->states);
+	freeMemory(self->hashes);
+	freeMemory(self->transitions);
+	freeMemory(self->sums);
+	freeMemory(self->bandCarries);
+	freeMemory(self->bandHashes);
+	freeMemory(self);
+	return;
+}
+
+/*
+	Function: createMemoEngine()
+	Purpose: Create an engine that calculates generations on live and age planes a tile at a time, looking up tiles that recur in a cache.
+	Arguments: The width and height of the board (width and height),
+	           and the command line settings (options), of which the no. of threads and the size of the tile cache are used.
+	Return value: A pointer to the new engine.
+	Inputs from user: None.
+	Outputs to user: None.
+	Note: The threads are started when the board is loaded.
+ */
+lifeEngine *createMemoEngine(int width, int height, const engineOptions *options)
+{
+	memoEngine *self = (memoEngine *)allocateMemory(sizeof(memoEngine));
+	self->base.type = &memoEngineType;
+	self->base.width = width;
+	self->base.height = height;
+	allocatePlanes(&self->current, width, height);
+	allocatePlanes(&self->next, width, height);
+	self->deadRow = (uint64_t *)allocateMemory(self->current.liveWordsPerRow * sizeof(uint64_t));
+	self->lastWordMask = (width % 64 == 0) ? ~(uint64_t)0 : ( ((uint64_t)1 << (width % 64)) - 1 );
+
+	/* The number of sets is a power of two, so that a set can be picked from the hash of a key with a mask */
+	for(self->noOfSets = 1; self->noOfSets * TILE_CACHE_WAYS < options->tileCacheEntries; self->noOfSets *= 2)
+		;
+	self->entries = (tileCacheEntry *)allocateMemory( (size_t)self->noOfSets * TILE_CACHE_WAYS * sizeof(tileCacheEntry) );
+	self->hands = (atomic_uint *)allocateMemory(self->noOfSets * sizeof(atomic_uint));
+
+	self->noOfTileRows = (height + TILE_SIZE - 1) / TILE_SIZE;
+	self->tileCounts = (long *)allocateMemory(3 * (size_t)self->noOfTileRows * sizeof(long));
+	self->noOfThreads = options->noOfThreads;
+	self->trackStatistics = options->trackStatistics;
+	self->haveStatistics = 0;
+	self->rowStatistics = self->trackStatistics ? (boardStatistics *)allocateMemory(self->noOfTileRows * sizeof(boardStatistics)) : NULL;
+	return &self->base;
+}
+
+/*
+	Function: loadMemoEngine()
+	Purpose: Set the current board of a memo engine, and start its threads.
+	Arguments: The engine (engine), and the live cells to load (cells).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+	Note: A memo engine can only be loaded once. The cache is kept, as the tiles in it don't depend on the board they came from.
+ */
+void loadMemoEngine(lifeEngine *engine, const cellList *cells)
+{
+	memoEngine *self = (memoEngine *)engine;
+	fillPlanes(&self->current, cells);
+	startThreadPool(&self->pool, self->noOfThreads);
+
+	/* Which of the cells were just born isn't known, so only the population is kept, to work out the deaths from in the next generation */
+	self->haveStatistics = 0;
+	if(self->trackStatistics)
+		scanBoardStatistics(&self->current, 0, 0, &self->statistics);
+	return;
+}
+
+/*
+	Function: stepMemoEngine()
+	Purpose: Calculate the next generation of a memo engine, a row of tiles at a time on its thread pool, and swap the planes.
+	Arguments: The engine (engine).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+	Note: Every MEMO_CALIBRATION_INTERVAL generations, the generation is calculated with the bit engine's kernel instead of the cache,
+	      and the time taken by each kind of generation is added up, so that the cache can be compared with the kernel on the same board.
+ */
+void stepMemoEngine(lifeEngine *engine)
+{
+	memoEngine *self = (memoEngine *)engine;
+	struct timespec start, finish;
+	int tileRow;
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	self->useKernel = (self->generation % MEMO_CALIBRATION_INTERVAL == MEMO_CALIBRATION_INTERVAL - 1);
+	runPoolTasks(&self->pool, self->noOfTileRows, stepMemoTileRow, self);
+	clock_gettime(CLOCK_MONOTONIC, &finish);
+
+	double seconds = (finish.tv_sec - start.tv_sec) + (finish.tv_nsec - start.tv_nsec) / 1e9;
+	if(self->useKernel)
+	{
+		self->kernelSeconds += seconds;
+		self->kernelGenerations++;
+	}
+	else
+	{
+		self->cacheSeconds += seconds;
+		self->cacheGenerations++;
+		for(tileRow = 0; tileRow < self->noOfTileRows; tileRow++)
+		{
+			self->hits += self->tileCounts[3 * tileRow];
+			self->misses += self->tileCounts[3 * tileRow + 1];
+			self->emptyTiles += self->tileCounts[3 * tileRow + 2];
+		}
+	}
+
+	/* Put the statistics of the rows of tiles together, in order */
+	if(self->trackStatistics)
+	{
+		long previousPopulation = self->statistics.population;
+		startStatistics(&self->statistics, self->current.width, self->current.height);
+		for(tileRow = 0; tileRow < self->noOfTileRows; tileRow++)
+			mergeStatistics(&self->statistics, &self->rowStatistics[tileRow]);
+		self->statistics.deaths = previousPopulation + self->statistics.births - self->statistics.population;
+		self->haveStatistics = 1;
+	}
+
+	/* Swap the planes, so that the current board is the one that has just been calculated */
+	boardPlanes temp = self->current;
+	self->current = self->next;
+	self->next = temp;
+	self->generation++;
+	return;
+}
+
+/*
+	Function: stepMemoTileRow()
+	Purpose: A task for a memo engine's thread pool: calculate the next generation of one row of tiles, TILE_SIZE rows of the board,
+	         then update their ages.
+	Arguments: The engine (context), and the row of tiles (tileRow).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+	Note: Each word of a row holds TILES_PER_WORD tiles, which are looked up together. If any of them misses, the word is calculated
+	      with the bit engine's kernel, which costs no more than calculating the one tile, and the tiles that missed are added to the cache.
+	      The rows and columns past the edges of the board are dead, so a tile there has the same key wherever it is,
+	      and any cells its next generation has past the right edge are masked off.
+ */
+void stepMemoTileRow(void *context, int tileRow)
+{
+	memoEngine *self = (memoEngine *)context;
+	const boardPlanes *current = &self->current;
+	boardPlanes *next = &self->next;
+	int words = current->liveWordsPerRow;
+	int ageWords = current->ageWordsPerRow;
+	int firstRow = tileRow * TILE_SIZE;
+	int lastRow = (firstRow + TILE_SIZE < current->height) ? firstRow + TILE_SIZE : current->height;
+	const uint64_t *rowWords[TILE_SIZE + 2];
+	uint64_t rows[TILES_PER_WORD][TILE_SIZE + 2], keys[TILES_PER_WORD][TILE_KEY_WORDS], value[TILE_VALUE_WORDS], nextWords[TILE_SIZE];
+	uint64_t shifted, anyLive[TILES_PER_WORD], hash;
+	const uint64_t tileMask = ( (uint64_t)1 << TILE_SIZE ) - 1, rowMask = ( (uint64_t)1 << (TILE_SIZE + 2) ) - 1;
+	long sets[TILES_PER_WORD], hits = 0, misses = 0, emptyTiles = 0;
+	int row, word, tile, noOfTiles, missed, i;
+
+	if(self->useKernel)
+		for(row = firstRow; row < lastRow; row++)
+			iterateLiveRow( (row > 0) ? current->live + (size_t)(row - 1) * words : self->deadRow, current->live + (size_t)row * words,
+			                (row < current->height - 1) ? current->live + (size_t)(row + 1) * words : self->deadRow,
+			                next->live + (size_t)row * words, words, self->lastWordMask );
+	else
+	{
+		/* The rows of the board that the tiles and the cells around them are in */
+		for(i = 0; i < TILE_SIZE + 2; i++)
+			rowWords[i] = ( (firstRow - 1 + i >= 0) && (firstRow - 1 + i < current->height) )
+			              ? current->live + (size_t)(firstRow - 1 + i) * words : self->deadRow;
+
+		for(word = 0; word < words; word++)
+		{
+			noOfTiles = (current->width - 64 * word + TILE_SIZE - 1) / TILE_SIZE;
+			if(noOfTiles > TILES_PER_WORD)
+				noOfTiles = TILES_PER_WORD;
+
+			/* Take out the rows of each tile, with the cell to either side, which for the tiles at the ends is in the next word along */
+			memset(anyLive, 0, sizeof(anyLive));
+			for(i = 0; i < TILE_SIZE + 2; i++)
+			{
+				shifted = (rowWords[i][word] << 1) | ( (word > 0) ? rowWords[i][word - 1] >> 63 : 0 );
+				for(tile = 0; tile < TILES_PER_WORD - 1; tile++)
+					rows[tile][i] = (shifted >> (TILE_SIZE * tile)) & rowMask;
+				rows[tile][i] = (shifted >> (TILE_SIZE * tile)) | ( (rowWords[i][word] >> 63) << TILE_SIZE )
+				                | ( ( (word < words - 1) ? rowWords[i][word + 1] & 1 : 0 ) << (TILE_SIZE + 1) );
+				for(tile = 0; tile < TILES_PER_WORD; tile++)
+					anyLive[tile] |= rows[tile][i];
+			}
+
+			/* Look the tiles up, an empty tile staying empty. missed has a bit set for each tile that isn't in the cache. */
+			memset(nextWords, 0, sizeof(nextWords));
+			missed = 0;
+			for(tile = 0; tile < noOfTiles; tile++)
+			{
+				if(anyLive[tile] == 0)
+				{
+					emptyTiles++;
+					continue;
+				}
+
+				hash = 0;
+				for(i = 0; i < TILE_KEY_WORDS; i++)
+				{
+					keys[tile][i] = rows[tile][3 * i] | (rows[tile][3 * i + 1] << (TILE_SIZE + 2)) | (rows[tile][3 * i + 2] << (2 * (TILE_SIZE + 2)));
+					hash = (hash ^ keys[tile][i]) * 0x9e3779b97f4a7c15ULL;
+				}
+				sets[tile] = (long)(mixBits(hash) & (uint64_t)(self->noOfSets - 1));
+
+				if(findCachedTile(self, sets[tile], keys[tile], value))
+				{
+					hits++;
+					for(i = 0; i < TILE_SIZE; i++)
+						nextWords[i] |= ( (value[i / 4] >> (TILE_SIZE * (i % 4))) & tileMask ) << (TILE_SIZE * tile);
+				}
+				else
+				{
+					missed |= 1 << tile;
+					misses++;
+				}
+			}
+
+			/* The whole word is calculated, including any rows of the tiles past the bottom of the board, which the keys of the tiles say are dead */
+			if(missed != 0)
+			{
+				for(i = 0; i < TILE_SIZE; i++)
+					nextWords[i] = iterateLiveWord(rowWords[i], rowWords[i + 1], rowWords[i + 2], word, words);
+				for(tile = 0; tile < noOfTiles; tile++)
+					if( (missed >> tile) & 1 )
+					{
+						memset(value, 0, sizeof(value));
+						for(i = 0; i < TILE_SIZE; i++)
+							value[i / 4] |= ( (nextWords[i] >> (TILE_SIZE * tile)) & tileMask ) << (TILE_SIZE * (i % 4));
+						addCachedTile(self, sets[tile], keys[tile], value);
+					}
+			}
+
+			for(row = firstRow; row < lastRow; row++)
+				next->live[(size_t)row * words + word] = nextWords[row - firstRow];
+		}
+
+		for(row = firstRow; (row < lastRow) && (words > 0); row++)
+			next->live[(size_t)row * words + words - 1] &= self->lastWordMask;
+	}
+
+	/* The ages only depend on whether each cell stayed alive, so they are updated separately from the rules, along with the statistics */
+	if(self->trackStatistics)
+		startStatistics(&self->rowStatistics[tileRow], current->width, current->height);
+	for(row = firstRow; row < lastRow; row++)
+	{
+		updateAgeRow(current->live + (size_t)row * words, next->live + (size_t)row * words,
+		             current->ages + (size_t)row * ageWords, next->ages + (size_t)row * ageWords, ageWords);
+		if(self->trackStatistics)
+			addRowToStatistics(next->live + (size_t)row * words, current->live + (size_t)row * words, words, row, &self->rowStatistics[tileRow]);
+	}
+
+	self->tileCounts[3 * tileRow] = hits;
+	self->tileCounts[3 * tileRow + 1] = misses;
+	self->tileCounts[3 * tileRow + 2] = emptyTiles;
+	return;
+}
+
+/*
+	Function: memoEngineStatistics()
+	Purpose: Give the statistics of the current board of a memo engine, which it works out as it calculates each generation if asked to.
+	Arguments: The engine (engine), and where to write the statistics (statistics).
+	Return value: 1 if the statistics were written.
+	              0 if the engine hasn't got them, because it wasn't asked to keep them or hasn't calculated a generation since it was loaded.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+int memoEngineStatistics(lifeEngine *engine, boardStatistics *statistics)
+{
+	memoEngine *self = (memoEngine *)engine;
+	if(!self->haveStatistics)
+		return 0;
+	*statistics = self->statistics;
+	return 1;
+}
+
+/*
+	Function: findCachedTile()
+	Purpose: Look up a tile in a set of the memo engine's cache.
+	Arguments: The engine (self), the set the key belongs in (set), the key of the tile (key), and the value to copy the tile's next generation to (value).
+	Return value: 1 if the tile was found, or 0 if it wasn't.
+	Inputs from user: None.
+	Outputs to user: None.
+	Note: An entry that another thread is writing, or writes while it is being read, is passed over, so a tile can be missed but never wrong.
+ */
+int findCachedTile(memoEngine *self, long set, const uint64_t key[TILE_KEY_WORDS], uint64_t value[TILE_VALUE_WORDS])
+{
+	tileCacheEntry *entry;
+	uint64_t before;
+	int way, i;
+
+	for(way = 0; way < TILE_CACHE_WAYS; way++)
+	{
+		entry = &self->entries[set * TILE_CACHE_WAYS + way];
+		before = atomic_load_explicit(&entry->sequence, memory_order_acquire);
+		if(before % 2 == 1)
+			continue;
+		for(i = 0; i < TILE_KEY_WORDS; i++)
+			if(atomic_load_explicit(&entry->key[i], memory_order_relaxed) != key[i])
+				break;
+		if(i < TILE_KEY_WORDS)
+			continue;
+		for(i = 0; i < TILE_VALUE_WORDS; i++)
+			value[i] = atomic_load_explicit(&entry->value[i], memory_order_relaxed);
+
+		atomic_thread_fence(memory_order_acquire);
+		if(atomic_load_explicit(&entry->sequence, memory_order_relaxed) != before)
+			continue;
+
+		/* The flag is only written if it isn't already set, so that tiles that are used all the time don't keep writing to the cache */
+		if(!atomic_load_explicit(&entry->referenced, memory_order_relaxed))
+			atomic_store_explicit(&entry->referenced, 1, memory_order_relaxed);
+		return 1;
+	}
+	return 0;
+}
+
+/*
+	Function: addCachedTile()
+	Purpose: Add a tile to a set of the memo engine's cache, replacing the first entry the set's clock hand finds that hasn't been used recently.
+	Arguments: The engine (self), the set the key belongs in (set), the key of the tile (key), and its next generation (value).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+	Note: If another thread is writing the entry chosen, the tile isn't added, which only costs a miss the next time it is looked up.
+ */
+void addCachedTile(memoEngine *self, long set, const uint64_t key[TILE_KEY_WORDS], const uint64_t value[TILE_VALUE_WORDS])
+{
+	tileCacheEntry *entry;
+	uint64_t sequence;
+	int i;
+
+	/* Every entry gets a second chance: after one pass of the hand clears all the flags, the second pass must find one */
+	for(i = 0; i < 2 * TILE_CACHE_WAYS; i++)
+	{
+		entry = &self->entries[set * TILE_CACHE_WAYS + atomic_fetch_add_explicit(&self->hands[set], 1, memory_order_relaxed) % TILE_CACHE_WAYS];
+		if(!atomic_load_explicit(&entry->referenced, memory_order_relaxed))
+			break;
+		atomic_store_explicit(&entry->referenced, 0, memory_order_relaxed);
+	}
+
+	sequence = atomic_load_explicit(&entry->sequence, memory_order_relaxed);
+	if( (sequence % 2 == 1) || !atomic_compare_exchange_strong_explicit(&entry->sequence, &sequence, sequence + 1,
+	                                                                     memory_order_relaxed, memory_order_relaxed) )
+		return;
+	atomic_thread_fence(memory_order_release);
+
+	for(i = 0; i < TILE_KEY_WORDS; i++)
+		atomic_store_explicit(&entry->key[i], key[i], memory_order_relaxed);
+	for(i = 0; i < TILE_VALUE_WORDS; i++)
+		atomic_store_explicit(&entry->value[i], value[i], memory_order_relaxed);
+	atomic_store_explicit(&entry->referenced, 1, memory_order_relaxed);
+	atomic_store_explicit(&entry->sequence, sequence + 2, memory_order_release);
+	return;
+}
+
+/*
+	Function: viewMemoEngine()
+	Purpose: Provide the current board of a memo engine.
+	Arguments: The engine (engine).
+	Return value: A pointer to the engine's current board, which is valid until the engine is next stepped.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+const boardPlanes *viewMemoEngine(lifeEngine *engine)
+{
+	return &((memoEngine *)engine)->current;
+}
+
+/*
+	Function: memoEngineMemory()
+	Purpose: Calculate the memory a memo engine allocates for a board.
+	Arguments: The width and height of the board (width and height),
+	           and the command line settings (options), of which the no. of threads and the size of the tile cache are used.
+	Return value: The number of bytes.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+double memoEngineMemory(int width, int height, const engineOptions *options)
+{
+	long noOfSets;
+	for(noOfSets = 1; noOfSets * TILE_CACHE_WAYS < options->tileCacheEntries; noOfSets *= 2)
+		;
+	return sizeof(memoEngine) + 2 * planesSize(width, height) + ( (long)width + 63 ) / 64 * sizeof(uint64_t)
+	       + (double)noOfSets * ( TILE_CACHE_WAYS * sizeof(tileCacheEntry) + sizeof(atomic_uint) )
+	       + 3.0 * ( (long)height + TILE_SIZE - 1 ) / TILE_SIZE * sizeof(long) + options->noOfThreads * sizeof(pthread_t) + 8 * ARENA_ALIGNMENT
+	       + ( options->trackStatistics ? (double)( (long)height + TILE_SIZE - 1 ) / TILE_SIZE * sizeof(boardStatistics) + ARENA_ALIGNMENT : 0 );
+}
+
+/*
+	Function: destroyMemoEngine()
+	Purpose: Report how well a memo engine's cache did, stop its threads, and free the engine.
+	Arguments: The engine (engine).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: The hits, misses and empty tiles of the cache, its size, and how much faster it was than the bit engine's kernel,
+	                 if any generations were calculated.
+ */
+void destroyMemoEngine(lifeEngine *engine)
+{
+	memoEngine *self = (memoEngine *)engine;
+	long lookups = self->hits + self->misses;
+
+	if(self->cacheGenerations > 0)
+	{
+		fprintf(stderr, "Tile cache: %ld hits and %ld misses (a hit rate of %.1f%%), %ld empty tiles, %ld tiles in %.1f MB",
+		        self->hits, self->misses, (lookups > 0) ? 100.0 * self->hits / lookups : 0.0, self->emptyTiles,
+		        self->noOfSets * TILE_CACHE_WAYS, self->noOfSets * ( TILE_CACHE_WAYS * sizeof(tileCacheEntry) + sizeof(atomic_uint) ) / 1048576.0);
+		if( (self->kernelGenerations > 0) && (self->cacheSeconds > 0) )
+			fprintf(stderr, ", %.2f times as fast as the bit engine's kernel\n",
+			        (self->kernelSeconds / self->kernelGenerations) / (self->cacheSeconds / self->cacheGenerations));
+		else
+			fprintf(stderr, ", too few generations to compare with the bit engine's kernel\n");
+	}
+
+	stopThreadPool(&self->pool);
+	freePlanes(&self->current);
+	freePlanes(&self->next);
+	freeMemory(self->deadRow);
+	freeMemory(self->entries);
+	freeMemory(self->hands);
+	freeMemory(self->tileCounts);
+	freeMemory(self->rowStatistics);
+	freeMemory(self);
+	return;
+}
+
+/*
+	Function: createTableEngine()
+	Purpose: Create an engine that calculates generations on live and age planes by looking up 2 x 2 blocks of cells in a rule table.
+	Arguments: The width and height of the board (width and height), and the command line settings (options), of which only the rule is used.
+	Return value: A pointer to the new engine.
+	Inputs from user: None.
+	Outputs to user: None.
+	Note: The table for Life is part of the program. The table for another rule is mapped from the cache if it is there,
+	      otherwise it is built and saved to the cache for the next run.
+ */
+lifeEngine *createTableEngine(int width, int height, const engineOptions *options)
+{
+	tableEngine *engine = (tableEngine *)allocateMemory(sizeof(tableEngine));
+	engine->base.type = &tableEngineType;
+	engine->base.width = width;
+	engine->base.height = height;
+	allocatePlanes(&engine->current, width, height);
+	allocatePlanes(&engine->next, width, height);
+
+	/* A row of dead cells to use above the top row and below the bottom row, and a row to write the row below the bottom row to */
+	engine->deadRow = (uint64_t *)allocateMemory(engine->current.liveWordsPerRow * sizeof(uint64_t));
+	engine->spareRow = (uint64_t *)allocateMemory(engine->current.liveWordsPerRow * sizeof(uint64_t));
+	engine->trackStatistics = options->trackStatistics;
+	engine->haveStatistics = 0;
+
+	engine->builtTable = NULL;
+	engine->tableMap = NULL;
+	if( (options->rule.birth == (1u << 3)) && (options->rule.survival == ( (1u << 2) | (1u << 3) )) )
+		engine->rules = lifeBlockTable;
+	else if( (engine->rules = mapBlockTable(&options->rule, &engine->tableMap, &engine->tableMapSize)) == NULL )
+	{
+		engine->builtTable = (unsigned char *)allocateMemory(BLOCK_TABLE_SIZE);
+		buildBlockTable(&options->rule, engine->builtTable);
+		saveBlockTable(&options->rule, engine->builtTable);
+		engine->rules = engine->builtTable;
+	}
+	return &engine->base;
+}
+
+/*
+	Function: loadTableEngine()
+	Purpose: Set the current board of a table engine.
+	Arguments: The engine (engine), and the live cells to load (cells).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+void loadTableEngine(lifeEngine *engine, const cellList *cells)
+{
+	tableEngine *self = (tableEngine *)engine;
+
+	fillPlanes(&self->current, cells);
+
+	/* Which of the cells were just born isn't known, so only the population is kept, to work out the deaths from in the next generation */
+	self->haveStatistics = 0;
+	if(self->trackStatistics)
+		scanBoardStatistics(&self->current, 0, 0, &self->statistics);
+	return;
+}
+
+/*
+	Function: stepTableEngine()
+	Purpose: Calculate the next generation of the live plane two rows at a time, then update the ages, and swap the planes.
+	Arguments: The engine (engine).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+	Note: The rows above the top and below the bottom of the board are treated as dead cells.
+	      If the board has an odd number of rows, the bottom row is calculated with the row below it, which is thrown away.
+ */
+void stepTableEngine(lifeEngine *engine)
+{
+	tableEngine *self = (tableEngine *)engine;
+	boardPlanes *current = &self->current;
+	boardPlanes *next = &self->next;
+	int words = current->liveWordsPerRow;
+	int ageWords = current->ageWordsPerRow;
+
+	/* The cells past the end of the last word of each row don't exist, so must be kept dead */
+	uint64_t lastWordMask = (current->width % 64 == 0) ? ~(uint64_t)0 : ( ((uint64_t)1 << (current->width % 64)) - 1 );
+
+	int row;
+	const uint64_t *above, *top, *bottom, *below;
+	for(row = 0; row < current->height; row += 2)
+	{
+		top = current->live + (size_t)row * words;
+		above = (row > 0) ? top - words : self->deadRow;
+		bottom = (row + 1 < current->height) ? top + words : self->deadRow;
+		below = (row + 2 < current->height) ? top + 2 * words : self->deadRow;
+		iterateBlockRow(above, top, bottom, below, next->live + (size_t)row * words,
+		                (row + 1 < current->height) ? next->live + (size_t)(row + 1) * words : self->spareRow, words, lastWordMask, self->rules);
+	}
+
+	/* The statistics are taken a row at a time along with the ages, while the row's live cells are still in the cache */
+	long previousPopulation = 0;
+	if(self->trackStatistics)
+	{
+		previousPopulation = self->statistics.population;
+		startStatistics(&self->statistics, current->width, current->height);
+	}
+	for(row = 0; row < current->height; row++)
+	{
+		updateAgePairs(current->live + (size_t)row * words, next->live + (size_t)row * words,
+		               current->ages + (size_t)row * ageWords, next->ages + (size_t)row * ageWords, ageWords);
+		if(self->trackStatistics)
+			addRowToStatistics(next->live + (size_t)row * words, current->live + (size_t)row * words, words, row, &self->statistics);
+	}
+	if(self->trackStatistics)
+	{
+		self->statistics.deaths = previousPopulation + self->statistics.births - self->statistics.population;
+		self->haveStatistics = 1;
+	}
+
+	/* Swap the planes, so that the current board is the one that has just been calculated */
+	boardPlanes temp = *current;
+	*current = *next;
+	*next = temp;
+	return;
+}
+
+/*
+	Function: iterateBlockRow()
+	Purpose: Apply the rules to two rows of the live plane, a 2 x 2 block of cells at a time.
+	Arguments: The rows above, of and below the two rows to calculate (above, top, bottom and below),
+	           the rows to write the next generation of the two rows to (topToWrite and bottomToWrite),
+	           the number of words in each row (words), the mask of the cells that exist in the last word (lastWordMask),
+	           and the rule table (rules).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+	Note: Block k of a word is columns 2k and 2k + 1, so its 4 x 4 cells are columns 2k - 1 to 2k + 2 of the four rows.
+	      A word whose blocks are all surrounded by dead cells is filled with the entry for index 0, without looking each block up.
+ */
+void iterateBlockRow(const uint64_t *above, const uint64_t *top, const uint64_t *bottom, const uint64_t *below,
+                     uint64_t *topToWrite, uint64_t *bottomToWrite, int words, uint64_t lastWordMask, const unsigned char *rules)
+{
+	int word, block;
+	uint64_t shiftedAbove, shiftedTop, shiftedBottom, shiftedBelow, nextTop, nextBottom;
+	unsigned index, cells;
+
+	for(word = 0; word < words; word++)
+	{
+		/* Shift each row left by one cell, bringing in the last cell of the word before, so that the cells around block k are bits 2k to 2k + 3.
+		   The last block also needs the first cell of the next word, so its index is put together separately. */
+		shiftedAbove = (above[word] << 1) | ( (word > 0) ? above[word - 1] >> 63 : 0 );
+		shiftedTop = (top[word] << 1) | ( (word > 0) ? top[word - 1] >> 63 : 0 );
+		shiftedBottom = (bottom[word] << 1) | ( (word > 0) ? bottom[word - 1] >> 63 : 0 );
+		shiftedBelow = (below[word] << 1) | ( (word > 0) ? below[word - 1] >> 63 : 0 );
+		index = (unsigned)(above[word] >> 61) | (unsigned)(top[word] >> 61) << 4 | (unsigned)(bottom[word] >> 61) << 8 | (unsigned)(below[word] >> 61) << 12;
+		if(word < words - 1)
+			index |= (unsigned)(above[word + 1] & 1) << 3 | (unsigned)(top[word + 1] & 1) << 7
+			         | (unsigned)(bottom[word + 1] & 1) << 11 | (unsigned)(below[word + 1] & 1) << 15;
+
+		if( (index == 0) && ( (shiftedAbove | shiftedTop | shiftedBottom | shiftedBelow) == 0 ) )
+		{
+			topToWrite[word] = (rules[0] & 3) * 0x5555555555555555ULL;
+			bottomToWrite[word] = (rules[0] >> 2) * 0x5555555555555555ULL;
+			continue;
+		}
+
+		cells = rules[index];
+		nextTop = (uint64_t)(cells & 3) << 62;
+		nextBottom = (uint64_t)(cells >> 2) << 62;
+		for(block = 0; block < 31; block++)
+		{
+			index = (unsigned)( (shiftedAbove >> (2 * block)) & 0xF ) | (unsigned)( (shiftedTop >> (2 * block)) & 0xF ) << 4
+			        | (unsigned)( (shiftedBottom >> (2 * block)) & 0xF ) << 8 | (unsigned)( (shiftedBelow >> (2 * block)) & 0xF ) << 12;
+			cells = rules[index];
+			nextTop |= (uint64_t)(cells & 3) << (2 * block);
+			nextBottom |= (uint64_t)(cells >> 2) << (2 * block);
+		}
+		topToWrite[word] = nextTop;
+		bottomToWrite[word] = nextBottom;
+	}
+
+	if(words > 0)
+	{
+		topToWrite[words - 1] &= lastWordMask;
+		bottomToWrite[words - 1] &= lastWordMask;
+	}
+	return;
+}
+
+/*
+	Function: updateAgePairs()
+	Purpose: Update the ages of a row of cells, looking up two cells at a time in ageTransitionTable.
+	Arguments: The live cells of the row in the previous and next generations (oldLive and newLive),
+	           the ages of the row in the previous and next generations (oldAges and newAges),
+	           and the number of age words in the row (ageWords).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+void updateAgePairs(const uint64_t *oldLive, const uint64_t *newLive, const uint64_t *oldAges, uint64_t *newAges, int ageWords)
+{
+	int word, pair;
+	unsigned oldCells, newCells;
+	uint64_t ages;
+
+	for(word = 0; word < ageWords; word++)
+	{
+		/* The 16 cells covered by this age word, in the previous and next generations */
+		oldCells = (unsigned)( oldLive[word / 4] >> (16 * (word % 4)) ) & 0xFFFF;
+		newCells = (unsigned)( newLive[word / 4] >> (16 * (word % 4)) ) & 0xFFFF;
+
+		ages = 0;
+		if(newCells != 0)
+		{
+			for(pair = 0; pair < 8; pair++)
+				ages |= (uint64_t)ageTransitionTable[ ( (oldAges[word] >> (8 * pair)) & 0xFF ) | ( (oldCells >> (2 * pair)) & 3 ) << 8
+				                                      | ( (newCells >> (2 * pair)) & 3 ) << 10 ] << (8 * pair);
+		}
+		newAges[word] = ages;
+	}
+	return;
+}
+
+/*
+	Function: tableEngineStatistics()
+	Purpose: Give the statistics of the current board of a table engine, which it works out as it calculates each generation if asked to.
+	Arguments: The engine (engine), and where to write the statistics (statistics).
+	Return value: 1 if the statistics were written.
+	              0 if the engine hasn't got them, because it wasn't asked to keep them or hasn't calculated a generation since it was loaded.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+int tableEngineStatistics(lifeEngine *engine, boardStatistics *statistics)
+{
+	tableEngine *self = (tableEngine *)engine;
+	if(!self->haveStatistics)
+		return 0;
+	*statistics = self->statistics;
+	return 1;
+}
+
+/*
+	Function: viewTableEngine()
+	Purpose: Provide the current board of a table engine.
+	Arguments: The engine (engine).
+	Return value: A pointer to the planes, which are valid until the engine is next used.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+const boardPlanes *viewTableEngine(lifeEngine *engine)
+{
+	return &((tableEngine *)engine)->current;
+}
+
+/*
+	Function: tableEngineMemory()
+	Purpose: Estimate the most memory a table engine allocates for a board.
+	Arguments: The width and height of the board (width and height), and the command line settings (options), of which only the rule is used.
+	Return value: The number of bytes.
+	Inputs from user: None.
+	Outputs to user: None.
+	Note: A rule other than Life may need its table built, if it isn't in the cache.
+ */
+double tableEngineMemory(int width, int height, const engineOptions *options)
+{
+	int isLife = (options->rule.birth == (1u << 3)) && (options->rule.survival == ( (1u << 2) | (1u << 3) ));
+	return sizeof(tableEngine) + 2 * planesSize(width, height) + 2 * ( ( (long)width + 63 ) / 64 ) * sizeof(uint64_t)
+	       + (isLife ? 0 : BLOCK_TABLE_SIZE) + 4 * ARENA_ALIGNMENT;
+}
+
+/*
+	Function: destroyTableEngine()
+	Purpose: Free a table engine, and unmap its rule table if it was mapped from the cache.
+	Arguments: The engine (engine).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+void destroyTableEngine(lifeEngine *engine)
+{
+	tableEngine *self = (tableEngine *)engine;
+	if(self->tableMap != NULL)
+		munmap(self->tableMap, self->tableMapSize);
+	freeMemory(self->builtTable);
+	freePlanes(&self->current);
+	freePlanes(&self->next);
+	freeMemory(self->deadRow);
+	freeMemory(self->spareRow);
+	freeMemory(self);
+	return;
+}
+
+/*
+	Function: blockTablePath()
+	Purpose: Work out the name of the file that the rule table of a rule is cached in,
+	         which is B<counts>S<counts>.table in the BLOCK_TABLE_DIRECTORY directory of $XDG_CACHE_HOME, or of ~/.cache if it isn't set.
+	Arguments: The rule (rule), and where to write the name and its size (path and size).
+	Return value: The length of the directory's name, which is the start of path, or 0 if there is nowhere to cache the table.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+int blockTablePath(const generationsRule *rule, char *path, size_t size)
+{
+	const char *cacheHome = getenv("XDG_CACHE_HOME");
+	const char *home = getenv("HOME");
+	char ruleName[32];
+	int length, directoryLength, count;
+
+	if( (cacheHome != NULL) && (cacheHome[0] == '/') )
+		directoryLength = snprintf(path, size, "%s/%s", cacheHome, BLOCK_TABLE_DIRECTORY);
+	else if( (home != NULL) && (home[0] == '/') )
+		directoryLength = snprintf(path, size, "%s/.cache/%s", home, BLOCK_TABLE_DIRECTORY);
+	else
+		return 0;
+	if( (directoryLength < 0) || ( (size_t)directoryLength >= size ) )
+		return 0;
+
+	length = 0;
+	ruleName[length++] = 'B';
+	for(count = 0; count <= 8; count++)
+		if(rule->birth & (1u << count))
+			ruleName[length++] = (char)('0' + count);
+	ruleName[length++] = 'S';
+	for(count = 0; count <= 8; count++)
+		if(rule->survival & (1u << count))
+			ruleName[length++] = (char)('0' + count);
+	ruleName[length] = '\0';
+
+	length = snprintf(path + directoryLength, size - directoryLength, "/%s.table", ruleName);
+	if( (length < 0) || ( (size_t)length >= size - directoryLength ) )
+		return 0;
+	return directoryLength;
+}
+
+/*
+	Function: mapBlockTable()
+	Purpose: Map the rule table of a rule from the cache.
+	Arguments: The rule (rule), and where to write the start and size of the mapping, to unmap it with (map and mapSize).
+	Return value: A pointer to the table, or NULL if it isn't in the cache (or the file isn't a table for the rule).
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+const unsigned char *mapBlockTable(const generationsRule *rule, void **map, size_t *mapSize)
+{
+	char path[PATH_MAX];
+	const blockTableHeader *header;
+	struct stat status;
+	int fd;
+
+	if(blockTablePath(rule, path, sizeof(path)) == 0)
+		return NULL;
+	fd = open(path, O_RDONLY);
+	if(fd < 0)
+		return NULL;
+	if( (fstat(fd, &status) != 0) || (status.st_size != (off_t)( sizeof(blockTableHeader) + BLOCK_TABLE_SIZE )) )
+	{
+		close(fd);
+		return NULL;
+	}
+	*mapSize = sizeof(blockTableHeader) + BLOCK_TABLE_SIZE;
+	*map = mmap(NULL, *mapSize, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if(*map == MAP_FAILED)
+	{
+		*map = NULL;
+		return NULL;
+	}
+
+	header = (const blockTableHeader *)*map;
+	if( (memcmp(header->magic, BLOCK_TABLE_MAGIC, 8) != 0) || (header->birth != rule->birth) || (header->survival != rule->survival)
+	    || (header->size != BLOCK_TABLE_SIZE) )
+	{
+		munmap(*map, *mapSize);
+		*map = NULL;
+		return NULL;
+	}
+	return (const unsigned char *)*map + sizeof(blockTableHeader);
+}
+
+/*
+	Function: buildBlockTable()
+	Purpose: Build the rule table of a rule from the Generations family without dying states, in the same way the compiler builds lifeBlockTable.
+	Arguments: The rule (rule), and the table to write (table), which must have BLOCK_TABLE_SIZE entries.
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+void buildBlockTable(const generationsRule *rule, unsigned char *table)
+{
+	/* The neighbours and the bit of each of the four cells of a block, in the order of the bits of an entry */
+	static const unsigned neighbours[4] = {0x757, 0xEAE, 0x7570, 0xEAE0};
+	static const int centres[4] = {5, 6, 9, 10};
+	unsigned index, cells;
+	int cell;
+
+	for(index = 0; index < BLOCK_TABLE_SIZE; index++)
+	{
+		cells = 0;
+		for(cell = 0; cell < 4; cell++)
+			cells |= ( ( ( (index >> centres[cell]) & 1 ? rule->survival : rule->birth ) >> countBits(index & neighbours[cell]) ) & 1 ) << cell;
+		table[index] = (unsigned char)cells;
+	}
+	return;
+}
+
+/*
+	Function: saveBlockTable()
+	Purpose: Save the rule table of a rule to the cache, for later runs to map.
+	Arguments: The rule (rule), and its table (table).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+	Note: The table is written to a temporary file that is then renamed, so that another run never maps a table that is only partly written.
+	      Nothing is saved if the cache can't be written to, which only means the table is built again next time.
+ */
+void saveBlockTable(const generationsRule *rule, const unsigned char *table)
+{
+	char path[PATH_MAX], temporaryPath[PATH_MAX + 8];
+	blockTableHeader header;
+	int directoryLength, fd, written;
+
+	directoryLength = blockTablePath(rule, path, sizeof(path));
+	if(directoryLength == 0)
+		return;
+
+	/* Make the directory, and ~/.cache above it if need be */
+	path[directoryLength] = '\0';
+	if( (mkdir(path, 0755) != 0) && (errno == ENOENT) )
+	{
+		char *slash = strrchr(path, '/');
+		*slash = '\0';
+		mkdir(path, 0755);
+		*slash = '/';
+		mkdir(path, 0755);
+	}
+	path[directoryLength] = '/';
+
+	snprintf(temporaryPath, sizeof(temporaryPath), "%s.XXXXXX", path);
+	fd = mkstemp(temporaryPath);
+	if(fd < 0)
+		return;
+
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, BLOCK_TABLE_MAGIC, 8);
+	header.birth = rule->birth;
+	header.survival = rule->survival;
+	header.size = BLOCK_TABLE_SIZE;
+	written = (write(fd, &header, sizeof(header)) == (ssize_t)sizeof(header)) && (write(fd, table, BLOCK_TABLE_SIZE) == BLOCK_TABLE_SIZE);
+	if( (close(fd) != 0) || !written || (rename(temporaryPath, path) != 0) )
+		unlink(temporaryPath);
+	return;
+}
+
+/*
+	Function: createCowEngine()
+	Purpose: Create an engine that keeps the board in tiles shared between generations, copying a tile only when it changes.
+	Arguments: The width and height of the board (width and height), and the command line settings (options), of which only the history depth is used.
+	Return value: A pointer to the new engine.
+	Inputs from user: None.
+	Outputs to user: None.
+	Note: In an arena, the tiles and grids come from a pool with room for every generation in the history, the one being calculated, and the view.
+	      The pages of the pool are only used once a tile is, so a board whose tiles don't change much uses a fraction of it.
+ */
+lifeEngine *createCowEngine(int width, int height, const engineOptions *options)
+{
+	cowEngine *engine = (cowEngine *)allocateMemory(sizeof(cowEngine));
+	engine->base.type = &cowEngineType;
+	engine->base.width = width;
+	engine->base.height = height;
+	engine->tileRows = (height + COW_TILE_SIZE - 1) / COW_TILE_SIZE;
+	engine->tileColumns = (width + COW_TILE_SIZE - 1) / COW_TILE_SIZE;
+	engine->noOfTiles = (long)engine->tileRows * engine->tileColumns;
+
+	/* Generation n is in slot n % noOfSlots, and the generation before the current one is always kept, to see which tiles can't change */
+	engine->historyDepth = options->historyDepth;
+	engine->noOfSlots = (engine->historyDepth + 1 > 2) ? engine->historyDepth + 1 : 2;
+	engine->generation = 0;
+	engine->history = (cowGrid **)allocateMemory(engine->noOfSlots * sizeof(cowGrid *));
+
+	engine->pool = NULL;
+	if(activeArena != NULL)
+	{
+		cowPool *pool = (cowPool *)allocateMemory(sizeof(cowPool));
+		pthread_mutex_init(&pool->lock, NULL);
+		atomic_init(&pool->references, 1);
+		pool->gridBytes = sizeof(cowGrid) + engine->noOfTiles * sizeof(cowTile *);
+		pool->tileCapacity = (engine->noOfSlots + 2) * engine->noOfTiles;
+		pool->gridCapacity = engine->noOfSlots + 1;
+		pool->tiles = (cowTile *)allocateMemory(pool->tileCapacity * sizeof(cowTile));
+		pool->grids = (unsigned char *)allocateMemory(pool->gridCapacity * pool->gridBytes);
+		engine->pool = pool;
+	}
+
+	engine->scratch = (cowTile *)allocateMemory(sizeof(cowTile));
+	allocatePlanes(&engine->planes, width, height);
+	engine->viewedTiles = (cowTile **)allocateMemory(engine->noOfTiles * sizeof(cowTile *));
+	engine->viewedGeneration = -1;
+	return &engine->base;
+}
+
+/*
+	Function: loadCowEngine()
+	Purpose: Set the current board of a cow engine, which becomes generation 0, cutting it into tiles.
+	Arguments: The engine (engine), and the live cells to load (cells).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+	Note: The board is laid out in the view's planes first, which are then the view of generation 0.
+ */
+void loadCowEngine(lifeEngine *engine, const cellList *cells)
+{
+	cowEngine *self = (cowEngine *)engine;
+	boardPlanes *planes = &self->planes;
+	cowGrid *grid;
+	cowTile *tile;
+	int tileRow, tileColumn, row, ageWord, isEmpty;
+	long index;
+
+	for(index = 0; index < self->noOfSlots; index++)
+	{
+		releaseCowGrid(self->pool, self->history[index], self->noOfTiles);
+		self->history[index] = NULL;
+	}
+	fillPlanes(planes, cells);
+
+	grid = newCowGrid(self);
+	for(tileRow = 0; tileRow < self->tileRows; tileRow++)
+	{
+		for(tileColumn = 0; tileColumn < self->tileColumns; tileColumn++)
+		{
+			/* Copy the tile out of the planes, with the rows past the bottom of the board left dead */
+			tile = self->scratch;
+			isEmpty = 1;
+			for(row = 0; row < COW_TILE_SIZE; row++)
+			{
+				long boardRow = (long)tileRow * COW_TILE_SIZE + row;
+				tile->live[row] = (boardRow < planes->height) ? planes->live[boardRow * planes->liveWordsPerRow + tileColumn] : 0;
+				for(ageWord = 0; ageWord < COW_AGE_WORDS; ageWord++)
+					tile->ages[row * COW_AGE_WORDS + ageWord] = ( (boardRow < planes->height) && (tileColumn * COW_AGE_WORDS + ageWord < planes->ageWordsPerRow) )
+					                                            ? planes->ages[boardRow * planes->ageWordsPerRow + tileColumn * COW_AGE_WORDS + ageWord] : 0;
+				if(tile->live[row] != 0)
+					isEmpty = 0;
+			}
+
+			index = (long)tileRow * self->tileColumns + tileColumn;
+			if(isEmpty)
+				tile = &emptyCowTile;
+			else
+			{
+				tile = newCowTile(self->pool);
+				memcpy(tile->live, self->scratch->live, sizeof(tile->live));
+				memcpy(tile->ages, self->scratch->ages, sizeof(tile->ages));
+				measureCowTile(tile);
+				grid->hash += mixBits(tile->hash ^ mixBits(index));
+			}
+			grid->tiles[index] = tile;
+
+			/* The planes already hold generation 0, so the view is made from this grid's tiles */
+			releaseCowTile(self->pool, self->viewedTiles[index]);
+			holdCowTile(tile);
+			self->viewedTiles[index] = tile;
+		}
+	}
+
+	/* A board from the file has no births or deaths, but one from another engine has, which aren't known until the next generation */
+	self->generation = 0;
+	self->history[0] = grid;
+	self->viewedGeneration = 0;
+	self->haveStatistics = (cells->ages == NULL);
+	return;
+}
+
+/*
+	Function: stepCowEngine()
+	Purpose: Calculate the next generation of a cow engine's board a tile at a time, and add it to the history in place of the oldest generation.
+	Arguments: The engine (engine).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+void stepCowEngine(lifeEngine *engine)
+{
+	cowEngine *self = (cowEngine *)engine;
+	const cowGrid *current = self->history[self->generation % self->noOfSlots];
+	const cowGrid *previous = (self->generation > 0) ? self->history[(self->generation - 1) % self->noOfSlots] : NULL;
+	cowGrid *next = newCowGrid(self);
+	int tileRow, tileColumn;
+	long index, slot;
+
+	for(tileRow = 0; tileRow < self->tileRows; tileRow++)
+	{
+		for(tileColumn = 0; tileColumn < self->tileColumns; tileColumn++)
+		{
+			index = (long)tileRow * self->tileColumns + tileColumn;
+			next->tiles[index] = stepCowTile(self, current, previous, tileRow, tileColumn);
+			if(next->tiles[index] != &emptyCowTile)
+				next->hash += mixBits(next->tiles[index]->hash ^ mixBits(index));
+		}
+	}
+
+	self->generation++;
+	slot = self->generation % self->noOfSlots;
+	releaseCowGrid(self->pool, self->history[slot], self->noOfTiles);
+	self->history[slot] = next;
+	self->haveStatistics = 1;
+	return;
+}
+
+/*
+	Function: stepCowTile()
+	Purpose: Calculate the next generation of one tile of a cow engine's board, sharing the tile it was if it doesn't change.
+	Arguments: The engine (self), the current and previous generations (current and previous, which is NULL if there isn't one),
+	           and the row and column of the tile (tileRow and tileColumn).
+	Return value: The tile of the next generation, which the caller holds.
+	Inputs from user: None.
+	Outputs to user: None.
+	Note: The tiles past the edges of the board are emptyCowTile, as are the rows of a tile past the bottom of the board,
+	      and the columns past the right of the board are kept dead, so that the edges are dead cells as for the other engines.
+ */
+cowTile *stepCowTile(cowEngine *self, const cowGrid *current, const cowGrid *previous, int tileRow, int tileColumn)
+{
+	cowTile *neighbourhood[3][3], *centre, *scratch = self->scratch, *tile;
+	uint64_t above[3], rowWords[3], below[3], anyLive = 0;
+	int isEmpty = 1, isUnchanged = (previous != NULL), i, j, row;
+	long index;
+
+	for(i = 0; i < 3; i++)
+	{
+		for(j = 0; j < 3; j++)
+		{
+			if( (tileRow + i - 1 < 0) || (tileRow + i - 1 >= self->tileRows) || (tileColumn + j - 1 < 0) || (tileColumn + j - 1 >= self->tileColumns) )
+			{
+				neighbourhood[i][j] = &emptyCowTile;
+				continue;
+			}
+			index = (long)(tileRow + i - 1) * self->tileColumns + tileColumn + j - 1;
+			neighbourhood[i][j] = current->tiles[index];
+			if(neighbourhood[i][j] != &emptyCowTile)
+				isEmpty = 0;
+			if( (previous != NULL) && (previous->tiles[index] != neighbourhood[i][j]) )
+				isUnchanged = 0;
+		}
+	}
+
+	/* A tile can only change if a tile around it changed in the last generation, and an empty tile with nothing around it stays empty */
+	centre = neighbourhood[1][1];
+	if(isEmpty)
+		return &emptyCowTile;
+	if(isUnchanged)
+	{
+		holdCowTile(centre);
+		return centre;
+	}
+
+	/* The cells past the right of the board don't exist, so must be kept dead, as must the rows past the bottom */
+	uint64_t lastWordMask = ( (tileColumn < self->tileColumns - 1) || (self->base.width % 64 == 0) ) ? ~(uint64_t)0
+	                        : ( ((uint64_t)1 << (self->base.width % 64)) - 1 );
+	int noOfRows = (self->base.height - tileRow * COW_TILE_SIZE < COW_TILE_SIZE) ? self->base.height - tileRow * COW_TILE_SIZE : COW_TILE_SIZE;
+
+	for(row = 0; row < COW_TILE_SIZE; row++)
+	{
+		for(j = 0; j < 3; j++)
+		{
+			above[j] = (row > 0) ? neighbourhood[1][j]->live[row - 1] : neighbourhood[0][j]->live[COW_TILE_SIZE - 1];
+			rowWords[j] = neighbourhood[1][j]->live[row];
+			below[j] = (row < COW_TILE_SIZE - 1) ? neighbourhood[1][j]->live[row + 1] : neighbourhood[2][j]->live[0];
+		}
+		scratch->live[row] = (row < noOfRows) ? iterateLiveWord(above, rowWords, below, 1, 3) & lastWordMask : 0;
+		updateAgeRow(&centre->live[row], &scratch->live[row], centre->ages + row * COW_AGE_WORDS, scratch->ages + row * COW_AGE_WORDS, COW_AGE_WORDS);
+		anyLive |= scratch->live[row];
+	}
+
+	if( (memcmp(scratch->live, centre->live, sizeof(scratch->live)) == 0) && (memcmp(scratch->ages, centre->ages, sizeof(scratch->ages)) == 0) )
+	{
+		holdCowTile(centre);
+		return centre;
+	}
+	if(anyLive == 0)
+		return &emptyCowTile;
+
+	tile = newCowTile(self->pool);
+	memcpy(tile->live, scratch->live, sizeof(tile->live));
+	memcpy(tile->ages, scratch->ages, sizeof(tile->ages));
+	measureCowTile(tile);
+	return tile;
+}
+
+/*
+	Function: viewCowEngine()
+	Purpose: Provide the current board of a cow engine, copying the tiles that have changed since it was last viewed into the planes.
+	Arguments: The engine (engine).
+	Return value: A pointer to the planes, which are valid until the engine is next used.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+const boardPlanes *viewCowEngine(lifeEngine *engine)
+{
+	cowEngine *self = (cowEngine *)engine;
+	const cowGrid *grid = self->history[self->generation % self->noOfSlots];
+	int tileRow, tileColumn;
+	long index;
+
+	if(self->viewedGeneration == self->generation)
+		return &self->planes;
+
+	for(tileRow = 0; tileRow < self->tileRows; tileRow++)
+	{
+		for(tileColumn = 0; tileColumn < self->tileColumns; tileColumn++)
+		{
+			index = (long)tileRow * self->tileColumns + tileColumn;
+			if(grid->tiles[index] == self->viewedTiles[index])
+				continue;
+			copyTileToPlanes(grid->tiles[index], &self->planes, tileRow, tileColumn);
+			releaseCowTile(self->pool, self->viewedTiles[index]);
+			holdCowTile(grid->tiles[index]);
+			self->viewedTiles[index] = grid->tiles[index];
+		}
+	}
+	self->viewedGeneration = self->generation;
+	return &self->planes;
+}
+
+/*
+	Function: findCowPeriod()
+	Purpose: Test the live cells of the current board of a cow engine against the earlier generations, most recent first.
+	Arguments: The engine (engine).
+	Return value: The period if the live cells are the same as in one of the last historyDepth generations, or 0 if they aren't.
+	Inputs from user: None.
+	Outputs to user: None.
+	Note: Tiles that are shared between the generations are the same without being compared.
+ */
+int findCowPeriod(lifeEngine *engine)
+{
+	cowEngine *self = (cowEngine *)engine;
+	const cowGrid *current = self->history[self->generation % self->noOfSlots], *earlier;
+	long index;
+	int j;
+
+	for(j = 1; (j <= self->historyDepth) && (j <= self->generation); j++)
+	{
+		earlier = self->history[(self->generation - j) % self->noOfSlots];
+		if(earlier->hash != current->hash)
+			continue;
+		for(index = 0; index < self->noOfTiles; index++)
+			if( (earlier->tiles[index] != current->tiles[index])
+			    && (memcmp(earlier->tiles[index]->live, current->tiles[index]->live, sizeof(current->tiles[index]->live)) != 0) )
+				break;
+		if(index == self->noOfTiles)
+			return j;
+	}
+	return 0;
+}
+
+/*
+	Function: cowEngineStatistics()
+	Purpose: Give the statistics of a cow engine's current board, from what its tiles know of themselves.
+	Arguments: The engine (engine), and where to write the statistics (statistics).
+	Return value: 1 if the statistics were written, 0 if the births and deaths aren't known (the board has just come from another engine).
+	Inputs from user: None.
+	Outputs to user: None.
+	Note: Only the cells of the tiles that aren't shared with the generation before are read, to count the births,
+	      as the tiles that are shared have the same cells as they had then, so none of them were born.
+ */
+int cowEngineStatistics(lifeEngine *engine, boardStatistics *statistics)
+{
+	cowEngine *self = (cowEngine *)engine;
+	const cowGrid *current = self->history[self->generation % self->noOfSlots];
+	const cowGrid *previous = (self->generation > 0) ? self->history[(self->generation - 1) % self->noOfSlots] : NULL;
+	const cowTile *tile;
+	long index, previousPopulation = 0;
+	int tileRow, tileColumn;
+
+	if(!self->haveStatistics)
+		return 0;
+
+	startStatistics(statistics, self->base.width, self->base.height);
+	for(tileRow = 0; tileRow < self->tileRows; tileRow++)
+	{
+		for(tileColumn = 0; tileColumn < self->tileColumns; tileColumn++)
+		{
+			index = (long)tileRow * self->tileColumns + tileColumn;
+			tile = current->tiles[index];
+			if(previous != NULL)
+			{
+				previousPopulation += previous->tiles[index]->population;
+				if(previous->tiles[index] != tile)
+					statistics->births += countRowBits(tile->live, previous->tiles[index]->live, COW_TILE_SIZE);
+			}
+			if(tile->population == 0)
+				continue;
+
+			statistics->population += tile->population;
+			if(tileRow * COW_TILE_SIZE + tile->firstRow < statistics->top)
+				statistics->top = tileRow * COW_TILE_SIZE + tile->firstRow;
+			if(tileRow * COW_TILE_SIZE + tile->lastRow > statistics->bottom)
+				statistics->bottom = tileRow * COW_TILE_SIZE + tile->lastRow;
+			if(tileColumn * COW_TILE_SIZE + countTrailingZeros(tile->columns) < statistics->left)
+				statistics->left = tileColumn * COW_TILE_SIZE + countTrailingZeros(tile->columns);
+			if(tileColumn * COW_TILE_SIZE + 63 - countLeadingZeros(tile->columns) > statistics->right)
+				statistics->right = tileColumn * COW_TILE_SIZE + 63 - countLeadingZeros(tile->columns);
+		}
+	}
+	if(previous != NULL)
+		statistics->deaths = previousPopulation + statistics->births - statistics->population;
+	return 1;
+}
+
+/*
+	Function: forkCowEngine()
+	Purpose: Make a new cow engine at the same generation as another, sharing its history (and so every tile of its board).
+	Arguments: The engine to fork (engine).
+	Return value: A pointer to the new engine.
+	Inputs from user: None.
+	Outputs to user: None.
+	Note: Only the pointers to the history's grids are copied. The new engine's view is made from the tiles when it is first viewed.
+ */
+lifeEngine *forkCowEngine(lifeEngine *engine)
+{
+	cowEngine *self = (cowEngine *)engine;
+	cowEngine *fork = (cowEngine *)allocateMemory(sizeof(cowEngine));
+	int slot;
+
+	*fork = *self;
+	fork->history = (cowGrid **)allocateMemory(self->noOfSlots * sizeof(cowGrid *));
+	for(slot = 0; slot < self->noOfSlots; slot++)
+	{
+		fork->history[slot] = self->history[slot];
+		if(fork->history[slot] != NULL)
+			atomic_fetch_add_explicit(&fork->history[slot]->references, 1, memory_order_relaxed);
+	}
+	if(fork->pool != NULL)
+		atomic_fetch_add_explicit(&fork->pool->references, 1, memory_order_relaxed);
+
+	fork->scratch = (cowTile *)allocateMemory(sizeof(cowTile));
+	allocatePlanes(&fork->planes, self->base.width, self->base.height);
+	fork->viewedTiles = (cowTile **)allocateMemory(self->noOfTiles * sizeof(cowTile *));
+	fork->viewedGeneration = -1;
+	return &fork->base;
+}
+
+/*
+	Function: cowEngineMemory()
+	Purpose: Estimate the most memory a cow engine allocates for a board, which is when every tile changes every generation.
+	Arguments: The width and height of the board (width and height), and the command line settings (options), of which only the history depth is used.
+	Return value: The number of bytes.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+double cowEngineMemory(int width, int height, const engineOptions *options)
+{
+	double noOfTiles = (double)( ( (long)height + COW_TILE_SIZE - 1 ) / COW_TILE_SIZE ) * ( ( (long)width + COW_TILE_SIZE - 1 ) / COW_TILE_SIZE );
+	int noOfSlots = (options->historyDepth + 1 > 2) ? options->historyDepth + 1 : 2;
+	return sizeof(cowEngine) + sizeof(cowPool) + noOfSlots * sizeof(cowGrid *) + planesSize(width, height)
+	       + (noOfSlots + 2.0) * noOfTiles * sizeof(cowTile) + (noOfSlots + 1.0) * ( sizeof(cowGrid) + noOfTiles * sizeof(cowTile *) )
+	       + sizeof(cowTile) + noOfTiles * sizeof(cowTile *) + 8 * ARENA_ALIGNMENT;
+}
+
+/*
+	Function: destroyCowEngine()
+	Purpose: Free a cow engine, letting go of its tiles, which are only freed if no fork of the engine holds them.
+	Arguments: The engine (engine).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+void destroyCowEngine(lifeEngine *engine)
+{
+	cowEngine *self = (cowEngine *)engine;
+	cowPool *pool = self->pool;
+	long index;
+
+	for(index = 0; index < self->noOfSlots; index++)
+		releaseCowGrid(pool, self->history[index], self->noOfTiles);
+	for(index = 0; index < self->noOfTiles; index++)
+		releaseCowTile(pool, self->viewedTiles[index]);
+
+	if( (pool != NULL) && (atomic_fetch_sub_explicit(&pool->references, 1, memory_order_acq_rel) == 1) )
+	{
+		pthread_mutex_destroy(&pool->lock);
+		freeMemory(pool->tiles);
+		freeMemory(pool->grids);
+		freeMemory(pool);
+	}
+	freeMemory(self->history);
+	freeMemory(self->scratch);
+	freePlanes(&self->planes);
+	freeMemory(self->viewedTiles);
+	freeMemory(self);
+	return;
+}
+
+/*
+	Function: newCowTile()
+	Purpose: Allocate a tile for the cow engine, from its pool if it has one, or from the heap.
+	Arguments: The pool (pool), which is NULL if there isn't one.
+	Return value: A pointer to the tile, held once, whose cells and hash must be filled in.
+	Inputs from user: None.
+	Outputs to user: An error message if the pool is full, which can only happen if forks of the engine hold more tiles than it was made for.
+ */
+cowTile *newCowTile(cowPool *pool)
+{
+	cowTile *tile;
+
+	if(pool == NULL)
+		tile = (cowTile *)allocateMemory(sizeof(cowTile));
+	else
+	{
+		pthread_mutex_lock(&pool->lock);
+		if(pool->freeTiles != NULL)
+		{
+			tile = pool->freeTiles;
+			pool->freeTiles = tile->nextFree;
+		}
+		else if(pool->tilesUsed < pool->tileCapacity)
+			tile = &pool->tiles[pool->tilesUsed++];
+		else
+		{
+			fputs("The cow engine's tiles are full.\n"
+			      "The program will now exit.\n", stderr);
+			exit(EXIT_FAILURE);
+		}
+		pthread_mutex_unlock(&pool->lock);
+	}
+	atomic_init(&tile->references, 1);
+	return tile;
+}
+
+/*
+	Function: newCowGrid()
+	Purpose: Allocate an empty grid for a cow engine's board, from its pool if it has one, or from the heap.
+	Arguments: The engine (self).
+	Return value: A pointer to the grid, held once, with a hash of 0, whose tiles must be filled in.
+	Inputs from user: None.
+	Outputs to user: An error message if the pool is full, which can only happen if forks of the engine hold more grids than it was made for.
+ */
+cowGrid *newCowGrid(cowEngine *self)
+{
+	cowPool *pool = self->pool;
+	cowGrid *grid;
+
+	if(pool == NULL)
+		grid = (cowGrid *)allocateMemory(sizeof(cowGrid) + self->noOfTiles * sizeof(cowTile *));
+	else
+	{
+		pthread_mutex_lock(&pool->lock);
+		if(pool->freeGrids != NULL)
+		{
+			grid = pool->freeGrids;
+			pool->freeGrids = grid->nextFree;
+		}
+		else if(pool->gridsUsed < pool->gridCapacity)
+			grid = (cowGrid *)(pool->grids + pool->gridsUsed++ * pool->gridBytes);
+		else
+		{
+			fputs("The cow engine's grids are full.\n"
+			      "The program will now exit.\n", stderr);
+			exit(EXIT_FAILURE);
+		}
+		pthread_mutex_unlock(&pool->lock);
+	}
+	atomic_init(&grid->references, 1);
+	grid->hash = 0;
+	return grid;
+}
+
+/*
+	Function: holdCowTile()
+	Purpose: Count another holder of a tile, so that it isn't freed while it is held.
+	Arguments: The tile (tile).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+void holdCowTile(cowTile *tile)
+{
+	if(tile != &emptyCowTile)
+		atomic_fetch_add_explicit(&tile->references, 1, memory_order_relaxed);
+	return;
+}
+
+/*
+	Function: releaseCowTile()
+	Purpose: Let go of a tile, freeing it if nothing else holds it.
+	Arguments: The pool the tile came from (pool), which is NULL if it came from the heap, and the tile, which may be NULL (tile).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+void releaseCowTile(cowPool *pool, cowTile *tile)
+{
+	if( (tile == NULL) || (tile == &emptyCowTile) || (atomic_fetch_sub_explicit(&tile->references, 1, memory_order_acq_rel) != 1) )
+		return;
+
+	if(pool == NULL)
+		freeMemory(tile);
+	else
+	{
+		pthread_mutex_lock(&pool->lock);
+		tile->nextFree = pool->freeTiles;
+		pool->freeTiles = tile;
+		pthread_mutex_unlock(&pool->lock);
+	}
+	return;
+}
+
+/*
+	Function: releaseCowGrid()
+	Purpose: Let go of a grid, freeing it, and letting go of its tiles, if nothing else holds it.
+	Arguments: The pool the grid came from (pool), which is NULL if it came from the heap, the grid, which may be NULL (grid),
+	           and the number of tiles in it (noOfTiles).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+void releaseCowGrid(cowPool *pool, cowGrid *grid, long noOfTiles)
+{
+	long index;
+
+	if( (grid == NULL) || (atomic_fetch_sub_explicit(&grid->references, 1, memory_order_acq_rel) != 1) )
+		return;
+
+	for(index = 0; index < noOfTiles; index++)
+		releaseCowTile(pool, grid->tiles[index]);
+	if(pool == NULL)
+		freeMemory(grid);
+	else
+	{
+		pthread_mutex_lock(&pool->lock);
+		grid->nextFree = pool->freeGrids;
+		pool->freeGrids = grid;
+		pthread_mutex_unlock(&pool->lock);
+	}
+	return;
+}
+
+/*
+	Function: copyTileToPlanes()
+	Purpose: Copy the cells of a cow engine's tile, and their ages, to its place in a board's planes.
+	Arguments: The tile (tile), the planes (planes), and the row and column of the tile (tileRow and tileColumn).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+void copyTileToPlanes(const cowTile *tile, boardPlanes *planes, int tileRow, int tileColumn)
+{
+	int row, ageWord;
+	long boardRow;
+
+	for(row = 0; (row < COW_TILE_SIZE) && ( (long)tileRow * COW_TILE_SIZE + row < planes->height ); row++)
+	{
+		boardRow = (long)tileRow * COW_TILE_SIZE + row;
+		planes->live[boardRow * planes->liveWordsPerRow + tileColumn] = tile->live[row];
+		for(ageWord = 0; (ageWord < COW_AGE_WORDS) && (tileColumn * COW_AGE_WORDS + ageWord < planes->ageWordsPerRow); ageWord++)
+			planes->ages[boardRow * planes->ageWordsPerRow + tileColumn * COW_AGE_WORDS + ageWord] = tile->ages[row * COW_AGE_WORDS + ageWord];
+	}
+	return;
+}
+
+/*
+	Function: measureCowTile()
+	Purpose: Work out what a new tile of a cow engine needs to know of itself: the hash, population and rows and columns of its live cells.
+	Arguments: The tile (tile), which must have some live cells.
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+void measureCowTile(cowTile *tile)
+{
+	int row;
+
+	tile->hash = hashCowTile(tile);
+	tile->population = (int)countRowBits(tile->live, NULL, COW_TILE_SIZE);
+	tile->columns = 0;
+	for(row = 0; row < COW_TILE_SIZE; row++)
+		tile->columns |= tile->live[row];
+	for(tile->firstRow = 0; tile->live[tile->firstRow] == 0; tile->firstRow++)
+		;
+	for(tile->lastRow = COW_TILE_SIZE - 1; tile->live[tile->lastRow] == 0; tile->lastRow--)
+		;
+	return;
+}
+
+/*
+	Function: hashCowTile()
+	Purpose: Work out the hash of the live cells of a cow engine's tile.
+	Arguments: The tile (tile).
+	Return value: The hash.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+uint64_t hashCowTile(const cowTile *tile)
+{
+	uint64_t hash = 0;
+	int row;
+
+	for(row = 0; row < COW_TILE_SIZE; row++)
+		if(tile->live[row] != 0)
+			hash += mixBits(tile->live[row] ^ mixBits(row));
+	return hash;
+}
+
+/*
+	Function: createFreezeEngine()
+	Purpose: Create an engine that calculates generations on live and age planes, skipping the tiles that have stopped changing.
+	Arguments: The width and height of the board (width and height), and the command line settings (options), which aren't used.
+	Return value: A pointer to the new engine.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+lifeEngine *createFreezeEngine(int width, int height, const engineOptions *options)
+{
+	freezeEngine *engine = (freezeEngine *)allocateMemory(sizeof(freezeEngine));
+	int i;
+
+	engine->base.type = &freezeEngineType;
+	engine->base.width = width;
+	engine->base.height = height;
+	for(i = 0; i < FREEZE_CYCLE; i++)
+		allocatePlanes(&engine->planes[i], width, height);
+
+	int words = engine->planes[0].liveWordsPerRow;
+	engine->tileRows = (height + FREEZE_TILE_ROWS - 1) / FREEZE_TILE_ROWS;
+	engine->repeating = (unsigned char *)allocateMemory( (size_t)engine->tileRows * words );
+	engine->nextRepeating = (unsigned char *)allocateMemory( (size_t)engine->tileRows * words );
+	engine->frozenWords = (unsigned char *)allocateMemory(words);
+
+	/* A row of dead cells to use above the top row and below the bottom row */
+	engine->deadRow = (uint64_t *)allocateMemory(words * sizeof(uint64_t));
+
+	/* The counts of each tile are only kept if the statistics are */
+	engine->trackStatistics = options->trackStatistics;
+	engine->haveStatistics = 0;
+	engine->tilePopulations = engine->tileBirths = NULL;
+	if(engine->trackStatistics)
+	{
+		engine->tilePopulations = (uint16_t *)allocateMemory( FREEZE_CYCLE * (size_t)engine->tileRows * words * sizeof(uint16_t) );
+		engine->tileBirths = (uint16_t *)allocateMemory( FREEZE_CYCLE * (size_t)engine->tileRows * words * sizeof(uint16_t) );
+	}
+	return &engine->base;
+}
+
+/*
+	Function: loadFreezeEngine()
+	Purpose: Set the current board of a freezing engine, and forget the earlier generations.
+	Arguments: The engine (engine), and the live cells to load (cells).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+void loadFreezeEngine(lifeEngine *engine, const cellList *cells)
+{
+	freezeEngine *self = (freezeEngine *)engine;
+
+	/* Nothing can be frozen until the engine has calculated a whole cycle of generations from this board,
+	   so the counts of the tiles aren't needed until then either. Only the population is kept, to work out the deaths from. */
+	self->generation = 0;
+	fillPlanes(&self->planes[0], cells);
+	self->haveStatistics = 0;
+	if(self->trackStatistics)
+		scanBoardStatistics(&self->planes[0], 0, 0, &self->statistics);
+	return;
+}
+
+/*
+	Function: stepFreezeEngine()
+	Purpose: Calculate the next generation of every tile that isn't frozen, a row at a time, and note which tiles are repeating.
+	Arguments: The engine (engine).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+	Note: The planes that the next generation is written to hold the generation FREEZE_CYCLE - 1 before it,
+	      so each word is compared with what it overwrites to find the tiles that are repeating.
+	      A frozen tile's words are already right, and it is still repeating.
+ */
+void stepFreezeEngine(lifeEngine *engine)
+{
+	freezeEngine *self = (freezeEngine *)engine;
+	const boardPlanes *current = &self->planes[self->generation % FREEZE_CYCLE];
+	boardPlanes *next = &self->planes[(self->generation + 1) % FREEZE_CYCLE];
+	int words = current->liveWordsPerRow;
+	int ageWords = current->ageWordsPerRow;
+
+	/* The cells past the end of the last word of each row don't exist, so must be kept dead */
+	uint64_t lastWordMask = (current->width % 64 == 0) ? ~(uint64_t)0 : ( ((uint64_t)1 << (current->width % 64)) - 1 );
+
+	/* The repeating flags compare the current generation with one that was calculated since the board was loaded,
+	   so they can only be trusted once a whole cycle has been calculated */
+	int canFreeze = (self->generation >= FREEZE_CYCLE);
+
+	/* A frozen tile's counts are already in the next generation's, like its cells */
+	size_t noOfTiles = (size_t)self->tileRows * words;
+	uint16_t *populations = NULL, *births = NULL;
+	if(self->trackStatistics)
+	{
+		populations = self->tilePopulations + (self->generation + 1) % FREEZE_CYCLE * noOfTiles;
+		births = self->tileBirths + (self->generation + 1) % FREEZE_CYCLE * noOfTiles;
+	}
+
+	int tileRow, row, lastRow, word, ageWord, noOfAgeWords;
+	unsigned char *nextRepeating;
+	const uint64_t *above, *below;
+	uint64_t newLive, newAges[4], *liveToWrite, *agesToWrite;
+
+	self->activeTiles = 0;
+	for(tileRow = 0; tileRow < self->tileRows; tileRow++)
+	{
+		/* Find the frozen tiles in this row of tiles first, so that the rest can be calculated a row of cells at a time */
+		nextRepeating = self->nextRepeating + (size_t)tileRow * words;
+		for(word = 0; word < words; word++)
+		{
+			self->frozenWords[word] = canFreeze && tileIsFrozen(self, tileRow, word);
+			nextRepeating[word] = 1;
+			if(!self->frozenWords[word])
+			{
+				self->activeTiles++;
+				if(self->trackStatistics)
+					populations[(size_t)tileRow * words + word] = births[(size_t)tileRow * words + word] = 0;
+			}
+		}
+
+		lastRow = (tileRow + 1) * FREEZE_TILE_ROWS;
+		if(lastRow > current->height)
+			lastRow = current->height;
+		for(row = tileRow * FREEZE_TILE_ROWS; row < lastRow; row++)
+		{
+			above = (row > 0) ? current->live + (size_t)(row - 1) * words : self->deadRow;
+			below = (row < current->height - 1) ? current->live + (size_t)(row + 1) * words : self->deadRow;
+			liveToWrite = next->live + (size_t)row * words;
+			agesToWrite = next->ages + (size_t)row * ageWords;
+			for(word = 0; word < words; word++)
+			{
+				if(self->frozenWords[word])
+					continue;
+
+				newLive = iterateLiveWord(above, current->live + (size_t)row * words, below, word, words);
+				if(word == words - 1)
+					newLive &= lastWordMask;
+				noOfAgeWords = (ageWords - 4 * word < 4) ? ageWords - 4 * word : 4;
+				updateAgeRow(current->live + (size_t)row * words + word, &newLive, current->ages + (size_t)row * ageWords + 4 * word, newAges, noOfAgeWords);
+
+				if(liveToWrite[word] != newLive)
+					nextRepeating[word] = 0;
+				liveToWrite[word] = newLive;
+				if(self->trackStatistics)
+				{
+					populations[(size_t)tileRow * words + word] += countBits(newLive);
+					births[(size_t)tileRow * words + word] += countBits(newLive & ~current->live[(size_t)row * words + word]);
+				}
+				for(ageWord = 0; ageWord < noOfAgeWords; ageWord++)
+				{
+					if(agesToWrite[4 * word + ageWord] != newAges[ageWord])
+						nextRepeating[word] = 0;
+					agesToWrite[4 * word + ageWord] = newAges[ageWord];
+				}
+			}
+		}
+	}
+
+	if(self->trackStatistics)
+		gatherFreezeStatistics(self, next, populations, births);
+
+	unsigned char *temp = self->repeating;
+	self->repeating = self->nextRepeating;
+	self->nextRepeating = temp;
+	self->generation++;
+	return;
+}
+
+/*
+	Function: tileIsFrozen()
+	Purpose: Test whether a tile can be skipped, because it and all the tiles around it are repeating.
+	Arguments: The engine (self), and the row of tiles and word of the tile (tileRow and word).
+	Return value: 1 if the tile is frozen, 0 otherwise.
+	Inputs from user: None.
+	Outputs to user: None.
+	Note: The tiles around a tile hold all the cells that its cells' next generation depends on.
+	      Past the edges of the board there are only dead cells, which are always repeating.
+ */
+int tileIsFrozen(const freezeEngine *self, int tileRow, int word)
+{
+	int words = self->planes[0].liveWordsPerRow;
+	int i, j;
+
+	for(i = tileRow - 1; i <= tileRow + 1; i++)
+		for(j = word - 1; j <= word + 1; j++)
+			if( (i >= 0) && (i < self->tileRows) && (j >= 0) && (j < words) && !self->repeating[(size_t)i * words + j] )
+				return 0;
+	return 1;
+}
+
+/*
+	Function: gatherFreezeStatistics()
+	Purpose: Work out the statistics of the generation a freezing engine has just calculated from the counts of its tiles.
+	Arguments: The engine (self), the generation's board (board), and the live cells and the cells just born in each of its tiles
+	           (populations and births).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+	Note: The bounding box is found from the tiles with live cells, so only the rows and columns of the tiles on its edges are read.
+ */
+void gatherFreezeStatistics(freezeEngine *self, const boardPlanes *board, const uint16_t *populations, const uint16_t *births)
+{
+	int words = board->liveWordsPerRow;
+	int tileRow, word, row, lastRow, firstTileRow = -1, lastTileRow = -1, firstWord = words, lastWord = -1;
+	long previousPopulation = self->statistics.population;
+	const uint16_t *tile;
+	const uint64_t *live;
+
+	startStatistics(&self->statistics, board->width, board->height);
+	for(tileRow = 0; tileRow < self->tileRows; tileRow++)
+		for(word = 0; word < words; word++)
+		{
+			tile = populations + (size_t)tileRow * words + word;
+			if(*tile == 0)
+				continue;
+			self->statistics.population += *tile;
+			self->statistics.births += births[tile - populations];
+			if(firstTileRow < 0)
+				firstTileRow = tileRow;
+			lastTileRow = tileRow;
+			if(word < firstWord)
+				firstWord = word;
+			if(word > lastWord)
+				lastWord = word;
+		}
+	self->statistics.deaths = previousPopulation + self->statistics.births - self->statistics.population;
+	self->haveStatistics = 1;
+	if(firstTileRow < 0)
+		return;
+
+	/* The top and bottom rows are in the first and last rows of tiles, and the left and right columns in the first and last words */
+	for(row = firstTileRow * FREEZE_TILE_ROWS; self->statistics.top > row; row++)
+		for(word = firstWord; word <= lastWord; word++)
+			if(board->live[(size_t)row * words + word] != 0)
+				self->statistics.top = row;
+	lastRow = ( (lastTileRow + 1) * FREEZE_TILE_ROWS < board->height ) ? (lastTileRow + 1) * FREEZE_TILE_ROWS - 1 : board->height - 1;
+	for(row = lastRow; self->statistics.bottom < row; row--)
+		for(word = firstWord; word <= lastWord; word++)
+			if(board->live[(size_t)row * words + word] != 0)
+				self->statistics.bottom = row;
+	for(row = self->statistics.top; row <= self->statistics.bottom; row++)
+	{
+		live = board->live + (size_t)row * words;
+		if( (live[firstWord] != 0) && (64 * firstWord + countTrailingZeros(live[firstWord]) < self->statistics.left) )
+			self->statistics.left = 64 * firstWord + countTrailingZeros(live[firstWord]);
+		if( (live[lastWord] != 0) && (64 * lastWord + 63 - countLeadingZeros(live[lastWord]) > self->statistics.right) )
+			self->statistics.right = 64 * lastWord + 63 - countLeadingZeros(live[lastWord]);
+	}
+	return;
+}
+
+/*
+	Function: freezeEngineStatistics()
+	Purpose: Give the statistics of the current board of a freezing engine, which it works out as it calculates each generation if asked to.
+	Arguments: The engine (engine), and where to write the statistics (statistics).
+	Return value: 1 if the statistics were written.
+	              0 if the engine hasn't got them, because it wasn't asked to keep them or hasn't calculated a generation since it was loaded.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+int freezeEngineStatistics(lifeEngine *engine, boardStatistics *statistics)
+{
+	freezeEngine *self = (freezeEngine *)engine;
+	if(!self->haveStatistics)
+		return 0;
+	*statistics = self->statistics;
+	return 1;
+}
+
+/*
+	Function: viewFreezeEngine()
+	Purpose: Provide the current board of a freezing engine.
+	Arguments: The engine (engine).
+	Return value: A pointer to the planes, which are valid until the engine is next used.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+const boardPlanes *viewFreezeEngine(lifeEngine *engine)
+{
+	freezeEngine *self = (freezeEngine *)engine;
+	return &self->planes[self->generation % FREEZE_CYCLE];
+}
+
+/*
+	Function: measureFreezeEngine()
+	Purpose: Count the live cells of a freezing engine's board, and the cells that changed in the last generation.
+	Arguments: The engine (engine), and where to write the counts (population and changed).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+void measureFreezeEngine(lifeEngine *engine, long *population, long *changed)
+{
+	freezeEngine *self = (freezeEngine *)engine;
+	const boardPlanes *current = &self->planes[self->generation % FREEZE_CYCLE];
+	const boardPlanes *previous = &self->planes[(self->generation + FREEZE_CYCLE - 1) % FREEZE_CYCLE];
+	size_t i, noOfWords = (size_t)current->height * current->liveWordsPerRow;
+
+	*population = *changed = 0;
+	for(i = 0; i < noOfWords; i++)
+	{
+		*population += countBits(current->live[i]);
+		if(self->generation > 0)
+			*changed += countBits(current->live[i] ^ previous->live[i]);
+	}
+	return;
+}
+
+/*
+	Function: estimateFreezeCost()
+	Purpose: Estimate the time the freezing engine takes for a generation, from the area of the board and the cells that changed.
+	Arguments: The area of the board (area), the number of live cells (population), which isn't used, and the cells that changed (changed).
+	Return value: The estimated time in nanoseconds.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+double estimateFreezeCost(double area, long population, long changed)
+{
+	(void)population;
+	double activeArea = FREEZE_CELLS_PER_CHANGED_CELL * changed;
+	if(activeArea > area)
+		activeArea = area;
+	return FREEZE_COST_PER_CELL * area + BIT_COST_PER_CELL * activeArea;
+}
+
+/*
+	Function: freezeEngineMemory()
+	Purpose: Estimate the most memory a freezing engine allocates for a board.
+	Arguments: The width and height of the board (width and height), and the command line settings (options), which aren't used.
+	Return value: The number of bytes.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+double freezeEngineMemory(int width, int height, const engineOptions *options)
+{
+	double tiles = (double)( ( (long)height + FREEZE_TILE_ROWS - 1 ) / FREEZE_TILE_ROWS ) * ( ( (long)width + 63 ) / 64 );
+	double tileCounts = options->trackStatistics ? 2 * FREEZE_CYCLE * tiles * sizeof(uint16_t) + 2 * ARENA_ALIGNMENT : 0;
+	return sizeof(freezeEngine) + FREEZE_CYCLE * planesSize(width, height) + 2 * tiles + ( ( (long)width + 63 ) / 64 ) * (1 + sizeof(uint64_t))
+	       + tileCounts + 5 * ARENA_ALIGNMENT;
+}
+
+/*
+	Function: destroyFreezeEngine()
+	Purpose: Free a freezing engine.
+	Arguments: The engine (engine).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+void destroyFreezeEngine(lifeEngine *engine)
+{
+	freezeEngine *self = (freezeEngine *)engine;
+	int i;
+
+	for(i = 0; i < FREEZE_CYCLE; i++)
+		freePlanes(&self->planes[i]);
+	freeMemory(self->repeating);
+	freeMemory(self->nextRepeating);
+	freeMemory(self->frozenWords);
+	freeMemory(self->deadRow);
+	freeMemory(self->tilePopulations);
+	freeMemory(self->tileBirths);
+	freeMemory(self);
+	return;
+}
+
+/*
+	Function: startOutputPipeline()
+	Purpose: Allocate the slots of the output pipeline, and start the writer thread.
+	Arguments: The pipeline to start (pipeline), the number of boards that can wait to be output (noOfSlots),
+	           the size of the boards (width and height), what to do when they are all waiting (policy),
+	           and the function the writer thread outputs each board with, along with the first argument to pass it (writeBoard and context).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: An error message if the writer thread can't be started.
+ */
+void startOutputPipeline(outputPipeline *pipeline, int noOfSlots, int width, int height, outputPolicy policy,
+                         void (*writeBoard)(void *context, const boardPlanes *board), void *context)
+{
+	int i;
+
+	pipeline->noOfSlots = noOfSlots;
+	pipeline->slots = (boardPlanes *)allocateMemory(noOfSlots * sizeof(boardPlanes));
+	pipeline->slotIsStop = (int *)allocateMemory(noOfSlots * sizeof(int));
+	for(i = 0; i < noOfSlots; i++)
+		allocatePlanes(&pipeline->slots[i], width, height);
+
+	atomic_init(&pipeline->head, 0);
+	atomic_init(&pipeline->tail, 0);
+	sem_init(&pipeline->fullSlots, 0, 0);
+	sem_init(&pipeline->freeSlots, 0, noOfSlots);
+
+	pipeline->policy = policy;
+	pipeline->haveCoalesced = 0;
+	pipeline->droppedBoards = 0;
+	pipeline->writeBoard = writeBoard;
+	pipeline->context = context;
+	if(policy == OUTPUT_COALESCE)
+		allocatePlanes(&pipeline->coalesced, width, height);
+
+	if(pthread_create(&pipeline->writer, NULL, writeBoards, pipeline) != 0)
+	{
+		fputs("Error starting the output thread.\n"
+		      "The program will now exit.\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+	return;
+}
+
+/*
+	Function: queueBoard()
+	Purpose: Pass a copy of a board to the writer thread to be output, following the pipeline's policy if the buffer is full.
+	Arguments: The pipeline (pipeline), and the board to print (board).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+	Note: Only the block policy ever waits for the writer thread.
+ */
+void queueBoard(outputPipeline *pipeline, const boardPlanes *board)
+{
+	switch(pipeline->policy)
+	{
+		case OUTPUT_BLOCK:
+			publishToPipeline(pipeline, board, 0, 1, 1);
+			break;
+
+		case OUTPUT_DROP:
+			if(!publishToPipeline(pipeline, board, 0, 0, 1))
+				pipeline->droppedBoards++;
+			break;
+
+		case OUTPUT_COALESCE:
+			/* A board kept aside is older than this one, so it has to go first.
+			   If it still doesn't fit, this board replaces it. */
+			if(pipeline->haveCoalesced)
+			{
+				if(publishToPipeline(pipeline, &pipeline->coalesced, 0, 0, 1))
+					pipeline->haveCoalesced = 0;
+				else
+					pipeline->droppedBoards++;
+			}
+			if(pipeline->haveCoalesced || !publishToPipeline(pipeline, board, 0, 0, 1))
+			{
+				copyPlanes(&pipeline->coalesced, board);
+				pipeline->haveCoalesced = 1;
+			}
+			break;
+	}
+	return;
+}
+
+/*
+	Function: publishToPipeline()
+	Purpose: Copy a board into the next free slot of the ring, and pass it to the writer thread.
+	Arguments: The pipeline (pipeline), the board to copy (board),
+	           whether this is the stop marker rather than a board (isStop), whether to wait for a free slot (wait),
+	           and whether the writer needs the age plane as well as the live plane (copyAges).
+	Return value: 1 if the board was passed to the writer thread.
+	              0 if there was no free slot and wait was 0.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+int publishToPipeline(outputPipeline *pipeline, const boardPlanes *board, int isStop, int wait, int copyAges)
+{
+	if(wait)
+	{
+		while(sem_wait(&pipeline->freeSlots) != 0)
+			;
+	}
+	else if(sem_trywait(&pipeline->freeSlots) != 0)
+		return 0;
+
+	/* Only this thread moves the tail, so it can be read without synchronisation.
+	   Storing it with release ordering makes the copied board visible to the writer before the new tail is. */
+	int tail = atomic_load_explicit(&pipeline->tail, memory_order_relaxed);
+	pipeline->slotIsStop[tail] = isStop;
+	if(!isStop && copyAges)
+		copyPlanes(&pipeline->slots[tail], board);
+	else if(!isStop)
+		memcpy(pipeline->slots[tail].live, board->live, (size_t)board->height * board->liveWordsPerRow * sizeof(uint64_t));
+	atomic_store_explicit(&pipeline->tail, (tail + 1) % pipeline->noOfSlots, memory_order_release);
+
+	sem_post(&pipeline->fullSlots);
+	return 1;
+}
+
+/*
+	Function: copyPlanes()
+	Purpose: Copy the live and age planes of one board to another of the same size.
+	Arguments: The board to copy to (destination), and the board to copy (source).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+void copyPlanes(boardPlanes *destination, const boardPlanes *source)
+{
+	memcpy(destination->live, source->live, (size_t)source->height * source->liveWordsPerRow * sizeof(uint64_t));
+	memcpy(destination->ages, source->ages, (size_t)source->height * source->ageWordsPerRow * sizeof(uint64_t));
+	return;
+}
+
+/*
+	Function: stopOutputPipeline()
+	Purpose: Output any board kept aside, wait for the writer thread to output every queued board, then free the pipeline.
+	Arguments: The pipeline to stop (pipeline).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: The number of boards that weren't output, if any were dropped.
+ */
+void stopOutputPipeline(outputPipeline *pipeline)
+{
+	int i;
+
+	if(pipeline->haveCoalesced)
+		publishToPipeline(pipeline, &pipeline->coalesced, 0, 1, 1);
+	publishToPipeline(pipeline, NULL, 1, 1, 0);
+	pthread_join(pipeline->writer, NULL);
+	fflush(stdout);
+
+	if(pipeline->droppedBoards > 0)
+		fprintf(stderr, "%ld boards were not printed because the output buffer was full.\n", pipeline->droppedBoards);
+
+	for(i = 0; i < pipeline->noOfSlots; i++)
+		freePlanes(&pipeline->slots[i]);
+	freeMemory(pipeline->slots);
+	freeMemory(pipeline->slotIsStop);
+	if(pipeline->policy == OUTPUT_COALESCE)
+		freePlanes(&pipeline->coalesced);
+	sem_destroy(&pipeline->fullSlots);
+	sem_destroy(&pipeline->freeSlots);
+	return;
+}
+
+/*
+	Function: writeBoards()
+	Purpose: The writer thread: output the boards in the output pipeline in order, until the stop marker is reached.
+	Arguments: The pipeline (argument).
+	Return value: None (NULL).
+	Inputs from user: None.
+	Outputs to user: Whatever writeBoard() outputs.
+ */
+void *writeBoards(void *argument)
+{
+	outputPipeline *pipeline = (outputPipeline *)argument;
+	int head;
+
+	while(1)
+	{
+		while(sem_wait(&pipeline->fullSlots) != 0)
+			;
+
+		/* Only this thread moves the head. Loading the tail with acquire ordering makes the board in the slot visible. */
+		head = atomic_load_explicit(&pipeline->head, memory_order_relaxed);
+		atomic_load_explicit(&pipeline->tail, memory_order_acquire);
+		if(pipeline->slotIsStop[head])
+			break;
+
+		pipeline->writeBoard(pipeline->context, &pipeline->slots[head]);
+
+		atomic_store_explicit(&pipeline->head, (head + 1) % pipeline->noOfSlots, memory_order_release);
+		sem_post(&pipeline->freeSlots);
+	}
+
+	return NULL;
+}
+
+/*
+	Function: printQueuedBoard()
+	Purpose: Print a board from the printing pipeline, in the form writeBoards() expects.
+	Arguments: Nothing (context), and the board to print (board).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: The board that is printed.
+ */
+void printQueuedBoard(void *context, const boardPlanes *board)
+{
+	(void)context;
+	printBoard(board);
+	return;
+}
+
+/*
+	Function: openViewport()
+	Purpose: Set up a view of part of the board, with an empty population pyramid and image.
+	Arguments: The viewport to set up (viewport), the cell at its top left (top and left), which is moved up and left to the start of its block,
+	           the zoom, as the power of two of the width and height of the block of cells in each pixel (zoom),
+	           the size of the view in characters (columns and rows), and whether each character holds two pixels (halfBlocks).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+void openViewport(boardViewport *viewport, int top, int left, int zoom, int columns, int rows, int halfBlocks)
+{
+	viewport->zoom = zoom;
+	viewport->top = (int)( ( (long)top >> zoom ) << zoom );
+	viewport->left = (int)( ( (long)left >> zoom ) << zoom );
+	viewport->columns = columns;
+	viewport->rows = rows;
+	viewport->halfBlocks = halfBlocks;
+	allocatePyramid(&viewport->pyramid, boardWidth, boardHeight);
+	allocatePlanes(&viewport->image, columns, halfBlocks ? 2 * rows : rows);
+	viewport->pixelCounts = (long *)allocateMemory( (size_t)columns * viewport->image.height * sizeof(long) );
+	return;
+}
+
+/*
+	Function: closeViewport()
+	Purpose: Free the population pyramid and image of a view.
+	Arguments: The viewport to free (viewport).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+void closeViewport(boardViewport *viewport)
+{
+	freePyramid(&viewport->pyramid);
+	freePlanes(&viewport->image);
+	freeMemory(viewport->pixelCounts);
+	return;
+}
+
+/*
+	Function: viewportMemory()
+	Purpose: Calculate the memory needed for a view of the board, for estimating the size of the arenas.
+	Arguments: The size of the view in characters (columns and rows), and whether each character holds two pixels (halfBlocks).
+	Return value: The number of bytes, including the arena headers.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+double viewportMemory(int columns, int rows, int halfBlocks)
+{
+	return pyramidMemory(boardWidth, boardHeight) + planesSize(columns, halfBlocks ? 2 * rows : rows)
+	       + (double)columns * (halfBlocks ? 2 * rows : rows) * sizeof(long) + ARENA_ALIGNMENT;
+}
+
+/*
+	Function: allocatePyramid()
+	Purpose: Allocate the levels of a population pyramid for an empty board.
+	Arguments: The pyramid to allocate (pyramid), and the width and height of the board (width and height).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+void allocatePyramid(populationPyramid *pyramid, int width, int height)
+{
+	int level;
+
+	pyramid->width = width;
+	pyramid->height = height;
+	pyramid->liveWordsPerRow = (width + 63) / 64;
+
+	/* The levels go up until one block covers the board, so that a view of the whole board never sums more than a few blocks.
+	   There is always a level above the first, which blocks bigger than the last level are summed from. */
+	pyramid->noOfLevels = PYRAMID_FIRST_LEVEL + 2;
+	while( (pyramid->noOfLevels <= PYRAMID_LAST_LEVEL) && ( (width > (1L << (pyramid->noOfLevels - 1))) || (height > (1L << (pyramid->noOfLevels - 1))) ) )
+		pyramid->noOfLevels++;
+
+	for(level = PYRAMID_FIRST_LEVEL; level < pyramid->noOfLevels; level++)
+	{
+		pyramid->rows[level] = (int)( ( (long)height + (1L << level) - 1 ) >> level );
+		pyramid->columns[level] = (int)( ( (long)width + (1L << level) - 1 ) >> level );
+		if(level > PYRAMID_FIRST_LEVEL)
+			pyramid->counts[level] = (uint32_t *)allocateMemory( (size_t)pyramid->rows[level] * pyramid->columns[level] * sizeof(uint32_t) );
+	}
+	pyramid->firstLevel = (uint64_t *)allocateMemory( (size_t)pyramid->rows[PYRAMID_FIRST_LEVEL] * pyramid->liveWordsPerRow * sizeof(uint64_t) );
+	pyramid->sums = (uint64_t *)allocateMemory(pyramid->liveWordsPerRow * sizeof(uint64_t));
+	return;
+}
+
+/*
+	Function: freePyramid()
+	Purpose: Free the memory used by a population pyramid.
+	Arguments: The pyramid to free (pyramid).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+void freePyramid(populationPyramid *pyramid)
+{
+	int level;
+
+	for(level = PYRAMID_FIRST_LEVEL + 1; level < pyramid->noOfLevels; level++)
+		freeMemory(pyramid->counts[level]);
+	freeMemory(pyramid->firstLevel);
+	freeMemory(pyramid->sums);
+	return;
+}
+
+/*
+	Function: pyramidMemory()
+	Purpose: Calculate the memory needed for the population pyramid of a board, for estimating the size of the arenas.
+	Arguments: The width and height of the board (width and height).
+	Return value: The number of bytes, including the arena headers.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+double pyramidMemory(int width, int height)
+{
+	double size = ( ( (long)height + 7 ) / 8 + 1.0 ) * ( ( (long)width + 63 ) / 64 ) * sizeof(uint64_t) + 2 * ARENA_ALIGNMENT;
+	int level;
+
+	for(level = PYRAMID_FIRST_LEVEL + 1; level <= PYRAMID_LAST_LEVEL; level++)
+		size += (double)( ( (long)height + (1L << level) - 1 ) >> level ) * ( ( (long)width + (1L << level) - 1 ) >> level ) * sizeof(uint32_t)
+		        + 2 * ARENA_ALIGNMENT;
+	return size;
+}
+
+/*
+	Function: updatePyramid()
+	Purpose: Bring a population pyramid up to date with a board, changing only the blocks above the blocks of the first level that changed.
+	Arguments: The pyramid to update (pyramid), and the board (board).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+	Note: The first level is counted afresh from the live plane, a byte at a time in parallel as in countRowBits(), so the board is read once,
+	      but the levels above are only visited where a block of the first level changed.
+	      The populations are unsigned, but adding a negative change to them wraps round to the right population.
+ */
+void updatePyramid(populationPyramid *pyramid, const boardPlanes *board)
+{
+	int words = pyramid->liveWordsPerRow;
+	int blockRow, row, word, level, lane, noOfChanges;
+	int changes[8];
+
+	for(blockRow = 0; blockRow < pyramid->rows[PYRAMID_FIRST_LEVEL]; blockRow++)
+	{
+		/* Add up the cells in each byte of the block row's rows, which is the population of each of its blocks */
+		memset(pyramid->sums, 0, words * sizeof(uint64_t));
+		for(row = 8 * blockRow; (row < 8 * blockRow + 8) && (row < pyramid->height); row++)
+		{
+			const uint64_t *live = board->live + (size_t)row * words;
+			for(word = 0; word < words; word++)
+			{
+				uint64_t bits = live[word] - ( (live[word] >> 1) & 0x5555555555555555ULL );
+				bits = (bits & 0x3333333333333333ULL) + ( (bits >> 2) & 0x3333333333333333ULL );
+				pyramid->sums[word] += (bits + (bits >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+			}
+		}
+
+		uint64_t *populations = pyramid->firstLevel + (size_t)blockRow * words;
+		for(word = 0; word < words; word++)
+		{
+			if(pyramid->sums[word] == populations[word])
+				continue;
+			for(lane = 0; lane < 8; lane++)
+				changes[lane] = (int)( (pyramid->sums[word] >> (8 * lane)) & 0xFF ) - (int)( (populations[word] >> (8 * lane)) & 0xFF );
+			populations[word] = pyramid->sums[word];
+
+			/* Each level's blocks hold two of the level below's in each direction, so the changes are added in pairs
+			   until one change covers the whole word, which is in one block of every level from 64 x 64 up */
+			noOfChanges = 8;
+			for(level = PYRAMID_FIRST_LEVEL + 1; level < pyramid->noOfLevels; level++)
+			{
+				uint32_t *counts = pyramid->counts[level] + (size_t)(blockRow >> (level - PYRAMID_FIRST_LEVEL)) * pyramid->columns[level];
+				if(noOfChanges > 1)
+				{
+					noOfChanges /= 2;
+					for(lane = 0; lane < noOfChanges; lane++)
+						changes[lane] = changes[2 * lane] + changes[2 * lane + 1];
+				}
+				for(lane = 0; lane < noOfChanges; lane++)
+					if(changes[lane] != 0)
+						counts[( (long)word * 64 + lane * (64 / noOfChanges) ) >> level] += changes[lane];
+			}
+		}
+	}
+	return;
+}
+
+/*
+	Function: blockPopulation()
+	Purpose: Find the population of a block of cells from a population pyramid.
+	Arguments: The pyramid (pyramid), the board it was last updated from (board),
+	           the block's size, as the power of two of its width and height (zoom),
+	           and its position in blocks of that size (blockRow and blockColumn).
+	Return value: The number of live cells in the block, which is 0 if it is off the board.
+	Inputs from user: None.
+	Outputs to user: None.
+	Note: Blocks smaller than the first level are counted from the board's live plane, and blocks larger than the last
+	      are summed from the last level's blocks, so this reads at most 4 words or 4^(zoom - PYRAMID_LAST_LEVEL) blocks.
+ */
+long blockPopulation(const populationPyramid *pyramid, const boardPlanes *board, int zoom, long blockRow, long blockColumn)
+{
+	long population = 0, row, column;
+
+	if(zoom < PYRAMID_FIRST_LEVEL)
+	{
+		long top = blockRow << zoom, left = blockColumn << zoom;
+		if( (top >= pyramid->height) || (left >= pyramid->width) )
+			return 0;
+
+		/* The block is aligned to its size, so its columns are all in one word */
+		uint64_t mask = ( (UINT64_C(1) << (1 << zoom)) - 1 ) << (left % 64);
+		for(row = top; (row < top + (1L << zoom)) && (row < pyramid->height); row++)
+			population += countBits( board->live[row * board->liveWordsPerRow + left / 64] & mask );
+		return population;
+	}
+
+	if(zoom == PYRAMID_FIRST_LEVEL)
+	{
+		if( (blockRow >= pyramid->rows[zoom]) || (blockColumn >= pyramid->columns[zoom]) )
+			return 0;
+		return (long)( ( pyramid->firstLevel[blockRow * pyramid->liveWordsPerRow + blockColumn / 8] >> (8 * (blockColumn % 8)) ) & 0xFF );
+	}
+
+	int level = (zoom < pyramid->noOfLevels) ? zoom : pyramid->noOfLevels - 1;
+	long size = 1L << (zoom - level);
+	const uint32_t *counts = pyramid->counts[level];
+	for(row = blockRow * size; (row < (blockRow + 1) * size) && (row < pyramid->rows[level]); row++)
+		for(column = blockColumn * size; (column < (blockColumn + 1) * size) && (column < pyramid->columns[level]); column++)
+			population += counts[row * pyramid->columns[level] + column];
+	return population;
+}
+
+/*
+	Function: drawViewport()
+	Purpose: Bring a view's population pyramid up to date with the engine's board, and draw the view into its image.
+	Arguments: The viewport (viewport), and the engine (engine).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+	Note: Other than updating the pyramid, this takes time in proportion to the size of the view, whatever its zoom.
+	      An engine that can visit its cells has the view drawn from them instead, without the whole board being made.
+ */
+void drawViewport(boardViewport *viewport, lifeEngine *engine)
+{
+	boardPlanes *image = &viewport->image;
+	int row, column, zoom = viewport->zoom;
+	double blockArea = (double)(1L << zoom) * (1L << zoom);
+	const boardPlanes *board;
+
+	if(engine->type->visitCells != NULL)
+	{
+		drawViewportFromCells(viewport, engine);
+		return;
+	}
+
+	board = engine->type->view(engine);
+	updatePyramid(&viewport->pyramid, board);
+	memset(image->live, 0, (size_t)image->height * image->liveWordsPerRow * sizeof(uint64_t));
+	memset(image->ages, 0, (size_t)image->height * image->ageWordsPerRow * sizeof(uint64_t));
+
+	for(row = 0; row < image->height; row++)
+		for(column = 0; column < image->width; column++)
+		{
+			long population = blockPopulation(&viewport->pyramid, board, zoom, (viewport->top >> zoom) + row, (viewport->left >> zoom) + column);
+			if(population == 0)
+				continue;
+
+			/* A full size view shows the ages of the cells, and a zoomed out one the density of each block */
+			uint64_t age;
+			if(zoom == 0)
+			{
+				long cellRow = viewport->top + row, cellColumn = viewport->left + column;
+				age = ( board->ages[cellRow * board->ageWordsPerRow + cellColumn / 16] >> (4 * (cellColumn % 16)) ) & 0xF;
+			}
+			else
+				age = 1 + (uint64_t)( (DENSITY_LEVELS - 1) * (population / blockArea) );
+
+			image->live[row * image->liveWordsPerRow + column / 64] |= UINT64_C(1) << (column % 64);
+			image->ages[row * image->ageWordsPerRow + column / 16] |= age << (4 * (column % 16));
+		}
+	return;
+}
+
+/*
+	Function: drawViewportFromCells()
+	Purpose: Draw a view into its image from the live cells inside it, which the engine visits.
+	Arguments: The viewport (viewport), and the engine, which must provide visitCells() (engine).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+	Note: This takes time in proportion to the size of the view and the number of live cells in it, however big the board is.
+ */
+void drawViewportFromCells(boardViewport *viewport, lifeEngine *engine)
+{
+	boardPlanes *image = &viewport->image;
+	int row, column, zoom = viewport->zoom;
+	double blockArea = (double)(1L << zoom) * (1L << zoom);
+	long bottom = viewport->top + ( (long)image->height << zoom ) - 1, right = viewport->left + ( (long)image->width << zoom ) - 1;
+	long population;
+
+	memset(image->live, 0, (size_t)image->height * image->liveWordsPerRow * sizeof(uint64_t));
+	memset(image->ages, 0, (size_t)image->height * image->ageWordsPerRow * sizeof(uint64_t));
+	memset(viewport->pixelCounts, 0, (size_t)image->height * image->width * sizeof(long));
+	if( (viewport->top >= engine->height) || (viewport->left >= engine->width) )
+		return;
+
+	/* A full size view is drawn as the cells are visited, and a zoomed out one once they have all been counted */
+	engine->type->visitCells(engine, viewport->top, viewport->left, (bottom < engine->height) ? (int)bottom : engine->height - 1,
+	                         (right < engine->width) ? (int)right : engine->width - 1, countViewportCell, viewport);
+	if(zoom == 0)
+		return;
+
+	for(row = 0; row < image->height; row++)
+		for(column = 0; column < image->width; column++)
+		{
+			population = viewport->pixelCounts[(size_t)row * image->width + column];
+			if(population == 0)
+				continue;
+			image->live[row * image->liveWordsPerRow + column / 64] |= UINT64_C(1) << (column % 64);
+			image->ages[row * image->ageWordsPerRow + column / 16] |= ( 1 + (uint64_t)( (DENSITY_LEVELS - 1) * (population / blockArea) ) )
+			                                                          << (4 * (column % 16));
+		}
+	return;
+}
+
+/*
+	Function: countViewportCell()
+	Purpose: Add a live cell passed by an engine's visitCells() to the pixel of a view that it is in.
+	Arguments: The viewport (context), the cell's row and column (row and column), and its age (age).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+void countViewportCell(void *context, int row, int column, int age)
+{
+	boardViewport *viewport = (boardViewport *)context;
+	boardPlanes *image = &viewport->image;
+	int pixelRow = (row - viewport->top) >> viewport->zoom, pixelColumn = (column - viewport->left) >> viewport->zoom;
+
+	if(viewport->zoom > 0)
+	{
+		viewport->pixelCounts[(size_t)pixelRow * image->width + pixelColumn]++;
+		return;
+	}
+	image->live[pixelRow * image->liveWordsPerRow + pixelColumn / 64] |= UINT64_C(1) << (pixelColumn % 64);
+	image->ages[pixelRow * image->ageWordsPerRow + pixelColumn / 16] |= (uint64_t)age << (4 * (pixelColumn % 16));
+	return;
+}
+
+/*
+	Function: printViewport()
+	Purpose: Print a view of the board from the printing pipeline, in the form writeBoards() expects, with the same border as printBoard().
+	         With half blocks, each character shows the pixel above it with its top half and the pixel below with its bottom half,
+	         and a pixel is shown if any of its cells are alive. Otherwise a full size view is printed like a board,
+	         and a zoomed out one with densityCharacters.
+	Arguments: The viewport (context), and the view's image (image).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: The view that is printed.
+ */
+void printViewport(void *context, const boardPlanes *image)
+{
+	const boardViewport *viewport = (const boardViewport *)context;
+	int row, column, i;
+
+	printBorderRow(viewport->columns);
+	for(row = 0; row < viewport->rows; row++)
+	{
+		putchar('|');
+		for(column = 0; column < viewport->columns; column++)
+		{
+			if(viewport->halfBlocks)
+			{
+				int upper = ( image->live[2 * row * image->liveWordsPerRow + column / 64] >> (column % 64) ) & 1;
+				int lower = ( image->live[(2 * row + 1) * image->liveWordsPerRow + column / 64] >> (column % 64) ) & 1;
+				if(upper && lower)
+					fputs("\u2588", stdout);
+				else if(upper)
+					fputs("\u2580", stdout);
+				else if(lower)
+					fputs("\u2584", stdout);
+				else
+					putchar(' ');
+				continue;
+			}
+
+			int age = (int)( ( image->ages[row * image->ageWordsPerRow + column / 16] >> (4 * (column % 16)) ) & 0xF );
+			if( !( ( image->live[row * image->liveWordsPerRow + column / 64] >> (column % 64) ) & 1 ) )
+				putchar(' ');
+			else if(viewport->zoom == 0)
+				putchar(ageCharacters[age]);
+			else
+				putchar(densityCharacters[ (age * (int)(sizeof(densityCharacters) - 2) + DENSITY_LEVELS - 1) / DENSITY_LEVELS ]);
+		}
+		puts("|");
+	}
+	printBorderRow(viewport->columns);
+
+	/* Put two blank lines after the view, as after a board */
+	for(i = 1; i <= 2; i++)
+		putchar('\n');
+	return;
+}
+
+/*
+	Function: openImageDump()
+	Purpose: Create the file that the views of the board are dumped to.
+	Arguments: The dump to open (dump), the name of the file to create (fileName), and the viewport whose views are dumped (viewport).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: An error message if the file can't be created.
+	Note: The file has no header: it is one frame after another, each a byte per pixel, row by row, as many pixels wide and high as the image.
+	      Each byte is the fraction of the pixel's cells that are alive, from 0 to 255, in DENSITY_LEVELS steps, so the file can be read
+	      as raw 8 bit greyscale video (e.g. by ffmpeg -f rawvideo -pixel_format gray -video_size <width>x<height>).
+ */
+void openImageDump(imageDump *dump, const char *fileName, const boardViewport *viewport)
+{
+	dump->file = fopen(fileName, "wb");
+	if(dump->file == NULL)
+	{
+		fprintf(stderr, "Error opening image dump file (%s) for writing.\n"
+		                "The program will now exit.\n", fileName);
+		exit(EXIT_FAILURE);
+	}
+
+	/* The file's buffer is allocated here, so that the C library doesn't allocate one when the first frame is written */
+	dump->streamBuffer = (char *)allocateMemory(STREAM_BUFFER_SIZE);
+	setvbuf(dump->file, dump->streamBuffer, _IOFBF, STREAM_BUFFER_SIZE);
+
+	dump->pixels = (unsigned char *)allocateMemory(viewport->image.width);
+	dump->viewport = viewport;
+	return;
+}
+
+/*
+	Function: dumpImage()
+	Purpose: Append a view of the board to an image dump, in the form writeBoards() expects.
+	Arguments: The dump (context), and the view's image (image).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+	Note: This is called by the dump's writer thread, so the writing is kept off the simulation thread.
+ */
+void dumpImage(void *context, const boardPlanes *image)
+{
+	imageDump *dump = (imageDump *)context;
+	int row, column;
+
+	for(row = 0; row < image->height; row++)
+	{
+		for(column = 0; column < image->width; column++)
+		{
+			int age = (int)( ( image->ages[row * image->ageWordsPerRow + column / 16] >> (4 * (column % 16)) ) & 0xF );
+			if( !( ( image->live[row * image->liveWordsPerRow + column / 64] >> (column % 64) ) & 1 ) )
+				dump->pixels[column] = 0;
+			else if(dump->viewport->zoom == 0)
+				dump->pixels[column] = 255;
+			else
+				dump->pixels[column] = (unsigned char)(age * 255 / DENSITY_LEVELS);
+		}
+		fwrite(dump->pixels, 1, image->width, dump->file);
+	}
+	return;
+}
+
+/*
+	Function: closeImageDump()
+	Purpose: Close an image dump's file and free the dump.
+	Arguments: The dump to close (dump).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+void closeImageDump(imageDump *dump)
+{
+	fclose(dump->file);
+	freeMemory(dump->streamBuffer);
+	freeMemory(dump->pixels);
+	return;
+}
+
+/*
+	Function: startThreadPool()
+	Purpose: Start the helper threads of a thread pool, which wait until they are given a job by runPoolTasks().
+	Arguments: The pool to start (pool), and the no. of threads to share each job between, including the calling thread (noOfThreads).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: An error message if a helper thread can't be started.
+	Note: The helpers must be started after any worker processes, which are forked when the engine is loaded.
+ */
+void startThreadPool(threadPool *pool, int noOfThreads)
+{
+	int i;
+
+	pool->noOfThreads = noOfThreads;
+	pool->helpers = (pthread_t *)allocateMemory(noOfThreads * sizeof(pthread_t));
+	pool->stopping = 0;
+	sem_init(&pool->startTasks, 0, 0);
+	sem_init(&pool->tasksDone, 0, 0);
+
+	for(i = 0; i < noOfThreads - 1; i++)
+		if(pthread_create(&pool->helpers[i], NULL, runHelper, pool) != 0)
+		{
+			fputs("Error starting the helper threads.\n"
+			      "The program will now exit.\n", stderr);
+			exit(EXIT_FAILURE);
+		}
+	return;
+}
+
+/*
+	Function: runPoolTasks()
+	Purpose: Run a job of numbered tasks on the threads of a pool, and wait for them all to finish.
+	Arguments: The pool (pool), the no. of tasks (noOfTasks),
+	           and the function that runs a task, along with the first argument to pass it (runTask and context).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+	Note: The calling thread runs tasks too, so a job is only handed to the helpers if there is more than one task.
+	      A helper may take more than one of the posts on startTasks, but each post is matched by a post on tasksDone,
+	      so every helper has finished with the job when this returns.
+ */
+void runPoolTasks(threadPool *pool, int noOfTasks, void (*runTask)(void *context, int task), void *context)
+{
+	int i, task;
+
+	if( (pool->noOfThreads == 1) || (noOfTasks == 1) )
+	{
+		for(task = 0; task < noOfTasks; task++)
+			runTask(context, task);
+		return;
+	}
+
+	/* Posting the semaphore makes the job visible to the helpers before they start */
+	pool->runTask = runTask;
+	pool->context = context;
+	pool->noOfTasks = noOfTasks;
+	atomic_store(&pool->nextTask, 0);
+	for(i = 0; i < pool->noOfThreads - 1; i++)
+		sem_post(&pool->startTasks);
+
+	while( (task = atomic_fetch_add(&pool->nextTask, 1)) < noOfTasks )
+		runTask(context, task);
+
+	for(i = 0; i < pool->noOfThreads - 1; i++)
+		while(sem_wait(&pool->tasksDone) != 0)
+			;
+	return;
+}
+
+/*
+	Function: runHelper()
+	Purpose: A helper thread of a thread pool: run tasks from each job it is given, until the pool is stopped.
+	Arguments: The pool (argument).
+	Return value: None (NULL).
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+void *runHelper(void *argument)
+{
+	threadPool *pool = (threadPool *)argument;
+	int task;
+
+	while(1)
+	{
+		while(sem_wait(&pool->startTasks) != 0)
+			;
+		if(pool->stopping)
+			break;
+
+		while( (task = atomic_fetch_add(&pool->nextTask, 1)) < pool->noOfTasks )
+			pool->runTask(pool->context, task);
+		sem_post(&pool->tasksDone);
+	}
+
+	return NULL;
+}
+
+/*
+	Function: stopThreadPool()
+	Purpose: Stop the helper threads of a thread pool, and free the pool.
+	Arguments: The pool to stop (pool).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+void stopThreadPool(threadPool *pool)
+{
+	int i;
+
+	pool->stopping = 1;
+	for(i = 0; i < pool->noOfThreads - 1; i++)
+		sem_post(&pool->startTasks);
+	for(i = 0; i < pool->noOfThreads - 1; i++)
+		pthread_join(pool->helpers[i], NULL);
+
+	freeMemory(pool->helpers);
+	sem_destroy(&pool->startTasks);
+	sem_destroy(&pool->tasksDone);
+	return;
+}
+
+/*
+	Function: openFrameLog()
+	Purpose: Create a frame log file and write its header.
+	Arguments: The log to open (log), the name of the file to create (fileName),
+	           the number of generations between keyframes (keyframeInterval),
+	           and the largest generation number that will be logged (maxGenerations), so the keyframe index can be allocated.
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: An error message if the file can't be created.
+	Note: All numbers in the log are in the byte order of the machine that wrote it. The file is laid out as:
+	        header:  "LIFELOG1", int32 width, int32 height, int32 keyframe interval, int32 0
+	        records: int64 generation, int32 type, int32 payload length, then the payload,
+	                 where a keyframe (type 0) holds the live plane followed by the age plane,
+	                 and a delta (type 1) holds the live plane XORed with the previous generation's.
+	                 Both are compressed with encodeZeroRuns(), and the ages in a delta follow from the live planes.
+	                 Each record is at most (live words + age words) * 10 + 32 bytes long.
+	        index:   int64 generation and int64 file offset of each keyframe record
+	        trailer: "LIFEIDX1", int64 offset of the index, int64 number of keyframes, int64 number of generations
+	      A log that was never closed has no index or trailer, so lifereplay rebuilds the index by reading the records.
+ */
+void openFrameLog(frameLog *log, const char *fileName, int keyframeInterval, long maxGenerations)
+{
+	log->file = fopen(fileName, "wb");
+	if(log->file == NULL)
+	{
+		fprintf(stderr, "Error opening log file (%s) for writing.\n"
+		                "The program will now exit.\n", fileName);
+		exit(EXIT_FAILURE);
+	}
+
+	/* The file's buffer is allocated here, so that the C library doesn't allocate one when the first record is written */
+	log->streamBuffer = (char *)allocateMemory(STREAM_BUFFER_SIZE);
+	setvbuf(log->file, log->streamBuffer, _IOFBF, STREAM_BUFFER_SIZE);
+
+	log->keyframeInterval = keyframeInterval;
+	log->generation = 0;
+	log->noOfKeyframes = 0;
+	allocatePlanes(&log->previous, boardWidth, boardHeight);
+
+	size_t liveWords = (size_t)boardHeight * log->previous.liveWordsPerRow;
+	size_t ageWords = (size_t)boardHeight * log->previous.ageWordsPerRow;
+
+	/* In the worst case a word costs its 8 bytes plus a mask byte, and every other word is a zero word
+	   costing two bytes of run length and end marker, so this is always enough room for a record */
+	log->buffer = (unsigned char *)allocateMemory( (liveWords + ageWords) * (sizeof(uint64_t) + 2) + 32 );
+
+	log->keyframeGenerations = (int64_t *)allocateMemory( (maxGenerations / keyframeInterval + 1) * sizeof(int64_t) );
+	log->keyframeOffsets = (int64_t *)allocateMemory( (maxGenerations / keyframeInterval + 1) * sizeof(int64_t) );
+
+	int32_t header[4] = {boardWidth, boardHeight, keyframeInterval, 0};
+	fwrite("LIFELOG1", 1, 8, log->file);
+	fwrite(header, sizeof(int32_t), 4, log->file);
+	return;
+}
+
+/*
+	Function: logBoard()
+	Purpose: Record the next generation in a frame log, as a keyframe every keyframeInterval generations and as a delta otherwise.
+	Arguments: The log (context), and the board to record (board), whose age plane is only needed for a keyframe.
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+	Note: This is called by the log's writer thread, so the work of compressing and writing is kept off the simulation thread.
+ */
+void logBoard(void *context, const boardPlanes *board)
+{
+	frameLog *log = (frameLog *)context;
+	size_t liveWords = (size_t)board->height * board->liveWordsPerRow;
+	size_t ageWords = (size_t)board->height * board->ageWordsPerRow;
+
+	if(log->generation % log->keyframeInterval == 0)
+	{
+		log->keyframeGenerations[log->noOfKeyframes] = log->generation;
+		log->keyframeOffsets[log->noOfKeyframes] = ftell(log->file);
+		log->noOfKeyframes++;
+		writeLogRecord(log, 0, board->live, NULL, liveWords, board->ages, ageWords);
+	}
+	else
+		writeLogRecord(log, 1, board->live, log->previous.live, liveWords, NULL, 0);
+
+	/* Only the live plane is needed to calculate the next delta */
+	memcpy(log->previous.live, board->live, liveWords * sizeof(uint64_t));
+	log->generation++;
+	return;
+}
+
+/*
+	Function: writeLogRecord()
+	Purpose: Compress one or two blocks of words and write them to a frame log as a record.
+	Arguments: The log (log), the type of record (type),
+	           the first block of words, the words to XOR it with or NULL, and its length (words1, previous1 and noOfWords1),
+	           and the second block of words and its length (words2 and noOfWords2), which may be empty.
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+void writeLogRecord(frameLog *log, int32_t type, const uint64_t *words1, const uint64_t *previous1, size_t noOfWords1, const uint64_t *words2, size_t noOfWords2)
+{
+	size_t length = encodeZeroRuns(words1, previous1, noOfWords1, log->buffer);
+	length += encodeZeroRuns(words2, NULL, noOfWords2, log->buffer + length);
+
+	int64_t generation = log->generation;
+	int32_t payloadLength = (int32_t)length;
+	fwrite(&generation, sizeof(generation), 1, log->file);
+	fwrite(&type, sizeof(type), 1, log->file);
+	fwrite(&payloadLength, sizeof(payloadLength), 1, log->file);
+	fwrite(log->buffer, 1, length, log->file);
+	return;
+}
+
+/*
+	Function: encodeZeroRuns()
+	Purpose: Compress a block of words (or the XOR of two blocks) by run-length encoding the runs of zero words,
+	         which make up most of a delta or a sparse board, and leaving out the zero bytes of the other words.
+	         The output is a series of (number of zero words, the other words, a 0 byte), the numbers stored with encodeNumber().
+	         Each of the other words is stored as a byte with bit n set if byte n of the word isn't zero, followed by those bytes,
+	         so the 0 byte can't be mistaken for a word.
+	Arguments: The words to compress and their number (input and length),
+	           the words to XOR them with, or NULL to compress them as they are (previous),
+	           and where to write the compressed bytes (output).
+	Return value: The number of compressed bytes written.
+	Inputs from user: None.
+	Outputs to user: None.
+	Note: A word that changes in only a few cells costs two or three bytes.
+	      The words are read once, the mask is found with a few bitwise operations, and only the non-zero bytes are visited,
+	      so the encoder is fast enough to run every generation.
+ */
+size_t encodeZeroRuns(const uint64_t *input, const uint64_t *previous, size_t length, unsigned char *output)
+{
+	size_t position = 0, written = 0, runStart;
+	uint64_t word, nonZero;
+	unsigned int mask;
+
+	while(position < length)
+	{
+		/* Count the zero words */
+		runStart = position;
+		if(previous == NULL)
+			while( (position < length) && (input[position] == 0) )
+				position++;
+		else
+			while( (position < length) && (input[position] == previous[position]) )
+				position++;
+		written += encodeNumber(position - runStart, output + written);
+
+		/* Write each of the following non-zero words as its mask byte then its non-zero bytes */
+		for(; position < length; position++)
+		{
+			word = (previous == NULL) ? input[position] : input[position] ^ previous[position];
+			if(word == 0)
+				break;
+
+			/* OR every bit of each byte into its lowest bit, then gather the lowest bits into the mask with a multiplication */
+			nonZero = word | (word >> 4);
+			nonZero |= nonZero >> 2;
+			nonZero |= nonZero >> 1;
+			mask = (unsigned int)( ( (nonZero & 0x0101010101010101ULL) * 0x0102040810204080ULL ) >> 56 );
+
+			output[written++] = (unsigned char)mask;
+			for(; mask != 0; mask &= mask - 1)
+				output[written++] = (unsigned char)(word >> (8 * countTrailingZeros(mask)));
+		}
+		output[written++] = 0;
+	}
+
+	return written;
+}
+
+/*
+	Function: encodeNumber()
+	Purpose: Write a number in as few bytes as possible: 7 bits per byte, lowest first, with the top bit set on every byte but the last.
+	Arguments: The number to write (number), and where to write it (output).
+	Return value: The number of bytes written.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+size_t encodeNumber(uint64_t number, unsigned char *output)
+{
+	size_t written = 0;
+	while(number >= 0x80)
+	{
+		output[written++] = (unsigned char)(number | 0x80);
+		number >>= 7;
+	}
+	output[written++] = (unsigned char)number;
+	return written;
+}
+
+/*
+	Function: closeFrameLog()
+	Purpose: Write the keyframe index and trailer to a frame log, close the file and free the log.
+	Arguments: The log to close (log).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+void closeFrameLog(frameLog *log)
+{
+	int64_t trailer[3];
+	long i;
+
+	trailer[0] = ftell(log->file);
+	trailer[1] = log->noOfKeyframes;
+	trailer[2] = log->generation;
+	for(i = 0; i < log->noOfKeyframes; i++)
+	{
+		fwrite(&log->keyframeGenerations[i], sizeof(int64_t), 1, log->file);
+		fwrite(&log->keyframeOffsets[i], sizeof(int64_t), 1, log->file);
+	}
+	fwrite("LIFEIDX1", 1, 8, log->file);
+	fwrite(trailer, sizeof(int64_t), 3, log->file);
+	fclose(log->file);
+
+	freeMemory(log->streamBuffer);
+	freePlanes(&log->previous);
+	freeMemory(log->buffer);
+	freeMemory(log->keyframeGenerations);
+	freeMemory(log->keyframeOffsets);
+	return;
+}
+
+/*
+	Function: openBoardExport()
+	Purpose: Create a POSIX shared memory object that other programs can map to read the board as it is calculated.
+	Arguments: The export to set up (export), and the name of the shared memory object (name), e.g. "/life".
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: An error message if the shared memory object can't be created.
+	Note: The object holds a sharedBoardHeader, padded to 64 bytes, then the live plane and the age plane in the layout of boardPlanes.
+	      The planes are always updated in place, so a reader only needs to map the object once.
+	      The magic is "LIFESHM1", and generation is -1 until the first board is published. finished is set after the last board.
+	      hash is the sum of mixBits(word ^ mixBits(i)) over the non-empty words of the live plane, where i is the word's position,
+	      so a reader can check its copy of the live plane.
+ */
+void openBoardExport(boardExport *export, const char *name)
+{
+	int liveWordsPerRow = (boardWidth + 63) / 64;
+	int ageWordsPerRow = (boardWidth + 15) / 16;
+	size_t liveBytes = (size_t)boardHeight * liveWordsPerRow * sizeof(uint64_t);
+	size_t ageBytes = (size_t)boardHeight * ageWordsPerRow * sizeof(uint64_t);
+
+	export->name = name;
+	export->size = 64 + liveBytes + ageBytes;
+
+	int fd = shm_open(name, O_CREAT | O_RDWR, 0644);
+	if( (fd < 0) || (ftruncate(fd, export->size) != 0) )
+	{
+		fprintf(stderr, "Error creating shared memory object (%s).\n"
+		                "Please ensure that the name starts with a '/' and contains no other '/'.\n"
+		                "The program will now exit.\n", name);
+		exit(EXIT_FAILURE);
+	}
+
+	void *memory = mmap(NULL, export->size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+	if(memory == MAP_FAILED)
+	{
+		fprintf(stderr, "Error mapping shared memory object (%s).\n"
+		                "The program will now exit.\n", name);
+		exit(EXIT_FAILURE);
+	}
+
+	export->header = (sharedBoardHeader *)memory;
+	export->live = (uint64_t *)( (unsigned char *)memory + 64 );
+	export->ages = (uint64_t *)( (unsigned char *)memory + 64 + liveBytes );
+
+	/* Readers that find the object before it is filled in see an odd sequence, and wait */
+	atomic_store_explicit(&export->header->sequence, 1, memory_order_relaxed);
+	atomic_thread_fence(memory_order_release);
+	export->header->width = boardWidth;
+	export->header->height = boardHeight;
+	export->header->liveWordsPerRow = liveWordsPerRow;
+	export->header->ageWordsPerRow = ageWordsPerRow;
+	export->header->generation = -1;
+	export->header->population = 0;
+	export->header->hash = 0;
+	export->header->finished = 0;
+	export->header->reserved = 0;
+	memcpy(export->header->magic, "LIFESHM1", 8);
+	atomic_store_explicit(&export->header->sequence, 2, memory_order_release);
+	return;
+}
+
+/*
+	Function: exportBoard()
+	Purpose: Publish a board in a shared memory export.
+	Arguments: The export (export), the board (board), and its generation (generation).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+	Note: This never waits for readers and makes no system calls, a reader that is part way through copying the board
+	      sees the sequence change and tries again.
+ */
+void exportBoard(boardExport *export, const boardPlanes *board, long generation)
+{
+	size_t liveWords = (size_t)board->height * board->liveWordsPerRow;
+	size_t ageWords = (size_t)board->height * board->ageWordsPerRow;
+	uint64_t sequence = atomic_load_explicit(&export->header->sequence, memory_order_relaxed);
+	int64_t population = 0;
+	uint64_t hash = 0;
+	size_t i;
+
+	/* Make the sequence odd before anything changes, and even again after */
+	atomic_store_explicit(&export->header->sequence, sequence + 1, memory_order_relaxed);
+	atomic_thread_fence(memory_order_release);
+
+	for(i = 0; i < liveWords; i++)
+	{
+		export->live[i] = board->live[i];
+		if(board->live[i] != 0)
+		{
+			population += countBits(board->live[i]);
+			hash += mixBits(board->live[i] ^ mixBits(i));
+		}
+	}
+	memcpy(export->ages, board->ages, ageWords * sizeof(uint64_t));
+	export->header->generation = generation;
+	export->header->population = population;
+	export->header->hash = hash;
+
+	atomic_store_explicit(&export->header->sequence, sequence + 2, memory_order_release);
+	return;
+}
+
+/*
+	Function: closeBoardExport()
+	Purpose: Mark a shared memory export as finished, and remove it.
+	Arguments: The export (export).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+	Note: Readers that already have the object mapped can still read the last board, but new readers can't find it.
+ */
+void closeBoardExport(boardExport *export)
+{
+	uint64_t sequence = atomic_load_explicit(&export->header->sequence, memory_order_relaxed);
+
+	atomic_store_explicit(&export->header->sequence, sequence + 1, memory_order_relaxed);
+	atomic_thread_fence(memory_order_release);
+	export->header->finished = 1;
+	atomic_store_explicit(&export->header->sequence, sequence + 2, memory_order_release);
+
+	munmap(export->header, export->size);
+	shm_unlink(export->name);
+	return;
+}
+
+/*
+	Function: createDistributedEngine()
+	Purpose: Create an engine that splits the board into bands of rows, one for each worker process.
+	Arguments: The width and height of the board (width and height),
+	           and the command line settings (options): the number of workers, the history depth, and whether boards are printed or logged.
+	Return value: A pointer to the new engine.
+	Inputs from user: None.
+	Outputs to user: None.
+	Note: The workers aren't started until the board is loaded.
+ */
+lifeEngine *createDistributedEngine(int width, int height, const engineOptions *options)
+{
+	distributedEngine *engine = (distributedEngine *)allocateMemory(sizeof(distributedEngine));
+	int worker;
+
+	engine->base.type = &distributedEngineType;
+	engine->base.width = width;
+	engine->base.height = height;
+	engine->noOfWorkers = options->noOfWorkers;
+	engine->historyDepth = options->historyDepth;
+	engine->needBoards = options->needBoards;
+
+	/* Share the rows out as evenly as possible */
+	engine->firstRows = (int *)allocateMemory( (engine->noOfWorkers + 1) * sizeof(int) );
+	for(worker = 0; worker <= engine->noOfWorkers; worker++)
+		engine->firstRows[worker] = (int)( (long)height * worker / engine->noOfWorkers );
+
+	engine->workerPids = (pid_t *)allocateMemory(engine->noOfWorkers * sizeof(pid_t));
+	engine->workerSockets = (int *)allocateMemory(engine->noOfWorkers * sizeof(int));
+
+	/* The whole board is only gathered from the workers when it is printed or logged */
+	if(engine->needBoards)
+		allocatePlanes(&engine->board, width, height);
+
+	engine->generation = 0;
+	engine->receivedGeneration = -1;
+	engine->period = 0;
+	return &engine->base;
+}
+
+/*
+	Function: loadDistributedEngine()
+	Purpose: Start the worker processes, each with its band of the board, connected to its neighbours and to the launcher by sockets.
+	Arguments: The engine (engine), and the live cells to load (cells).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: An error message if the sockets or processes can't be created.
+ */
+void loadDistributedEngine(lifeEngine *engine, const cellList *cells)
+{
+	distributedEngine *self = (distributedEngine *)engine;
+	int worker, other;
+
+	/* Each worker copies its band from the whole board */
+	boardPlanes board;
+	allocatePlanes(&board, self->base.width, self->base.height);
+	fillPlanes(&board, cells);
+
+	/* haloSockets[2n] is worker n's end of the connection to worker n + 1, the band below it, and haloSockets[2n + 1] is the other end */
+	int *haloSockets = (int *)allocateMemory(2 * self->noOfWorkers * sizeof(int));
+	int *launcherSockets = (int *)allocateMemory(2 * self->noOfWorkers * sizeof(int));
+
+	for(worker = 0; worker < self->noOfWorkers; worker++)
+	{
+		if( (socketpair(AF_UNIX, SOCK_STREAM, 0, &launcherSockets[2 * worker]) != 0)
+		    || ( (worker < self->noOfWorkers - 1) && (socketpair(AF_UNIX, SOCK_STREAM, 0, &haloSockets[2 * worker]) != 0) ) )
+		{
+			fputs("Error creating the sockets for the workers.\n"
+			      "The program will now exit.\n", stderr);
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	/* Anything still buffered would be printed again by every worker */
+	fflush(stdout);
+	fflush(stderr);
+
+	for(worker = 0; worker < self->noOfWorkers; worker++)
+	{
+		self->workerPids[worker] = fork();
+		if(self->workerPids[worker] < 0)
+		{
+			fputs("Error starting the worker processes.\n"
+			      "The program will now exit.\n", stderr);
+			exit(EXIT_FAILURE);
+		}
+
+		if(self->workerPids[worker] == 0)
+		{
+			/* In the worker: close every socket that belongs to the launcher or to other workers */
+			for(other = 0; other < self->noOfWorkers; other++)
+			{
+				close(launcherSockets[2 * other]);
+				if(other != worker)
+					close(launcherSockets[2 * other + 1]);
+				if(other < self->noOfWorkers - 1)
+				{
+					if(other != worker)
+						close(haloSockets[2 * other]);
+					if(other != worker - 1)
+						close(haloSockets[2 * other + 1]);
+				}
+			}
+			for(other = 0; other < worker; other++)
+				close(self->workerSockets[other]);
+
+			runWorker(self, &board, worker,
+			          (worker > 0) ? haloSockets[2 * (worker - 1) + 1] : -1,
+			          (worker < self->noOfWorkers - 1) ? haloSockets[2 * worker] : -1,
+			          launcherSockets[2 * worker + 1]);
+		}
+
+		/* In the launcher: keep only its own end of each worker's socket */
+		self->workerSockets[worker] = launcherSockets[2 * worker];
+		close(launcherSockets[2 * worker + 1]);
+	}
+
+	for(worker = 0; worker < self->noOfWorkers - 1; worker++)
+	{
+		close(haloSockets[2 * worker]);
+		close(haloSockets[2 * worker + 1]);
+	}
+	freeMemory(haloSockets);
+	freeMemory(launcherSockets);
+	freePlanes(&board);
+	return;
+}
+
+/*
+	Function: stepDistributedEngine()
+	Purpose: Move on to the next generation. The workers calculate generations as fast as the launcher reads them,
+	         so this only changes which generation the launcher will read next.
+	Arguments: The engine (engine).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+void stepDistributedEngine(lifeEngine *engine)
+{
+	((distributedEngine *)engine)->generation++;
+	return;
+}
+
+/*
+	Function: viewDistributedEngine()
+	Purpose: Provide the current board, gathered from the bands sent by the workers.
+	Arguments: The engine (engine).
+	Return value: A pointer to the planes, which are valid until the engine is next used.
+	Inputs from user: None.
+	Outputs to user: None.
+	Note: The board is only gathered if the engine was created with needBoards set.
+ */
+const boardPlanes *viewDistributedEngine(lifeEngine *engine)
+{
+	distributedEngine *self = (distributedEngine *)engine;
+	receiveFromWorkers(self);
+	return &self->board;
+}
+
+/*
+	Function: findDistributedPeriod()
+	Purpose: Test the current generation for repetition, using the tests each worker made on its own band.
+	Arguments: The engine (engine).
+	Return value: The smallest period with which every band repeats, or 0 if there isn't one.
+	Inputs from user: None.
+	Outputs to user: None.
+	Note: The whole board is the same as it was n generations ago exactly when every band is, so this gives the same answer
+	      as testing the whole board.
+ */
+int findDistributedPeriod(lifeEngine *engine)
+{
+	distributedEngine *self = (distributedEngine *)engine;
+	receiveFromWorkers(self);
+	return self->period;
+}
+
+/*
+	Function: distributedEngineMemory()
+	Purpose: Estimate the most memory a distributed engine allocates for a board, in this process and in any one worker.
+	Arguments: The width and height of the board (width and height), and the command line settings (options).
+	Return value: The number of bytes.
+	Inputs from user: None.
+	Outputs to user: None.
+	Note: A worker's memory is a copy of this process's, so it needs room for the launcher's allocations as well as its own.
+ */
+double distributedEngineMemory(int width, int height, const engineOptions *options)
+{
+	int depth = options->historyDepth;
+	return sizeof(distributedEngine) + 8.0 * (options->noOfWorkers + 1) * sizeof(int) + 4 * planesSize(width, height)
+	       + (depth + 1) * ( (double)height * ( ( (long)width + 63 ) / 64 ) * sizeof(uint64_t) + 2 * sizeof(uint64_t) )
+	       + 16 * ARENA_ALIGNMENT;
+}
+
+/*
+	Function: receiveFromWorkers()
+	Purpose: Read the current generation's message (and band, if boards are needed) from every worker, if it hasn't been read yet.
+	Arguments: The engine (self).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: An error message if a worker has stopped unexpectedly.
+ */
+void receiveFromWorkers(distributedEngine *self)
+{
+	if(self->receivedGeneration == self->generation)
+		return;
+
+	workerStatus status;
+	uint64_t matches = ~(uint64_t)0;
+	int worker, bandRows;
+	int liveWords = self->board.liveWordsPerRow, ageWords = self->board.ageWordsPerRow;
+
+	for(worker = 0; worker < self->noOfWorkers; worker++)
+	{
+		bandRows = self->firstRows[worker + 1] - self->firstRows[worker];
+		if( !readAll(self->workerSockets[worker], &status, sizeof(status))
+		    || ( self->needBoards
+		         && ( !readAll(self->workerSockets[worker], self->board.live + (size_t)self->firstRows[worker] * liveWords, (size_t)bandRows * liveWords * sizeof(uint64_t))
+		              || !readAll(self->workerSockets[worker], self->board.ages + (size_t)self->firstRows[worker] * ageWords, (size_t)bandRows * ageWords * sizeof(uint64_t)) ) ) )
+		{
+			fputs("A worker process stopped unexpectedly.\n"
+			      "The program will now exit.\n", stderr);
+			exit(EXIT_FAILURE);
+		}
+		matches &= status.matches;
+	}
+
+	/* The period is the lowest generation back that every worker matched */
+	self->period = (matches == 0) ? 0 : countTrailingZeros(matches) + 1;
+	self->receivedGeneration = self->generation;
+	return;
+}
+
+/*
+	Function: destroyDistributedEngine()
+	Purpose: Stop the worker processes and free the engine.
+	Arguments: The engine (engine).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+	Note: Closing the launcher's sockets makes each worker's next message fail, and the workers exit when they notice,
+	      so the workers are also sent SIGTERM in case they are waiting for each other.
+ */
+void destroyDistributedEngine(lifeEngine *engine)
+{
+	distributedEngine *self = (distributedEngine *)engine;
+	int worker;
+
+	for(worker = 0; worker < self->noOfWorkers; worker++)
+	{
+		close(self->workerSockets[worker]);
+		kill(self->workerPids[worker], SIGTERM);
+	}
+	for(worker = 0; worker < self->noOfWorkers; worker++)
+		waitpid(self->workerPids[worker], NULL, 0);
+
+	if(self->needBoards)
+		freePlanes(&self->board);
+	freeMemory(self->firstRows);
+	freeMemory(self->workerPids);
+	freeMemory(self->workerSockets);
+	freeMemory(self);
+	return;
+}
+
+/*
+	Function: runWorker()
+	Purpose: The main loop of a worker process: calculate a band of the board forever, sending each generation's
+	         repetition tests (and the band itself, if needed) to the launcher.
+	Arguments: The engine as it was when the worker was started (self), the whole starting board (board),
+	           the number of this worker (worker),
+	           the sockets to the workers above and below, or -1 at the top or bottom of the board (upperSocket and lowerSocket),
+	           and the socket to the launcher (launcherSocket).
+	Return value: None, the worker exits when the launcher or a neighbour stops.
+	Inputs from user: None.
+	Outputs to user: None.
+	Note: Each generation the halo rows are sent first, then the rows in the middle of the band are calculated while they travel,
+	      and only the top and bottom rows of the band wait for the neighbours' rows to arrive.
+ */
+void runWorker(distributedEngine *self, const boardPlanes *board, int worker, int upperSocket, int lowerSocket, int launcherSocket)
+{
+	int firstRow = self->firstRows[worker];
+	int bandRows = self->firstRows[worker + 1] - firstRow;
+	int words = board->liveWordsPerRow, ageWords = board->ageWordsPerRow;
+	size_t rowBytes = words * sizeof(uint64_t);
+	size_t bandWords = (size_t)bandRows * words;
+	int row, j;
+	long generation;
+
+	/* A closed socket should stop the worker, not kill it with a signal */
+	signal(SIGPIPE, SIG_IGN);
+	signal(SIGTERM, SIG_DFL);
+
+	/* The worker's band is held as a board bandRows high, with the halo rows kept separately */
+	boardPlanes current, next;
+	allocatePlanes(&current, board->width, bandRows);
+	allocatePlanes(&next, board->width, bandRows);
+	memcpy(current.live, board->live + (size_t)firstRow * words, bandWords * sizeof(uint64_t));
+	memcpy(current.ages, board->ages + (size_t)firstRow * ageWords, (size_t)bandRows * ageWords * sizeof(uint64_t));
+	uint64_t *haloAbove = (uint64_t *)allocateMemory(rowBytes);
+	uint64_t *haloBelow = (uint64_t *)allocateMemory(rowBytes);
+	uint64_t lastWordMask = (board->width % 64 == 0) ? ~(uint64_t)0 : ( ((uint64_t)1 << (board->width % 64)) - 1 );
+
+	/* The history of the band: historyDepth + 1 copies of its live plane, with their populations and hashes */
+	int depth = self->historyDepth;
+	uint64_t *historyCells = (uint64_t *)allocateMemory( (depth + 1) * bandWords * sizeof(uint64_t) );
+	int64_t *historyPopulations = (int64_t *)allocateMemory( (depth + 1) * sizeof(int64_t) );
+	uint64_t *historyHashes = (uint64_t *)allocateMemory( (depth + 1) * sizeof(uint64_t) );
+	int currentSlot, slot;
+
+	if(upperSocket >= 0)
+		fcntl(upperSocket, F_SETFL, fcntl(upperSocket, F_GETFL) | O_NONBLOCK);
+	if(lowerSocket >= 0)
+		fcntl(lowerSocket, F_SETFL, fcntl(lowerSocket, F_GETFL) | O_NONBLOCK);
+
+	/* The worker has allocated everything it needs */
+	allocationsSealed = 1;
+
+	workerStatus status;
+	size_t i, progress[4];
+
+	for(generation = 0; ; generation++)
+	{
+		/* Remember the band, and test it against the earlier generations */
+		currentSlot = generation % (depth + 1);
+		uint64_t *cells = historyCells + currentSlot * bandWords;
+		memcpy(cells, current.live, bandWords * sizeof(uint64_t));
+		historyPopulations[currentSlot] = 0;
+		historyHashes[currentSlot] = 0;
+		for(i = 0; i < bandWords; i++)
+			if(cells[i] != 0)
+			{
+				historyPopulations[currentSlot] += countBits(cells[i]);
+				historyHashes[currentSlot] += mixBits(cells[i] ^ mixBits(i));
+			}
+
+		status.matches = 0;
+		for(j = 1; (j <= depth) && (j <= generation); j++)
+		{
+			slot = (currentSlot + depth + 1 - j) % (depth + 1);
+			if( (historyPopulations[slot] == historyPopulations[currentSlot]) && (historyHashes[slot] == historyHashes[currentSlot])
+			    && (memcmp(historyCells + slot * bandWords, cells, bandWords * sizeof(uint64_t)) == 0) )
+				status.matches |= (uint64_t)1 << (j - 1);
+		}
+
+		if( !writeAll(launcherSocket, &status, sizeof(status))
+		    || ( self->needBoards && ( !writeAll(launcherSocket, current.live, bandWords * sizeof(uint64_t))
+		                               || !writeAll(launcherSocket, current.ages, (size_t)bandRows * ageWords * sizeof(uint64_t)) ) ) )
+			_exit(EXIT_SUCCESS);
+
+		/* Send the top and bottom rows to the neighbours, and start receiving theirs */
+		memset(progress, 0, sizeof(progress));
+		if(upperSocket < 0)
+			memset(haloAbove, 0, rowBytes);
+		if(lowerSocket < 0)
+			memset(haloBelow, 0, rowBytes);
+		if(exchangeHaloRows(upperSocket, lowerSocket, current.live, current.live + bandWords - words, haloAbove, haloBelow, rowBytes, 0, progress) < 0)
+			_exit(EXIT_SUCCESS);
+
+		/* The middle rows only need the band itself */
+		for(row = 1; row < bandRows - 1; row++)
+			iterateLiveRow(current.live + (row - 1) * words, current.live + row * words, current.live + (row + 1) * words,
+			               next.live + row * words, words, lastWordMask);
+
+		/* The top and bottom rows need the halo rows, so wait for them to arrive */
+		if(exchangeHaloRows(upperSocket, lowerSocket, current.live, current.live + bandWords - words, haloAbove, haloBelow, rowBytes, 1, progress) < 0)
+			_exit(EXIT_SUCCESS);
+		iterateLiveRow(haloAbove, current.live, (bandRows > 1) ? current.live + words : haloBelow, next.live, words, lastWordMask);
+		if(bandRows > 1)
+			iterateLiveRow(current.live + bandWords - 2 * words, current.live + bandWords - words, haloBelow,
+			               next.live + bandWords - words, words, lastWordMask);
+
+		for(row = 0; row < bandRows; row++)
+			updateAgeRow(current.live + row * words, next.live + row * words, current.ages + row * ageWords, next.ages + row * ageWords, ageWords);
+
+		boardPlanes temp = current;
+		current = next;
+		next = temp;
+	}
+}
+
+/*
+	Function: exchangeHaloRows()
+	Purpose: Send the top and bottom rows of a band to the neighbouring workers, and receive their rows into the halo rows,
+	         without blocking on either, so that a worker can't be held up by a neighbour that is sending at the same time.
+	Arguments: The sockets to the workers above and below, or -1 if there isn't one (upperSocket and lowerSocket),
+	           the rows to send (topRow and bottomRow), the rows to receive into (haloAbove and haloBelow),
+	           the number of bytes in a row (rowBytes), whether to wait until the exchange is finished (wait),
+	           and the number of bytes sent up, sent down, received from above and received from below so far (progress).
+	Return value: 1 if the exchange is finished, 0 if it isn't (only when wait is 0), or -1 if a neighbour has stopped.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+int exchangeHaloRows(int upperSocket, int lowerSocket, const uint64_t *topRow, const uint64_t *bottomRow,
+                     uint64_t *haloAbove, uint64_t *haloBelow, size_t rowBytes, int wait, size_t progress[4])
+{
+	/* The four transfers: sending to each neighbour, and receiving from each */
+	int sockets[4] = {upperSocket, lowerSocket, upperSocket, lowerSocket};
+	unsigned char *buffers[4] = {(unsigned char *)topRow, (unsigned char *)bottomRow, (unsigned char *)haloAbove, (unsigned char *)haloBelow};
+	struct pollfd waitingFor[4];
+	int transfer, noWaiting;
+	ssize_t moved;
+
+	while(1)
+	{
+		noWaiting = 0;
+		for(transfer = 0; transfer < 4; transfer++)
+		{
+			if( (sockets[transfer] < 0) || (progress[transfer] == rowBytes) )
+				continue;
+
+			if(transfer < 2)
+				moved = send(sockets[transfer], buffers[transfer] + progress[transfer], rowBytes - progress[transfer], MSG_NOSIGNAL);
+			else
+				moved = recv(sockets[transfer], buffers[transfer] + progress[transfer], rowBytes - progress[transfer], 0);
+
+			if(moved > 0)
+				progress[transfer] += moved;
+			else if( (moved == 0) || ( (errno != EAGAIN) && (errno != EWOULDBLOCK) && (errno != EINTR) ) )
+				return -1;
+
+			if(progress[transfer] < rowBytes)
+			{
+				waitingFor[noWaiting].fd = sockets[transfer];
+				waitingFor[noWaiting].events = (transfer < 2) ? POLLOUT : POLLIN;
+				noWaiting++;
+			}
+		}
+
+		if(noWaiting == 0)
+			return 1;
+		if(!wait)
+			return 0;
+		poll(waitingFor, noWaiting, -1);
+	}
+}
+
+/*
+	Function: writeAll()
+	Purpose: Write a whole buffer to a socket, however many writes it takes.
+	Arguments: The socket (socket), and the buffer and its length (buffer and length).
+	Return value: 1 if the whole buffer was written, 0 if the socket was closed or failed.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+int writeAll(int socket, const void *buffer, size_t length)
+{
+	const unsigned char *position = (const unsigned char *)buffer;
+	ssize_t written;
+
+	while(length > 0)
+	{
+		written = send(socket, position, length, MSG_NOSIGNAL);
+		if(written < 0 && errno == EINTR)
+			continue;
+		if(written <= 0)
+			return 0;
+		position += written;
+		length -= written;
+	}
+	return 1;
+}
+
+/*
+	Function: readAll()
+	Purpose: Read a whole buffer from a socket, however many reads it takes.
+	Arguments: The socket (socket), and the buffer and its length (buffer and length).
+	Return value: 1 if the whole buffer was read, 0 if the socket was closed or failed first.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+int readAll(int socket, void *buffer, size_t length)
+{
+	unsigned char *position = (unsigned char *)buffer;
+	ssize_t received;
+
+	while(length > 0)
+	{
+		received = recv(socket, position, length, 0);
+		if(received < 0 && errno == EINTR)
+			continue;
+		if(received <= 0)
+			return 0;
+		position += received;
+		length -= received;
+	}
+	return 1;
+}
+
+/*
+	Function: createSparseEngine()
+	Purpose: Create an engine that stores only the live cells.
+	Arguments: The width and height of the board (width and height), and the command line settings (options), of which only the history depth is used.
+	Return value: A pointer to the new engine.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+lifeEngine *createSparseEngine(int width, int height, const engineOptions *options)
+{
+	sparseEngine *engine = (sparseEngine *)allocateMemory(sizeof(sparseEngine));
+	engine->base.type = &sparseEngineType;
+	engine->base.width = width;
+	engine->base.height = height;
+
+	/* The arrays grow as the population does, see reserveSparseCells() */
+	engine->noOfCells = 0;
+	engine->capacity = 0;
+	reserveSparseCells(engine, 16);
+
+	/* A ring of historyDepth + 1 snapshots, as in main(), each of which grows as needed */
+	engine->historyDepth = options->historyDepth;
+	engine->currentSnapshot = 0;
+	engine->history = (sparseSnapshot *)allocateMemory( (engine->historyDepth + 1) * sizeof(sparseSnapshot) );
+
+	/* The whole board is only made if it is viewed */
+	engine->havePlanes = 0;
+	return &engine->base;
+}
+
+/*
+	Function: reserveSparseCells()
+	Purpose: Make sure that a sparse engine has room to calculate the generation after one with a number of live cells:
+	         room in its arrays for the next generation's cells, and for the columns of the cells in any three rows.
+	Arguments: The engine (self), and the number of live cells (noOfCells).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+	Note: A cell is born with three neighbours, and each live cell is a neighbour of eight cells,
+	      so the next generation has fewer than four times as many cells as the current one.
+ */
+void reserveSparseCells(sparseEngine *self, long noOfCells)
+{
+	long oldCapacity = self->capacity;
+	if(4 * noOfCells > self->capacity)
+	{
+		while(self->capacity < 4 * noOfCells)
+			self->capacity = (self->capacity == 0) ? 64 : self->capacity * 2;
+
+		self->keys = (uint64_t *)resizeMemory(self->keys, oldCapacity * sizeof(uint64_t), self->capacity * sizeof(uint64_t));
+		self->nextKeys = (uint64_t *)resizeMemory(self->nextKeys, oldCapacity * sizeof(uint64_t), self->capacity * sizeof(uint64_t));
+		self->ages = (unsigned char *)resizeMemory(self->ages, oldCapacity, self->capacity);
+		self->nextAges = (unsigned char *)resizeMemory(self->nextAges, oldCapacity, self->capacity);
+		self->neighbourColumns = (long *)resizeMemory(self->neighbourColumns, oldCapacity * sizeof(long), self->capacity * sizeof(long));
+	}
+	return;
+}
+
+/*
+	Function: loadSparseEngine()
+	Purpose: Set the current board of a sparse engine.
+	Arguments: The engine (engine), and the live cells to load (cells).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+void loadSparseEngine(lifeEngine *engine, const cellList *cells)
+{
+	sparseEngine *self = (sparseEngine *)engine;
+	long i, noOfCells = 0;
+
+	/* The keys are sorted before duplicates are removed, so there must be room for all of them */
+	reserveSparseCells(self, cells->noOfCells);
+	for(i = 0; i < cells->noOfCells; i++)
+		self->keys[i] = ( (uint64_t)cells->cells[i].row << 32 ) | (uint32_t)cells->cells[i].column;
+
+	/* A list with ages is already in order. Otherwise sort the keys, and remove any cell that was listed more than once */
+	if(cells->ages != NULL)
+	{
+		memcpy(self->ages, cells->ages, cells->noOfCells);
+		noOfCells = cells->noOfCells;
+	}
+	else
+	{
+		qsort(self->keys, cells->noOfCells, sizeof(uint64_t), compareKeys);
+		for(i = 0; i < cells->noOfCells; i++)
+			if( (noOfCells == 0) || (self->keys[i] != self->keys[noOfCells - 1]) )
+				self->keys[noOfCells++] = self->keys[i];
+		memset(self->ages, 0, noOfCells);
+	}
+
+	self->noOfCells = noOfCells;
+	self->changedCells = noOfCells;
+
+	/* A board from the file has no births or deaths, but one from another engine has, which aren't known until the next generation */
+	self->births = self->deaths = 0;
+	self->haveStatistics = (cells->ages == NULL);
+	return;
+}
+
+/*
+	Function: stepSparseEngine()
+	Purpose: Calculate the next generation, looking only at the rows next to live cells.
+	Arguments: The engine (engine).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+	Note: The keys are in order, so each row of the next generation is calculated from three runs of keys,
+	      and comes out in order without needing to be sorted.
+ */
+void stepSparseEngine(lifeEngine *engine)
+{
+	sparseEngine *self = (sparseEngine *)engine;
+	long position = 0, noOfNextCells = 0;
+	long cellRow, row, lastRow = -1;
+
+	/* stepSparseRow() counts the cells that stayed alive, so that the cells that changed can be counted */
+	long survivors = 0;
+
+	/* Each row with live cells makes the row above it, itself and the row below it worth calculating */
+	while(position < self->noOfCells)
+	{
+		cellRow = (long)(self->keys[position] >> 32);
+		for(row = (cellRow - 1 > lastRow) ? cellRow - 1 : lastRow + 1; (row <= cellRow + 1) && (row < self->base.height); row++)
+			if(row >= 0)
+			{
+				stepSparseRow(self, row, &noOfNextCells, &survivors);
+				lastRow = row;
+			}
+
+		while( (position < self->noOfCells) && ( (long)(self->keys[position] >> 32) == cellRow ) )
+			position++;
+	}
+
+	self->births = noOfNextCells - survivors;
+	self->deaths = self->noOfCells - survivors;
+	self->changedCells = self->births + self->deaths;
+	self->haveStatistics = 1;
+
+	/* Swap the arrays, and make room for the generation after */
+	uint64_t *tempKeys = self->keys;
+	self->keys = self->nextKeys;
+	self->nextKeys = tempKeys;
+	unsigned char *tempAges = self->ages;
+	self->ages = self->nextAges;
+	self->nextAges = tempAges;
+	self->noOfCells = noOfNextCells;
+	reserveSparseCells(self, noOfNextCells);
+	return;
+}
+
+/*
+	Function: stepSparseRow()
+	Purpose: Calculate one row of the sparse engine's next generation, and add its cells to the end of the next keys.
+	Arguments: The engine (self), the row to calculate (row),
+	           and the number of next keys so far and how many of them stayed alive (noOfNextCells and survivors), which are updated.
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+	Note: The columns of the live cells in the rows above, on and below the row are merged into one ordered list,
+	      so the number of live cells around column x (including itself) is the number of entries from x - 1 to x + 1,
+	      which is found for each column next to a live cell by moving two positions along the list.
+ */
+void stepSparseRow(sparseEngine *self, long row, long *noOfNextCells, long *survivors)
+{
+	long start[3], end[3];
+	long noOfColumns = 0, low = 0, high = 0, onRow, column, lastColumn = -2, i;
+	int band, neighbours, alive;
+	long *columns = self->neighbourColumns;
+
+	/* The runs of keys for the rows above, on and below the row */
+	for(band = 0; band < 3; band++)
+	{
+		start[band] = end[band] = 0;
+		if( (row + band - 1 < 0) || (row + band - 1 >= self->base.height) )
+			continue;
+		start[band] = findRowStart(self->keys, self->noOfCells, row + band - 1);
+		end[band] = findRowStart(self->keys, self->noOfCells, row + band);
+	}
+
+	/* Merge the three runs into one ordered list of columns */
+	long next[3] = {start[0], start[1], start[2]};
+	while(1)
+	{
+		int smallest = -1;
+		for(band = 0; band < 3; band++)
+			if( (next[band] < end[band])
+			    && ( (smallest < 0) || ( (self->keys[next[band]] & 0xFFFFFFFF) < (self->keys[next[smallest]] & 0xFFFFFFFF) ) ) )
+				smallest = band;
+		if(smallest < 0)
+			break;
+		columns[noOfColumns++] = (long)(self->keys[next[smallest]++] & 0xFFFFFFFF);
+	}
+
+	/* Try each column next to a live cell, in order, skipping any already tried */
+	onRow = start[1];
+	for(i = 0; i < noOfColumns; i++)
+		for(column = columns[i] - 1; column <= columns[i] + 1; column++)
+		{
+			if( (column <= lastColumn) || (column < 0) || (column >= self->base.width) )
+				continue;
+			lastColumn = column;
+
+			while(columns[low] < column - 1)
+				low++;
+			while( (high < noOfColumns) && (columns[high] <= column + 1) )
+				high++;
+			while( (onRow < end[1]) && ( (long)(self->keys[onRow] & 0xFFFFFFFF) < column ) )
+				onRow++;
+			alive = (onRow < end[1]) && ( (long)(self->keys[onRow] & 0xFFFFFFFF) == column );
+			neighbours = (int)(high - low) - alive;
+
+			/* A cell that stayed alive is a generation older, up to MAX_AGE, and a new cell has age 0 */
+			if( (neighbours == 3) || ( alive && (neighbours == 2) ) )
+			{
+				self->nextKeys[*noOfNextCells] = ( (uint64_t)row << 32 ) | (uint64_t)column;
+				self->nextAges[*noOfNextCells] = alive ? ( (self->ages[onRow] < MAX_AGE) ? self->ages[onRow] + 1 : MAX_AGE ) : 0;
+				(*noOfNextCells)++;
+				*survivors += alive;
+			}
+		}
+	return;
+}
+
+/*
+	Function: findRowStart()
+	Purpose: Find the first key on or after a row, by binary search.
+	Arguments: The keys in order (keys), the number of keys (noOfCells), and the row (row).
+	Return value: The position of the first key on or after the row, or noOfCells if there isn't one.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+long findRowStart(const uint64_t *keys, long noOfCells, long row)
+{
+	long low = 0, high = noOfCells, middle;
+	uint64_t key = (uint64_t)row << 32;
+
+	while(low < high)
+	{
+		middle = low + (high - low) / 2;
+		if(keys[middle] < key)
+			low = middle + 1;
+		else
+			high = middle;
+	}
+	return low;
+}
+
+/*
+	Function: compareKeys()
+	Purpose: Compare two cell keys for qsort().
+	Arguments: Pointers to the two keys (key1 and key2).
+	Return value: A negative number, zero, or a positive number if the first key is less than, equal to, or greater than the second.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+int compareKeys(const void *key1, const void *key2)
+{
+	uint64_t first = *(const uint64_t *)key1, second = *(const uint64_t *)key2;
+	return (first > second) - (first < second);
+}
+
+/*
+	Function: viewSparseEngine()
+	Purpose: Make the whole board from the live cells, for printing or logging.
+	Arguments: The engine (engine).
+	Return value: A pointer to the planes, which are valid until the engine is next used.
+	Inputs from user: None.
+	Outputs to user: None.
+	Note: The planes are only allocated the first time the board is viewed, so that a board that is never viewed can be as large as the keys allow.
+ */
+const boardPlanes *viewSparseEngine(lifeEngine *engine)
+{
+	sparseEngine *self = (sparseEngine *)engine;
+	boardPlanes *planes = &self->planes;
+	size_t row, column;
+	long i;
+
+	if(!self->havePlanes)
+	{
+		allocatePlanes(planes, self->base.width, self->base.height);
+		self->havePlanes = 1;
+	}
+
+	memset(planes->live, 0, (size_t)planes->height * planes->liveWordsPerRow * sizeof(uint64_t));
+	memset(planes->ages, 0, (size_t)planes->height * planes->ageWordsPerRow * sizeof(uint64_t));
+	for(i = 0; i < self->noOfCells; i++)
+	{
+		row = self->keys[i] >> 32;
+		column = self->keys[i] & 0xFFFFFFFF;
+		planes->live[row * planes->liveWordsPerRow + column / 64] |= (uint64_t)1 << (column % 64);
+		planes->ages[row * planes->ageWordsPerRow + column / 16] |= (uint64_t)self->ages[i] << (4 * (column % 16));
+	}
+	return planes;
+}
+
+/*
+	Function: sparseEngineStatistics()
+	Purpose: Give the statistics of a sparse engine's current board.
+	Arguments: The engine (engine), and where to write the statistics (statistics).
+	Return value: 1 if the statistics were written, 0 if the births and deaths aren't known (the board has just come from another engine).
+	Inputs from user: None.
+	Outputs to user: None.
+	Note: The keys are in order, so the first and last give the top and bottom rows, and only the columns need to be looked through.
+ */
+int sparseEngineStatistics(lifeEngine *engine, boardStatistics *statistics)
+{
+	sparseEngine *self = (sparseEngine *)engine;
+	long i, column;
+
+	if(!self->haveStatistics)
+		return 0;
+
+	startStatistics(statistics, self->base.width, self->base.height);
+	statistics->population = self->noOfCells;
+	statistics->births = self->births;
+	statistics->deaths = self->deaths;
+	if(self->noOfCells == 0)
+		return 1;
+
+	statistics->top = (int)(self->keys[0] >> 32);
+	statistics->bottom = (int)(self->keys[self->noOfCells - 1] >> 32);
+	for(i = 0; i < self->noOfCells; i++)
+	{
+		column = (long)(self->keys[i] & 0xFFFFFFFF);
+		if(column < statistics->left)
+			statistics->left = (int)column;
+		if(column > statistics->right)
+			statistics->right = (int)column;
+	}
+	return 1;
+}
+
+/*
+	Function: visitSparseCells()
+	Purpose: Pass each live cell of a sparse engine's board that is inside a rectangle to a function, row by row.
+	Arguments: The engine (engine), the first and last rows and columns of the rectangle (top, left, bottom and right),
+	           and the function to pass the cells to, with the context to pass it (visit and context).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+	Note: Each row is entered at the rectangle's left edge by binary search, so a narrow rectangle doesn't read the cells either side of it.
+ */
+void visitSparseCells(lifeEngine *engine, int top, int left, int bottom, int right, void (*visit)(void *context, int row, int column, int age), void *context)
+{
+	sparseEngine *self = (sparseEngine *)engine;
+	long position = findRowStart(self->keys, self->noOfCells, top), high, middle, row;
+	uint64_t key;
+
+	while(position < self->noOfCells)
+	{
+		row = (long)(self->keys[position] >> 32);
+		if(row > bottom)
+			break;
+
+		/* Find the row's first cell at or after the left edge */
+		key = ( (uint64_t)row << 32 ) | (uint32_t)left;
+		for(high = self->noOfCells; position < high; )
+		{
+			middle = position + (high - position) / 2;
+			if(self->keys[middle] < key)
+				position = middle + 1;
+			else
+				high = middle;
+		}
+
+		for(; (position < self->noOfCells) && ( (long)(self->keys[position] >> 32) == row ) && ( (long)(self->keys[position] & 0xFFFFFFFF) <= right );
+		    position++)
+			visit(context, (int)row, (int)(self->keys[position] & 0xFFFFFFFF), self->ages[position]);
+
+		position += findRowStart(self->keys + position, self->noOfCells - position, row + 1);
+	}
+	return;
+}
+
+/*
+	Function: findSparsePeriod()
+	Purpose: Remember the current live cells, and test them against the earlier generations, most recent first.
+	Arguments: The engine (engine).
+	Return value: The period if the live cells are the same as in one of the last historyDepth generations, or 0 if they aren't.
+	Inputs from user: None.
+	Outputs to user: None.
+	Note: This must be called once for each generation, as main() does. The keys are sorted, so identical boards have identical arrays.
+	      The hash is a sum, like the hash of a boardSnapshot, so that the order of the cells wouldn't matter.
+ */
+int findSparsePeriod(lifeEngine *engine)
+{
+	sparseEngine *self = (sparseEngine *)engine;
+	sparseSnapshot *current = &self->history[self->currentSnapshot];
+	sparseSnapshot *earlier;
+	int j, slot, period = 0;
+	long i;
+
+	if(current->capacity < self->noOfCells)
+	{
+		/* The capacity doubles, so that a population that keeps growing by a few cells doesn't need a new array every generation */
+		while(current->capacity < self->noOfCells)
+			current->capacity = (current->capacity == 0) ? 64 : current->capacity * 2;
+		freeMemory(current->keys);
+		current->keys = (uint64_t *)allocateMemory(current->capacity * sizeof(uint64_t));
+	}
+	memcpy(current->keys, self->keys, self->noOfCells * sizeof(uint64_t));
+	current->noOfCells = self->noOfCells;
+	current->hash = 0;
+	for(i = 0; i < self->noOfCells; i++)
+		current->hash += mixBits(self->keys[i]);
+	current->used = 1;
+
+	for(j = 1; j <= self->historyDepth; j++)
+	{
+		slot = (self->currentSnapshot + self->historyDepth + 1 - j) % (self->historyDepth + 1);
+		earlier = &self->history[slot];
+		if(!earlier->used)
+			break;
+
+		if( (earlier->noOfCells == current->noOfCells) && (earlier->hash == current->hash)
+		    && (memcmp(earlier->keys, current->keys, current->noOfCells * sizeof(uint64_t)) == 0) )
+		{
+			period = j;
+			break;
+		}
+	}
+
+	self->currentSnapshot = (self->currentSnapshot + 1) % (self->historyDepth + 1);
+	return period;
+}
+
+/*
+	Function: recallSparseHistory()
+	Purpose: Give back the earlier generations that a sparse engine remembers, so that another engine can carry on testing for repetition.
+	Arguments: The engine (engine), and an array of historyDepth lists to write the generations to, oldest first (generations).
+	Return value: The number of generations written.
+	Inputs from user: None.
+	Outputs to user: None.
+	Note: This must be called between generations, after findSparsePeriod() has remembered the last one.
+ */
+int recallSparseHistory(lifeEngine *engine, cellList *generations)
+{
+	sparseEngine *self = (sparseEngine *)engine;
+	int noOfGenerations = 0, j, slot;
+	long i;
+	const sparseSnapshot *snapshot;
+
+	/* Count back to the oldest generation that is remembered */
+	while( (noOfGenerations < self->historyDepth)
+	       && self->history[(self->currentSnapshot + self->historyDepth - noOfGenerations) % (self->historyDepth + 1)].used )
+		noOfGenerations++;
+
+	for(j = 0; j < noOfGenerations; j++)
+	{
+		slot = (self->currentSnapshot + self->historyDepth + 1 - noOfGenerations + j) % (self->historyDepth + 1);
+		snapshot = &self->history[slot];
+		generations[j].noOfCells = snapshot->noOfCells;
+		generations[j].cells = (coord *)allocateMemory(snapshot->noOfCells * sizeof(coord));
+		generations[j].ages = NULL;
+		for(i = 0; i < snapshot->noOfCells; i++)
+		{
+			generations[j].cells[i].row = (int)(snapshot->keys[i] >> 32);
+			generations[j].cells[i].column = (int)(snapshot->keys[i] & 0xFFFFFFFF);
+		}
+	}
+	return noOfGenerations;
+}
+
+/*
+	Function: measureSparseEngine()
+	Purpose: Count the live cells of a sparse engine's board, and the cells that changed in the last generation.
+	Arguments: The engine (engine), and where to write the counts (population and changed).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+void measureSparseEngine(lifeEngine *engine, long *population, long *changed)
+{
+	sparseEngine *self = (sparseEngine *)engine;
+	*population = self->noOfCells;
+	*changed = self->changedCells;
+	return;
+}
+
+/*
+	Function: estimateSparseCost()
+	Purpose: Estimate the time the sparse engine takes for a generation, which depends on the live cells and how many changed.
+	Arguments: The area of the board (area), which isn't used, the number of live cells (population) and the cells that changed (changed).
+	Return value: The estimated time in nanoseconds.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+double estimateSparseCost(double area, long population, long changed)
+{
+	(void)area;
+	return SPARSE_COST_PER_LIVE_CELL * population + SPARSE_COST_PER_CHANGED_CELL * changed;
+}
+
+/*
+	Function: sparseEngineMemory()
+	Purpose: Estimate the most memory a sparse engine allocates for a board, with room for the board to grow to SPARSE_GROWTH times its starting population.
+	Arguments: The width and height of the board (width and height),
+	           and the command line settings (options), of which only the history depth and the starting population are used.
+	Return value: The number of bytes.
+	Inputs from user: None.
+	Outputs to user: None.
+	Note: The arrays double in size as they grow, so can be up to twice as big as they need to be,
+	      and an arena can't always reuse the arrays they replace, which can double the memory again.
+ */
+double sparseEngineMemory(int width, int height, const engineOptions *options)
+{
+	double area = (double)width * height;
+	double cells = (double)SPARSE_GROWTH * options->initialPopulation;
+	if(cells < SPARSE_MIN_CELLS)
+		cells = SPARSE_MIN_CELLS;
+	if(cells > area)
+		cells = area;
+	double capacity = (8 * cells > 64) ? 8 * cells : 64;
+	double snapshotCapacity = (2 * cells > 64) ? 2 * cells : 64;
+	int depth = options->historyDepth;
+
+	return sizeof(sparseEngine) + (depth + 1) * sizeof(sparseSnapshot) + planesSize(width, height)
+	       + 2 * capacity * ( 2 * sizeof(uint64_t) + 2 + sizeof(long) )
+	       + 2 * (depth + 1) * snapshotCapacity * sizeof(uint64_t)
+	       + (depth + 6) * 64 * 2 * ARENA_ALIGNMENT;
+}
+
+/*
+	Function: destroySparseEngine()
+	Purpose: Free a sparse engine.
+	Arguments: The engine (engine).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+void destroySparseEngine(lifeEngine *engine)
+{
+	sparseEngine *self = (sparseEngine *)engine;
+	int i;
+
+	for(i = 0; i <= self->historyDepth; i++)
+		freeMemory(self->history[i].keys);
+	freeMemory(self->history);
+	freeMemory(self->keys);
+	freeMemory(self->nextKeys);
+	freeMemory(self->ages);
+	freeMemory(self->nextAges);
+	freeMemory(self->neighbourColumns);
+	if(self->havePlanes)
+		freePlanes(&self->planes);
+	freeMemory(self);
+	return;
+}
+
+/*
+	Function: createMappedEngine()
+	Purpose: Create an engine that keeps its boards in a memory-mapped file, and map the file.
+	Arguments: The width and height of the board (width and height),
+	           and the command line settings (options), of which the history depth and the name of the file are used.
+	Return value: A pointer to the new engine.
+	Inputs from user: None.
+	Outputs to user: An error message if the file can't be created or mapped.
+	Note: Without a file name, the boards are kept in a temporary file, which is deleted straight away so that it goes when the program does.
+ */
+lifeEngine *createMappedEngine(int width, int height, const engineOptions *options)
+{
+	mappedEngine *self = (mappedEngine *)allocateMemory(sizeof(mappedEngine));
+	self->base.type = &mappedEngineType;
+	self->base.width = width;
+	self->base.height = height;
+	self->planes.width = width;
+	self->planes.height = height;
+	self->planes.liveWordsPerRow = (width + 63) / 64;
+	self->planes.ageWordsPerRow = (width + 15) / 16;
+
+	/* Generation n is in live slot n % noOfLiveSlots, so at least two are needed to calculate one generation from another */
+	self->historyDepth = options->historyDepth;
+	self->noOfLiveSlots = (self->historyDepth + 1 > 2) ? self->historyDepth + 1 : 2;
+	self->generation = 0;
+
+	/* Each plane starts on a page boundary, so that each plane's pages can be dropped without touching another's */
+	size_t pageSize = (size_t)sysconf(_SC_PAGESIZE);
+	size_t rowBytes = self->planes.liveWordsPerRow * sizeof(uint64_t);
+	size_t ageRowBytes = self->planes.ageWordsPerRow * sizeof(uint64_t);
+	self->liveBytes = ( (size_t)height * rowBytes + pageSize - 1 ) / pageSize * pageSize;
+	self->ageBytes = ( (size_t)height * ageRowBytes + pageSize - 1 ) / pageSize * pageSize;
+	self->mapSize = self->noOfLiveSlots * self->liveBytes + 2 * self->ageBytes;
+	if(self->mapSize == 0)
+		self->mapSize = pageSize;
+
+	/* A band is the rows of the current and next boards that are worked on at once */
+	self->bandRows = ( (rowBytes + ageRowBytes) > 0 ) ? (int)( MAPPED_BAND_BYTES / ( 2 * (rowBytes + ageRowBytes) ) ) : height;
+	if(self->bandRows < 1)
+		self->bandRows = 1;
+
+	if(options->mapFileName != NULL)
+		self->fd = open(options->mapFileName, O_RDWR | O_CREAT | O_TRUNC, 0644);
+	else
+	{
+		char fileName[] = MAPPED_FILE_TEMPLATE;
+		self->fd = mkstemp(fileName);
+		if(self->fd >= 0)
+			unlink(fileName);
+	}
+	if( (self->fd < 0) || (ftruncate(self->fd, (off_t)self->mapSize) != 0) )
+	{
+		fprintf(stderr, "Error creating the file to keep the boards in (%s).\n"
+		                "Please ensure that the file can be written, and that there is room for %zu bytes.\n"
+		                "The program will now exit.\n", (options->mapFileName != NULL) ? options->mapFileName : MAPPED_FILE_TEMPLATE,
+		                self->mapSize);
+		exit(EXIT_FAILURE);
+	}
+
+	self->map = (unsigned char *)mmap(NULL, self->mapSize, PROT_READ | PROT_WRITE, MAP_SHARED, self->fd, 0);
+	if(self->map == MAP_FAILED)
+	{
+		fputs("Error mapping the file to keep the boards in.\n"
+		      "The program will now exit.\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+	madvise(self->map, self->mapSize, MADV_SEQUENTIAL);
+
+	self->populations = (long *)allocateMemory(self->noOfLiveSlots * sizeof(long));
+	self->hashes = (uint64_t *)allocateMemory(self->noOfLiveSlots * sizeof(uint64_t));
+
+	/* A row of dead cells to use above the top row and below the bottom row */
+	self->deadRow = (uint64_t *)allocateMemory(self->planes.liveWordsPerRow * sizeof(uint64_t));
+	return &self->base;
+}
+
+/*
+	Function: loadMappedEngine()
+	Purpose: Set the current board of a mapped engine, which becomes generation 0, and write it to the file.
+	Arguments: The engine (engine), and the live cells to load (cells).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: An error message if the file can't be cleared.
+ */
+void loadMappedEngine(lifeEngine *engine, const cellList *cells)
+{
+	mappedEngine *self = (mappedEngine *)engine;
+	int words = self->planes.liveWordsPerRow, ageWords = self->planes.ageWordsPerRow;
+	long i;
+
+	/* Cutting the file down to nothing and back clears it, without writing to every page */
+	if( (ftruncate(self->fd, 0) != 0) || (ftruncate(self->fd, (off_t)self->mapSize) != 0) )
+	{
+		fputs("Error clearing the file to keep the boards in.\n"
+		      "The program will now exit.\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+	self->generation = 0;
+	viewMappedEngine(engine);
+
+	for(i = 0; i < cells->noOfCells; i++)
+	{
+		self->planes.live[(size_t)cells->cells[i].row * words + cells->cells[i].column / 64] |= (uint64_t)1 << (cells->cells[i].column % 64);
+		if(cells->ages != NULL)
+			self->planes.ages[(size_t)cells->cells[i].row * ageWords + cells->cells[i].column / 16] |= (uint64_t)cells->ages[i] << (4 * (cells->cells[i].column % 16));
+	}
+
+	/* The population and hash of the board are found as it is written back */
+	long population = 0;
+	uint64_t hash = 0;
+	size_t word, noOfWords = (size_t)self->planes.height * words;
+	for(word = 0; word < noOfWords; word++)
+		if(self->planes.live[word] != 0)
+		{
+			population += countBits(self->planes.live[word]);
+			hash += mixBits(self->planes.live[word] ^ mixBits(word));
+		}
+	self->populations[0] = population;
+	self->hashes[0] = hash;
+
+	releaseMappedRange(self, 0, self->liveBytes, 1);
+	releaseMappedRange(self, self->noOfLiveSlots * self->liveBytes, self->noOfLiveSlots * self->liveBytes + self->ageBytes, 1);
+	return;
+}
+
+/*
+	Function: stepMappedEngine()
+	Purpose: Calculate the next generation of a mapped engine in bands of rows, writing each band back to the file as soon as it is done.
+	Arguments: The engine (engine).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+	Note: This is the bit engine's kernel. Once a band has been calculated, its rows of the next board are written back in the background,
+	      and dropped after the following band (by which time they have usually been written), along with the rows of the current board
+	      that the following bands don't need, so that only about two bands of each plane are in memory at once.
+ */
+void stepMappedEngine(lifeEngine *engine)
+{
+	mappedEngine *self = (mappedEngine *)engine;
+	int words = self->planes.liveWordsPerRow;
+	int ageWords = self->planes.ageWordsPerRow;
+	int height = self->planes.height;
+	size_t rowBytes = words * sizeof(uint64_t), ageRowBytes = ageWords * sizeof(uint64_t);
+
+	/* The offsets in the file of the planes of the current board, and of the next board, which goes in the slots after them */
+	int nextSlot = (int)( (self->generation + 1) % self->noOfLiveSlots );
+	size_t currentLive = (self->generation % self->noOfLiveSlots) * self->liveBytes;
+	size_t nextLive = nextSlot * self->liveBytes;
+	size_t currentAges = self->noOfLiveSlots * self->liveBytes + (self->generation % 2) * self->ageBytes;
+	size_t nextAges = self->noOfLiveSlots * self->liveBytes + ( (self->generation + 1) % 2 ) * self->ageBytes;
+	uint64_t *live = (uint64_t *)(self->map + currentLive), *ages = (uint64_t *)(self->map + currentAges);
+	uint64_t *newLive = (uint64_t *)(self->map + nextLive), *newAges = (uint64_t *)(self->map + nextAges);
+
+	/* The cells past the end of the last word of each row don't exist, so must be kept dead */
+	uint64_t lastWordMask = (self->planes.width % 64 == 0) ? ~(uint64_t)0 : ( ((uint64_t)1 << (self->planes.width % 64)) - 1 );
+
+	long population = 0;
+	uint64_t hash = 0;
+	int first, last = 0, row, word;
+	size_t rowStart;
+
+	/* The rows of the current board's planes, and of the next board's, that have been dropped so far */
+	int droppedLive = 0, droppedAges = 0, droppedNext = 0;
+	const uint64_t *above, *below;
+
+	for(first = 0; first < height; first = last)
+	{
+		last = (first + self->bandRows < height) ? first + self->bandRows : height;
+		for(row = first; row < last; row++)
+		{
+			rowStart = (size_t)row * words;
+			above = (row > 0) ? live + rowStart - words : self->deadRow;
+			below = (row < height - 1) ? live + rowStart + words : self->deadRow;
+			iterateLiveRow(above, live + rowStart, below, newLive + rowStart, words, lastWordMask);
+			updateAgeRow(live + rowStart, newLive + rowStart, ages + (size_t)row * ageWords, newAges + (size_t)row * ageWords, ageWords);
+
+			for(word = 0; word < words; word++)
+				if(newLive[rowStart + word] != 0)
+				{
+					population += countBits(newLive[rowStart + word]);
+					hash += mixBits(newLive[rowStart + word] ^ mixBits(rowStart + word));
+				}
+		}
+
+		/* Start writing this band back, and drop the band before it */
+		writeBackMappedRange(self, nextLive + first * rowBytes, nextLive + last * rowBytes);
+		writeBackMappedRange(self, nextAges + first * ageRowBytes, nextAges + last * ageRowBytes);
+		releaseMappedRange(self, nextLive + droppedNext * rowBytes, nextLive + first * rowBytes, 1);
+		releaseMappedRange(self, nextAges + droppedNext * ageRowBytes, nextAges + first * ageRowBytes, 1);
+		droppedNext = first;
+
+		/* The next band only needs the last row of this one from the current board */
+		releaseMappedRange(self, currentLive + droppedLive * rowBytes, currentLive + (last - 1) * rowBytes, 0);
+		releaseMappedRange(self, currentAges + droppedAges * ageRowBytes, currentAges + last * ageRowBytes, 0);
+		droppedLive = last - 1;
+		droppedAges = last;
+	}
+
+	/* Drop the rest of both boards, the planes end on page boundaries so nothing is left behind */
+	releaseMappedRange(self, nextLive + droppedNext * rowBytes, nextLive + self->liveBytes, 1);
+	releaseMappedRange(self, nextAges + droppedNext * ageRowBytes, nextAges + self->ageBytes, 1);
+	releaseMappedRange(self, currentLive + droppedLive * rowBytes, currentLive + self->liveBytes, 0);
+	releaseMappedRange(self, currentAges + droppedAges * ageRowBytes, currentAges + self->ageBytes, 0);
+
+	self->generation++;
+	self->populations[nextSlot] = population;
+	self->hashes[nextSlot] = hash;
+	return;
+}
+
+/*
+	Function: writeBackMappedRange()
+	Purpose: Start writing a range of a mapped engine's file back to the disk, without waiting for it to be written.
+	Arguments: The engine (self), and the offsets in the file of the start and end of the range (start and end).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+	Note: Only Linux can start writing a range without waiting for it, elsewhere the range is written when it is released.
+ */
+void writeBackMappedRange(mappedEngine *self, size_t start, size_t end)
+{
+#ifdef SYNC_FILE_RANGE_WRITE
+	if(end > start)
+		sync_file_range(self->fd, (off_t)start, (off_t)(end - start), SYNC_FILE_RANGE_WRITE);
+#else
+	(void)self;
+	(void)start;
+	(void)end;
+#endif
+	return;
+}
+
+/*
+	Function: releaseMappedRange()
+	Purpose: Drop the whole pages of a range of a mapped engine's file from memory, first waiting for them to be written if they have changed.
+	Arguments: The engine (self), the offsets in the file of the start and end of the range (start and end), and whether the range has changed (written).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+	Note: The page that the end is in is only partly in the range, so it is left to be dropped with the range that follows.
+	      Dropping a page never loses anything, since the file keeps it, it just has to be read again if it is used again.
+ */
+void releaseMappedRange(mappedEngine *self, size_t start, size_t end, int written)
+{
+	size_t pageSize = (size_t)sysconf(_SC_PAGESIZE);
+	size_t firstPage = start / pageSize * pageSize;
+	size_t lastPage = end / pageSize * pageSize;
+
+	if(firstPage >= lastPage)
+		return;
+
+	if(written)
+	{
+#ifdef SYNC_FILE_RANGE_WRITE
+		sync_file_range(self->fd, (off_t)firstPage, (off_t)(lastPage - firstPage),
+		                SYNC_FILE_RANGE_WAIT_BEFORE | SYNC_FILE_RANGE_WRITE | SYNC_FILE_RANGE_WAIT_AFTER);
+#else
+		msync(self->map + firstPage, lastPage - firstPage, MS_SYNC);
+#endif
+	}
+	madvise(self->map + firstPage, lastPage - firstPage, MADV_DONTNEED);
+	posix_fadvise(self->fd, (off_t)firstPage, (off_t)(lastPage - firstPage), POSIX_FADV_DONTNEED);
+	return;
+}
+
+/*
+	Function: viewMappedEngine()
+	Purpose: Give the current board of a mapped engine, which is in the file.
+	Arguments: The engine (engine).
+	Return value: A pointer to the planes of the current board, which are paged in from the file as they are read.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+const boardPlanes *viewMappedEngine(lifeEngine *engine)
+{
+	mappedEngine *self = (mappedEngine *)engine;
+	self->planes.live = (uint64_t *)( self->map + (self->generation % self->noOfLiveSlots) * self->liveBytes );
+	self->planes.ages = (uint64_t *)( self->map + self->noOfLiveSlots * self->liveBytes + (self->generation % 2) * self->ageBytes );
+	return &self->planes;
+}
+
+/*
+	Function: findMappedPeriod()
+	Purpose: Test the current board of a mapped engine against the earlier generations in its file, most recent first.
+	Arguments: The engine (engine).
+	Return value: The period if the live cells are the same as in one of the last historyDepth generations, or 0 if they aren't.
+	Inputs from user: None.
+	Outputs to user: None.
+	Note: The population and hash of each generation are found as it is calculated,
+	      so the boards are only read from the file (a band at a time) when they match.
+ */
+int findMappedPeriod(lifeEngine *engine)
+{
+	mappedEngine *self = (mappedEngine *)engine;
+	int current = (int)(self->generation % self->noOfLiveSlots), earlier, j;
+	size_t start, end, bandBytes = (size_t)self->bandRows * self->planes.liveWordsPerRow * sizeof(uint64_t);
+	int same;
+
+	for(j = 1; (j <= self->historyDepth) && (j <= self->generation); j++)
+	{
+		earlier = (int)( (self->generation - j) % self->noOfLiveSlots );
+		if( (self->populations[earlier] != self->populations[current]) || (self->hashes[earlier] != self->hashes[current]) )
+			continue;
+
+		/* The population and hash match, so compare the cells themselves to rule out a hash collision */
+		same = 1;
+		for(start = 0; same && (start < self->liveBytes); start = end)
+		{
+			end = (start + bandBytes < self->liveBytes) ? start + bandBytes : self->liveBytes;
+			same = memcmp(self->map + current * self->liveBytes + start, self->map + earlier * self->liveBytes + start, end - start) == 0;
+			releaseMappedRange(self, current * self->liveBytes + start, current * self->liveBytes + end, 0);
+			releaseMappedRange(self, earlier * self->liveBytes + start, earlier * self->liveBytes + end, 0);
+		}
+		if(same)
+			return j;
+	}
+	return 0;
+}
+
+/*
+	Function: mappedEngineMemory()
+	Purpose: Calculate the memory a mapped engine allocates for a board, which doesn't include the file its boards are kept in.
+	Arguments: The width and height of the board (width and height), and the command line settings (options), of which only the history depth is used.
+	Return value: The number of bytes.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+double mappedEngineMemory(int width, int height, const engineOptions *options)
+{
+	(void)height;
+	return sizeof(mappedEngine) + (options->historyDepth + 2) * ( sizeof(long) + sizeof(uint64_t) ) + ( (long)width + 63 ) / 64 * sizeof(uint64_t)
+	       + 4 * ARENA_ALIGNMENT;
+}
+
+/*
+	Function: destroyMappedEngine()
+	Purpose: Unmap and close a mapped engine's file, and free the engine.
+	Arguments: The engine (engine).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+	Note: A file named with --map-file is kept, holding the last generations.
+ */
+void destroyMappedEngine(lifeEngine *engine)
+{
+	mappedEngine *self = (mappedEngine *)engine;
+
+	munmap(self->map, self->mapSize);
+	close(self->fd);
+	freeMemory(self->populations);
+	freeMemory(self->hashes);
+	freeMemory(self->deadRow);
+	freeMemory(self);
+	return;
+}
+
+/*
+	Function: engineForRule()
+	Purpose: Choose the engine for a rule, as only the ltl engine calculates Larger than Life rules,
+	         and only it, the generations engine and (for rules without dying states) the table engine calculate other rules than Life.
+	Arguments: The engine chosen with --engine, or NULL if none was (selectedEngine), and the rule to calculate (rule).
+	Return value: The engine to use, which is NULL if none was chosen and any engine can calculate the rule.
+	Inputs from user: None.
+	Outputs to user: An error message if the engine chosen can't calculate the rule.
+ */
+const engineType *engineForRule(const engineType *selectedEngine, const generationsRule *rule)
+{
+	if(rule->range > 0)
+	{
+		if(selectedEngine == NULL)
+			selectedEngine = &largerThanLifeEngineType;
+		else if(selectedEngine != &largerThanLifeEngineType)
+		{
+			fputs("Only the ltl engine can calculate Larger than Life rules.\n"
+			      "The program will now exit.\n", stderr);
+			exit(EXIT_FAILURE);
+		}
+	}
+	else if( (rule->birth != (1u << 3)) || (rule->survival != ( (1u << 2) | (1u << 3) )) || (rule->noOfStates != 2) )
+	{
+		if(selectedEngine == NULL)
+			selectedEngine = &generationsEngineType;
+		else if( (selectedEngine != &generationsEngineType) && (selectedEngine != &largerThanLifeEngineType)
+		         && ( (selectedEngine != &tableEngineType) || (rule->noOfStates != 2) ) )
+		{
+			fputs("Only the generations and ltl engines can calculate rules other than Life (B3/S23),\n"
+			      "and the table engine those without dying states.\n"
+			      "The program will now exit.\n", stderr);
+			exit(EXIT_FAILURE);
+		}
+	}
+	return selectedEngine;
+}
+
+/*
+	Function: runServer()
+	Purpose: Run the program as a server, which holds any number of boards (sessions) for its clients, until it is sent SIGINT or SIGTERM.
+	         A single thread (the event loop) waits on every connection at once, and carries out the requests that are quick enough itself.
+	         The rest are carried out by noOfWorkers worker threads, each taking a session at a time from a queue, along with every request
+	         queued for the session since, so that requests which arrive while a session is busy are carried out together in one batch.
+	Arguments: The path of the Unix domain socket to listen on (socketPath), the engine that calculates every session's board (type),
+	           the settings to create the engines with (options), of which the history depth is given by each load,
+	           and the number of worker threads (noOfWorkers).
+	Return value: EXIT_SUCCESS once the server has stopped.
+	Inputs from user: Requests from the clients that connect to the socket.
+	Outputs to user: "Listening on <path>" once the clients can connect, and "Server stopped" once it has stopped.
+	                 Error messages if the server can't be started.
+	Note: Every message is a serverHeader followed by length bytes of payload, all in the machine's own byte order.
+	      Each request is answered with a reply of the same type, with the same session and tag, and its status in flags.
+	      Unless it is noted otherwise, a reply with the status SERVER_OK has a serverStatus as its payload, and any other has none.
+	      SERVER_LOAD: int32 width, height, history depth (the maximum period to detect) and 0, followed by the row and column (int32 each)
+	                   of every live cell. Session 0 starts a new session, whose id is in the reply, otherwise the session's board is replaced.
+	      SERVER_STEP: int64 number of generations to calculate.
+	      SERVER_QUERY: int32 top, left, height and width of a region of the board, which may go past its edges (where the cells are dead).
+	                    The reply's serverStatus is followed by the cells of the region, a row at a time, (width + 7) / 8 bytes to a row,
+	                    bit (column % 8) of byte (column / 8) being set if the cell is alive, then with the flag SERVER_WITH_AGES,
+	                    the age of each cell of the region, a byte to a cell.
+	      SERVER_STATUS: no payload.
+	      SERVER_CLOSE: no payload, and the reply has none.
+	      SERVER_FORK: no payload. Starts a new session with the session's board at its current generation, and its history,
+	                   which then carries on independently of it. The new session's id is in the reply, with its status.
+	                   An engine with fork() (the cow engine) shares the board between the sessions, so the fork takes no time,
+	                   otherwise the board is copied, which engines that keep their own history can't do, so a fork is a bad request with them.
+	      A session belongs to the connection that loaded it, and is closed when the connection is.
+	      The requests for a session are always carried out in order, but the replies for different sessions may come in any order.
+ */
+int runServer(const char *socketPath, const engineType *type, const engineOptions *options, int noOfWorkers)
+{
+	lifeServer *server = (lifeServer *)allocateMemory(sizeof(lifeServer));
+	struct epoll_event event, events[64];
+	int noOfEvents, running = 1, i;
+
+	server->type = type;
+	server->options = *options;
+	server->noOfWorkers = noOfWorkers;
+
+	/* SIGINT and SIGTERM are read from signalFd, so they are blocked here, before the workers start, as they inherit the mask */
+	sigset_t signals;
+	sigemptyset(&signals);
+	sigaddset(&signals, SIGINT);
+	sigaddset(&signals, SIGTERM);
+	pthread_sigmask(SIG_BLOCK, &signals, NULL);
+
+	server->listenSocket = openServerSocket(socketPath);
+	server->epollFd = epoll_create1(EPOLL_CLOEXEC);
+	server->wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	server->signalFd = signalfd(-1, &signals, SFD_NONBLOCK | SFD_CLOEXEC);
+
+	/* The listening socket, the eventfd and the signalfd are told apart from the connections by their data, which points to their descriptor */
+	int *descriptors[3] = {&server->listenSocket, &server->wakeFd, &server->signalFd};
+	for(i = 0; i < 3; i++)
+	{
+		event.events = EPOLLIN;
+		event.data.ptr = descriptors[i];
+		if( (server->epollFd < 0) || (*descriptors[i] < 0) || (epoll_ctl(server->epollFd, EPOLL_CTL_ADD, *descriptors[i], &event) != 0) )
+		{
+			fputs("Error starting the server's event loop.\n"
+			      "The program will now exit.\n", stderr);
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	pthread_mutex_init(&server->lock, NULL);
+	pthread_cond_init(&server->sessionsReady, NULL);
+	server->workers = (pthread_t *)allocateMemory(noOfWorkers * sizeof(pthread_t));
+	for(i = 0; i < noOfWorkers; i++)
+	{
+		if(pthread_create(&server->workers[i], NULL, runServerWorker, server) != 0)
+		{
+			fputs("Error starting the server's worker threads.\n"
+			      "The program will now exit.\n", stderr);
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	printf("Listening on %s\n", socketPath);
+	fflush(stdout);
+
+	while(running)
+	{
+		noOfEvents = epoll_wait(server->epollFd, events, 64, -1);
+		if( (noOfEvents < 0) && (errno != EINTR) )
+		{
+			fputs("Error waiting for the server's connections.\n"
+			      "The program will now exit.\n", stderr);
+			exit(EXIT_FAILURE);
+		}
+
+		for(i = 0; i < noOfEvents; i++)
+		{
+			if(events[i].data.ptr == &server->listenSocket)
+				acceptConnections(server);
+			else if(events[i].data.ptr == &server->wakeFd)
+				finishBatches(server);
+			else if(events[i].data.ptr == &server->signalFd)
+				running = 0;
+			else if( (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) && !readConnection(server, (serverConnection *)events[i].data.ptr) )
+				closeConnection(server, (serverConnection *)events[i].data.ptr);
+			else if(events[i].events & EPOLLOUT)
+				flushConnection(server, (serverConnection *)events[i].data.ptr);
+		}
+	}
+
+	/* Stop the workers once they have finished their batches, then close every connection and session, whether it was finished or not */
+	pthread_mutex_lock(&server->lock);
+	server->stopping = 1;
+	pthread_cond_broadcast(&server->sessionsReady);
+	pthread_mutex_unlock(&server->lock);
+	for(i = 0; i < noOfWorkers; i++)
+		pthread_join(server->workers[i], NULL);
+
+	for(i = 0; i < MAX_SERVER_CONNECTIONS; i++)
+		if(server->connections[i] != NULL)
+			closeConnection(server, server->connections[i]);
+	for(i = 0; i < MAX_SERVER_SESSIONS; i++)
+		if(server->sessions[i] != NULL)
+			destroySession(server, server->sessions[i]);
+
+	close(server->listenSocket);
+	close(server->epollFd);
+	close(server->wakeFd);
+	close(server->signalFd);
+	unlink(socketPath);
+	pthread_mutex_destroy(&server->lock);
+	pthread_cond_destroy(&server->sessionsReady);
+	freeMemory(server->workers);
+	freeMemory(server);
+
+	puts("Server stopped");
+	return EXIT_SUCCESS;
+}
+
+/*
+	Function: openServerSocket()
+	Purpose: Create the server's listening socket, replacing any socket left at the path by a server that didn't stop cleanly.
+	Arguments: The path of the socket (socketPath).
+	Return value: The listening socket, which doesn't block.
+	Inputs from user: None.
+	Outputs to user: An error message if the socket can't be created.
+ */
+int openServerSocket(const char *socketPath)
+{
+	struct sockaddr_un address;
+	struct stat status;
+	int listenSocket;
+
+	if(strlen(socketPath) >= sizeof(address.sun_path))
+	{
+		fprintf(stderr, "The socket path (%s) is too long.\n"
+		                "Please ensure that it is less than %d characters long.\n"
+		                "The program will now exit.\n", socketPath, (int)sizeof(address.sun_path));
+		exit(EXIT_FAILURE);
+	}
+	memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	strcpy(address.sun_path, socketPath);
+
+	/* A socket that nothing is listening on any more is removed, but one that a server is still listening on is left alone */
+	if( (lstat(socketPath, &status) == 0) && S_ISSOCK(status.st_mode) )
+	{
+		listenSocket = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+		if( (listenSocket >= 0) && (connect(listenSocket, (struct sockaddr *)&address, sizeof(address)) == 0) )
+		{
+			fprintf(stderr, "Another server is already listening on the socket (%s).\n"
+			                "The program will now exit.\n", socketPath);
+			exit(EXIT_FAILURE);
+		}
+		if(listenSocket >= 0)
+			close(listenSocket);
+		unlink(socketPath);
+	}
+
+	listenSocket = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+	if( (listenSocket < 0) || (bind(listenSocket, (struct sockaddr *)&address, sizeof(address)) != 0) || (listen(listenSocket, SOMAXCONN) != 0) )
+	{
+		fprintf(stderr, "Error listening on the socket (%s).\n"
+		                "Please ensure that the directory exists, and that nothing else is at the path.\n"
+		                "The program will now exit.\n", socketPath);
+		exit(EXIT_FAILURE);
+	}
+	return listenSocket;
+}
+
+/*
+	Function: acceptConnections()
+	Purpose: Accept every connection that is waiting on the server's listening socket.
+	Arguments: The server (server).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+	Note: A connection beyond the first MAX_SERVER_CONNECTIONS is closed at once.
+ */
+void acceptConnections(lifeServer *server)
+{
+	serverConnection *connection;
+	struct epoll_event event;
+	int connectionSocket, slot;
+
+	while( (connectionSocket = accept4(server->listenSocket, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0 )
+	{
+		for(slot = 0; (slot < MAX_SERVER_CONNECTIONS) && (server->connections[slot] != NULL); slot++);
+		if(slot == MAX_SERVER_CONNECTIONS)
+		{
+			close(connectionSocket);
+			continue;
+		}
+
+		connection = (serverConnection *)allocateMemory(sizeof(serverConnection));
+		connection->socket = connectionSocket;
+		connection->slot = slot;
+		event.events = EPOLLIN;
+		event.data.ptr = connection;
+		if(epoll_ctl(server->epollFd, EPOLL_CTL_ADD, connectionSocket, &event) != 0)
+		{
+			close(connectionSocket);
+			freeMemory(connection);
+			continue;
+		}
+		server->connections[slot] = connection;
+	}
+	return;
+}
+
+/*
+	Function: readConnection()
+	Purpose: Read everything that a client has sent, pass on each whole request, and send any replies that are ready.
+	Arguments: The server (server), and the connection to read (connection).
+	Return value: 1 if the connection is still open,
+	              0 if the client has closed it, or sent a message that is too long, so it must be closed.
+	Inputs from user: The client's requests.
+	Outputs to user: The replies to the requests that are carried out at once.
+ */
+int readConnection(lifeServer *server, serverConnection *connection)
+{
+	byteBuffer *input = &connection->input;
+	serverHeader header;
+	size_t position;
+	ssize_t received;
+
+	/* Read until the socket is empty, leaving room for at least another STREAM_BUFFER_SIZE bytes each time */
+	while(1)
+	{
+		reserveBytes(input, STREAM_BUFFER_SIZE);
+		received = recv(connection->socket, input->bytes + input->length, input->capacity - input->length, 0);
+		if( (received < 0) && (errno == EINTR) )
+			continue;
+		if( (received < 0) && ( (errno == EAGAIN) || (errno == EWOULDBLOCK) ) )
+			break;
+		if(received <= 0)
+			return 0;
+		input->length += received;
+		if(input->length < input->capacity)
+			break;
+	}
+
+	/* Pass on every whole message, and keep the start of any message that is still to come */
+	for(position = 0; input->length - position >= sizeof(serverHeader); position += sizeof(serverHeader) + header.length)
+	{
+		memcpy(&header, input->bytes + position, sizeof(serverHeader));
+		if(header.length > MAX_SERVER_MESSAGE)
+			return 0;
+		if(input->length - position - sizeof(serverHeader) < header.length)
+			break;
+		receiveRequest(server, connection, &header, input->bytes + position + sizeof(serverHeader));
+	}
+	memmove(input->bytes, input->bytes + position, input->length - position);
+	input->length -= position;
+
+	flushConnection(server, connection);
+	return 1;
+}
+
+/*
+	Function: receiveRequest()
+	Purpose: Queue a request for its session, and carry it out at once if the session isn't busy and the request is quick enough.
+	Arguments: The server (server), the connection the request came from (connection), the request's header (header),
+	           which is given the new session's id if the request starts one, and its payload (payload).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+void receiveRequest(lifeServer *server, serverConnection *connection, serverHeader *header, const unsigned char *payload)
+{
+	serverSession *session;
+	int32_t sizes[4];
+	int64_t noOfGenerations;
+	double cost = 0;
+
+	/* A load for session 0 starts a new session */
+	if( (header->type == SERVER_LOAD) && (header->session == 0) )
+	{
+		session = createSession(server, connection);
+		if(session == NULL)
+		{
+			addReply(&connection->output, header, SERVER_BAD_REQUEST, 0);
+			return;
+		}
+		header->session = session->id;
+	}
+	else
+	{
+		session = findSession(server, header->session);
+		if( (session == NULL) || (session->owner != connection) )
+		{
+			addReply(&connection->output, header, SERVER_NO_SESSION, 0);
+			return;
+		}
+	}
+
+	/* A fork starts a new session, which gets its board when the session it is forked from carries the fork out, in order with its other requests,
+	   and is marked as queued until then so that any requests for it wait. The fork is queued with a pointer to the new session as its payload,
+	   or with no payload if the request had one or the session couldn't be started, so that it is answered as a bad request. */
+	serverHeader forkHeader;
+	serverSession *fork;
+	if(header->type == SERVER_FORK)
+	{
+		fork = (header->length == 0) ? createSession(server, connection) : NULL;
+		if(fork != NULL)
+		{
+			fork->queued = 1;
+			fork->area = session->area;
+		}
+		forkHeader = *header;
+		forkHeader.length = (fork != NULL) ? sizeof(fork) : 0;
+		header = &forkHeader;
+		payload = (const unsigned char *)&fork;
+	}
+
+	/* Estimate the number of cells the request calculates or copies, from the size of the last board loaded */
+	if( (header->type == SERVER_LOAD) && (header->length >= sizeof(sizes)) )
+	{
+		memcpy(sizes, payload, sizeof(sizes));
+		if( (sizes[0] > 0) && (sizes[1] > 0) )
+			session->area = (double)sizes[0] * sizes[1];
+		cost = session->area + header->length / 8;
+	}
+	else if( (header->type == SERVER_STEP) && (header->length == sizeof(noOfGenerations)) )
+	{
+		memcpy(&noOfGenerations, payload, sizeof(noOfGenerations));
+		if(noOfGenerations > 0)
+			cost = session->area * noOfGenerations;
+	}
+	else if( (header->type == SERVER_QUERY) && (header->length == sizeof(sizes)) )
+	{
+		memcpy(sizes, payload, sizeof(sizes));
+		if( (sizes[2] > 0) && (sizes[3] > 0) )
+			cost = (double)sizes[2] * sizes[3];
+	}
+
+	/* The queue of a session that is queued itself is shared with the workers */
+	if(session->queued)
+		pthread_mutex_lock(&server->lock);
+	appendBytes(&session->requests, header, sizeof(serverHeader));
+	appendBytes(&session->requests, payload, header->length);
+	session->cost += cost;
+	if(session->queued)
+		pthread_mutex_unlock(&server->lock);
+	else
+		scheduleSession(server, session);
+	return;
+}
+
+/*
+	Function: scheduleSession()
+	Purpose: Carry out the requests queued for a session that isn't queued itself, at once if they are quick enough,
+	         or otherwise by queueing the session for the workers.
+	Arguments: The server (server), and the session (session).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+void scheduleSession(lifeServer *server, serverSession *session)
+{
+	byteBuffer spare;
+
+	if(session->cost <= SERVER_INLINE_CELLS)
+	{
+		spare = session->batch;
+		session->batch = session->requests;
+		session->requests = spare;
+		session->cost = 0;
+		runSessionBatch(server, session);
+		finishSessionBatch(server, session);
+		return;
+	}
+
+	session->queued = 1;
+	session->next = NULL;
+	pthread_mutex_lock(&server->lock);
+	if(server->lastReady == NULL)
+		server->firstReady = session;
+	else
+		server->lastReady->next = session;
+	server->lastReady = session;
+	pthread_cond_signal(&server->sessionsReady);
+	pthread_mutex_unlock(&server->lock);
+	return;
+}
+
+/*
+	Function: finishBatches()
+	Purpose: Pass on the replies of the batches that the workers have finished, and schedule any requests that arrived meanwhile.
+	Arguments: The server (server).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: The replies that are sent.
+ */
+void finishBatches(lifeServer *server)
+{
+	serverSession *session, *next;
+	serverConnection *owner;
+	uint64_t count;
+	ssize_t received;
+
+	/* The eventfd is cleared before the list is taken, so that a batch finished after this wakes the event loop again */
+	received = read(server->wakeFd, &count, sizeof(count));
+	(void)received;
+
+	pthread_mutex_lock(&server->lock);
+	session = server->firstDone;
+	server->firstDone = NULL;
+	pthread_mutex_unlock(&server->lock);
+
+	for(; session != NULL; session = next)
+	{
+		next = session->next;
+		owner = session->owner;
+		session->queued = 0;
+		finishSessionBatch(server, session);
+		if(owner != NULL)
+			flushConnection(server, owner);
+	}
+	return;
+}
+
+/*
+	Function: finishSessionBatch()
+	Purpose: Pass the replies of a session's batch to its connection, then destroy the session if it has been closed,
+	         or carry out any requests that have been queued for it since.
+	Arguments: The server (server), and the session, which must not be queued (session).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+void finishSessionBatch(lifeServer *server, serverSession *session)
+{
+	serverSession *fork;
+
+	if(session->owner != NULL)
+		appendBytes(&session->owner->output, session->replies.bytes, session->replies.length);
+	session->replies.length = 0;
+
+	/* The sessions forked in the batch can now carry out their own requests, or are destroyed if the fork failed or their connection has gone */
+	while(session->forks != NULL)
+	{
+		fork = session->forks;
+		session->forks = fork->nextFork;
+		fork->queued = 0;
+		finishSessionBatch(server, fork);
+	}
+
+	/* A session without an engine has been closed, or was new and couldn't be loaded */
+	if( (session->owner == NULL) || ( (session->engine == NULL) && (session->requests.length == 0) ) )
+		destroySession(server, session);
+	else if(session->requests.length > 0)
+		scheduleSession(server, session);
+	return;
+}
+
+/*
+	Function: flushConnection()
+	Purpose: Send as much of a connection's replies as the socket takes without blocking,
+	         and wait for the socket to become writable only while some are left.
+	Arguments: The server (server), and the connection (connection).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: The replies that are sent.
+	Note: If the client has gone, the replies are thrown away, and the connection is closed when the event loop next reads it.
+ */
+void flushConnection(lifeServer *server, serverConnection *connection)
+{
+	byteBuffer *output = &connection->output;
+	struct epoll_event event;
+	ssize_t sent = 0;
+	int waiting;
+
+	while(connection->written < output->length)
+	{
+		sent = send(connection->socket, output->bytes + connection->written, output->length - connection->written, MSG_NOSIGNAL | MSG_DONTWAIT);
+		if( (sent < 0) && (errno == EINTR) )
+			continue;
+		if(sent < 0)
+			break;
+		connection->written += sent;
+	}
+	if( (sent < 0) && (errno != EAGAIN) && (errno != EWOULDBLOCK) )
+		connection->written = output->length;
+
+	/* Move what is left to the start of the buffer once most of it has been sent, so that the buffer doesn't keep growing */
+	if(connection->written == output->length)
+		output->length = connection->written = 0;
+	else if(connection->written > output->length / 2)
+	{
+		memmove(output->bytes, output->bytes + connection->written, output->length - connection->written);
+		output->length -= connection->written;
+		connection->written = 0;
+	}
+
+	waiting = (output->length > 0);
+	if(waiting != connection->waitingToWrite)
+	{
+		event.events = waiting ? (EPOLLIN | EPOLLOUT) : EPOLLIN;
+		event.data.ptr = connection;
+		epoll_ctl(server->epollFd, EPOLL_CTL_MOD, connection->socket, &event);
+		connection->waitingToWrite = waiting;
+	}
+	return;
+}
+
+/*
+	Function: closeConnection()
+	Purpose: Close a connection and its sessions.
+	Arguments: The server (server), and the connection (connection).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+	Note: A session that is queued is only left without an owner, and is destroyed once its batch is finished.
+ */
+void closeConnection(lifeServer *server, serverConnection *connection)
+{
+	serverSession *session;
+	int slot;
+
+	for(slot = 0; slot < MAX_SERVER_SESSIONS; slot++)
+	{
+		session = server->sessions[slot];
+		if( (session != NULL) && (session->owner == connection) )
+		{
+			session->owner = NULL;
+			if(!session->queued)
+				destroySession(server, session);
+		}
+	}
+
+	epoll_ctl(server->epollFd, EPOLL_CTL_DEL, connection->socket, NULL);
+	close(connection->socket);
+	server->connections[connection->slot] = NULL;
+	freeMemory(connection->input.bytes);
+	freeMemory(connection->output.bytes);
+	freeMemory(connection);
+	return;
+}
+
+/*
+	Function: createSession()
+	Purpose: Start a new session, without a board until its first load is carried out.
+	Arguments: The server (server), and the connection the session belongs to (owner).
+	Return value: A pointer to the session, or NULL if the server already holds MAX_SERVER_SESSIONS sessions.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+serverSession *createSession(lifeServer *server, serverConnection *owner)
+{
+	serverSession *session;
+	int slot;
+
+	for(slot = 0; (slot < MAX_SERVER_SESSIONS) && (server->sessions[slot] != NULL); slot++);
+	if(slot == MAX_SERVER_SESSIONS)
+		return NULL;
+
+	/* The id counts the uses of the slot, which wrap round before the id goes past 32 bits */
+	server->slotUses[slot] = (server->slotUses[slot] + 1) % (UINT32_MAX / MAX_SERVER_SESSIONS);
+	session = (serverSession *)allocateMemory(sizeof(serverSession));
+	session->id = server->slotUses[slot] * MAX_SERVER_SESSIONS + slot + 1;
+	session->owner = owner;
+	session->measuredGeneration = -1;
+	server->sessions[slot] = session;
+	return session;
+}
+
+/*
+	Function: findSession()
+	Purpose: Find a session from its id.
+	Arguments: The server (server), and the id (id).
+	Return value: A pointer to the session, or NULL if there isn't one with the id.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+serverSession *findSession(lifeServer *server, uint32_t id)
+{
+	serverSession *session;
+
+	if(id == 0)
+		return NULL;
+	session = server->sessions[(id - 1) % MAX_SERVER_SESSIONS];
+	return ( (session != NULL) && (session->id == id) ) ? session : NULL;
+}
+
+/*
+	Function: destroySession()
+	Purpose: Destroy a session, with its engine and history, and free its slot.
+	Arguments: The server (server), and the session, which must not be queued (session).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+void destroySession(lifeServer *server, serverSession *session)
+{
+	freeSessionBoard(session);
+	freeMemory(session->requests.bytes);
+	freeMemory(session->batch.bytes);
+	freeMemory(session->replies.bytes);
+	server->sessions[(session->id - 1) % MAX_SERVER_SESSIONS] = NULL;
+	freeMemory(session);
+	return;
+}
+
+/*
+	Function: freeSessionBoard()
+	Purpose: Destroy a session's engine and history, leaving it without a board.
+	Arguments: The session (session).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+void freeSessionBoard(serverSession *session)
+{
+	if(session->engine != NULL)
+		session->engine->type->destroy(session->engine);
+	freeMemory(session->history);
+	freeMemory(session->populations);
+	freeMemory(session->hashes);
+	session->engine = NULL;
+	session->history = NULL;
+	session->populations = NULL;
+	session->hashes = NULL;
+	return;
+}
+
+/*
+	Function: runServerWorker()
+	Purpose: Carry out batches of requests for the server's sessions, one session at a time, until the server stops.
+	Arguments: The server (argument).
+	Return value: NULL.
+	Inputs from user: None.
+	Outputs to user: None.
+	Note: Each batch is every request queued for the session when the worker takes it, and once it is finished the session
+	      is put on the done list, and the event loop woken to pass on the replies.
+ */
+void *runServerWorker(void *argument)
+{
+	lifeServer *server = (lifeServer *)argument;
+	serverSession *session;
+	byteBuffer spare;
+	uint64_t one = 1;
+	ssize_t written;
+
+	pthread_mutex_lock(&server->lock);
+	while(1)
+	{
+		while( (server->firstReady == NULL) && !server->stopping )
+			pthread_cond_wait(&server->sessionsReady, &server->lock);
+		if(server->stopping)
+			break;
+
+		session = server->firstReady;
+		server->firstReady = session->next;
+		if(server->firstReady == NULL)
+			server->lastReady = NULL;
+		spare = session->batch;
+		session->batch = session->requests;
+		session->requests = spare;
+		session->cost = 0;
+		pthread_mutex_unlock(&server->lock);
+
+		runSessionBatch(server, session);
+
+		pthread_mutex_lock(&server->lock);
+		session->next = server->firstDone;
+		server->firstDone = session;
+
+		/* Writing to the eventfd only fails if its count is about to overflow, in which case the event loop hasn't read it yet anyway */
+		written = write(server->wakeFd, &one, sizeof(one));
+		(void)written;
+	}
+	pthread_mutex_unlock(&server->lock);
+	return NULL;
+}
+
+/*
+	Function: runSessionBatch()
+	Purpose: Carry out the batch of requests of a session, in order, writing their replies to the session's replies.
+	Arguments: The server (server), and the session (session).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+void runSessionBatch(const lifeServer *server, serverSession *session)
+{
+	serverHeader header;
+	serverStatus status;
+	const unsigned char *payload;
+	unsigned char *reply;
+	int32_t region[4];
+	int64_t noOfGenerations;
+	size_t position, regionBytes;
+	int withAges, result;
+	serverSession *fork;
+
+	for(position = 0; position < session->batch.length; position += sizeof(serverHeader) + header.length)
+	{
+		memcpy(&header, session->batch.bytes + position, sizeof(serverHeader));
+		payload = session->batch.bytes + position + sizeof(serverHeader);
+
+		/* A session started by a fork is given back to the event loop once the batch is done, whether or not it gets a board */
+		fork = NULL;
+		if( (header.type == SERVER_FORK) && (header.length == sizeof(fork)) )
+		{
+			memcpy(&fork, payload, sizeof(fork));
+			fork->nextFork = session->forks;
+			session->forks = fork;
+		}
+
+		/* Nothing can be done with a closed session, and only a load with a new one */
+		if( session->closed || ( (session->engine == NULL) && (header.type != SERVER_LOAD) ) )
+		{
+			addReply(&session->replies, &header, SERVER_NO_SESSION, 0);
+			continue;
+		}
+
+		switch(header.type)
+		{
+			case SERVER_LOAD:
+				result = loadSession(server, session, payload, header.length);
+				if(result != SERVER_OK)
+				{
+					/* A new session that couldn't be loaded is destroyed, so the client isn't told its id */
+					if(session->engine == NULL)
+						header.session = 0;
+					addReply(&session->replies, &header, result, 0);
+					continue;
+				}
+				break;
+
+			case SERVER_STEP:
+				if(header.length != sizeof(noOfGenerations))
+				{
+					addReply(&session->replies, &header, SERVER_BAD_REQUEST, 0);
+					continue;
+				}
+				memcpy(&noOfGenerations, payload, sizeof(noOfGenerations));
+				if(noOfGenerations < 0)
+				{
+					addReply(&session->replies, &header, SERVER_BAD_REQUEST, 0);
+					continue;
+				}
+				stepSession(session, noOfGenerations);
+				break;
+
+			case SERVER_QUERY:
+				if(header.length != sizeof(region))
+				{
+					addReply(&session->replies, &header, SERVER_BAD_REQUEST, 0);
+					continue;
+				}
+				memcpy(region, payload, sizeof(region));
+				withAges = (header.flags & SERVER_WITH_AGES) != 0;
+				if( (region[2] < 0) || (region[3] < 0)
+				    || ( ( (region[3] + 7.0) / 8 + withAges * (double)region[3] ) * region[2] > MAX_SERVER_MESSAGE - sizeof(serverStatus) ) )
+				{
+					addReply(&session->replies, &header, SERVER_BAD_REQUEST, 0);
+					continue;
+				}
+				regionBytes = ( ( (size_t)region[3] + 7 ) / 8 + withAges * (size_t)region[3] ) * region[2];
+				describeSession(session, &status);
+				reply = addReply(&session->replies, &header, SERVER_OK, sizeof(serverStatus) + regionBytes);
+				memcpy(reply, &status, sizeof(serverStatus));
+				copyRegion(session->engine->type->view(session->engine), region[0], region[1], region[2], region[3], withAges, reply + sizeof(serverStatus));
+				continue;
+
+			case SERVER_STATUS:
+				if(header.length != 0)
+				{
+					addReply(&session->replies, &header, SERVER_BAD_REQUEST, 0);
+					continue;
+				}
+				break;
+
+			case SERVER_CLOSE:
+				if(header.length != 0)
+				{
+					addReply(&session->replies, &header, SERVER_BAD_REQUEST, 0);
+					continue;
+				}
+				freeSessionBoard(session);
+				session->closed = 1;
+				addReply(&session->replies, &header, SERVER_OK, 0);
+				continue;
+
+			case SERVER_FORK:
+				if( (fork == NULL) || (forkSession(server, session, fork) != SERVER_OK) )
+				{
+					addReply(&session->replies, &header, SERVER_BAD_REQUEST, 0);
+					continue;
+				}
+				header.session = fork->id;
+				describeSession(fork, &status);
+				memcpy(addReply(&session->replies, &header, SERVER_OK, sizeof(serverStatus)), &status, sizeof(serverStatus));
+				continue;
+
+			default:
+				addReply(&session->replies, &header, SERVER_BAD_REQUEST, 0);
+				continue;
+		}
+
+		/* The requests that break out of the switch are answered with the session's status */
+		describeSession(session, &status);
+		memcpy(addReply(&session->replies, &header, SERVER_OK, sizeof(serverStatus)), &status, sizeof(serverStatus));
+	}
+	session->batch.length = 0;
+	return;
+}
+
+/*
+	Function: loadSession()
+	Purpose: Replace a session's board with the one in a load request, in a new engine.
+	Arguments: The server (server), the session (session), and the request's payload (payload) and its length in bytes (length).
+	Return value: SERVER_OK if the board was loaded,
+	              SERVER_BAD_REQUEST if the request is malformed, a cell is outside the board, or the board is too big or would need too much memory,
+	              in which case the session is left as it was.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+int loadSession(const lifeServer *server, serverSession *session, const unsigned char *payload, uint32_t length)
+{
+	engineOptions options = server->options;
+	int32_t sizes[4], cell[2];
+	cellList cells;
+	long i;
 
-	for(i = 0, boards[MAX_PERIOD_TO_DETECT][0][0] = '\0'; i <= noOfGenerations; i++)
-	{
-		/* Print the current board to stdout. */
-		printBoard(currentBoard);
+	if( (length < sizeof(sizes)) || ( (length - sizeof(sizes)) % sizeof(cell) != 0 ) )
+		return SERVER_BAD_REQUEST;
+	memcpy(sizes, payload, sizeof(sizes));
+	options.historyDepth = sizes[2];
+	options.initialPopulation = (length - sizeof(sizes)) / sizeof(cell);
+	if( (sizes[0] < 1) || (sizes[1] < 1) || (sizes[2] < 0) || (sizes[0] > MAX_SERVER_BOARD_SIDE) || (sizes[1] > MAX_SERVER_BOARD_SIDE) )
+		return SERVER_BAD_REQUEST;
 
-		/* We (naively) set boardToCompareCounter to be two behind the next board (one behind the current board) */
-		boardToCompareCounter = nextBoardPosition - 2;
-		/* if this naive formula results in the array index being less than zero, move it to the correct position at the end of the array */
-		if(boardToCompareCounter < 0)
-			boardToCompareCounter = MAX_PERIOD_TO_DETECT + (boardToCompareCounter + 1);
+	/* The engine, and the history if the engine doesn't keep its own, must fit in the memory a session is allowed */
+	double memoryNeeded = server->type->memoryNeeded(sizes[0], sizes[1], &options);
+	if(server->type->findPeriod == NULL)
+		memoryNeeded += (sizes[2] + 1.0) * ( (double)sizes[1] * ( ( (long)sizes[0] + 63 ) / 64 ) * sizeof(uint64_t) + sizeof(long) + sizeof(uint64_t) );
+	if(memoryNeeded > MAX_SERVER_SESSION_MEMORY)
+		return SERVER_BAD_REQUEST;
 
-		/* Test all the relevant boards to see if any of them are identical to the current board */
-		for(j =1; (j <= MAX_PERIOD_TO_DETECT) && (boards[boardToCompareCounter][0][0] != '\0'); j++)
+	cells.noOfCells = (length - sizeof(sizes)) / sizeof(cell);
+	cells.cells = (coord *)allocateMemory(cells.noOfCells * sizeof(coord));
+	cells.ages = NULL;
+	for(i = 0; i < cells.noOfCells; i++)
+	{
+		memcpy(cell, payload + sizeof(sizes) + i * sizeof(cell), sizeof(cell));
+		if( (cell[0] < 0) || (cell[1] < 0) || (cell[0] >= sizes[1]) || (cell[1] >= sizes[0]) )
 		{
-			if(repetitionTest(currentBoard, boards[boardToCompareCounter]))
-			{
-				printf("Period detected (%d): exiting\n", j);
-				free(boards);
-				exit(EXIT_SUCCESS);
-			}
-			boardToCompareCounter == 0? boardToCompareCounter = MAX_PERIOD_TO_DETECT : boardToCompareCounter--;
+			freeCells(&cells);
+			return SERVER_BAD_REQUEST;
 		}
+		cells.cells[i].row = cell[0];
+		cells.cells[i].column = cell[1];
+	}
 
-		/*Iterate currentBoard, saving the results in nextBoard.
-		  It is not necessary to initialise nextBoard to be the same as currentBoard because iterateBoard() writes to every used cell. */
-		iterateBoard(currentBoard, nextBoard);
+	freeSessionBoard(session);
+	session->engine = server->type->create(sizes[0], sizes[1], &options);
+	session->engine->type->load(session->engine, &cells);
+	freeCells(&cells);
 
-		/* Set the pointer such that the current board is the board that has just had the iterations saved in it */
-		currentBoard = nextBoard;
-		if(nextBoardPosition == MAX_PERIOD_TO_DETECT)
-			nextBoardPosition = 0;
-		else
-			nextBoardPosition += 1;
-		nextBoard = boards[nextBoardPosition];		
+	session->historyDepth = sizes[2];
+	session->generation = 0;
+	session->measuredGeneration = -1;
+	if( (server->type->findPeriod == NULL) && (session->historyDepth > 0) )
+	{
+		session->liveWords = (size_t)sizes[1] * ( (sizes[0] + 63) / 64 );
+		session->history = (uint64_t *)allocateMemory( (session->historyDepth + 1) * session->liveWords * sizeof(uint64_t) );
+		session->populations = (long *)allocateMemory( (session->historyDepth + 1) * sizeof(long) );
+		session->hashes = (uint64_t *)allocateMemory( (session->historyDepth + 1) * sizeof(uint64_t) );
 	}
-		
+	testSessionPeriod(session);
+	return SERVER_OK;
+}
 
-	/* After the for loop, we are finished */
-	puts("Finished");
-	free(boards);
-	return EXIT_SUCCESS;
+/*
+	Function: stepSession()
+	Purpose: Calculate generations of a session's board, testing each one for repetition.
+	Arguments: The session (session), and the number of generations to calculate (noOfGenerations).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+	Note: Unlike main(), a session carries on calculating once a period is detected, so the board is always at the generation asked for.
+ */
+void stepSession(serverSession *session, int64_t noOfGenerations)
+{
+	for(; noOfGenerations > 0; noOfGenerations--)
+	{
+		session->engine->type->step(session->engine);
+		session->generation++;
+		testSessionPeriod(session);
+	}
+	return;
 }
 
 /*
-	Function: readFileToCurrentBoard()
-	Purpose: Read the initial board configuration from a file, and save the live cells in the correct place on a board.
-	Arguments: The filename of the configuration file (fileName)
-	           A pointer to the board array to write the live cells to (boardToWrite)
-	Return value: 1 upon successful reading.
-	              0 upon unsuccessful reading
+	Function: testSessionPeriod()
+	Purpose: Test a session's current board for repetition, with the engine's findPeriod() if it has one,
+	         or otherwise by comparing it with the earlier generations in the session's history, and adding it to the history.
+	Arguments: The session (session).
+	Return value: None, the period found (or 0) is left in session->period.
 	Inputs from user: None.
-	Outputs to user: Error messages if there if there is a problem with the file.
-	Note: As per the specification, this function does no error checking on the format of the input file,
-	      other than ensuring the input file exists and ensuring the co-ordinates are within the defined board.
-	      So please ensure that any input files are carefully formatted.
+	Outputs to user: None.
  */
-int readFileToBoard(const char* fileName, char (*boardToWrite)[boardWidth])
+void testSessionPeriod(serverSession *session)
 {
-	/* Attempt to open the file */
-	FILE *inputFilePointer;
-	inputFilePointer = fopen(fileName, "r");
+	lifeEngine *engine = session->engine;
+	const boardPlanes *board;
+	long slot, earlier;
+	int j;
 
-	/* If the inputFilePointer is NULL, the opening must have failed */
-	if(inputFilePointer == NULL)
+	session->period = 0;
+	if(engine->type->findPeriod != NULL)
 	{
-		fputs("Error opening board configuration file.\n"
-					"Please ensure that the file exists.\n", stderr);
-		return 0;
+		session->period = engine->type->findPeriod(engine);
+		return;
 	}
+	if(session->historyDepth == 0)
+		return;
 
-	/* The first integer in the file is the number of coordinates that that file contains. */
-	int noOfCoordsToRead;
-	fscanf(inputFilePointer, "%d", &noOfCoordsToRead);
+	board = engine->type->view(engine);
+	measureLivePlane(board, &session->population, &session->hash);
+	session->measuredGeneration = session->generation;
 
-	/* Now loop through the file until we've read the specifed no. of co-ordinates,
-	   read the each co-ordinate from the file,
-	   and save it in the appropriate place on the board. */
-	coord currentPoint;
-	for(; noOfCoordsToRead > 0; noOfCoordsToRead--)
-	{
-		/* Read the co-ordinates from the file */
-		fscanf(inputFilePointer, "%d%d", &currentPoint.row, &currentPoint.column);
+	slot = session->generation % (session->historyDepth + 1);
+	memcpy(session->history + slot * session->liveWords, board->live, session->liveWords * sizeof(uint64_t));
+	session->populations[slot] = session->population;
+	session->hashes[slot] = session->hash;
 
-		/* Ensure that the co-ordiates are within the defined range. Return 0 (the error return) if they're not */
-		if( (currentPoint.row >= boardHeight) || (currentPoint.column >= boardWidth) )
+	for(j = 1; (j <= session->historyDepth) && (j <= session->generation); j++)
+	{
+		earlier = (session->generation - j) % (session->historyDepth + 1);
+		if( (session->populations[earlier] == session->population) && (session->hashes[earlier] == session->hash)
+		    && (memcmp(session->history + earlier * session->liveWords, board->live, session->liveWords * sizeof(uint64_t)) == 0) )
 		{
-			fputs("Co-ordinate outside board dimensions.\n", stderr);
-			return 0;
+			session->period = j;
+			return;
 		}
-
-		/* If the defined co-ordinates are correct, define each one as a live cell of age 0. */
-		boardToWrite[currentPoint.row][currentPoint.column] = '0';
 	}
-
-	/* Close the input file and return the "success" return. */
-	fclose(inputFilePointer);
-	return 1;
+	return;
 }
 
 /*
-	Function: printBoard()
-	Purpose: Print the current iteration of the board to stdout.
-	Arguments: None.
+	Function: describeSession()
+	Purpose: Fill in the status of a session's current board, working out its population and hash if they aren't known yet.
+	Arguments: The session (session), and the status to fill in (status).
 	Return value: None.
 	Inputs from user: None.
-	Outputs to user: The board that is printed.
+	Outputs to user: None.
  */
-void printBoard(char (*boardToRead)[boardWidth])
+void describeSession(serverSession *session, serverStatus *status)
 {
-	/* Call printBorderRow(), to print the top border of the grid. */
-	printBorderRow();
-
-	/* Loop through and print out each row in turn. */
-	int i;
-	for(i=0; i < boardHeight; i++)
-		/* Each row is stored as an array of characters, so can be printed out as a strign with defined length boardWidth.
-		   Pipes are put on the beginning and end of the string to create the border.*/
-		printf("|%.*s|\n", boardWidth, boardToRead[i]);
-
-	/* Call printBorderRow() again, to print the bottom border */
-	printBorderRow();
-
-	/* Put two blank lines after the board is printed, as specified. */
-	for(i=1; i<=2; i++)
-	putchar('\n');
-
+	if(session->measuredGeneration != session->generation)
+	{
+		measureLivePlane(session->engine->type->view(session->engine), &session->population, &session->hash);
+		session->measuredGeneration = session->generation;
+	}
+	status->generation = session->generation;
+	status->population = session->population;
+	status->hash = session->hash;
+	status->period = session->period;
+	status->reserved = 0;
 	return;
 }
 
 /*
-	Function: printBorderRow()
-	Purpose: Print a "border row" (the border that appears at the top or bottom of each printed board) to stdout.
-	Arguments: None.
-	Return value: None.
+	Function: forkSession()
+	Purpose: Give a session started by a fork the board of the session it is forked from, at its current generation, with its history.
+	Arguments: The server (server), the session forked from (session), and the new session (fork).
+	Return value: SERVER_OK if the board was forked,
+	              SERVER_BAD_REQUEST if the engine keeps its own history but has no fork(), so the board can't be copied.
 	Inputs from user: None.
-	Outputs to user: The border row that is printed to stdout.
+	Outputs to user: None.
+	Note: Without fork(), the board is copied to a new engine, with its ages, and the session's own history is copied with it.
  */
-void printBorderRow(void)
+int forkSession(const lifeServer *server, serverSession *session, serverSession *fork)
 {
-	/*Put a '*' to the the left corner of the border */
-	putchar('*');
+	lifeEngine *engine = session->engine;
+	const boardPlanes *board;
+	engineOptions options;
+	cellList cells;
 
-	/* Now we need as many '-'s as there are columns in the board */
-	int i;
-	for(i=0; i < boardWidth; i++)
-		putchar('-');
+	if(engine->type->fork != NULL)
+		fork->engine = engine->type->fork(engine);
+	else if(engine->type->findPeriod != NULL)
+		return SERVER_BAD_REQUEST;
+	else
+	{
+		options = server->options;
+		options.historyDepth = session->historyDepth;
+		board = engine->type->view(engine);
+		fork->engine = engine->type->create(board->width, board->height, &options);
+		planesToCells(board, &cells);
+		fork->engine->type->load(fork->engine, &cells);
+		freeCells(&cells);
+	}
 
-	/* Now we need a * for the top right hand corner */
-	putchar('*');
+	fork->generation = session->generation;
+	fork->period = session->period;
+	fork->historyDepth = session->historyDepth;
+	fork->measuredGeneration = session->measuredGeneration;
+	fork->population = session->population;
+	fork->hash = session->hash;
+	fork->liveWords = session->liveWords;
+	if(session->history != NULL)
+	{
+		fork->history = (uint64_t *)allocateMemory( (session->historyDepth + 1) * session->liveWords * sizeof(uint64_t) );
+		fork->populations = (long *)allocateMemory( (session->historyDepth + 1) * sizeof(long) );
+		fork->hashes = (uint64_t *)allocateMemory( (session->historyDepth + 1) * sizeof(uint64_t) );
+		memcpy(fork->history, session->history, (session->historyDepth + 1) * session->liveWords * sizeof(uint64_t));
+		memcpy(fork->populations, session->populations, (session->historyDepth + 1) * sizeof(long));
+		memcpy(fork->hashes, session->hashes, (session->historyDepth + 1) * sizeof(uint64_t));
+	}
+	return SERVER_OK;
+}
 
-	/* Then finally a new line character so that the next output goes to a blank line. */
-	putchar('\n');
+/*
+	Function: measureLivePlane()
+	Purpose: Count the live cells of a board, and work out its hash as the shared memory export does.
+	Arguments: The board (board), and where to write the population (population) and hash (hash).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+void measureLivePlane(const boardPlanes *board, long *population, uint64_t *hash)
+{
+	size_t liveWords = (size_t)board->height * board->liveWordsPerRow, i;
+	long count = 0;
+	uint64_t sum = 0;
 
+	for(i = 0; i < liveWords; i++)
+	{
+		if(board->live[i] != 0)
+		{
+			count += countBits(board->live[i]);
+			sum += mixBits(board->live[i] ^ mixBits(i));
+		}
+	}
+	*population = count;
+	*hash = sum;
 	return;
 }
 
 /*
-	Function: iterateBoard()
-	Purpose: Perform the logical operations on each and every cell in a board, to see if it will live or die in the next state.
-	         Then write these changes to a different board.
-	Arguments: The board to read the current state from (boardToRead), and the board to write the next state to (boardToWrite).
+	Function: copyRegion()
+	Purpose: Copy the cells of a region of a board into the payload of a query's reply, in the layout described with runServer().
+	Arguments: The board (board), the top row, left column, height and width of the region (top, left, height and width),
+	           whether the ages are copied as well (withAges), and the bytes to copy them to (bytes).
 	Return value: None.
 	Inputs from user: None.
 	Outputs to user: None.
  */
-void iterateBoard(char (*boardToRead)[boardWidth], char (*boardToWrite)[boardWidth])
+void copyRegion(const boardPlanes *board, int32_t top, int32_t left, int32_t height, int32_t width, int withAges, unsigned char *bytes)
 {
+	size_t rowBytes = ( (size_t)width + 7 ) / 8;
+	unsigned char *ages = bytes + rowBytes * height;
+	const uint64_t *live;
+	long r, c, row, column;
+	uint64_t bits;
+	size_t b;
 
-	/* Since we will be looping through each cell of the board, we will use a coord structure as our loop counter */
-	coord counter;
-
-	/* Outside loop loops through the rows */
-	for(counter.row = 0; counter.row < boardHeight; counter.row++)
-		/* Inside loop loops through the columns */
-		for(counter.column = 0; counter.column < boardWidth; counter.column++)
-			/* numberOfNeighbours() returns the number of live neighbours that a cell has.
-			   We can use this with a switch to create different outcomes each possible number of neighbours */
-			switch( numberOfNeighbours(boardToRead, counter) )
-			{
-				/* 0, 1 or 4+ (i.e default: ) neighbours means the cell will need to be dead */
-				case 0: case 1: default:
-					boardToWrite[counter.row][counter.column] = ' ';
-					break;
-
-				/* 2 neighbours means that the cell continues in its current state. */
-				case 2:
-					/* We can use a nested switch to handle the different cases that arise due to this */
-					switch(boardToRead[counter.row][counter.column])
-					{
-						/* If it's dead(' '), it remains dead (' '). */
-						case ' ':
-							boardToWrite[counter.row][counter.column] = ' ';
-							break;
-
-					 	/* If it's alive and has an age of 9 ('9') or more ('X'), it will be made an 'X' */
-						case'9': case'X':
-							boardToWrite[counter.row][counter.column] = 'X';
-							break;
-
-						/* All the other cases mean that the cell is alive and has an age of less than 9.
-						   This means that we should increment the digit.
-						   To do ths, we can add 1 to the ASCII code,
-						   since the ANSI standard guarentees that the digits 0-9 are be properly odered in the ASCII table. */
-						default:
-							boardToWrite[counter.row][counter.column] = boardToRead[counter.row][counter.column] + 1;
-							break;
-					}
-					break;
-
-				/* 3 neighbours means the cell will be alive */
-				case 3:
-					/* As with case 2, we can use a nested switch to take care of the eventualities */
-					switch(boardToRead[counter.row][counter.column])
-					{
-						/* If it's currently dead, make it a live cell with an age of 0 */
-						case ' ':
-							boardToWrite[counter.row][counter.column] = '0';
-						break;
+	memset(bytes, 0, rowBytes * height + (withAges ? (size_t)height * width : 0));
+	for(r = 0; r < height; r++)
+	{
+		row = (long)top + r;
+		if( (row < 0) || (row >= board->height) )
+			continue;
 
-					 	/* If it's alive and has an age of 9 ('9') or more ('X'), it will be made an 'X' */
-						case'9': case'X':
-							boardToWrite[counter.row][counter.column] = 'X';
-							break;
+		/* 64 cells at a time, from wherever they start in the live plane */
+		live = board->live + row * board->liveWordsPerRow;
+		for(c = 0; c < width; c += 64)
+		{
+			bits = liveBitsFrom(live, board->liveWordsPerRow, (long)left + c);
+			if(width - c < 64)
+				bits &= ( (uint64_t)1 << (width - c) ) - 1;
+			for(b = 0; (b < 8) && (c / 8 + b < rowBytes); b++)
+				bytes[r * rowBytes + c / 8 + b] = (unsigned char)(bits >> (8 * b));
+		}
 
-						/* All the other cases mean that the cell is alive and has an age of less than 9.
-						   This means that we should increment the digit.
-						   To do ths, we can add 1 to the ASCII code,
-						   since the ANSI standard guarentees that the digits 0-9 are be properly odered in the ASCII table. */
-						default:
-							boardToWrite[counter.row][counter.column] = boardToRead[counter.row][counter.column] + 1;
-							break;
-					}
-					break;
+		if(withAges)
+			for(c = 0; c < width; c++)
+			{
+				column = (long)left + c;
+				if( (column >= 0) && (column < board->width) )
+					ages[(size_t)r * width + c] = (board->ages[row * board->ageWordsPerRow + column / 16] >> (4 * (column % 16))) & 0xF;
 			}
-
+	}
+	return;
 }
 
 /*
-	Function: numberOfNeighbours()
-	Purpose: Calculate the number of live neighbours that a cell has, and return this number
-	Arguments: The board containing the cell whose neighbours need checking (board), and the co-ordinates of the cell the check (current).
-	Return value: An integer contianing the number of live neighbours that a cell has
+	Function: liveBitsFrom()
+	Purpose: Get the 64 cells of a row of a live plane that start at a column, which may be outside the row.
+	Arguments: The row (row), its length in words (words), and the first column (column).
+	Return value: The cells, bit n being the cell n columns after the first, with the cells outside the row dead.
 	Inputs from user: None.
 	Outputs to user: None.
  */
-int numberOfNeighbours(char (*board)[boardWidth], coord current)
+uint64_t liveBitsFrom(const uint64_t *row, int words, long column)
 {
-	/* Return variable */
-	int neighbours = 0;
-
-	/* Starting from the far top left, check all the cells in a clockwise order, to see if a neighbour cell is alive */
-
-	/*Top left */
-	if( (current.row > 0) && (current.column > 0) )
-		if (board[current.row -1][current.column -1] != ' ')
-			neighbours++;
-
-	/*Top middle */
-	if(current.row > 0)
-		if (board[current.row -1][current.column] != ' ')
-			neighbours++;
-
-	/*Top right */
-	if( (current.row > 0) && (current.column < (boardWidth -1)) )
-		if (board[current.row -1][current.column +1] != ' ')
-			neighbours++;
-
-	/* Centre right */
-	if(current.column < (boardWidth -1) )
-		if (board[current.row][current.column +1] != ' ')
-			neighbours++;
-
-	/* Bottom right */
-	if( (current.column < (boardWidth -1)) && (current.row < (boardHeight -1)) )
-		if (board[current.row + 1][current.column +1] != ' ')
-			neighbours++;
-
-	/* Bottom middle */
-	if(current.row < (boardHeight -1))
-		if (board[current.row +1][current.column] != ' ')
-			neighbours++;
+	/* The word holding the first cell, rounded down for columns left of the row */
+	long word = (column >= 0) ? column / 64 : -( (63 - column) / 64 );
+	int shift = (int)(column - word * 64);
+	uint64_t low = ( (word >= 0) && (word < words) ) ? row[word] : 0;
+	uint64_t high = ( (word + 1 >= 0) && (word + 1 < words) ) ? row[word + 1] : 0;
 
-	/* Bottom left */
-	if( (current.column > 0) && (current.row < (boardHeight -1)) )
-		if (board[current.row +1][current.column -1] != ' ')
-			neighbours++;
+	return (shift == 0) ? low : (low >> shift) | (high << (64 - shift));
+}
 
-	/* Centre left */
-	if(current.column > 0)
-		if (board[current.row][current.column -1] != ' ')
-			neighbours++;
+/*
+	Function: addReply()
+	Purpose: Add a reply to a request to a buffer of replies, leaving room for its payload.
+	Arguments: The buffer (buffer), the request's header (request), the status of the reply (status), and the length of its payload (length).
+	Return value: A pointer to where the payload is to be written.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+unsigned char *addReply(byteBuffer *buffer, const serverHeader *request, uint16_t status, size_t length)
+{
+	serverHeader header = *request;
 
-	/* Returnt the number of neighbours that there are. */
-	return neighbours;
+	header.length = (uint32_t)length;
+	header.flags = status;
+	reserveBytes(buffer, sizeof(serverHeader) + length);
+	memcpy(buffer->bytes + buffer->length, &header, sizeof(serverHeader));
+	buffer->length += sizeof(serverHeader) + length;
+	return buffer->bytes + buffer->length - length;
 }
 
 /*
-	Function: repetitionTest()
-	Purpose: Test to see if two boards contain identical live cells
-	Arguments: Two pointers to the boards to compare (board1 and board2)
-	Return value: 0 if the boards contain different live cells.
-	              1 if the boards contain identical live cells.
+	Function: appendBytes()
+	Purpose: Add bytes to the end of a buffer.
+	Arguments: The buffer (buffer), and the bytes (bytes) and their number (length).
+	Return value: None.
 	Inputs from user: None.
 	Outputs to user: None.
  */
-int repetitionTest(char (*board1)[boardWidth], char (*board2)[boardWidth])
+void appendBytes(byteBuffer *buffer, const void *bytes, size_t length)
 {
-	/* Since we will be looping through each cell of the board, we will use a coord structure as our loop counter */
-	coord counter;
+	if(length == 0)
+		return;
+	reserveBytes(buffer, length);
+	memcpy(buffer->bytes + buffer->length, bytes, length);
+	buffer->length += length;
+	return;
+}
 
-	/* Outside loop loops through the rows */
-	for(counter.row = 0; counter.row < boardHeight; counter.row++)
-		/* Inside loop loops through the columns */
-		for(counter.column = 0; counter.column < boardWidth; counter.column++)
-			/* This is an exclusive or test, the if will evaluate true if one but not both of the cells contains a space */
-			if( (board1[counter.row][counter.column] != ' ') != (board2[counter.row][counter.column] != ' ') )
-				return 0;
+/*
+	Function: reserveBytes()
+	Purpose: Make room for a number of bytes after the ones in use in a buffer, doubling its size as often as needed.
+	Arguments: The buffer (buffer), and the number of bytes (length).
+	Return value: None.
+	Inputs from user: None.
+	Outputs to user: None.
+ */
+void reserveBytes(byteBuffer *buffer, size_t length)
+{
+	size_t capacity = (buffer->capacity == 0) ? 4096 : buffer->capacity;
 
-	return 1;
+	if(buffer->length + length <= buffer->capacity)
+		return;
+	while(capacity < buffer->length + length)
+		capacity *= 2;
+	buffer->bytes = (unsigned char *)resizeMemory(buffer->bytes, buffer->capacity, capacity);
+	buffer->capacity = capacity;
+	return;
 }
-
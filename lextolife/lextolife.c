@@ -23,6 +23,9 @@
 #define LIVE_CELL_CHARACTER 'O'
 #define DEAD_CELL_CHARACTER '.'
 
+/* The number of co-ordinates allocated at once, so that the list doesn't need an allocation for every live cell. */
+#define COORDS_PER_BLOCK 1024
+
 /* Structure to hold the co-ordinates of a point in a linked list*/
 typedef struct coord
 {
@@ -151,6 +154,11 @@ int readCellsFromInput(FILE* fp, int blankColumns, int blankRows)
 	extern coord *head;
 	coord *last;
 
+	/* The elements of the list are taken in turn from a block of COORDS_PER_BLOCK,
+	   and a new block is allocated when the current one is used up. */
+	coord *block = NULL;
+	int usedInBlock = COORDS_PER_BLOCK;
+
 	int character;
 	int numberLiveCells = 0;
 	
@@ -166,26 +174,26 @@ int readCellsFromInput(FILE* fp, int blankColumns, int blankRows)
 
 			if(character == LIVE_CELL_CHARACTER)
 			{
-				/*If head is null, store this coordinate in the head.
-				  If the head is not null, put it on the end (using the last pointer) */
-				if(head == NULL)
+				if(usedInBlock == COORDS_PER_BLOCK)
 				{
-					head = (coord *)malloc(sizeof(coord));
-					if(head == NULL)
+					block = (coord *)malloc(COORDS_PER_BLOCK * sizeof(coord));
+					if(block == NULL)
 					{
 						fputs("Memory allocation error.\n"
 						      "The program will now exit.\n", stderr);
 						exit(EXIT_FAILURE);
 					}
+					usedInBlock = 0;
+				}
+
+				/*If head is null, store this coordinate in the head.
+				  If the head is not null, put it on the end (using the last pointer) */
+				if(head == NULL)
+				{
+					head = &block[usedInBlock++];
 					last = head;
 				} else {
-					last->next = (coord *)malloc(sizeof(coord));
-					if(last->next == NULL)
-					{
-						fputs("Memory allocation error.\n"
-						      "The program will now exit.\n", stderr);
-						exit(EXIT_FAILURE);
-					}
+					last->next = &block[usedInBlock++];
 					last = last->next;
 				}
 			/* Set the newly allocated memory equal to the current coordinates */
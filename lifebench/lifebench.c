@@ -0,0 +1,668 @@
+/*
+	lifebench.c v1.0
+	Program to measure how fast the engines of TYLERJ-life3 calculate real patterns, using every pattern in the lexicon as the workload.
+
+	Usage: ./lifebench <TYLERJ-life3> [--lexicon <file>] [--states <directory>] [--engines <name,name,...>] [--match <text>]
+	                   [--size <width> <height>] [--generations <n>] [--threads <n>] [--repeats <n>] [--flag <factor>] [--csv <file>]
+
+	<TYLERJ-life3> is the program to measure.
+	--lexicon <file> is the lexicon to take the patterns from (default lextolife/lexicon/lexicon.htm).
+	--states <directory> is a directory of boards already in TYLERJ-life3's format to add to them (default lextolife/processedstates).
+	--engines <names> measures only the engines named, separated by commas (by default every engine, and the adaptive controller as "adaptive").
+	--match <text> measures only the patterns whose names contain text.
+	--size <width> <height> is the size of the board each pattern is placed in the middle of (default 256 256).
+	--generations <n> is the number of generations each pattern is run for (default 200).
+	--threads <n> is passed on to TYLERJ-life3 (default 1).
+	--repeats <n> runs each pattern n times on each engine and keeps the fastest (default 1).
+	--flag <factor> reports the patterns that an engine calculates more than factor times slower than its median pattern (default 4).
+	--csv <file> also writes every result to file, one line for each pattern on each engine, to compare runs with.
+
+	Each pattern is run with --quiet and --history 0, so that every generation is calculated and nothing is printed,
+	and again for no generations, to measure how long TYLERJ-life3 takes to start and load the board. The difference is the time
+	taken to calculate the generations, which gives the number of cells updated per second (width x height x generations / time).
+	The rate of every engine on each pattern is printed as it is measured, in millions of cells per second, followed by the rate
+	of each engine over the whole corpus (the total cells updated over the total time, so the slow patterns count as much as they cost),
+	its median rate, and the patterns it is pathologically slow on.
+*/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+/* The most engines that can be measured, including the adaptive controller */
+#define MAX_ENGINES 32
+
+/* The longest pattern name that is kept, and the width it is printed in */
+#define MAX_NAME_LENGTH 64
+#define NAME_COLUMN_WIDTH 24
+
+/* The characters that represent live and dead cells in the lexicon, as for lextolife */
+#define LIVE_CELL_CHARACTER 'O'
+#define DEAD_CELL_CHARACTER '.'
+
+/* The result of a run that failed, and the shortest time a calculation is counted as. Starting TYLERJ-life3 varies by about this much,
+   so a calculation that takes less (e.g. of a pattern that dies out on the sparse engine) is too fast to measure, and is printed with a '+'. */
+#define RUN_FAILED -1.0
+#define MIN_CALCULATION_TIME 1e-3
+
+/* Structure to hold co-ordinates of a point */
+typedef struct
+{
+	int row;
+	int column;
+} coord;
+
+/* Structure to hold a pattern from the corpus: its name, the size of its bounding box, and its live cells */
+typedef struct
+{
+	char name[MAX_NAME_LENGTH];
+	int width, height;
+	long noOfCells;
+	coord *cells;
+} pattern;
+
+/* The program being measured, the directory the boards are written to, and the engines measured (NULL for the adaptive controller) */
+const char *lifeProgram;
+char workDirectory[] = "/tmp/lifebench-XXXXXX";
+char *engines[MAX_ENGINES];
+int noOfEngines = 0;
+
+/* The corpus */
+pattern *patterns = NULL;
+int noOfPatterns = 0, patternsAllocated = 0;
+
+/* Function prototypes */
+void *allocateMemory(size_t size);
+void findEngines(const char *selection);
+void readLexicon(const char *fileName, const char *match);
+void readStates(const char *directoryName, const char *match);
+pattern *addPattern(const char *name, const char *match);
+void addCell(pattern *shape, int row, int column);
+void decodeName(const char *text, size_t length, char *name);
+void writeBoardFile(const pattern *shape, int width, int height, const char *fileName);
+double runLife(const char *engine, int noOfThreads, int width, int height, int noOfGenerations, int repeats);
+double medianRate(double *rates, int noOfRates);
+int compareRates(const void *rate1, const void *rate2);
+
+int main(int argc, char* argv[])
+{
+	const char *lexiconName = "lextolife/lexicon/lexicon.htm", *statesName = "lextolife/processedstates";
+	const char *selection = NULL, *match = NULL, *csvName = NULL;
+	int width = 256, height = 256, noOfGenerations = 200, noOfThreads = 1, repeats = 1;
+	double flagFactor = 4;
+	int i, j;
+
+	for(i = 2; i < argc; i++)
+	{
+		if( (strcmp(argv[i], "--lexicon") == 0) && (i + 1 < argc) )
+			lexiconName = argv[++i];
+		else if( (strcmp(argv[i], "--states") == 0) && (i + 1 < argc) )
+			statesName = argv[++i];
+		else if( (strcmp(argv[i], "--engines") == 0) && (i + 1 < argc) )
+			selection = argv[++i];
+		else if( (strcmp(argv[i], "--match") == 0) && (i + 1 < argc) )
+			match = argv[++i];
+		else if( (strcmp(argv[i], "--size") == 0) && (i + 2 < argc) )
+		{
+			width = atoi(argv[++i]);
+			height = atoi(argv[++i]);
+		}
+		else if( (strcmp(argv[i], "--generations") == 0) && (i + 1 < argc) )
+			noOfGenerations = atoi(argv[++i]);
+		else if( (strcmp(argv[i], "--threads") == 0) && (i + 1 < argc) )
+			noOfThreads = atoi(argv[++i]);
+		else if( (strcmp(argv[i], "--repeats") == 0) && (i + 1 < argc) )
+			repeats = atoi(argv[++i]);
+		else if( (strcmp(argv[i], "--flag") == 0) && (i + 1 < argc) )
+			flagFactor = atof(argv[++i]);
+		else if( (strcmp(argv[i], "--csv") == 0) && (i + 1 < argc) )
+			csvName = argv[++i];
+		else
+			break;
+	}
+
+	/* Check the arguments */
+	if( (argc < 2) || (i < argc) || (width < 1) || (height < 1) || (noOfGenerations < 1) || (noOfThreads < 1) || (repeats < 1) || (flagFactor <= 1) )
+	{
+		fprintf(stderr, "Invalid arguments.\n"
+		                "Usage: %s <TYLERJ-life3> [--lexicon <file>] [--states <directory>] [--engines <name,name,...>] [--match <text>]\n"
+		                "       [--size <width> <height>] [--generations <n>] [--threads <n>] [--repeats <n>] [--flag <factor>] [--csv <file>]\n"
+		                "The program will now exit.\n", argv[0]);
+		exit(EXIT_FAILURE);
+	}
+	lifeProgram = argv[1];
+
+	findEngines(selection);
+	readLexicon(lexiconName, match);
+	readStates(statesName, match);
+	if(noOfPatterns == 0)
+	{
+		fputs("There are no patterns to measure.\n"
+		      "The program will now exit.\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+
+	FILE *csv = NULL;
+	if(csvName != NULL)
+	{
+		csv = fopen(csvName, "w");
+		if(csv == NULL)
+		{
+			fprintf(stderr, "Error opening CSV file (%s) for writing.\n"
+			                "The program will now exit.\n", csvName);
+			exit(EXIT_FAILURE);
+		}
+		fputs("pattern,cells,engine,width,height,generations,seconds,cells per second\n", csv);
+	}
+
+	if(mkdtemp(workDirectory) == NULL)
+	{
+		fputs("Error creating a directory for the boards.\n"
+		      "The program will now exit.\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+
+	printf("Measuring %s on %d patterns, on %d x %d boards for %d generations, in millions of cells per second\n",
+	       lifeProgram, noOfPatterns, width, height, noOfGenerations);
+	printf("%-*s %6s", NAME_COLUMN_WIDTH, "pattern", "cells");
+	for(j = 0; j < noOfEngines; j++)
+		printf(" %11.11s", (engines[j] != NULL) ? engines[j] : "adaptive");
+	puts("");
+	fflush(stdout);
+
+	/* The rate of every engine on every pattern, which is RUN_FAILED for a run that failed and 0 for a pattern that doesn't fit */
+	double *rates = (double *)allocateMemory( (size_t)noOfPatterns * noOfEngines * sizeof(double) );
+	double *totalSeconds = (double *)allocateMemory(noOfEngines * sizeof(double));
+	double *totalUpdates = (double *)allocateMemory(noOfEngines * sizeof(double));
+	double updates = (double)width * height * noOfGenerations, seconds, startSeconds;
+	char boardName[64];
+	int noOfSkipped = 0, noOfFailed = 0;
+
+	snprintf(boardName, sizeof(boardName), "%s/board", workDirectory);
+	for(i = 0; i < noOfPatterns; i++)
+	{
+		printf("%-*.*s %6ld", NAME_COLUMN_WIDTH, NAME_COLUMN_WIDTH, patterns[i].name, patterns[i].noOfCells);
+		if( (patterns[i].width > width) || (patterns[i].height > height) )
+		{
+			printf(" is %d x %d, which doesn't fit on the board\n", patterns[i].width, patterns[i].height);
+			noOfSkipped++;
+			continue;
+		}
+
+		writeBoardFile(&patterns[i], width, height, boardName);
+		for(j = 0; j < noOfEngines; j++)
+		{
+			/* The time to start up is taken off, so that small patterns measure the engine rather than the program */
+			startSeconds = runLife(engines[j], noOfThreads, width, height, 0, repeats);
+			seconds = runLife(engines[j], noOfThreads, width, height, noOfGenerations, repeats);
+			if( (startSeconds < 0) || (seconds < 0) )
+			{
+				rates[(size_t)i * noOfEngines + j] = RUN_FAILED;
+				printf(" %11s", "failed");
+				noOfFailed++;
+				continue;
+			}
+
+			seconds -= startSeconds;
+			if(seconds < MIN_CALCULATION_TIME)
+			{
+				seconds = MIN_CALCULATION_TIME;
+				printf(" %10.1f+", updates / seconds / 1e6);
+			}
+			else
+				printf(" %11.1f", updates / seconds / 1e6);
+			rates[(size_t)i * noOfEngines + j] = updates / seconds;
+			totalSeconds[j] += seconds;
+			totalUpdates[j] += updates;
+			if(csv != NULL)
+				fprintf(csv, "\"%s\",%ld,%s,%d,%d,%d,%.6f,%.0f\n", patterns[i].name, patterns[i].noOfCells,
+				        (engines[j] != NULL) ? engines[j] : "adaptive", width, height, noOfGenerations, seconds, updates / seconds);
+		}
+		puts("");
+		fflush(stdout);
+	}
+
+	/* The whole corpus, for each engine */
+	double *engineRates = (double *)allocateMemory(noOfPatterns * sizeof(double));
+	double *medians = (double *)allocateMemory(noOfEngines * sizeof(double));
+	int noOfRates;
+
+	printf("\n%-10s %12s %12s %12s\n", "engine", "corpus", "median", "slowest");
+	for(j = 0; j < noOfEngines; j++)
+	{
+		for(i = 0, noOfRates = 0; i < noOfPatterns; i++)
+			if(rates[(size_t)i * noOfEngines + j] > 0)
+				engineRates[noOfRates++] = rates[(size_t)i * noOfEngines + j];
+		medians[j] = medianRate(engineRates, noOfRates);
+		printf("%-11s %12.1f %12.1f %12.1f\n", (engines[j] != NULL) ? engines[j] : "adaptive",
+		       (totalSeconds[j] > 0) ? totalUpdates[j] / totalSeconds[j] / 1e6 : 0.0, medians[j] / 1e6,
+		       (noOfRates > 0) ? engineRates[0] / 1e6 : 0.0);
+	}
+
+	/* The patterns each engine is pathologically slow on, compared with how it does on the rest of the corpus */
+	int noOfFlagged = 0;
+	double rate;
+
+	printf("\nPatterns calculated more than %g times slower than the engine's median:\n", flagFactor);
+	for(j = 0; j < noOfEngines; j++)
+		for(i = 0; i < noOfPatterns; i++)
+		{
+			rate = rates[(size_t)i * noOfEngines + j];
+			if( (rate > 0) && (rate * flagFactor < medians[j]) )
+			{
+				printf("  %-11s %10.1f, %5.1f times slower: %s\n", (engines[j] != NULL) ? engines[j] : "adaptive",
+				       rate / 1e6, medians[j] / rate, patterns[i].name);
+				noOfFlagged++;
+			}
+		}
+	if(noOfFlagged == 0)
+		puts("  None");
+	if(noOfSkipped > 0)
+		printf("%d patterns didn't fit on the board, please increase its size to measure them.\n", noOfSkipped);
+	if(noOfFailed > 0)
+		printf("%d runs failed.\n", noOfFailed);
+
+	if( (csv != NULL) && (fclose(csv) != 0) )
+		fprintf(stderr, "Error writing %s.\n", csvName);
+
+	/* Only the board is in the directory */
+	unlink(boardName);
+	rmdir(workDirectory);
+	return (noOfFailed > 0) ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+/* Allocates zeroed memory, exiting if it can't be allocated */
+void *allocateMemory(size_t size)
+{
+	void *memory = calloc(size > 0 ? size : 1, 1);
+	if(memory == NULL)
+	{
+		fputs("Memory allocation error.\n"
+		      "The program will now exit.\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+	return memory;
+}
+
+/* Reads the names of the engines from the list TYLERJ-life3 gives when asked for an engine that doesn't exist,
+   keeping those in selection (a list separated by commas, or NULL for all of them and the adaptive controller) */
+void findEngines(const char *selection)
+{
+	char command[4096], line[256], name[64], *list;
+	const char *wanted;
+	FILE *listing;
+	size_t length;
+
+	snprintf(command, sizeof(command), "'%s' --engine '?' x 1 1 1 2>&1", lifeProgram);
+	listing = popen(command, "r");
+	if(listing == NULL)
+	{
+		fprintf(stderr, "Error running %s.\n"
+		                "The program will now exit.\n", lifeProgram);
+		exit(EXIT_FAILURE);
+	}
+
+	/* The engines are listed one to a line, indented by two spaces */
+	list = (char *)allocateMemory(1);
+	while(fgets(line, sizeof(line), listing) != NULL)
+		if( (strncmp(line, "  ", 2) == 0) && (sscanf(line, "%63s", name) == 1) )
+		{
+			length = strlen(list);
+			list = (char *)realloc(list, length + strlen(name) + 2);
+			if(list == NULL)
+				allocateMemory(SIZE_MAX);
+			sprintf(list + length, "%s,", name);
+		}
+	pclose(listing);
+	if(list[0] == '\0')
+	{
+		fprintf(stderr, "%s didn't list its engines.\n"
+		                "The program will now exit.\n", lifeProgram);
+		exit(EXIT_FAILURE);
+	}
+
+	/* Each engine selected must be one that the program has */
+	wanted = (selection != NULL) ? selection : list;
+	while(*wanted != '\0')
+	{
+		length = strcspn(wanted, ",");
+		if( (length > 0) && (length < sizeof(name)) )
+		{
+			memcpy(name, wanted, length);
+			name[length] = '\0';
+			if(noOfEngines >= MAX_ENGINES)
+				break;
+			if(strcmp(name, "adaptive") == 0)
+				engines[noOfEngines++] = NULL;
+			else
+			{
+				snprintf(line, sizeof(line), ",%s,", name);
+				snprintf(command, sizeof(command), ",%s", list);
+				if(strstr(command, line) == NULL)
+				{
+					fprintf(stderr, "%s doesn't have an engine called %s.\n"
+					                "The program will now exit.\n", lifeProgram, name);
+					exit(EXIT_FAILURE);
+				}
+				engines[noOfEngines] = (char *)allocateMemory(length + 1);
+				strcpy(engines[noOfEngines++], name);
+			}
+		}
+		wanted += length;
+		if(*wanted == ',')
+			wanted++;
+	}
+	if( (selection == NULL) && (noOfEngines < MAX_ENGINES) )
+		engines[noOfEngines++] = NULL;
+	free(list);
+	return;
+}
+
+/* Reads every pattern from the lexicon, whose patterns are in <pre> blocks of LIVE_CELL_CHARACTER and DEAD_CELL_CHARACTER,
+   each following the entry (":<b>name</b>") it belongs to. Blocks that hold anything else (e.g. tables) aren't patterns.
+   An entry with more than one pattern has them numbered. */
+void readLexicon(const char *fileName, const char *match)
+{
+	FILE *fp = fopen(fileName, "r");
+	if(fp == NULL)
+	{
+		fprintf(stderr, "Error opening lexicon (%s).\n"
+		                "Please ensure that the specified file exists, or give it with --lexicon.\n"
+		                "The program will now exit.\n", fileName);
+		exit(EXIT_FAILURE);
+	}
+
+	/* The lexicon is small, so it is read whole */
+	fseek(fp, 0, SEEK_END);
+	long size = ftell(fp);
+	fseek(fp, 0, SEEK_SET);
+	char *text = (char *)allocateMemory(size + 1);
+	size = (long)fread(text, 1, size, fp);
+	text[size] = '\0';
+	fclose(fp);
+
+	char entry[MAX_NAME_LENGTH] = "", name[MAX_NAME_LENGTH + 8];
+	const char *position = text, *nextEntry, *block, *end, *character;
+	int patternsInEntry = 0, row, column = -1, isPattern;
+	pattern *shape;
+
+	while( (block = strstr(position, "<pre>")) != NULL )
+	{
+		/* Find the entry that the block belongs to */
+		while( ( (nextEntry = strstr(position, "<p>:<b>")) != NULL ) && (nextEntry < block) )
+		{
+			nextEntry += strlen("<p>:<b>");
+			end = strstr(nextEntry, "</b>");
+			if(end == NULL)
+				break;
+			decodeName(nextEntry, end - nextEntry, entry);
+			patternsInEntry = 0;
+			position = end;
+		}
+
+		block += strlen("<pre>");
+		end = strstr(block, "</pre>");
+		if(end == NULL)
+			break;
+		position = end + strlen("</pre>");
+
+		isPattern = 0;
+		for(character = block; character < end; character++)
+			if( (*character == LIVE_CELL_CHARACTER) || (*character == DEAD_CELL_CHARACTER) )
+				isPattern = 1;
+			else if( (*character != '\n') && (*character != '\t') && (*character != ' ') && (*character != '\r') )
+				break;
+		if( !isPattern || (character < end) )
+			continue;
+
+		if(++patternsInEntry == 1)
+			snprintf(name, sizeof(name), "%s", entry);
+		else
+			snprintf(name, sizeof(name), "%s (%d)", entry, patternsInEntry);
+		shape = addPattern(name, match);
+		if(shape == NULL)
+			continue;
+
+		/* Each line of the block is a row, which starts after the indent */
+		row = -1;
+		for(character = block; character < end; character++)
+		{
+			if(*character == '\n')
+			{
+				column = -1;
+				continue;
+			}
+			if( (*character != LIVE_CELL_CHARACTER) && (*character != DEAD_CELL_CHARACTER) )
+				continue;
+			if(column < 0)
+			{
+				column = 0;
+				row++;
+			}
+			if(*character == LIVE_CELL_CHARACTER)
+				addCell(shape, row, column);
+			column++;
+			if(column > shape->width)
+				shape->width = column;
+		}
+		shape->height = row + 1;
+	}
+
+	free(text);
+	return;
+}
+
+/* Reads every board in a directory of boards already in TYLERJ-life3's format (a count, then a row and column for each live cell),
+   in order of their names. A directory that doesn't exist just adds nothing. */
+void readStates(const char *directoryName, const char *match)
+{
+	struct dirent **entries;
+	int noOfEntries = scandir(directoryName, &entries, NULL, alphasort);
+	char fileName[4096];
+	int i, row, column;
+	long noOfCells, j;
+	pattern *shape;
+	FILE *fp;
+
+	for(i = 0; i < noOfEntries; i++)
+	{
+		snprintf(fileName, sizeof(fileName), "%s/%s", directoryName, entries[i]->d_name);
+		fp = (entries[i]->d_name[0] != '.') ? fopen(fileName, "r") : NULL;
+		if( (fp != NULL) && (fscanf(fp, "%ld", &noOfCells) == 1) && ( (shape = addPattern(entries[i]->d_name, match)) != NULL ) )
+		{
+			for(j = 0; (j < noOfCells) && (fscanf(fp, "%d %d", &row, &column) == 2); j++)
+				if( (row >= 0) && (column >= 0) )
+				{
+					addCell(shape, row, column);
+					if(column >= shape->width)
+						shape->width = column + 1;
+					if(row >= shape->height)
+						shape->height = row + 1;
+				}
+		}
+		if(fp != NULL)
+			fclose(fp);
+		free(entries[i]);
+	}
+	if(noOfEntries >= 0)
+		free(entries);
+	return;
+}
+
+/* Adds an empty pattern to the corpus, if its name contains match (or match is NULL).
+   Returns the pattern, or NULL if it isn't wanted. */
+pattern *addPattern(const char *name, const char *match)
+{
+	if( (match != NULL) && (strstr(name, match) == NULL) )
+		return NULL;
+
+	if(noOfPatterns == patternsAllocated)
+	{
+		patternsAllocated = (patternsAllocated > 0) ? 2 * patternsAllocated : 256;
+		patterns = (pattern *)realloc(patterns, patternsAllocated * sizeof(pattern));
+		if(patterns == NULL)
+			allocateMemory(SIZE_MAX);
+	}
+
+	pattern *shape = &patterns[noOfPatterns++];
+	memset(shape, 0, sizeof(pattern));
+	snprintf(shape->name, sizeof(shape->name), "%s", name);
+	return shape;
+}
+
+/* Adds a live cell to a pattern, growing its list of cells by doubling */
+void addCell(pattern *shape, int row, int column)
+{
+	if( (shape->noOfCells & (shape->noOfCells - 1)) == 0 )
+	{
+		shape->cells = (coord *)realloc(shape->cells, (shape->noOfCells > 0 ? 2 * shape->noOfCells : 1) * sizeof(coord));
+		if(shape->cells == NULL)
+			allocateMemory(SIZE_MAX);
+	}
+	shape->cells[shape->noOfCells].row = row;
+	shape->cells[shape->noOfCells].column = column;
+	shape->noOfCells++;
+	return;
+}
+
+/* Copies the name of a lexicon entry, leaving out any tags and replacing the character entities it uses */
+void decodeName(const char *text, size_t length, char *name)
+{
+	static const char *entities[][2] = {{"&amp;", "&"}, {"&lt;", "<"}, {"&gt;", ">"}, {"&quot;", "'"}, {"&nbsp;", " "}};
+	size_t i, j, used = 0, noOfEntities = sizeof(entities) / sizeof(entities[0]);
+
+	for(i = 0; (i < length) && (used < MAX_NAME_LENGTH - 1); i++)
+	{
+		if(text[i] == '<')
+		{
+			while( (i < length) && (text[i] != '>') )
+				i++;
+			continue;
+		}
+		for(j = 0; j < noOfEntities; j++)
+			if( (strlen(entities[j][0]) <= length - i) && (strncmp(text + i, entities[j][0], strlen(entities[j][0])) == 0) )
+				break;
+		if(j < noOfEntities)
+		{
+			name[used++] = entities[j][1][0];
+			i += strlen(entities[j][0]) - 1;
+		}
+		else if(text[i] != '"')
+			name[used++] = text[i];
+	}
+	name[used] = '\0';
+	return;
+}
+
+/* Writes a pattern to a board file, in the middle of a board of the given size */
+void writeBoardFile(const pattern *shape, int width, int height, const char *fileName)
+{
+	FILE *fp = fopen(fileName, "w");
+	int rowOffset = (height - shape->height) / 2, columnOffset = (width - shape->width) / 2;
+	long i;
+
+	if(fp == NULL)
+	{
+		fprintf(stderr, "Error opening board file (%s) for writing.\n"
+		                "The program will now exit.\n", fileName);
+		exit(EXIT_FAILURE);
+	}
+	fprintf(fp, "%ld\n", shape->noOfCells);
+	for(i = 0; i < shape->noOfCells; i++)
+		fprintf(fp, "%d %d\n", shape->cells[i].row + rowOffset, shape->cells[i].column + columnOffset);
+	fclose(fp);
+	return;
+}
+
+/* Runs TYLERJ-life3 on the board file with an engine (NULL for the adaptive controller), repeats times.
+   Returns the shortest time it took in seconds, or RUN_FAILED if it didn't exit successfully. */
+double runLife(const char *engine, int noOfThreads, int width, int height, int noOfGenerations, int repeats)
+{
+	char boardName[64], widthText[16], heightText[16], generations[16], threads[16];
+	const char *arguments[16];
+	int noOfArguments = 0, status, output, repeat;
+	struct timespec start, finish;
+	double seconds, fastest = RUN_FAILED;
+	pid_t child;
+
+	snprintf(boardName, sizeof(boardName), "%s/board", workDirectory);
+	snprintf(widthText, sizeof(widthText), "%d", width);
+	snprintf(heightText, sizeof(heightText), "%d", height);
+	snprintf(generations, sizeof(generations), "%d", noOfGenerations);
+	snprintf(threads, sizeof(threads), "%d", noOfThreads);
+
+	/* With no history, nothing repeats, so every generation is calculated */
+	arguments[noOfArguments++] = lifeProgram;
+	if(engine != NULL)
+	{
+		arguments[noOfArguments++] = "--engine";
+		arguments[noOfArguments++] = engine;
+	}
+	arguments[noOfArguments++] = "--threads";
+	arguments[noOfArguments++] = threads;
+	arguments[noOfArguments++] = "--history";
+	arguments[noOfArguments++] = "0";
+	arguments[noOfArguments++] = "--quiet";
+	arguments[noOfArguments++] = boardName;
+	arguments[noOfArguments++] = widthText;
+	arguments[noOfArguments++] = heightText;
+	arguments[noOfArguments++] = generations;
+	arguments[noOfArguments] = NULL;
+
+	fflush(stdout);
+	for(repeat = 0; repeat < repeats; repeat++)
+	{
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		child = fork();
+		if(child < 0)
+		{
+			fputs("Error starting a run.\n"
+			      "The program will now exit.\n", stderr);
+			exit(EXIT_FAILURE);
+		}
+		if(child == 0)
+		{
+			output = open("/dev/null", O_WRONLY);
+			if(output >= 0)
+			{
+				dup2(output, STDOUT_FILENO);
+				dup2(output, STDERR_FILENO);
+			}
+			execv(lifeProgram, (char * const *)arguments);
+			_exit(127);
+		}
+		if( (waitpid(child, &status, 0) != child) || !WIFEXITED(status) || (WEXITSTATUS(status) != EXIT_SUCCESS) )
+			return RUN_FAILED;
+		clock_gettime(CLOCK_MONOTONIC, &finish);
+
+		seconds = (finish.tv_sec - start.tv_sec) + (finish.tv_nsec - start.tv_nsec) / 1e9;
+		if( (fastest < 0) || (seconds < fastest) )
+			fastest = seconds;
+	}
+	return fastest;
+}
+
+/* Sorts the rates, slowest first, and gives the median (or 0 if there are none) */
+double medianRate(double *rates, int noOfRates)
+{
+	if(noOfRates == 0)
+		return 0;
+	qsort(rates, noOfRates, sizeof(double), compareRates);
+	if(noOfRates % 2 == 1)
+		return rates[noOfRates / 2];
+	return (rates[noOfRates / 2 - 1] + rates[noOfRates / 2]) / 2;
+}
+
+/* Compares two rates for qsort */
+int compareRates(const void *rate1, const void *rate2)
+{
+	double difference = *(const double *)rate1 - *(const double *)rate2;
+	return (difference > 0) - (difference < 0);
+}
@@ -0,0 +1,413 @@
+/*
+	lifeclient.c v1.0
+	Program to calculate a board on a TYLERJ-life3 server (started with --serve), as a sample client of the server's protocol.
+
+	Usage: ./lifeclient <socket> <file-name containing initial data> <width> <height> <no. of generations to calculate> [--history <n>] [--fork <n>] [--latency <n>]
+
+	<socket> is the path given to TYLERJ-life3 --serve.
+	The initial data file, width, height and no. of generations are as for TYLERJ-life3.
+	--history <n> is the maximum period for the server to detect (default 4).
+	--fork <n> calculates the first n generations, then forks the session and calculates the rest on the fork,
+	leaving the original session at generation n, whose status is printed after the board.
+	--latency <n> measures the round trip of n status requests and n queries of an 8 x 8 region, one at a time, once the board is calculated.
+
+	The board is loaded into a new session and calculated on the server, then the client prints a line giving its generation, population,
+	hash and period, followed by the board in the same format as TYLERJ-life3 if it is small enough to print.
+	The protocol is described with runServer() in TYLERJ-life3.c.
+*/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+/* The largest board that is printed, as for TYLERJ-life3 */
+#define MAX_BOARD_WIDTH 78
+#define MAX_BOARD_HEIGHT 50
+
+/* The age at which a cell's age stops increasing, this is printed as an 'X' */
+#define MAX_AGE 10
+
+/* The message types, statuses and flags, which must match the ones in TYLERJ-life3.c */
+#define SERVER_LOAD 1
+#define SERVER_STEP 2
+#define SERVER_QUERY 3
+#define SERVER_STATUS 4
+#define SERVER_CLOSE 5
+#define SERVER_FORK 6
+#define SERVER_OK 0
+#define SERVER_WITH_AGES 1
+
+/* The header of every message, and the status at the start of most replies, which must match the ones in TYLERJ-life3.c */
+typedef struct
+{
+	uint32_t length;
+	uint16_t type;
+	uint16_t flags;
+	uint32_t session;
+	uint32_t tag;
+} serverHeader;
+
+typedef struct
+{
+	int64_t generation;
+	int64_t population;
+	uint64_t hash;
+	int32_t period;
+	int32_t reserved;
+} serverStatus;
+
+/* The connection to the server, the client's session, and the tag of the last request */
+int serverSocket;
+uint32_t session = 0;
+uint32_t lastTag = 0;
+
+/* The payload of the last reply, which grows as needed */
+unsigned char *reply = NULL;
+size_t replyCapacity = 0;
+
+/* The characters used to print the age of a live cell, indexed by its age. */
+const char ageCharacters[MAX_AGE + 1] = {'0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'X'};
+
+/* Function prototypes */
+void *allocateMemory(size_t size);
+int32_t *readBoardFile(const char *fileName, int width, int height, long *noOfCells);
+uint32_t request(uint16_t type, uint16_t flags, const void *payload, uint32_t length, const void *morePayload, uint32_t moreLength);
+void sendAll(const void *buffer, size_t length);
+void receiveAll(void *buffer, size_t length);
+double measureRoundTrips(int noOfRequests, uint16_t type, const void *payload, uint32_t length, double *median, double *slowest);
+int compareTimes(const void *time1, const void *time2);
+double secondsNow(void);
+void printBoard(const unsigned char *live, const unsigned char *ages, int width, int height);
+
+int main(int argc, char* argv[])
+{
+	char *positionalArguments[5];
+	int noOfPositionalArguments = 0;
+	int historyDepth = 4, latencyRequests = 0, i;
+	long long forkGeneration = -1;
+
+	for(i = 1; i < argc; i++)
+	{
+		if( (strcmp(argv[i], "--history") == 0) && (i + 1 < argc) )
+			historyDepth = atoi(argv[++i]);
+		else if( (strcmp(argv[i], "--latency") == 0) && (i + 1 < argc) )
+			latencyRequests = atoi(argv[++i]);
+		else if( (strcmp(argv[i], "--fork") == 0) && (i + 1 < argc) )
+			forkGeneration = atoll(argv[++i]);
+		else if( (strncmp(argv[i], "--", 2) != 0) && (noOfPositionalArguments < 5) )
+			positionalArguments[noOfPositionalArguments++] = argv[i];
+		else
+		{
+			noOfPositionalArguments = 6;
+			break;
+		}
+	}
+
+	int width = -1, height = -1;
+	long long noOfGenerations = -1;
+	if(noOfPositionalArguments == 5)
+	{
+		sscanf(positionalArguments[2], "%d", &width);
+		sscanf(positionalArguments[3], "%d", &height);
+		sscanf(positionalArguments[4], "%lld", &noOfGenerations);
+	}
+	if( (noOfPositionalArguments != 5) || (width < 1) || (height < 1) || (noOfGenerations < 0) || (historyDepth < 0) || (latencyRequests < 0)
+	    || (forkGeneration > noOfGenerations) )
+	{
+		fprintf(stderr, "Invalid arguments.\n"
+		                "Usage: %s <socket> <file-name containing initial data> <width> <height> <no. of generations to calculate> [--history <n>] [--fork <n>] [--latency <n>]\n"
+		                "The program will now exit.\n", argv[0]);
+		exit(EXIT_FAILURE);
+	}
+
+	long noOfCells;
+	int32_t *cells = readBoardFile(positionalArguments[1], width, height, &noOfCells);
+
+	/* Connect to the server */
+	struct sockaddr_un address;
+	memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	strncpy(address.sun_path, positionalArguments[0], sizeof(address.sun_path) - 1);
+	serverSocket = socket(AF_UNIX, SOCK_STREAM, 0);
+	if( (serverSocket < 0) || (connect(serverSocket, (struct sockaddr *)&address, sizeof(address)) != 0) )
+	{
+		fprintf(stderr, "Error connecting to the server (%s).\n"
+		                "Please ensure that TYLERJ-life3 is running with --serve %s.\n"
+		                "The program will now exit.\n", positionalArguments[0], positionalArguments[0]);
+		exit(EXIT_FAILURE);
+	}
+
+	/* Load the board into a new session, then calculate it */
+	int32_t sizes[4] = {width, height, historyDepth, 0};
+	if(request(SERVER_LOAD, 0, sizes, sizeof(sizes), cells, (uint32_t)(noOfCells * 2 * sizeof(int32_t))) != SERVER_OK)
+	{
+		fputs("The server couldn't load the board.\n"
+		      "The program will now exit.\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+	int64_t generations = noOfGenerations;
+	uint32_t originalSession = session;
+	if(forkGeneration >= 0)
+	{
+		/* Calculate up to the fork, then carry on with the fork, which becomes the client's session */
+		generations = forkGeneration;
+		request(SERVER_STEP, 0, &generations, sizeof(generations), NULL, 0);
+		if(request(SERVER_FORK, 0, NULL, 0, NULL, 0) != SERVER_OK)
+		{
+			fputs("The server couldn't fork the session.\n"
+			      "The program will now exit.\n", stderr);
+			exit(EXIT_FAILURE);
+		}
+		generations = noOfGenerations - forkGeneration;
+	}
+	request(SERVER_STEP, 0, &generations, sizeof(generations), NULL, 0);
+
+	/* Fetch the whole board, with its ages */
+	int32_t region[4] = {0, 0, height, width};
+	if(request(SERVER_QUERY, SERVER_WITH_AGES, region, sizeof(region), NULL, 0) != SERVER_OK)
+	{
+		fputs("The server couldn't send the board.\n"
+		      "The program will now exit.\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+	serverStatus status;
+	memcpy(&status, reply, sizeof(status));
+	printf("Generation %lld: population %lld, hash %016llx", (long long)status.generation, (long long)status.population, (unsigned long long)status.hash);
+	if(status.period != 0)
+		printf(", period %d", status.period);
+	putchar('\n');
+	if( (width <= MAX_BOARD_WIDTH) && (height <= MAX_BOARD_HEIGHT) )
+		printBoard(reply + sizeof(status), reply + sizeof(status) + (size_t)height * ( (width + 7) / 8 ), width, height);
+
+	/* The original session is left where it was forked */
+	if(originalSession != session)
+	{
+		uint32_t forkedSession = session;
+		session = originalSession;
+		request(SERVER_STATUS, 0, NULL, 0, NULL, 0);
+		memcpy(&status, reply, sizeof(status));
+		printf("Forked from session %u at generation %lld: population %lld, hash %016llx", originalSession, (long long)status.generation,
+		       (long long)status.population, (unsigned long long)status.hash);
+		if(status.period != 0)
+			printf(", period %d", status.period);
+		putchar('\n');
+		request(SERVER_CLOSE, 0, NULL, 0, NULL, 0);
+		session = forkedSession;
+	}
+	fflush(stdout);
+
+	if(latencyRequests > 0)
+	{
+		double mean, median, slowest;
+		int32_t smallRegion[4] = {0, 0, 8, 8};
+
+		mean = measureRoundTrips(latencyRequests, SERVER_STATUS, NULL, 0, &median, &slowest);
+		printf("Status round trip: mean %.1f us, median %.1f us, 99th percentile %.1f us\n", mean * 1e6, median * 1e6, slowest * 1e6);
+		mean = measureRoundTrips(latencyRequests, SERVER_QUERY, smallRegion, sizeof(smallRegion), &median, &slowest);
+		printf("8 x 8 query round trip: mean %.1f us, median %.1f us, 99th percentile %.1f us\n", mean * 1e6, median * 1e6, slowest * 1e6);
+	}
+
+	request(SERVER_CLOSE, 0, NULL, 0, NULL, 0);
+	close(serverSocket);
+	free(cells);
+	free(reply);
+	return EXIT_SUCCESS;
+}
+
+/* Allocates zeroed memory, exiting if it can't be allocated */
+void *allocateMemory(size_t size)
+{
+	void *memory = calloc(size > 0 ? size : 1, 1);
+	if(memory == NULL)
+	{
+		fputs("Memory allocation error.\n"
+		      "The program will now exit.\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+	return memory;
+}
+
+/* Reads a board file in the format TYLERJ-life3 reads, a count followed by the row and column of each live cell,
+   into pairs of rows and columns as they are sent to the server. Exits if the file can't be read or a cell is outside the board. */
+int32_t *readBoardFile(const char *fileName, int width, int height, long *noOfCells)
+{
+	FILE *file = fopen(fileName, "r");
+	long count = 0, i;
+	int row, column;
+
+	if( (file == NULL) || (fscanf(file, "%ld", &count) != 1) || (count < 0) )
+	{
+		fprintf(stderr, "Error reading board configuration file (%s).\n"
+		                "The program will now exit.\n", fileName);
+		exit(EXIT_FAILURE);
+	}
+
+	int32_t *cells = (int32_t *)allocateMemory(count * 2 * sizeof(int32_t));
+	for(i = 0; i < count; i++)
+	{
+		if( (fscanf(file, "%d%d", &row, &column) != 2) || (row < 0) || (column < 0) || (row >= height) || (column >= width) )
+		{
+			fputs("Co-ordinate outside board dimensions.\n"
+			      "The program will now exit.\n", stderr);
+			exit(EXIT_FAILURE);
+		}
+		cells[2 * i] = row;
+		cells[2 * i + 1] = column;
+	}
+	fclose(file);
+	*noOfCells = count;
+	return cells;
+}
+
+/* Sends a request for the client's session, with its payload in two parts, and waits for the reply, whose payload is left in reply.
+   A load's reply gives the session its id, and a fork's the id of the fork, which becomes the client's session. Returns the status of the reply. */
+uint32_t request(uint16_t type, uint16_t flags, const void *payload, uint32_t length, const void *morePayload, uint32_t moreLength)
+{
+	serverHeader header = {length + moreLength, type, flags, session, ++lastTag};
+
+	sendAll(&header, sizeof(header));
+	sendAll(payload, length);
+	sendAll(morePayload, moreLength);
+
+	receiveAll(&header, sizeof(header));
+	if(header.tag != lastTag)
+	{
+		fputs("The server replied to the wrong request.\n"
+		      "The program will now exit.\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+	if(header.length > replyCapacity)
+	{
+		free(reply);
+		replyCapacity = header.length;
+		reply = (unsigned char *)allocateMemory(replyCapacity);
+	}
+	receiveAll(reply, header.length);
+
+	if( ( (type == SERVER_LOAD) || (type == SERVER_FORK) ) && (header.flags == SERVER_OK) )
+		session = header.session;
+	return header.flags;
+}
+
+/* Sends the whole of a buffer to the server, exiting if the connection fails */
+void sendAll(const void *buffer, size_t length)
+{
+	const unsigned char *position = (const unsigned char *)buffer;
+	ssize_t sent;
+
+	while(length > 0)
+	{
+		sent = send(serverSocket, position, length, MSG_NOSIGNAL);
+		if( (sent < 0) && (errno == EINTR) )
+			continue;
+		if(sent <= 0)
+		{
+			fputs("Error sending to the server.\n"
+			      "The program will now exit.\n", stderr);
+			exit(EXIT_FAILURE);
+		}
+		position += sent;
+		length -= sent;
+	}
+	return;
+}
+
+/* Fills a buffer from the server, exiting if the connection fails */
+void receiveAll(void *buffer, size_t length)
+{
+	unsigned char *position = (unsigned char *)buffer;
+	ssize_t received;
+
+	while(length > 0)
+	{
+		received = recv(serverSocket, position, length, 0);
+		if( (received < 0) && (errno == EINTR) )
+			continue;
+		if(received <= 0)
+		{
+			fputs("The server closed the connection.\n"
+			      "The program will now exit.\n", stderr);
+			exit(EXIT_FAILURE);
+		}
+		position += received;
+		length -= received;
+	}
+	return;
+}
+
+/* Times noOfRequests requests of one type, each sent once the reply to the one before has arrived.
+   Returns the mean round trip in seconds, and gives the median and the 99th percentile. */
+double measureRoundTrips(int noOfRequests, uint16_t type, const void *payload, uint32_t length, double *median, double *slowest)
+{
+	double *times = (double *)allocateMemory(noOfRequests * sizeof(double));
+	double start, total = 0;
+	int i;
+
+	for(i = 0; i < noOfRequests; i++)
+	{
+		start = secondsNow();
+		request(type, 0, payload, length, NULL, 0);
+		times[i] = secondsNow() - start;
+		total += times[i];
+	}
+
+	qsort(times, noOfRequests, sizeof(double), compareTimes);
+	*median = times[noOfRequests / 2];
+	*slowest = times[(int)(noOfRequests * 0.99)];
+	free(times);
+	return total / noOfRequests;
+}
+
+/* Compares two times for qsort() */
+int compareTimes(const void *time1, const void *time2)
+{
+	double difference = *(const double *)time1 - *(const double *)time2;
+	return (difference > 0) - (difference < 0);
+}
+
+/* Gives the time in seconds from a monotonic clock */
+double secondsNow(void)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+/* Prints a board sent by the server, with its border, followed by two blank lines, in the same format as TYLERJ-life3 */
+void printBoard(const unsigned char *live, const unsigned char *ages, int width, int height)
+{
+	size_t rowBytes = ( (size_t)width + 7 ) / 8;
+	int row, column;
+
+	putchar('*');
+	for(column = 0; column < width; column++)
+		putchar('-');
+	puts("*");
+
+	for(row = 0; row < height; row++)
+	{
+		putchar('|');
+		for(column = 0; column < width; column++)
+			if( (live[row * rowBytes + column / 8] >> (column % 8)) & 1 )
+				putchar(ageCharacters[ages[(size_t)row * width + column]]);
+			else
+				putchar(' ');
+		puts("|");
+	}
+
+	putchar('*');
+	for(column = 0; column < width; column++)
+		putchar('-');
+	puts("*");
+
+	putchar('\n');
+	putchar('\n');
+	return;
+}
@@ -0,0 +1,656 @@
+/*
+	lifefuzz.c v1.0
+	Program to test the engines of TYLERJ-life3 against each other, by running random boards through every engine and comparing the results.
+
+	Usage: ./lifefuzz <TYLERJ-life3> [--seed <n>] [--cases <n> | --time <seconds>] [--max-size <cells>] [--timeout <seconds>] [--keep-going]
+
+	<TYLERJ-life3> is the program to test.
+	--seed <n> starts the random boards from seed n (by default the time), so that a run can be repeated.
+	--cases <n> tests n boards (default 100), or --time <seconds> tests boards until the time is up, for soak testing.
+	--max-size <cells> is the largest number of cells on a board (default 1000000).
+	--timeout <seconds> is how long a single run of TYLERJ-life3 may take before it is counted as a failure (default 60).
+	--keep-going carries on after a mismatch, instead of stopping at the first one.
+
+	Each board has a random size, density, number of generations and history depth. It is run through the char engine,
+	which calculates the boards in the same way as the original program and is the reference, then through every other engine,
+	with different numbers of threads, through the adaptive controller, and split between worker processes.
+	Boards small enough to print are compared as printed, generation by generation, so the age characters are compared too,
+	and every board is also compared through its frame log (--log), which holds every generation with the ages of its cells.
+	The message at the end (e.g. the period detected) and the exit status must match too.
+
+	A mismatch is shrunk to a small reproducer: the fewest generations, then the fewest live cells, then the smallest board
+	and history depth that still mismatch. The reproducer is saved as lifefuzz-<seed>-<case>.txt in the current directory,
+	and the command lines to run it with are printed. The program exits with EXIT_FAILURE if any mismatch was found.
+*/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <signal.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+/* The largest board that TYLERJ-life3 prints, larger boards are only compared through their frame logs */
+#define MAX_BOARD_WIDTH 78
+#define MAX_BOARD_HEIGHT 50
+
+/* The most engines that can be read from TYLERJ-life3, and the most runs that are compared for a board */
+#define MAX_ENGINES 32
+#define MAX_CONFIGURATIONS (4 * MAX_ENGINES)
+
+/* The results of a run that didn't exit normally */
+#define RUN_TIMED_OUT -1
+#define RUN_CRASHED -2
+
+/* Structure to hold co-ordinates of a point */
+typedef struct
+{
+	int row;
+	int column;
+} coord;
+
+/* Structure to hold a board to test: its size, its live cells (which may include duplicates, as a file may),
+   and the settings it is run with */
+typedef struct
+{
+	int width, height;
+	int noOfGenerations;
+	int historyDepth;
+	long noOfCells;
+	coord *cells;
+} testCase;
+
+/* Structure to hold one way of running TYLERJ-life3: the engine (NULL for the adaptive controller),
+   and the number of threads and worker processes */
+typedef struct
+{
+	const char *engine;
+	int noOfThreads;
+	int noOfWorkers;
+} configuration;
+
+/* The program being tested, the directory the boards and results are written to, and the engines it has */
+const char *lifeProgram;
+char workDirectory[] = "/tmp/lifefuzz-XXXXXX";
+char *engines[MAX_ENGINES];
+int noOfEngines = 0;
+
+/* The longest a run may take, in seconds */
+long runTimeout = 60;
+
+/* The state of the random number generator */
+uint64_t randomState;
+
+/* Function prototypes */
+void *allocateMemory(size_t size);
+uint64_t nextRandom(void);
+long randomBelow(long limit);
+void findEngines(void);
+void makeTestCase(testCase *test, long maxSize);
+int makeConfigurations(const testCase *test, configuration *configurations);
+void describeConfiguration(const configuration *config, char *text, size_t size);
+void writeBoardFile(const testCase *test, const char *fileName);
+int runLife(const testCase *test, const configuration *config, const char *outputName, const char *logName);
+int mismatches(const testCase *test, const configuration *config, long *firstGeneration);
+int sameFiles(const char *fileName1, const char *fileName2, long *firstGeneration);
+void shrinkTestCase(testCase *test, const configuration *config);
+void saveReproducer(const testCase *test, const configuration *config, uint64_t seed, long caseNumber);
+
+int main(int argc, char* argv[])
+{
+	uint64_t seed = (uint64_t)time(NULL);
+	long noOfCases = 100, timeLimit = -1, maxSize = 1000000;
+	int keepGoing = 0, i;
+
+	for(i = 2; i < argc; i++)
+	{
+		if( (strcmp(argv[i], "--seed") == 0) && (i + 1 < argc) )
+			seed = strtoull(argv[++i], NULL, 10);
+		else if( (strcmp(argv[i], "--cases") == 0) && (i + 1 < argc) )
+			noOfCases = atol(argv[++i]);
+		else if( (strcmp(argv[i], "--time") == 0) && (i + 1 < argc) )
+			timeLimit = atol(argv[++i]);
+		else if( (strcmp(argv[i], "--max-size") == 0) && (i + 1 < argc) )
+			maxSize = atol(argv[++i]);
+		else if( (strcmp(argv[i], "--timeout") == 0) && (i + 1 < argc) )
+			runTimeout = atol(argv[++i]);
+		else if(strcmp(argv[i], "--keep-going") == 0)
+			keepGoing = 1;
+		else
+			break;
+	}
+
+	/* Check the arguments */
+	if( (argc < 2) || (i < argc) || (noOfCases < 1) || (maxSize < 1) || (runTimeout < 1) )
+	{
+		fprintf(stderr, "Invalid arguments.\n"
+		                "Usage: %s <TYLERJ-life3> [--seed <n>] [--cases <n> | --time <seconds>] [--max-size <cells>] [--timeout <seconds>] [--keep-going]\n"
+		                "The program will now exit.\n", argv[0]);
+		exit(EXIT_FAILURE);
+	}
+	lifeProgram = argv[1];
+
+	if(mkdtemp(workDirectory) == NULL)
+	{
+		fputs("Error creating a directory for the boards.\n"
+		      "The program will now exit.\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+
+	findEngines();
+	printf("Testing %s with seed %llu\n", lifeProgram, (unsigned long long)seed);
+	fflush(stdout);
+
+	/* Each case has its own seed, so that any case can be made again from the seed of the run */
+	time_t startTime = time(NULL);
+	long caseNumber, noOfRuns = 0, noOfMismatches = 0, firstGeneration;
+	configuration configurations[MAX_CONFIGURATIONS];
+	char description[128];
+	testCase test;
+	int noOfConfigurations;
+
+	for(caseNumber = 0; (timeLimit >= 0) ? (time(NULL) - startTime < timeLimit) : (caseNumber < noOfCases); caseNumber++)
+	{
+		randomState = seed ^ ( (uint64_t)caseNumber * 0x9e3779b97f4a7c15ULL );
+		makeTestCase(&test, maxSize);
+		noOfConfigurations = makeConfigurations(&test, configurations);
+
+		for(i = 0; i < noOfConfigurations; i++)
+		{
+			noOfRuns++;
+			if(!mismatches(&test, &configurations[i], &firstGeneration))
+				continue;
+
+			noOfMismatches++;
+			describeConfiguration(&configurations[i], description, sizeof(description));
+			printf("Case %ld: %s doesn't match the char engine on a %d x %d board with %ld cells, %d generations and history %d",
+			       caseNumber, description, test.width, test.height, test.noOfCells, test.noOfGenerations, test.historyDepth);
+			if(firstGeneration >= 0)
+				printf(", from generation %ld", firstGeneration);
+			puts("");
+			fflush(stdout);
+
+			shrinkTestCase(&test, &configurations[i]);
+			saveReproducer(&test, &configurations[i], seed, caseNumber);
+			break;
+		}
+
+		free(test.cells);
+		if( (noOfMismatches > 0) && !keepGoing )
+		{
+			caseNumber++;
+			break;
+		}
+	}
+
+	printf("%ld cases, %ld runs compared, %ld mismatches\n", caseNumber, noOfRuns, noOfMismatches);
+
+	/* Only the boards and results are in the directory */
+	char command[64];
+	snprintf(command, sizeof(command), "rm -rf %s", workDirectory);
+	if(system(command) != 0)
+		fprintf(stderr, "Error removing %s.\n", workDirectory);
+	return (noOfMismatches > 0) ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+/* Allocates zeroed memory, exiting if it can't be allocated */
+void *allocateMemory(size_t size)
+{
+	void *memory = calloc(size > 0 ? size : 1, 1);
+	if(memory == NULL)
+	{
+		fputs("Memory allocation error.\n"
+		      "The program will now exit.\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+	return memory;
+}
+
+/* Gives the next random number (splitmix64), which is the same on every system for the same seed */
+uint64_t nextRandom(void)
+{
+	uint64_t value = (randomState += 0x9e3779b97f4a7c15ULL);
+	value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+	return value ^ (value >> 31);
+}
+
+/* Gives a random number from 0 to limit - 1 */
+long randomBelow(long limit)
+{
+	return (limit > 0) ? (long)(nextRandom() % (uint64_t)limit) : 0;
+}
+
+/* Reads the names of the engines from the list TYLERJ-life3 gives when asked for an engine that doesn't exist */
+void findEngines(void)
+{
+	char command[4096], line[256], name[64];
+	FILE *list;
+
+	snprintf(command, sizeof(command), "'%s' --engine '?' x 1 1 1 2>&1", lifeProgram);
+	list = popen(command, "r");
+	if(list == NULL)
+	{
+		fprintf(stderr, "Error running %s.\n"
+		                "The program will now exit.\n", lifeProgram);
+		exit(EXIT_FAILURE);
+	}
+
+	/* The engines are listed one to a line, indented by two spaces */
+	while(fgets(line, sizeof(line), list) != NULL)
+		if( (strncmp(line, "  ", 2) == 0) && (sscanf(line, "%63s", name) == 1) && (noOfEngines < MAX_ENGINES) )
+		{
+			engines[noOfEngines] = (char *)allocateMemory(strlen(name) + 1);
+			strcpy(engines[noOfEngines++], name);
+		}
+	pclose(list);
+
+	for(int i = 0; i < noOfEngines; i++)
+		if(strcmp(engines[i], "char") == 0)
+			return;
+	fprintf(stderr, "%s doesn't have a char engine to compare the others with.\n"
+	                "The program will now exit.\n", lifeProgram);
+	exit(EXIT_FAILURE);
+}
+
+/* Makes a random board. Most are small enough to print, the rest are bigger, up to maxSize cells.
+   The density varies from almost empty to crowded, and a few cells are given twice, as a file may give them. */
+void makeTestCase(testCase *test, long maxSize)
+{
+	long row, column, side, threshold, i;
+
+	if( (randomBelow(5) != 0) || (maxSize <= (long)MAX_BOARD_WIDTH * MAX_BOARD_HEIGHT) )
+	{
+		test->width = (int)randomBelow(MAX_BOARD_WIDTH + 1);
+		test->height = (int)randomBelow(MAX_BOARD_HEIGHT + 1);
+		test->noOfGenerations = (int)randomBelow(200);
+	}
+	else
+	{
+		/* A side of up to the square root of the largest size, with the other side making up the area */
+		for(side = 1; (side + 1) * (side + 1) <= maxSize; side++)
+			;
+		test->width = MAX_BOARD_WIDTH + 1 + (int)randomBelow(side);
+		test->height = 1 + (int)randomBelow(maxSize / test->width);
+		if(randomBelow(2))
+		{
+			int temp = test->width;
+			test->width = test->height;
+			test->height = temp;
+		}
+		test->noOfGenerations = (int)randomBelow(60);
+	}
+	test->historyDepth = (int)randomBelow(9);
+
+	/* Each cell is alive with a probability of threshold / 1024 */
+	threshold = 1 + randomBelow(600);
+	test->cells = (coord *)allocateMemory( ( (size_t)test->width * test->height + 8 ) * sizeof(coord) );
+	test->noOfCells = 0;
+	for(row = 0; row < test->height; row++)
+		for(column = 0; column < test->width; column++)
+			if(randomBelow(1024) < threshold)
+			{
+				test->cells[test->noOfCells].row = (int)row;
+				test->cells[test->noOfCells].column = (int)column;
+				test->noOfCells++;
+			}
+	for(i = randomBelow(4); (i > 0) && (test->noOfCells > 0); i--)
+	{
+		test->cells[test->noOfCells] = test->cells[randomBelow(test->noOfCells)];
+		test->noOfCells++;
+	}
+	return;
+}
+
+/* Makes the list of ways to run a board: every engine with one thread and with a random number of threads,
+   the adaptive controller, and the board split between worker processes.
+   Returns the number of configurations. */
+int makeConfigurations(const testCase *test, configuration *configurations)
+{
+	int noOfConfigurations = 0, i;
+
+	for(i = 0; i < noOfEngines; i++)
+	{
+		if(strcmp(engines[i], "char") == 0)
+			continue;
+		configurations[noOfConfigurations++] = (configuration){engines[i], 1, 1};
+		configurations[noOfConfigurations++] = (configuration){engines[i], 2 + (int)randomBelow(3), 1};
+	}
+	configurations[noOfConfigurations++] = (configuration){NULL, 1, 1};
+	configurations[noOfConfigurations++] = (configuration){NULL, 2 + (int)randomBelow(3), 1};
+
+	/* Workers need a row each */
+	if(test->height >= 2)
+		configurations[noOfConfigurations++] = (configuration){NULL, 1, 2 + (int)randomBelow( (test->height < 4) ? test->height - 1 : 3 )};
+	return noOfConfigurations;
+}
+
+/* Describes a configuration as the options that give it */
+void describeConfiguration(const configuration *config, char *text, size_t size)
+{
+	if(config->noOfWorkers > 1)
+		snprintf(text, size, "--workers %d", config->noOfWorkers);
+	else if(config->engine == NULL)
+		snprintf(text, size, "--threads %d", config->noOfThreads);
+	else
+		snprintf(text, size, "--engine %s --threads %d", config->engine, config->noOfThreads);
+	return;
+}
+
+/* Writes a board in the format that TYLERJ-life3 reads: the number of cells, then the row and column of each */
+void writeBoardFile(const testCase *test, const char *fileName)
+{
+	FILE *fp = fopen(fileName, "w");
+	long i;
+
+	if(fp == NULL)
+	{
+		fprintf(stderr, "Error opening board file (%s) for writing.\n"
+		                "The program will now exit.\n", fileName);
+		exit(EXIT_FAILURE);
+	}
+	fprintf(fp, "%ld\n", test->noOfCells);
+	for(i = 0; i < test->noOfCells; i++)
+		fprintf(fp, "%d %d\n", test->cells[i].row, test->cells[i].column);
+	fclose(fp);
+	return;
+}
+
+/* Runs TYLERJ-life3 on a board in one configuration, writing what it prints to outputName and its frame log to logName.
+   Returns its exit status, RUN_TIMED_OUT if it was stopped for taking too long, or RUN_CRASHED if it was killed by a signal. */
+int runLife(const testCase *test, const configuration *config, const char *outputName, const char *logName)
+{
+	char boardName[64], width[16], height[16], generations[16], history[16], threads[16], workers[16];
+	const char *arguments[24];
+	int noOfArguments = 0, status, output;
+	struct timespec pause = {0, 1000000};
+	long waited;
+	pid_t child;
+
+	snprintf(boardName, sizeof(boardName), "%s/board", workDirectory);
+	snprintf(width, sizeof(width), "%d", test->width);
+	snprintf(height, sizeof(height), "%d", test->height);
+	snprintf(generations, sizeof(generations), "%d", test->noOfGenerations);
+	snprintf(history, sizeof(history), "%d", test->historyDepth);
+	snprintf(threads, sizeof(threads), "%d", config->noOfThreads);
+	snprintf(workers, sizeof(workers), "%d", config->noOfWorkers);
+
+	arguments[noOfArguments++] = lifeProgram;
+	if(config->engine != NULL)
+	{
+		arguments[noOfArguments++] = "--engine";
+		arguments[noOfArguments++] = config->engine;
+	}
+	arguments[noOfArguments++] = "--threads";
+	arguments[noOfArguments++] = threads;
+	if(config->noOfWorkers > 1)
+	{
+		arguments[noOfArguments++] = "--workers";
+		arguments[noOfArguments++] = workers;
+	}
+	arguments[noOfArguments++] = "--history";
+	arguments[noOfArguments++] = history;
+	arguments[noOfArguments++] = "--log";
+	arguments[noOfArguments++] = logName;
+	if( (test->width > MAX_BOARD_WIDTH) || (test->height > MAX_BOARD_HEIGHT) )
+		arguments[noOfArguments++] = "--quiet";
+	arguments[noOfArguments++] = boardName;
+	arguments[noOfArguments++] = width;
+	arguments[noOfArguments++] = height;
+	arguments[noOfArguments++] = generations;
+	arguments[noOfArguments] = NULL;
+
+	fflush(stdout);
+	child = fork();
+	if(child < 0)
+	{
+		fputs("Error starting a run.\n"
+		      "The program will now exit.\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+	if(child == 0)
+	{
+		/* The messages on stderr (e.g. the adaptive controller's) differ between engines, so only stdout is kept */
+		output = open(outputName, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+		if(output >= 0)
+			dup2(output, STDOUT_FILENO);
+		output = open("/dev/null", O_WRONLY);
+		if(output >= 0)
+			dup2(output, STDERR_FILENO);
+		execv(lifeProgram, (char * const *)arguments);
+		_exit(127);
+	}
+
+	/* Wait for it, stopping it if it takes too long, which probably means it has deadlocked */
+	for(waited = 0; waitpid(child, &status, WNOHANG) == 0; waited++)
+	{
+		if(waited >= runTimeout * 1000)
+		{
+			kill(child, SIGKILL);
+			waitpid(child, &status, 0);
+			return RUN_TIMED_OUT;
+		}
+		nanosleep(&pause, NULL);
+	}
+	if(WIFEXITED(status))
+		return WEXITSTATUS(status);
+	return RUN_CRASHED;
+}
+
+/* Runs a board through the char engine and through a configuration, and compares them.
+   Returns 1 if they don't match, setting firstGeneration to the first generation printed differently (or -1 if it isn't known),
+   or 0 if they match. */
+int mismatches(const testCase *test, const configuration *config, long *firstGeneration)
+{
+	const configuration reference = {"char", 1, 1};
+	char boardName[64], referenceOutput[64], referenceLog[64], output[64], log[64];
+	int referenceStatus, status;
+	long logGeneration;
+
+	snprintf(boardName, sizeof(boardName), "%s/board", workDirectory);
+	snprintf(referenceOutput, sizeof(referenceOutput), "%s/reference.out", workDirectory);
+	snprintf(referenceLog, sizeof(referenceLog), "%s/reference.log", workDirectory);
+	snprintf(output, sizeof(output), "%s/test.out", workDirectory);
+	snprintf(log, sizeof(log), "%s/test.log", workDirectory);
+
+	writeBoardFile(test, boardName);
+	remove(referenceLog);
+	remove(log);
+	referenceStatus = runLife(test, &reference, referenceOutput, referenceLog);
+	status = runLife(test, config, output, log);
+
+	*firstGeneration = -1;
+	if(status != referenceStatus)
+		return 1;
+	return !sameFiles(referenceOutput, output, firstGeneration) | !sameFiles(referenceLog, log, &logGeneration);
+}
+
+/* Compares two files. Returns 1 if they are the same, or 0 if they aren't,
+   setting firstGeneration to the number of boards before the first difference if the files are boards printed by TYLERJ-life3. */
+int sameFiles(const char *fileName1, const char *fileName2, long *firstGeneration)
+{
+	FILE *fp1 = fopen(fileName1, "rb"), *fp2 = fopen(fileName2, "rb");
+	int character1, character2, atLineStart = 1, same;
+	long borders = 0;
+
+	/* A file that wasn't written (a log from a run that failed) is the same as another that wasn't */
+	if( (fp1 == NULL) || (fp2 == NULL) )
+	{
+		same = (fp1 == NULL) && (fp2 == NULL);
+		if(fp1 != NULL)
+			fclose(fp1);
+		if(fp2 != NULL)
+			fclose(fp2);
+		return same;
+	}
+
+	/* Each board starts and ends with a border line starting with '*', so every other border starts a generation */
+	do
+	{
+		character1 = fgetc(fp1);
+		character2 = fgetc(fp2);
+		if( atLineStart && (character1 == '*') )
+			borders++;
+		atLineStart = (character1 == '\n');
+	}
+	while( (character1 == character2) && (character1 != EOF) );
+	same = (character1 == character2);
+	if(!same && (borders > 0))
+		*firstGeneration = (borders - 1) / 2;
+
+	fclose(fp1);
+	fclose(fp2);
+	return same;
+}
+
+/* Shrinks a board that mismatches to a smaller one that still does: the fewest generations,
+   then the fewest cells (removing halves of them, then quarters, and so on down to single cells),
+   then the smallest board (moving the cells up and to the left, and taking columns off the right and rows off the bottom),
+   repeating these until none of them helps, and then the smallest history depth. */
+void shrinkTestCase(testCase *test, const configuration *config)
+{
+	long low, high, middle, chunk, start, length, i, kept, firstGeneration;
+	coord *removed = (coord *)allocateMemory( (test->noOfCells + 1) * sizeof(coord) );
+	int size, step, dimension, shrunk, top, left;
+	testCase trial;
+
+	do
+	{
+		shrunk = 0;
+
+		/* A mismatch in one generation is there in every run that calculates that generation */
+		low = 0;
+		high = test->noOfGenerations;
+		while(low < high)
+		{
+			middle = (low + high) / 2;
+			trial = *test;
+			trial.noOfGenerations = (int)middle;
+			if(mismatches(&trial, config, &firstGeneration))
+				high = middle;
+			else
+				low = middle + 1;
+		}
+		shrunk |= (high < test->noOfGenerations);
+		test->noOfGenerations = (int)high;
+
+		for(chunk = test->noOfCells / 2; chunk >= 1; chunk /= 2)
+			for(start = 0; start < test->noOfCells; )
+			{
+				/* Take out the cells from start to start + chunk, and put them back if the mismatch goes */
+				length = (start + chunk < test->noOfCells) ? chunk : test->noOfCells - start;
+				memcpy(removed, test->cells + start, length * sizeof(coord));
+				memmove(test->cells + start, test->cells + start + length, (test->noOfCells - start - length) * sizeof(coord));
+				test->noOfCells -= length;
+				if(mismatches(test, config, &firstGeneration))
+				{
+					shrunk = 1;
+					continue;
+				}
+				memmove(test->cells + start + length, test->cells + start, (test->noOfCells - start) * sizeof(coord));
+				memcpy(test->cells + start, removed, length * sizeof(coord));
+				test->noOfCells += length;
+				start += length;
+			}
+
+		/* Move the cells into the top left corner, which only keeps the mismatch if it doesn't depend on the top or left edge */
+		for(i = 0, top = test->height, left = test->width; i < test->noOfCells; i++)
+		{
+			if(test->cells[i].row < top)
+				top = test->cells[i].row;
+			if(test->cells[i].column < left)
+				left = test->cells[i].column;
+		}
+		if( (test->noOfCells > 0) && ( (top > 0) || (left > 0) ) )
+		{
+			trial = *test;
+			trial.width -= left;
+			trial.height -= top;
+			trial.cells = removed;
+			for(i = 0; i < test->noOfCells; i++)
+			{
+				removed[i].row = test->cells[i].row - top;
+				removed[i].column = test->cells[i].column - left;
+			}
+			if(mismatches(&trial, config, &firstGeneration))
+			{
+				memcpy(test->cells, removed, test->noOfCells * sizeof(coord));
+				test->width = trial.width;
+				test->height = trial.height;
+				shrunk = 1;
+			}
+		}
+
+		/* Try taking columns off the right, and rows off the bottom, in large steps and then in smaller ones */
+		for(dimension = 0; dimension < 2; dimension++)
+		{
+			size = (dimension == 0) ? test->width : test->height;
+			for(step = size / 2; step >= 1; step /= 2)
+				while(step <= size)
+				{
+					trial = *test;
+					if(dimension == 0)
+						trial.width = size - step;
+					else
+						trial.height = size - step;
+					trial.cells = removed;
+					for(i = 0, kept = 0; i < test->noOfCells; i++)
+						if( (test->cells[i].column < trial.width) && (test->cells[i].row < trial.height) )
+							removed[kept++] = test->cells[i];
+					trial.noOfCells = kept;
+					if(!mismatches(&trial, config, &firstGeneration))
+						break;
+					memcpy(test->cells, removed, kept * sizeof(coord));
+					test->noOfCells = kept;
+					test->width = trial.width;
+					test->height = trial.height;
+					size -= step;
+					shrunk = 1;
+				}
+		}
+	}
+	while(shrunk);
+
+	for(i = 0; i < test->historyDepth; i++)
+	{
+		trial = *test;
+		trial.historyDepth = (int)i;
+		if(mismatches(&trial, config, &firstGeneration))
+		{
+			test->historyDepth = (int)i;
+			break;
+		}
+	}
+
+	free(removed);
+	return;
+}
+
+/* Saves a shrunk board to the current directory, and prints how to run it */
+void saveReproducer(const testCase *test, const configuration *config, uint64_t seed, long caseNumber)
+{
+	char fileName[64], description[128];
+	const char *quiet;
+	long firstGeneration;
+	int stillMismatches;
+
+	snprintf(fileName, sizeof(fileName), "lifefuzz-%llu-%ld.txt", (unsigned long long)seed, caseNumber);
+	writeBoardFile(test, fileName);
+	stillMismatches = mismatches(test, config, &firstGeneration);
+	describeConfiguration(config, description, sizeof(description));
+
+	printf("  Shrunk to a %d x %d board with %ld cells and %d generations, saved as %s%s\n",
+	       test->width, test->height, test->noOfCells, test->noOfGenerations, fileName,
+	       stillMismatches ? "" : " (which no longer mismatches, the mismatch may depend on timing)");
+	quiet = ( (test->width > MAX_BOARD_WIDTH) || (test->height > MAX_BOARD_HEIGHT) ) ? " --quiet" : "";
+	printf("  Reference: %s --engine char --history %d%s %s %d %d %d\n",
+	       lifeProgram, test->historyDepth, quiet, fileName, test->width, test->height, test->noOfGenerations);
+	printf("  Mismatch:  %s %s --history %d%s %s %d %d %d\n",
+	       lifeProgram, description, test->historyDepth, quiet, fileName, test->width, test->height, test->noOfGenerations);
+	fflush(stdout);
+	return;
+}
@@ -0,0 +1,437 @@
+/*
+	lifereplay.c v1.0
+	Program to read back the frame logs written by TYLERJ-life3 --log, and print any generation in them.
+
+	Usage: ./lifereplay <log file> [<generation> [<last generation>]]
+
+	<log file> is a frame log written by TYLERJ-life3 with the --log option.
+	<generation> is the generation to print. If it is left out, a summary of the log is printed instead.
+	<last generation> prints every generation from <generation> to <last generation>.
+
+	Boards are printed in the same format as TYLERJ-life3, including the age of each live cell.
+	Finding a generation uses the keyframe index at the end of the log, so it takes a binary search
+	and at most one keyframe interval of deltas, however long the log is.
+	The format of the log is described with openFrameLog() in TYLERJ-life3.c.
+*/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+/* The age at which a cell's age stops increasing, this is printed as an 'X' */
+#define MAX_AGE 10
+
+/* The types of record in the log */
+#define KEYFRAME_RECORD 0
+#define DELTA_RECORD 1
+
+/* Structure to hold the keyframe index of a log */
+typedef struct
+{
+	long noOfKeyframes;
+	int64_t *generations;
+	int64_t *offsets;
+	long noOfGenerations;
+} keyframeIndex;
+
+/* The dimensions of the board in the log, and the number of words in each row of its live and age planes. */
+int boardWidth, boardHeight;
+int liveWordsPerRow, ageWordsPerRow;
+
+/* The characters used to print the age of a live cell, indexed by its age. */
+const char ageCharacters[MAX_AGE + 1] = {'0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'X'};
+
+/* Function prototypes */
+void *allocateMemory(size_t size);
+void readIndex(FILE *fp, keyframeIndex *index);
+void rebuildIndex(FILE *fp, keyframeIndex *index);
+long findKeyframe(const keyframeIndex *index, long generation);
+int readRecord(FILE *fp, int64_t *generation, int32_t *type, unsigned char *buffer, size_t bufferSize);
+size_t decodeZeroRuns(const unsigned char *input, size_t length, unsigned char *output, size_t outputLength);
+void applyDelta(uint64_t *live, uint64_t *ages, const uint64_t *difference);
+uint64_t spreadToNibbles(uint64_t bits);
+int agesValid(const uint64_t *ages);
+void printBoard(const uint64_t *live, const uint64_t *ages);
+
+int main(int argc, char* argv[])
+{
+	/* Check no. of arguments */
+	if( (argc < 2) || (argc > 4) )
+	{
+		fprintf(stderr, "Invalid arguments.\n"
+		                "Usage: %s <log file> [<generation> [<last generation>]]\n"
+		                "The program will now exit.\n", argv[0]);
+		exit(EXIT_FAILURE);
+	}
+
+	/* Open the log and check its header */
+	FILE *logFilePtr = fopen(argv[1], "rb");
+	if(logFilePtr == NULL)
+	{
+		fprintf(stderr, "Error opening log file (%s).\n"
+		                "Please ensure that the specified file exists.\n"
+		                "The program will now close.\n", argv[1]);
+		exit(EXIT_FAILURE);
+	}
+
+	char magic[8];
+	int32_t header[4];
+	if( (fread(magic, 1, 8, logFilePtr) != 8) || (memcmp(magic, "LIFELOG1", 8) != 0) || (fread(header, sizeof(int32_t), 4, logFilePtr) != 4) )
+	{
+		fprintf(stderr, "%s is not a frame log.\n"
+		                "The program will now close.\n", argv[1]);
+		exit(EXIT_FAILURE);
+	}
+	boardWidth = header[0];
+	boardHeight = header[1];
+	liveWordsPerRow = (boardWidth + 63) / 64;
+	ageWordsPerRow = (boardWidth + 15) / 16;
+
+	keyframeIndex index;
+	readIndex(logFilePtr, &index);
+
+	/* Without a generation, just describe the log */
+	if(argc == 2)
+	{
+		printf("Board: %d x %d\n"
+		       "Generations: %ld (0 to %ld)\n"
+		       "Keyframes: %ld, every %d generations\n",
+		       boardWidth, boardHeight, index.noOfGenerations, index.noOfGenerations - 1, index.noOfKeyframes, header[2]);
+		return EXIT_SUCCESS;
+	}
+
+	long firstGeneration = -1, lastGeneration;
+	sscanf(argv[2], "%ld", &firstGeneration);
+	lastGeneration = firstGeneration;
+	if(argc == 4)
+	{
+		lastGeneration = -1;
+		sscanf(argv[3], "%ld", &lastGeneration);
+	}
+	if( (firstGeneration < 0) || (lastGeneration < firstGeneration) || (lastGeneration >= index.noOfGenerations) )
+	{
+		fprintf(stderr, "Invalid generation.\n"
+		                "The log holds generations 0 to %ld.\n"
+		                "The program will now close.\n", index.noOfGenerations - 1);
+		exit(EXIT_FAILURE);
+	}
+
+	/* The board being rebuilt, and room to decompress a record into */
+	size_t liveWords = (size_t)boardHeight * liveWordsPerRow;
+	size_t ageWords = (size_t)boardHeight * ageWordsPerRow;
+	uint64_t *live = (uint64_t *)allocateMemory(liveWords * sizeof(uint64_t));
+	uint64_t *ages = (uint64_t *)allocateMemory(ageWords * sizeof(uint64_t));
+	uint64_t *difference = (uint64_t *)allocateMemory(liveWords * sizeof(uint64_t));
+	size_t bufferSize = (liveWords + ageWords) * (sizeof(uint64_t) + 2) + 32;
+	unsigned char *buffer = (unsigned char *)allocateMemory(bufferSize);
+
+	/* Start from the last keyframe at or before the first generation, and apply deltas from there */
+	long keyframe = findKeyframe(&index, firstGeneration);
+	fseek(logFilePtr, index.offsets[keyframe], SEEK_SET);
+
+	int64_t generation;
+	int32_t type;
+	int length;
+	do
+	{
+		length = readRecord(logFilePtr, &generation, &type, buffer, bufferSize);
+		if(length < 0)
+		{
+			fputs("The log is damaged.\n"
+			      "The program will now close.\n", stderr);
+			exit(EXIT_FAILURE);
+		}
+
+		if(type == KEYFRAME_RECORD)
+		{
+			size_t decoded = decodeZeroRuns(buffer, length, (unsigned char *)live, liveWords * sizeof(uint64_t));
+			decodeZeroRuns(buffer + decoded, length - decoded, (unsigned char *)ages, ageWords * sizeof(uint64_t));
+			if(!agesValid(ages))
+			{
+				fputs("The log is damaged.\n"
+				      "The program will now close.\n", stderr);
+				exit(EXIT_FAILURE);
+			}
+		}
+		else
+		{
+			decodeZeroRuns(buffer, length, (unsigned char *)difference, liveWords * sizeof(uint64_t));
+			applyDelta(live, ages, difference);
+		}
+
+		if(generation >= firstGeneration)
+			printBoard(live, ages);
+	}
+	while(generation < lastGeneration);
+
+	fclose(logFilePtr);
+	return EXIT_SUCCESS;
+}
+
+/* Allocates zeroed memory, exiting if it can't be allocated */
+void *allocateMemory(size_t size)
+{
+	void *memory = calloc(size > 0 ? size : 1, 1);
+	if(memory == NULL)
+	{
+		fputs("Memory allocation error.\n"
+		      "The program will now exit.\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+	return memory;
+}
+
+/* Reads the keyframe index from the end of the log.
+   If the log has no trailer (because TYLERJ-life3 was stopped before it closed the log), or the trailer and index don't fit
+   the file (because it was cut short or damaged), the index is rebuilt instead. */
+void readIndex(FILE *fp, keyframeIndex *index)
+{
+	char magic[8];
+	int64_t trailer[3];
+	long i;
+
+	if(fseek(fp, 0, SEEK_END) != 0)
+	{
+		rebuildIndex(fp, index);
+		return;
+	}
+	long fileSize = ftell(fp);
+
+	/* The index runs from its offset straight to the trailer, which ends the file */
+	if( (fseek(fp, -32, SEEK_END) != 0) || (fread(magic, 1, 8, fp) != 8) || (memcmp(magic, "LIFEIDX1", 8) != 0)
+	    || (fread(trailer, sizeof(int64_t), 3, fp) != 3) || (trailer[0] < 8 + 4 * (int64_t)sizeof(int32_t)) || (trailer[1] < 1)
+	    || (trailer[1] > (fileSize - 32 - trailer[0]) / 16) || (trailer[0] + 16 * trailer[1] + 32 != fileSize) || (trailer[2] < 1) )
+	{
+		rebuildIndex(fp, index);
+		return;
+	}
+
+	index->noOfKeyframes = trailer[1];
+	index->noOfGenerations = trailer[2];
+	index->generations = (int64_t *)allocateMemory(index->noOfKeyframes * sizeof(int64_t));
+	index->offsets = (int64_t *)allocateMemory(index->noOfKeyframes * sizeof(int64_t));
+
+	fseek(fp, trailer[0], SEEK_SET);
+	for(i = 0; i < index->noOfKeyframes; i++)
+	{
+		if( (fread(&index->generations[i], sizeof(int64_t), 1, fp) != 1) || (fread(&index->offsets[i], sizeof(int64_t), 1, fp) != 1)
+		    || (index->offsets[i] < 8 + 4 * (int64_t)sizeof(int32_t)) || (index->offsets[i] >= trailer[0])
+		    || (index->generations[i] < 0) || (index->generations[i] >= index->noOfGenerations) )
+		{
+			free(index->generations);
+			free(index->offsets);
+			rebuildIndex(fp, index);
+			return;
+		}
+	}
+	return;
+}
+
+/* Builds the keyframe index by reading the header of every record, for logs without a trailer.
+   Stops at the first record that is incomplete, isn't a keyframe or a delta, or isn't the generation after the one before it,
+   which is where the index starts in a log that has one. */
+void rebuildIndex(FILE *fp, keyframeIndex *index)
+{
+	long capacity = 16;
+	int64_t generation;
+	int32_t recordHeader[2];
+	long offset = 8 + 4 * sizeof(int32_t);
+
+	index->noOfKeyframes = 0;
+	index->noOfGenerations = 0;
+	index->generations = (int64_t *)allocateMemory(capacity * sizeof(int64_t));
+	index->offsets = (int64_t *)allocateMemory(capacity * sizeof(int64_t));
+
+	fseek(fp, 0, SEEK_END);
+	long fileSize = ftell(fp);
+
+	while(offset + 16 <= fileSize)
+	{
+		fseek(fp, offset, SEEK_SET);
+		if( (fread(&generation, sizeof(int64_t), 1, fp) != 1) || (fread(recordHeader, sizeof(int32_t), 2, fp) != 2) )
+			break;
+		if( ( (recordHeader[0] != KEYFRAME_RECORD) && (recordHeader[0] != DELTA_RECORD) ) || (generation != index->noOfGenerations)
+		    || (recordHeader[1] < 0) || (offset + 16 + recordHeader[1] > fileSize) )
+			break;
+
+		if(recordHeader[0] == KEYFRAME_RECORD)
+		{
+			if(index->noOfKeyframes == capacity)
+			{
+				capacity *= 2;
+				index->generations = (int64_t *)realloc(index->generations, capacity * sizeof(int64_t));
+				index->offsets = (int64_t *)realloc(index->offsets, capacity * sizeof(int64_t));
+				if( (index->generations == NULL) || (index->offsets == NULL) )
+				{
+					fputs("Memory allocation error.\n"
+					      "The program will now exit.\n", stderr);
+					exit(EXIT_FAILURE);
+				}
+			}
+			index->generations[index->noOfKeyframes] = generation;
+			index->offsets[index->noOfKeyframes] = offset;
+			index->noOfKeyframes++;
+		}
+		index->noOfGenerations = generation + 1;
+		offset += 16 + recordHeader[1];
+	}
+
+	if(index->noOfKeyframes == 0)
+	{
+		fputs("The log contains no complete generations.\n"
+		      "The program will now close.\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+	return;
+}
+
+/* Returns the position in the index of the last keyframe at or before a generation, by binary search */
+long findKeyframe(const keyframeIndex *index, long generation)
+{
+	long low = 0, high = index->noOfKeyframes - 1, middle;
+
+	while(low < high)
+	{
+		middle = (low + high + 1) / 2;
+		if(index->generations[middle] <= generation)
+			low = middle;
+		else
+			high = middle - 1;
+	}
+	return low;
+}
+
+/* Reads the next record from the log into buffer.
+   Returns the length of its payload, or -1 if the record is incomplete or too large. */
+int readRecord(FILE *fp, int64_t *generation, int32_t *type, unsigned char *buffer, size_t bufferSize)
+{
+	int32_t length;
+
+	if( (fread(generation, sizeof(int64_t), 1, fp) != 1) || (fread(type, sizeof(int32_t), 1, fp) != 1)
+	    || (fread(&length, sizeof(int32_t), 1, fp) != 1) || (length < 0) || ((size_t)length > bufferSize) )
+		return -1;
+	if(fread(buffer, 1, length, fp) != (size_t)length)
+		return -1;
+	return length;
+}
+
+/* Reverses encodeZeroRuns() in TYLERJ-life3.c, writing outputLength bytes.
+   Returns the number of input bytes used, since a keyframe holds two encoded planes one after the other.
+   FUNCTION DOES NO ERROR CHECKING BEYOND STAYING INSIDE THE BUFFERS */
+size_t decodeZeroRuns(const unsigned char *input, size_t length, unsigned char *output, size_t outputLength)
+{
+	uint64_t *words = (uint64_t *)output;
+	size_t noOfWords = outputLength / sizeof(uint64_t);
+	size_t position = 0, written = 0;
+	uint64_t zeros, word;
+	unsigned int mask;
+	int shift, byte;
+
+	while( (written < noOfWords) && (position < length) )
+	{
+		/* A run of zero words */
+		for(zeros = 0, shift = 0; position < length; shift += 7)
+		{
+			zeros |= (uint64_t)(input[position] & 0x7F) << shift;
+			if( (input[position++] & 0x80) == 0 )
+				break;
+		}
+		if(zeros > noOfWords - written)
+			zeros = noOfWords - written;
+		memset(words + written, 0, zeros * sizeof(uint64_t));
+		written += zeros;
+
+		/* Then the other words, each a mask byte followed by its non-zero bytes, until a 0 mask byte */
+		while( (position < length) && ( (mask = input[position++]) != 0 ) )
+		{
+			for(word = 0, byte = 0; byte < 8; byte++)
+				if( ( (mask >> byte) & 1 ) && (position < length) )
+					word |= (uint64_t)input[position++] << (8 * byte);
+			if(written < noOfWords)
+				words[written++] = word;
+		}
+	}
+
+	memset(words + written, 0, (noOfWords - written) * sizeof(uint64_t));
+	return position;
+}
+
+/* Moves the board on a generation by XORing the live plane with a delta.
+   The ages follow from which cells stayed alive, exactly as in updateAgeRow() in TYLERJ-life3.c. */
+void applyDelta(uint64_t *live, uint64_t *ages, const uint64_t *difference)
+{
+	int row, word;
+	uint64_t oldLive, stayedAlive, saturated;
+
+	for(row = 0; row < boardHeight; row++)
+		for(word = 0; word < ageWordsPerRow; word++)
+		{
+			oldLive = live[(size_t)row * liveWordsPerRow + word / 4];
+			stayedAlive = spreadToNibbles( ( (oldLive & (oldLive ^ difference[(size_t)row * liveWordsPerRow + word / 4])) >> (16 * (word % 4)) ) & 0xFFFF );
+			uint64_t *age = &ages[(size_t)row * ageWordsPerRow + word];
+			saturated = (*age >> 3) & (*age >> 1) & 0x1111111111111111ULL;
+			*age = (*age + (stayedAlive & ~saturated)) & (stayedAlive * 0xF);
+		}
+
+	size_t i;
+	for(i = 0; i < (size_t)boardHeight * liveWordsPerRow; i++)
+		live[i] ^= difference[i];
+	return;
+}
+
+/* Moves each of the lowest 16 bits of a word to the lowest bit of the corresponding nibble */
+uint64_t spreadToNibbles(uint64_t bits)
+{
+	bits = (bits | (bits << 24)) & 0x000000FF000000FFULL;
+	bits = (bits | (bits << 12)) & 0x000F000F000F000FULL;
+	bits = (bits | (bits << 6)) & 0x0303030303030303ULL;
+	bits = (bits | (bits << 3)) & 0x1111111111111111ULL;
+	return bits;
+}
+
+/* Returns 1 if every age in the age plane is at most MAX_AGE, 0 if any is too big to have been written by TYLERJ-life3.
+   The deltas never take an age past MAX_AGE, so only the keyframes need checking. */
+int agesValid(const uint64_t *ages)
+{
+	size_t i;
+	int nibble;
+
+	for(i = 0; i < (size_t)boardHeight * ageWordsPerRow; i++)
+		for(nibble = 0; nibble < 16; nibble++)
+			if( ( (ages[i] >> (4 * nibble)) & 0xF ) > MAX_AGE )
+				return 0;
+	return 1;
+}
+
+/* Prints a board in the same format as TYLERJ-life3 */
+void printBoard(const uint64_t *live, const uint64_t *ages)
+{
+	int row, column;
+
+	putchar('*');
+	for(column = 0; column < boardWidth; column++)
+		putchar('-');
+	puts("*");
+
+	for(row = 0; row < boardHeight; row++)
+	{
+		putchar('|');
+		for(column = 0; column < boardWidth; column++)
+			if( (live[(size_t)row * liveWordsPerRow + column / 64] >> (column % 64)) & 1 )
+				putchar(ageCharacters[(ages[(size_t)row * ageWordsPerRow + column / 16] >> (4 * (column % 16))) & 0xF]);
+			else
+				putchar(' ');
+		puts("|");
+	}
+
+	putchar('*');
+	for(column = 0; column < boardWidth; column++)
+		putchar('-');
+	puts("*");
+
+	putchar('\n');
+	putchar('\n');
+	return;
+}
@@ -0,0 +1,258 @@
+/*
+	lifewatch.c v1.0
+	Program to watch a board that TYLERJ-life3 is publishing with the --export option, as a sample reader of the shared memory export.
+
+	Usage: ./lifewatch <name> [<milliseconds between checks>]
+
+	<name> is the name given to TYLERJ-life3 --export, e.g. /life.
+	<milliseconds between checks> is how often the export is checked for a new generation (default 100).
+
+	Each new generation that is seen is described by a line giving its generation, population and hash,
+	followed by the board in the same format as TYLERJ-life3 if it is small enough to print.
+	Generations that come and go between checks are skipped, TYLERJ-life3 never waits for its readers.
+	The program stops once TYLERJ-life3 has published its last generation.
+	The layout of the export is described with openBoardExport() in TYLERJ-life3.c.
+*/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/* The largest board that is printed, as for TYLERJ-life3 */
+#define MAX_BOARD_WIDTH 78
+#define MAX_BOARD_HEIGHT 50
+
+/* The age at which a cell's age stops increasing, this is printed as an 'X' */
+#define MAX_AGE 10
+
+/* The header at the start of the export, which must match the one in TYLERJ-life3.c */
+typedef struct
+{
+	char magic[8];
+	int32_t width;
+	int32_t height;
+	int32_t liveWordsPerRow;
+	int32_t ageWordsPerRow;
+	atomic_uint_least64_t sequence;
+	int64_t generation;
+	int64_t population;
+	uint64_t hash;
+	int32_t finished;
+	int32_t reserved;
+} sharedBoardHeader;
+
+/* The dimensions of the board in the export, and the number of words in each row of its live and age planes. */
+int boardWidth, boardHeight;
+int liveWordsPerRow, ageWordsPerRow;
+
+/* The characters used to print the age of a live cell, indexed by its age. */
+const char ageCharacters[MAX_AGE + 1] = {'0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'X'};
+
+/* Function prototypes */
+void *allocateMemory(size_t size);
+int readFrame(const sharedBoardHeader *header, const uint64_t *sharedLive, const uint64_t *sharedAges,
+              sharedBoardHeader *frame, uint64_t *live, uint64_t *ages);
+uint64_t hashPlane(const uint64_t *live);
+uint64_t mixBits(uint64_t value);
+void printBoard(const uint64_t *live, const uint64_t *ages);
+
+int main(int argc, char* argv[])
+{
+	/* Check no. of arguments */
+	if( (argc < 2) || (argc > 3) )
+	{
+		fprintf(stderr, "Invalid arguments.\n"
+		                "Usage: %s <name> [<milliseconds between checks>]\n"
+		                "The program will now exit.\n", argv[0]);
+		exit(EXIT_FAILURE);
+	}
+
+	long interval = 100;
+	if(argc == 3)
+	{
+		interval = -1;
+		sscanf(argv[2], "%ld", &interval);
+		if(interval < 0)
+		{
+			fputs("Invalid interval.\n"
+			      "Please ensure that the interval is a whole number of milliseconds.\n"
+			      "The program will now exit.\n", stderr);
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	/* Map the export, read only, so that the reader can never disturb TYLERJ-life3 */
+	int fd = shm_open(argv[1], O_RDONLY, 0);
+	struct stat status;
+	if( (fd < 0) || (fstat(fd, &status) != 0) || ( (size_t)status.st_size < 64 ) )
+	{
+		fprintf(stderr, "Error opening shared memory object (%s).\n"
+		                "Please ensure that TYLERJ-life3 is running with --export %s.\n"
+		                "The program will now exit.\n", argv[1], argv[1]);
+		exit(EXIT_FAILURE);
+	}
+
+	void *memory = mmap(NULL, status.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if(memory == MAP_FAILED)
+	{
+		fprintf(stderr, "Error mapping shared memory object (%s).\n"
+		                "The program will now exit.\n", argv[1]);
+		exit(EXIT_FAILURE);
+	}
+
+	/* Wait for TYLERJ-life3 to fill in the header, which it does straight after creating the object */
+	const sharedBoardHeader *header = (const sharedBoardHeader *)memory;
+	struct timespec pause = {interval / 1000, (interval % 1000) * 1000000};
+	struct timespec shortPause = {0, 1000000};
+	uint64_t sequence;
+	while( (sequence = atomic_load_explicit((atomic_uint_least64_t *)&header->sequence, memory_order_acquire)) < 2 )
+		nanosleep(&shortPause, NULL);
+	if(memcmp(header->magic, "LIFESHM1", 8) != 0)
+	{
+		fprintf(stderr, "%s is not a board export.\n"
+		                "The program will now exit.\n", argv[1]);
+		exit(EXIT_FAILURE);
+	}
+
+	boardWidth = header->width;
+	boardHeight = header->height;
+	liveWordsPerRow = header->liveWordsPerRow;
+	ageWordsPerRow = header->ageWordsPerRow;
+	size_t liveBytes = (size_t)boardHeight * liveWordsPerRow * sizeof(uint64_t);
+	size_t ageBytes = (size_t)boardHeight * ageWordsPerRow * sizeof(uint64_t);
+	if( (size_t)status.st_size < 64 + liveBytes + ageBytes )
+	{
+		fprintf(stderr, "%s is too small for its board.\n"
+		                "The program will now exit.\n", argv[1]);
+		exit(EXIT_FAILURE);
+	}
+	const uint64_t *sharedLive = (const uint64_t *)( (const unsigned char *)memory + 64 );
+	const uint64_t *sharedAges = (const uint64_t *)( (const unsigned char *)memory + 64 + liveBytes );
+
+	/* The reader's own copy of the latest consistent frame */
+	sharedBoardHeader frame;
+	uint64_t *live = (uint64_t *)allocateMemory(liveBytes);
+	uint64_t *ages = (uint64_t *)allocateMemory(ageBytes);
+	int64_t lastGeneration = -1;
+
+	do
+	{
+		/* A frame that changed while it was being copied is simply copied again */
+		while(!readFrame(header, sharedLive, sharedAges, &frame, live, ages))
+			nanosleep(&shortPause, NULL);
+
+		if(frame.generation > lastGeneration)
+		{
+			printf("Generation %lld: population %lld, hash %016llx%s\n", (long long)frame.generation, (long long)frame.population,
+			       (unsigned long long)frame.hash, (hashPlane(live) == frame.hash) ? "" : " (does not match the board)");
+			if( (boardWidth <= MAX_BOARD_WIDTH) && (boardHeight <= MAX_BOARD_HEIGHT) )
+				printBoard(live, ages);
+			fflush(stdout);
+			lastGeneration = frame.generation;
+		}
+
+		if(!frame.finished)
+			nanosleep(&pause, NULL);
+	}
+	while(!frame.finished);
+
+	munmap(memory, status.st_size);
+	return EXIT_SUCCESS;
+}
+
+/* Allocates zeroed memory, exiting if it can't be allocated */
+void *allocateMemory(size_t size)
+{
+	void *memory = calloc(size > 0 ? size : 1, 1);
+	if(memory == NULL)
+	{
+		fputs("Memory allocation error.\n"
+		      "The program will now exit.\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+	return memory;
+}
+
+/* Copies the header and the planes of the export, using the sequence in the header as a seqlock.
+   Returns 1 if the copy is consistent, or 0 if TYLERJ-life3 was writing to the export during the copy. */
+int readFrame(const sharedBoardHeader *header, const uint64_t *sharedLive, const uint64_t *sharedAges,
+              sharedBoardHeader *frame, uint64_t *live, uint64_t *ages)
+{
+	atomic_uint_least64_t *sequence = (atomic_uint_least64_t *)&header->sequence;
+	uint64_t before = atomic_load_explicit(sequence, memory_order_acquire);
+	if(before % 2 == 1)
+		return 0;
+
+	frame->generation = header->generation;
+	frame->population = header->population;
+	frame->hash = header->hash;
+	frame->finished = header->finished;
+	memcpy(live, sharedLive, (size_t)boardHeight * liveWordsPerRow * sizeof(uint64_t));
+	memcpy(ages, sharedAges, (size_t)boardHeight * ageWordsPerRow * sizeof(uint64_t));
+
+	atomic_thread_fence(memory_order_acquire);
+	return atomic_load_explicit(sequence, memory_order_relaxed) == before;
+}
+
+/* Hashes a live plane in the same way as TYLERJ-life3, to check a copy of it */
+uint64_t hashPlane(const uint64_t *live)
+{
+	uint64_t hash = 0;
+	size_t i;
+
+	for(i = 0; i < (size_t)boardHeight * liveWordsPerRow; i++)
+		if(live[i] != 0)
+			hash += mixBits(live[i] ^ mixBits(i));
+	return hash;
+}
+
+/* Scrambles the bits of a 64 bit value (the splitmix64 finaliser), as in TYLERJ-life3 */
+uint64_t mixBits(uint64_t value)
+{
+	value ^= value >> 30;
+	value *= 0xbf58476d1ce4e5b9ULL;
+	value ^= value >> 27;
+	value *= 0x94d049bb133111ebULL;
+	value ^= value >> 31;
+	return value;
+}
+
+/* Prints a board with its border, followed by two blank lines, in the same format as TYLERJ-life3 */
+void printBoard(const uint64_t *live, const uint64_t *ages)
+{
+	int row, column;
+
+	putchar('*');
+	for(column = 0; column < boardWidth; column++)
+		putchar('-');
+	puts("*");
+
+	for(row = 0; row < boardHeight; row++)
+	{
+		putchar('|');
+		for(column = 0; column < boardWidth; column++)
+			if( (live[(size_t)row * liveWordsPerRow + column / 64] >> (column % 64)) & 1 )
+				putchar(ageCharacters[(ages[(size_t)row * ageWordsPerRow + column / 16] >> (4 * (column % 16))) & 0xF]);
+			else
+				putchar(' ');
+		puts("|");
+	}
+
+	putchar('*');
+	for(column = 0; column < boardWidth; column++)
+		putchar('-');
+	puts("*");
+
+	putchar('\n');
+	putchar('\n');
+	return;
+}